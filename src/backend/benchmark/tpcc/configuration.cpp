@@ -0,0 +1,175 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// configuration.cpp
+//
+// Identification: benchmark/tpcc/configuration.cpp
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <iomanip>
+#include <algorithm>
+
+#include "backend/benchmark/tpcc/configuration.h"
+
+namespace peloton {
+namespace benchmark {
+namespace tpcc {
+
+void Usage(FILE *out) {
+  fprintf(out,
+          "Command line options : tpcc <options> \n"
+          "   -h --help              :  Print help message \n"
+          "   -w --warehouse_count   :  # of warehouses \n"
+          "   -k --scale-factor      :  Size of the tables (100 = full) \n"
+          "   -b --backend-count     :  # of backends \n"
+          "   -t --transactions      :  # of transactions per backend \n"
+          "   -n --new_order_ratio   :  Fraction of NewOrder txns \n"
+          "   -i --index             :  Index type (BTREE, BWTREE) \n"
+          "   -e --concurrency       :  Concurrency control (MVCC, OCC) \n");
+  exit(EXIT_FAILURE);
+}
+
+static struct option opts[] = {
+    {"warehouse_count", optional_argument, NULL, 'w'},
+    {"scale-factor", optional_argument, NULL, 'k'},
+    {"backend-count", optional_argument, NULL, 'b'},
+    {"transactions", optional_argument, NULL, 't'},
+    {"new_order_ratio", optional_argument, NULL, 'n'},
+    {"index", optional_argument, NULL, 'i'},
+    {"concurrency", optional_argument, NULL, 'e'},
+    {NULL, 0, NULL, 0}};
+
+static void ValidateWarehouseCount(const configuration &state) {
+  if (state.warehouse_count <= 0) {
+    std::cout << "Invalid warehouse_count :: " << state.warehouse_count
+              << std::endl;
+    exit(EXIT_FAILURE);
+  }
+
+  std::cout << std::setw(20) << std::left << "warehouse_count "
+            << " : " << state.warehouse_count << std::endl;
+}
+
+static void ValidateScaleFactor(const configuration &state) {
+  if (state.scale_factor <= 0) {
+    std::cout << "Invalid scalefactor :: " << state.scale_factor << std::endl;
+    exit(EXIT_FAILURE);
+  }
+
+  std::cout << std::setw(20) << std::left << "scale_factor "
+            << " : " << state.scale_factor << std::endl;
+}
+
+static void ValidateBackendCount(const configuration &state) {
+  if (state.backend_count <= 0) {
+    std::cout << "Invalid backend_count :: " << state.backend_count
+              << std::endl;
+    exit(EXIT_FAILURE);
+  }
+
+  std::cout << std::setw(20) << std::left << "backend_count "
+            << " : " << state.backend_count << std::endl;
+}
+
+static void ValidateNewOrderRatio(const configuration &state) {
+  if (state.new_order_ratio < 0 || state.new_order_ratio > 1) {
+    std::cout << "Invalid new_order_ratio :: " << state.new_order_ratio
+              << std::endl;
+    exit(EXIT_FAILURE);
+  }
+
+  std::cout << std::setw(20) << std::left << "new_order_ratio "
+            << " : " << state.new_order_ratio << std::endl;
+}
+
+static void ValidateIndexType(const configuration &state) {
+  if (state.index_type == INDEX_TYPE_INVALID) {
+    std::cout << "Invalid index_type" << std::endl;
+    exit(EXIT_FAILURE);
+  }
+
+  std::cout << std::setw(20) << std::left << "index_type "
+            << " : " << IndexTypeToString(state.index_type) << std::endl;
+}
+
+static void ValidateConcurrencyType(const configuration &state) {
+  if (state.concurrency_type == CONCURRENCY_TYPE_INVALID) {
+    std::cout << "Invalid concurrency_type" << std::endl;
+    exit(EXIT_FAILURE);
+  }
+
+  std::cout << std::setw(20) << std::left << "concurrency_type "
+            << " : " << ConcurrencyTypeToString(state.concurrency_type)
+            << std::endl;
+}
+
+void ParseArguments(int argc, char *argv[], configuration &state) {
+  // Default Values
+  state.warehouse_count = 2;
+  state.scale_factor = 1;
+
+  state.backend_count = 4;
+  state.transactions = 1000;
+  state.new_order_ratio = 0.5;
+
+  state.index_type = INDEX_TYPE_BTREE;
+  state.concurrency_type = CONCURRENCY_TYPE_MVCC;
+
+  // Parse args
+  while (1) {
+    int idx = 0;
+    int c = getopt_long(argc, argv, "hw:k:b:t:n:i:e:", opts, &idx);
+
+    if (c == -1) break;
+
+    switch (c) {
+      case 'w':
+        state.warehouse_count = atoi(optarg);
+        break;
+      case 'k':
+        state.scale_factor = atoi(optarg);
+        break;
+      case 'b':
+        state.backend_count = atoi(optarg);
+        break;
+      case 't':
+        state.transactions = atoi(optarg);
+        break;
+      case 'n':
+        state.new_order_ratio = atof(optarg);
+        break;
+      case 'i':
+        state.index_type = StringToIndexType(optarg);
+        break;
+      case 'e':
+        state.concurrency_type = StringToConcurrencyType(optarg);
+        break;
+      case 'h':
+        Usage(stderr);
+        break;
+
+      default:
+        fprintf(stderr, "\nUnknown option: -%c-\n", c);
+        Usage(stderr);
+    }
+  }
+
+  // Print configuration
+  ValidateWarehouseCount(state);
+  ValidateScaleFactor(state);
+  ValidateBackendCount(state);
+  ValidateNewOrderRatio(state);
+  ValidateIndexType(state);
+  ValidateConcurrencyType(state);
+
+  std::cout << std::setw(20) << std::left << "transactions "
+            << " : " << state.transactions << std::endl;
+}
+
+}  // namespace tpcc
+}  // namespace benchmark
+}  // namespace peloton
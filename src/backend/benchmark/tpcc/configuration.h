@@ -0,0 +1,57 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// configuration.h
+//
+// Identification: benchmark/tpcc/configuration.h
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <string>
+#include <getopt.h>
+#include <vector>
+#include <sys/time.h>
+#include <iostream>
+
+#include "backend/storage/data_table.h"
+
+namespace peloton {
+namespace benchmark {
+namespace tpcc {
+
+class configuration {
+ public:
+  // # of warehouses, fewer warehouses = more contention
+  int warehouse_count;
+
+  // size of the item, stock and customer tables (100 = full size)
+  int scale_factor;
+
+  // # of concurrent backends
+  int backend_count;
+
+  // # of transactions per backend
+  unsigned long transactions;
+
+  // fraction of the transactions that are NewOrder (the rest are Payment)
+  double new_order_ratio;
+
+  // primary key indexes
+  IndexType index_type;
+
+  // concurrency control
+  ConcurrencyType concurrency_type;
+};
+
+void Usage(FILE *out);
+
+void ParseArguments(int argc, char *argv[], configuration &state);
+
+}  // namespace tpcc
+}  // namespace benchmark
+}  // namespace peloton
@@ -0,0 +1,164 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// loader.cpp
+//
+// Identification: benchmark/tpcc/loader.cpp
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <iostream>
+#include <cassert>
+
+#include "backend/benchmark/tpcc/loader.h"
+#include "backend/catalog/schema.h"
+#include "backend/common/value_factory.h"
+#include "backend/concurrency/transaction.h"
+#include "backend/concurrency/transaction_manager.h"
+#include "backend/index/index_factory.h"
+#include "backend/storage/tuple.h"
+#include "backend/storage/data_table.h"
+#include "backend/storage/table_factory.h"
+
+namespace peloton {
+namespace benchmark {
+namespace tpcc {
+
+storage::DataTable *warehouse_table;
+storage::DataTable *district_table;
+storage::DataTable *customer_table;
+storage::DataTable *item_table;
+storage::DataTable *stock_table;
+storage::DataTable *orders_table;
+storage::DataTable *new_order_table;
+storage::DataTable *order_line_table;
+storage::DataTable *history_table;
+
+int GetCustomerCount() { return CUSTOMERS_PER_DISTRICT * state.scale_factor; }
+
+int GetItemCount() { return ITEM_COUNT * state.scale_factor; }
+
+// Create a table with integer columns, and a primary key index on the
+// first key_count columns
+static storage::DataTable *CreateTable(std::string table_name,
+                                       oid_t col_count, oid_t key_count) {
+  const bool is_inlined = true;
+
+  std::vector<catalog::Column> columns;
+
+  for (oid_t col_itr = 0; col_itr < col_count; col_itr++) {
+    auto column =
+        catalog::Column(VALUE_TYPE_INTEGER, GetTypeSize(VALUE_TYPE_INTEGER),
+                        "" + std::to_string(col_itr), is_inlined);
+
+    columns.push_back(column);
+  }
+
+  catalog::Schema *table_schema = new catalog::Schema(columns);
+
+  bool own_schema = true;
+  bool adapt_table = false;
+  auto table = storage::TableFactory::GetDataTable(
+      INVALID_OID, INVALID_OID, table_schema, table_name,
+      DEFAULT_TUPLES_PER_TILEGROUP, own_schema, adapt_table);
+
+  // PRIMARY INDEX
+  if (key_count > 0) {
+    std::vector<oid_t> key_attrs;
+    for (oid_t key_itr = 0; key_itr < key_count; key_itr++) {
+      key_attrs.push_back(key_itr);
+    }
+
+    auto tuple_schema = table->GetSchema();
+    catalog::Schema *key_schema =
+        catalog::Schema::CopySchema(tuple_schema, key_attrs);
+    key_schema->SetIndexedColumns(key_attrs);
+
+    bool unique = true;
+
+    index::IndexMetadata *index_metadata = new index::IndexMetadata(
+        table_name + "_pkey", 123, state.index_type,
+        INDEX_CONSTRAINT_TYPE_PRIMARY_KEY, tuple_schema, key_schema, unique);
+
+    index::Index *pkey_index =
+        index::IndexFactory::GetInstance(index_metadata);
+    table->AddIndex(pkey_index);
+  }
+
+  return table;
+}
+
+static void CreateTables() {
+  warehouse_table = CreateTable("WAREHOUSE", 3, 1);
+  district_table = CreateTable("DISTRICT", 5, 2);
+  customer_table = CreateTable("CUSTOMER", 7, 3);
+  item_table = CreateTable("ITEM", 2, 1);
+  stock_table = CreateTable("STOCK", 5, 2);
+  orders_table = CreateTable("ORDERS", 5, 3);
+  new_order_table = CreateTable("NEW_ORDER", 3, 3);
+  order_line_table = CreateTable("ORDER_LINE", 7, 4);
+  history_table = CreateTable("HISTORY", 4, 0);
+}
+
+static void LoadTuple(concurrency::Transaction *txn, VarlenPool *pool,
+                      storage::DataTable *table,
+                      const std::vector<int> &values) {
+  storage::Tuple tuple(table->GetSchema(), true);
+
+  for (oid_t col_itr = 0; col_itr < values.size(); col_itr++) {
+    tuple.SetValue(col_itr, ValueFactory::GetIntegerValue(values[col_itr]),
+                   pool);
+  }
+
+  ItemPointer tuple_slot_id = table->InsertTuple(txn, &tuple);
+  assert(tuple_slot_id.block != INVALID_OID);
+  assert(tuple_slot_id.offset != INVALID_OID);
+  txn->RecordInsert(tuple_slot_id);
+}
+
+static void LoadTables() {
+  auto &txn_manager = concurrency::TransactionManager::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  std::unique_ptr<VarlenPool> pool(new VarlenPool(BACKEND_TYPE_MM));
+
+  // Prices, taxes and discounts are in basis points, money is in cents
+  for (int i_id = 0; i_id < GetItemCount(); i_id++) {
+    LoadTuple(txn, pool.get(), item_table, {i_id, 100 + (i_id % 10000)});
+  }
+
+  for (int w_id = 0; w_id < state.warehouse_count; w_id++) {
+    LoadTuple(txn, pool.get(), warehouse_table, {w_id, 1000, 30000000});
+
+    for (int i_id = 0; i_id < GetItemCount(); i_id++) {
+      LoadTuple(txn, pool.get(), stock_table, {w_id, i_id, 50, 0, 0});
+    }
+
+    for (int d_id = 0; d_id < DISTRICTS_PER_WAREHOUSE; d_id++) {
+      LoadTuple(txn, pool.get(), district_table,
+                {w_id, d_id, 1000, 3000000, 0});
+
+      for (int c_id = 0; c_id < GetCustomerCount(); c_id++) {
+        LoadTuple(txn, pool.get(), customer_table,
+                  {w_id, d_id, c_id, 500, -1000, 1000, 1});
+      }
+    }
+  }
+
+  txn_manager.CommitTransaction();
+}
+
+void CreateAndLoadTables() {
+  CreateTables();
+
+  LoadTables();
+}
+
+}  // namespace tpcc
+}  // namespace benchmark
+}  // namespace peloton
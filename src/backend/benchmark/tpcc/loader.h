@@ -0,0 +1,66 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// loader.h
+//
+// Identification: benchmark/tpcc/loader.h
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "backend/benchmark/tpcc/configuration.h"
+
+namespace peloton {
+namespace benchmark {
+namespace tpcc {
+
+// Table sizes at scale factor 1
+#define DISTRICTS_PER_WAREHOUSE 10
+#define CUSTOMERS_PER_DISTRICT 30
+#define ITEM_COUNT 1000
+
+extern configuration state;
+
+// Simplified TPC-C tables, with integer columns only.
+// The primary key is made of the leading columns of every table.
+
+// W_ID, W_TAX, W_YTD
+extern storage::DataTable *warehouse_table;
+
+// D_W_ID, D_ID, D_TAX, D_YTD, D_NEXT_O_ID
+extern storage::DataTable *district_table;
+
+// C_W_ID, C_D_ID, C_ID, C_DISCOUNT, C_BALANCE, C_YTD_PAYMENT, C_PAYMENT_CNT
+extern storage::DataTable *customer_table;
+
+// I_ID, I_PRICE
+extern storage::DataTable *item_table;
+
+// S_W_ID, S_I_ID, S_QUANTITY, S_YTD, S_ORDER_CNT
+extern storage::DataTable *stock_table;
+
+// O_W_ID, O_D_ID, O_ID, O_C_ID, O_OL_CNT
+extern storage::DataTable *orders_table;
+
+// NO_W_ID, NO_D_ID, NO_O_ID
+extern storage::DataTable *new_order_table;
+
+// OL_W_ID, OL_D_ID, OL_O_ID, OL_NUMBER, OL_I_ID, OL_QUANTITY, OL_AMOUNT
+extern storage::DataTable *order_line_table;
+
+// H_C_W_ID, H_C_D_ID, H_C_ID, H_AMOUNT (no index)
+extern storage::DataTable *history_table;
+
+int GetCustomerCount();
+
+int GetItemCount();
+
+void CreateAndLoadTables();
+
+}  // namespace tpcc
+}  // namespace benchmark
+}  // namespace peloton
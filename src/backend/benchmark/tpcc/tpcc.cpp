@@ -0,0 +1,49 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// tpcc.cpp
+//
+// Identification: benchmark/tpcc/tpcc.cpp
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <iostream>
+#include <fstream>
+
+#include "backend/benchmark/tpcc/tpcc.h"
+#include "backend/benchmark/tpcc/configuration.h"
+#include "backend/benchmark/tpcc/loader.h"
+#include "backend/benchmark/tpcc/workload.h"
+#include "backend/concurrency/transaction_manager.h"
+
+namespace peloton {
+namespace benchmark {
+namespace tpcc {
+
+configuration state;
+
+// Main Entry Point
+void RunBenchmark() {
+  auto &txn_manager = concurrency::TransactionManager::GetInstance();
+  txn_manager.SetConcurrencyType(state.concurrency_type);
+
+  CreateAndLoadTables();
+
+  RunWorkload();
+}
+
+}  // namespace tpcc
+}  // namespace benchmark
+}  // namespace peloton
+
+int main(int argc, char **argv) {
+  peloton::benchmark::tpcc::ParseArguments(argc, argv,
+                                           peloton::benchmark::tpcc::state);
+
+  peloton::benchmark::tpcc::RunBenchmark();
+
+  return 0;
+}
@@ -0,0 +1,412 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// workload.cpp
+//
+// Identification: benchmark/tpcc/workload.cpp
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <thread>
+#include <algorithm>
+#include <numeric>
+
+#include "backend/benchmark/tpcc/workload.h"
+#include "backend/benchmark/tpcc/loader.h"
+#include "backend/common/value_factory.h"
+#include "backend/common/value_peeker.h"
+#include "backend/concurrency/transaction.h"
+#include "backend/concurrency/transaction_manager.h"
+#include "backend/executor/executor_context.h"
+#include "backend/executor/index_scan_executor.h"
+#include "backend/executor/insert_executor.h"
+#include "backend/executor/logical_tile.h"
+#include "backend/executor/update_executor.h"
+#include "backend/expression/expression_util.h"
+#include "backend/planner/index_scan_plan.h"
+#include "backend/planner/insert_plan.h"
+#include "backend/planner/project_info.h"
+#include "backend/planner/update_plan.h"
+#include "backend/storage/data_table.h"
+
+namespace peloton {
+namespace benchmark {
+namespace tpcc {
+
+enum TransactionType {
+  TRANSACTION_TYPE_NEW_ORDER = 0,
+  TRANSACTION_TYPE_PAYMENT = 1,
+  TRANSACTION_TYPE_COUNT = 2
+};
+
+static const char *transaction_names[TRANSACTION_TYPE_COUNT] = {"new_order",
+                                                                "payment"};
+
+struct BackendResult {
+  unsigned long committed[TRANSACTION_TYPE_COUNT] = {0, 0};
+
+  unsigned long aborted[TRANSACTION_TYPE_COUNT] = {0, 0};
+
+  // latency of the committed transactions (us)
+  std::vector<double> latencies[TRANSACTION_TYPE_COUNT];
+};
+
+//===--------------------------------------------------------------------===//
+// Executor helpers
+//===--------------------------------------------------------------------===//
+
+// Scan the tuple with the given primary key
+static planner::IndexScanPlan *MakeKeyScan(storage::DataTable *table,
+                                           const std::vector<int> &key) {
+  std::vector<oid_t> column_ids(table->GetSchema()->GetColumnCount());
+  std::iota(column_ids.begin(), column_ids.end(), 0);
+
+  std::vector<oid_t> key_column_ids;
+  std::vector<ExpressionType> expr_types;
+  std::vector<Value> values;
+  std::vector<expression::AbstractExpression *> runtime_keys;
+
+  for (oid_t key_itr = 0; key_itr < key.size(); key_itr++) {
+    key_column_ids.push_back(key_itr);
+    expr_types.push_back(EXPRESSION_TYPE_COMPARE_EQUAL);
+    values.push_back(ValueFactory::GetIntegerValue(key[key_itr]));
+  }
+
+  planner::IndexScanPlan::IndexScanDesc index_scan_desc(
+      table->GetIndex(0), key_column_ids, expr_types, values, runtime_keys);
+
+  return new planner::IndexScanPlan(table, nullptr, column_ids,
+                                    index_scan_desc);
+}
+
+// Read the tuple with the given primary key
+// returns false if there is no visible tuple
+static bool ReadTuple(executor::ExecutorContext *context,
+                      storage::DataTable *table, const std::vector<int> &key,
+                      std::vector<int> &values) {
+  std::unique_ptr<planner::IndexScanPlan> scan_node(MakeKeyScan(table, key));
+  executor::IndexScanExecutor scan_executor(scan_node.get(), context);
+
+  if (scan_executor.Init() == false) return false;
+
+  bool found = false;
+  while (scan_executor.Execute()) {
+    std::unique_ptr<executor::LogicalTile> result_tile(
+        scan_executor.GetOutput());
+
+    for (oid_t tuple_id : *result_tile) {
+      if (found) break;
+      values.clear();
+      for (oid_t col_itr = 0; col_itr < result_tile->GetColumnCount();
+           col_itr++) {
+        values.push_back(
+            ValuePeeker::PeekAsInteger(result_tile->GetValue(tuple_id,
+                                                             col_itr)));
+      }
+      found = true;
+    }
+  }
+
+  return found;
+}
+
+// Overwrite some columns of the tuple with the given primary key
+// returns false on a conflict
+static bool UpdateTuple(executor::ExecutorContext *context,
+                        storage::DataTable *table,
+                        const std::vector<int> &key,
+                        const std::vector<std::pair<oid_t, int>> &updates) {
+  std::unique_ptr<planner::IndexScanPlan> scan_node(MakeKeyScan(table, key));
+  executor::IndexScanExecutor scan_executor(scan_node.get(), context);
+
+  planner::ProjectInfo::TargetList target_list;
+  planner::ProjectInfo::DirectMapList direct_map_list;
+  oid_t col_count = table->GetSchema()->GetColumnCount();
+
+  for (oid_t col_itr = 0; col_itr < col_count; col_itr++) {
+    auto update = std::find_if(updates.begin(), updates.end(),
+                               [col_itr](const std::pair<oid_t, int> &update) {
+                                 return update.first == col_itr;
+                               });
+
+    if (update != updates.end()) {
+      target_list.emplace_back(col_itr, expression::ConstantValueFactory(
+                                            ValueFactory::GetIntegerValue(
+                                                update->second)));
+    } else {
+      direct_map_list.emplace_back(col_itr,
+                                   std::pair<oid_t, oid_t>(0, col_itr));
+    }
+  }
+
+  planner::UpdatePlan update_node(
+      table, new planner::ProjectInfo(std::move(target_list),
+                                      std::move(direct_map_list)));
+
+  executor::UpdateExecutor update_executor(&update_node, context);
+  update_executor.AddChild(&scan_executor);
+
+  if (update_executor.Init() == false) return false;
+
+  update_executor.Execute();
+
+  return context->GetTransaction()->GetResult() == RESULT_SUCCESS;
+}
+
+// Insert a tuple
+// returns false if the key is taken
+static bool InsertTuple(executor::ExecutorContext *context,
+                        storage::DataTable *table,
+                        const std::vector<int> &values) {
+  planner::ProjectInfo::TargetList target_list;
+  planner::ProjectInfo::DirectMapList direct_map_list;
+
+  for (oid_t col_itr = 0; col_itr < values.size(); col_itr++) {
+    target_list.emplace_back(col_itr,
+                             expression::ConstantValueFactory(
+                                 ValueFactory::GetIntegerValue(values[col_itr])));
+  }
+
+  planner::InsertPlan insert_node(
+      table, new planner::ProjectInfo(std::move(target_list),
+                                      std::move(direct_map_list)));
+
+  executor::InsertExecutor insert_executor(&insert_node, context);
+
+  if (insert_executor.Init() == false) return false;
+
+  return insert_executor.Execute();
+}
+
+//===--------------------------------------------------------------------===//
+// Transactions
+//===--------------------------------------------------------------------===//
+
+// Non-uniform random number, as per the TPC-C spec (2.1.6)
+template <typename Generator>
+static int NURand(Generator &generator, int a, int x, int y) {
+  const int c = 42;
+  auto random = [&generator](int low, int high) {
+    return std::uniform_int_distribution<int>(low, high)(generator);
+  };
+
+  return (((random(0, a) | random(x, y)) + c) % (y - x + 1)) + x;
+}
+
+static bool RunNewOrder(executor::ExecutorContext *context,
+                        std::mt19937 &generator, int w_id) {
+  auto random = [&generator](int low, int high) {
+    return std::uniform_int_distribution<int>(low, high)(generator);
+  };
+
+  int d_id = random(0, DISTRICTS_PER_WAREHOUSE - 1);
+  int c_id = NURand(generator, 1023, 0, GetCustomerCount() - 1);
+  int ol_cnt = random(5, 15);
+  std::vector<int> warehouse, district, customer, item, stock;
+
+  if (ReadTuple(context, warehouse_table, {w_id}, warehouse) == false) {
+    return false;
+  }
+
+  // Take the next order id of the district
+  if (ReadTuple(context, district_table, {w_id, d_id}, district) == false) {
+    return false;
+  }
+  int o_id = district[4];
+  if (UpdateTuple(context, district_table, {w_id, d_id}, {{4, o_id + 1}}) ==
+      false) {
+    return false;
+  }
+
+  if (ReadTuple(context, customer_table, {w_id, d_id, c_id}, customer) ==
+      false) {
+    return false;
+  }
+
+  if (InsertTuple(context, orders_table, {w_id, d_id, o_id, c_id, ol_cnt}) ==
+          false ||
+      InsertTuple(context, new_order_table, {w_id, d_id, o_id}) == false) {
+    return false;
+  }
+
+  for (int ol_number = 0; ol_number < ol_cnt; ol_number++) {
+    int i_id = NURand(generator, 8191, 0, GetItemCount() - 1);
+    int ol_quantity = random(1, 10);
+
+    if (ReadTuple(context, item_table, {i_id}, item) == false) return false;
+
+    // Take the quantity from the stock
+    if (ReadTuple(context, stock_table, {w_id, i_id}, stock) == false) {
+      return false;
+    }
+    int s_quantity = stock[2] - ol_quantity;
+    if (s_quantity < 10) s_quantity += 91;
+    if (UpdateTuple(context, stock_table, {w_id, i_id},
+                    {{2, s_quantity},
+                     {3, stock[3] + ol_quantity},
+                     {4, stock[4] + 1}}) == false) {
+      return false;
+    }
+
+    // Price with the warehouse and district taxes and the discount
+    long amount = (long)ol_quantity * item[1];
+    amount = amount * (10000 + warehouse[1] + district[2]) / 10000 *
+             (10000 - customer[3]) / 10000;
+
+    if (InsertTuple(context, order_line_table,
+                    {w_id, d_id, o_id, ol_number, i_id, ol_quantity,
+                     (int)amount}) == false) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+static bool RunPayment(executor::ExecutorContext *context,
+                       std::mt19937 &generator, int w_id) {
+  auto random = [&generator](int low, int high) {
+    return std::uniform_int_distribution<int>(low, high)(generator);
+  };
+
+  int d_id = random(0, DISTRICTS_PER_WAREHOUSE - 1);
+  int c_id = NURand(generator, 1023, 0, GetCustomerCount() - 1);
+  int amount = random(100, 500000);
+  std::vector<int> warehouse, district, customer;
+
+  if (ReadTuple(context, warehouse_table, {w_id}, warehouse) == false ||
+      UpdateTuple(context, warehouse_table, {w_id},
+                  {{2, warehouse[2] + amount}}) == false) {
+    return false;
+  }
+
+  if (ReadTuple(context, district_table, {w_id, d_id}, district) == false ||
+      UpdateTuple(context, district_table, {w_id, d_id},
+                  {{3, district[3] + amount}}) == false) {
+    return false;
+  }
+
+  if (ReadTuple(context, customer_table, {w_id, d_id, c_id}, customer) ==
+          false ||
+      UpdateTuple(context, customer_table, {w_id, d_id, c_id},
+                  {{4, customer[4] - amount},
+                   {5, customer[5] + amount},
+                   {6, customer[6] + 1}}) == false) {
+    return false;
+  }
+
+  return InsertTuple(context, history_table, {w_id, d_id, c_id, amount});
+}
+
+// Run NewOrder and Payment transactions against the home warehouse
+static void RunBackend(int backend_id, BackendResult *result) {
+  auto &txn_manager = concurrency::TransactionManager::GetInstance();
+  int w_id = backend_id % state.warehouse_count;
+
+  std::mt19937 generator(backend_id);
+  std::bernoulli_distribution new_order_distribution(state.new_order_ratio);
+
+  for (unsigned long txn_itr = 0; txn_itr < state.transactions; txn_itr++) {
+    auto txn_type = new_order_distribution(generator)
+                        ? TRANSACTION_TYPE_NEW_ORDER
+                        : TRANSACTION_TYPE_PAYMENT;
+
+    auto start = std::chrono::steady_clock::now();
+
+    auto txn = txn_manager.BeginTransaction();
+    std::unique_ptr<executor::ExecutorContext> context(
+        new executor::ExecutorContext(txn));
+
+    bool status;
+    if (txn_type == TRANSACTION_TYPE_NEW_ORDER) {
+      status = RunNewOrder(context.get(), generator, w_id);
+    } else {
+      status = RunPayment(context.get(), generator, w_id);
+    }
+
+    if (status == false) {
+      txn_manager.AbortTransaction();
+      result->aborted[txn_type]++;
+      continue;
+    }
+
+    if (txn_manager.CommitTransaction() != RESULT_SUCCESS) {
+      result->aborted[txn_type]++;
+      continue;
+    }
+
+    auto end = std::chrono::steady_clock::now();
+    result->latencies[txn_type].push_back(
+        std::chrono::duration<double, std::micro>(end - start).count());
+    result->committed[txn_type]++;
+  }
+}
+
+void RunWorkload() {
+  std::vector<BackendResult> results(state.backend_count);
+  std::vector<std::thread> backends;
+
+  auto start = std::chrono::steady_clock::now();
+
+  for (int backend_itr = 0; backend_itr < state.backend_count; backend_itr++) {
+    backends.push_back(
+        std::thread(RunBackend, backend_itr, &results[backend_itr]));
+  }
+
+  for (auto &backend : backends) backend.join();
+
+  auto end = std::chrono::steady_clock::now();
+  double duration = std::chrono::duration<double>(end - start).count();
+
+  unsigned long total_committed = 0, total_aborted = 0;
+
+  for (int txn_type = 0; txn_type < TRANSACTION_TYPE_COUNT; txn_type++) {
+    unsigned long committed = 0, aborted = 0;
+    std::vector<double> latencies;
+    for (auto &result : results) {
+      committed += result.committed[txn_type];
+      aborted += result.aborted[txn_type];
+      latencies.insert(latencies.end(), result.latencies[txn_type].begin(),
+                       result.latencies[txn_type].end());
+    }
+
+    std::sort(latencies.begin(), latencies.end());
+    auto percentile = [&latencies](double fraction) {
+      if (latencies.empty()) return 0.0;
+      return latencies[(size_t)(fraction * (latencies.size() - 1))];
+    };
+
+    std::cout << transaction_names[txn_type] << std::endl;
+    std::cout << std::setw(20) << std::left << "  throughput "
+              << " : " << committed / duration << " txn/s" << std::endl;
+    std::cout << std::setw(20) << std::left << "  abort_rate "
+              << " : " << (double)aborted / std::max(committed + aborted, 1ul)
+              << std::endl;
+    std::cout << std::setw(20) << std::left << "  latency (us) "
+              << " : p50 " << percentile(0.5) << " p95 " << percentile(0.95)
+              << " p99 " << percentile(0.99) << std::endl;
+
+    total_committed += committed;
+    total_aborted += aborted;
+  }
+
+  std::cout << std::setw(20) << std::left << "throughput "
+            << " : " << total_committed / duration << " txn/s" << std::endl;
+  std::cout << std::setw(20) << std::left << "abort_rate "
+            << " : " << (double)total_aborted / (total_committed + total_aborted)
+            << std::endl;
+}
+
+}  // namespace tpcc
+}  // namespace benchmark
+}  // namespace peloton
@@ -0,0 +1,210 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// configuration.cpp
+//
+// Identification: benchmark/ycsb/configuration.cpp
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <iomanip>
+#include <algorithm>
+
+#include "backend/benchmark/ycsb/configuration.h"
+
+namespace peloton {
+namespace benchmark {
+namespace ycsb {
+
+void Usage(FILE *out) {
+  fprintf(out,
+          "Command line options : ycsb <options> \n"
+          "   -h --help              :  Print help message \n"
+          "   -k --scale-factor      :  # of tuples (x 1000) \n"
+          "   -c --column_count      :  # of value columns \n"
+          "   -b --backend-count     :  # of backends \n"
+          "   -t --transactions      :  # of transactions per backend \n"
+          "   -o --operation-count   :  # of tuples accessed per txn \n"
+          "   -u --update_ratio      :  Fraction of updates \n"
+          "   -z --zipf_theta        :  Skew of the keys (0 = uniform) \n"
+          "   -i --index             :  Index type (BTREE, BWTREE) \n"
+          "   -e --concurrency       :  Concurrency control (MVCC, OCC) \n");
+  exit(EXIT_FAILURE);
+}
+
+static struct option opts[] = {
+    {"scale-factor", optional_argument, NULL, 'k'},
+    {"column_count", optional_argument, NULL, 'c'},
+    {"backend-count", optional_argument, NULL, 'b'},
+    {"transactions", optional_argument, NULL, 't'},
+    {"operation-count", optional_argument, NULL, 'o'},
+    {"update_ratio", optional_argument, NULL, 'u'},
+    {"zipf_theta", optional_argument, NULL, 'z'},
+    {"index", optional_argument, NULL, 'i'},
+    {"concurrency", optional_argument, NULL, 'e'},
+    {NULL, 0, NULL, 0}};
+
+static void ValidateScaleFactor(const configuration &state) {
+  if (state.scale_factor <= 0) {
+    std::cout << "Invalid scalefactor :: " << state.scale_factor << std::endl;
+    exit(EXIT_FAILURE);
+  }
+
+  std::cout << std::setw(20) << std::left << "scale_factor "
+            << " : " << state.scale_factor << std::endl;
+}
+
+static void ValidateColumnCount(const configuration &state) {
+  if (state.column_count <= 0) {
+    std::cout << "Invalid column_count :: " << state.column_count
+              << std::endl;
+    exit(EXIT_FAILURE);
+  }
+
+  std::cout << std::setw(20) << std::left << "column_count "
+            << " : " << state.column_count << std::endl;
+}
+
+static void ValidateBackendCount(const configuration &state) {
+  if (state.backend_count <= 0) {
+    std::cout << "Invalid backend_count :: " << state.backend_count
+              << std::endl;
+    exit(EXIT_FAILURE);
+  }
+
+  std::cout << std::setw(20) << std::left << "backend_count "
+            << " : " << state.backend_count << std::endl;
+}
+
+static void ValidateOperationCount(const configuration &state) {
+  if (state.operation_count <= 0) {
+    std::cout << "Invalid operation_count :: " << state.operation_count
+              << std::endl;
+    exit(EXIT_FAILURE);
+  }
+
+  std::cout << std::setw(20) << std::left << "operation_count "
+            << " : " << state.operation_count << std::endl;
+}
+
+static void ValidateUpdateRatio(const configuration &state) {
+  if (state.update_ratio < 0 || state.update_ratio > 1) {
+    std::cout << "Invalid update_ratio :: " << state.update_ratio
+              << std::endl;
+    exit(EXIT_FAILURE);
+  }
+
+  std::cout << std::setw(20) << std::left << "update_ratio "
+            << " : " << state.update_ratio << std::endl;
+}
+
+static void ValidateZipfTheta(const configuration &state) {
+  if (state.zipf_theta < 0 || state.zipf_theta >= 1) {
+    std::cout << "Invalid zipf_theta :: " << state.zipf_theta << std::endl;
+    exit(EXIT_FAILURE);
+  }
+
+  std::cout << std::setw(20) << std::left << "zipf_theta "
+            << " : " << state.zipf_theta << std::endl;
+}
+
+static void ValidateIndexType(const configuration &state) {
+  if (state.index_type == INDEX_TYPE_INVALID) {
+    std::cout << "Invalid index_type" << std::endl;
+    exit(EXIT_FAILURE);
+  }
+
+  std::cout << std::setw(20) << std::left << "index_type "
+            << " : " << IndexTypeToString(state.index_type) << std::endl;
+}
+
+static void ValidateConcurrencyType(const configuration &state) {
+  if (state.concurrency_type == CONCURRENCY_TYPE_INVALID) {
+    std::cout << "Invalid concurrency_type" << std::endl;
+    exit(EXIT_FAILURE);
+  }
+
+  std::cout << std::setw(20) << std::left << "concurrency_type "
+            << " : " << ConcurrencyTypeToString(state.concurrency_type)
+            << std::endl;
+}
+
+void ParseArguments(int argc, char *argv[], configuration &state) {
+  // Default Values
+  state.scale_factor = 10;
+  state.column_count = 10;
+
+  state.backend_count = 4;
+  state.transactions = 10000;
+  state.operation_count = 10;
+  state.update_ratio = 0.5;
+  state.zipf_theta = 0;
+
+  state.index_type = INDEX_TYPE_BTREE;
+  state.concurrency_type = CONCURRENCY_TYPE_MVCC;
+
+  // Parse args
+  while (1) {
+    int idx = 0;
+    int c = getopt_long(argc, argv, "hk:c:b:t:o:u:z:i:e:", opts, &idx);
+
+    if (c == -1) break;
+
+    switch (c) {
+      case 'k':
+        state.scale_factor = atoi(optarg);
+        break;
+      case 'c':
+        state.column_count = atoi(optarg);
+        break;
+      case 'b':
+        state.backend_count = atoi(optarg);
+        break;
+      case 't':
+        state.transactions = atoi(optarg);
+        break;
+      case 'o':
+        state.operation_count = atoi(optarg);
+        break;
+      case 'u':
+        state.update_ratio = atof(optarg);
+        break;
+      case 'z':
+        state.zipf_theta = atof(optarg);
+        break;
+      case 'i':
+        state.index_type = StringToIndexType(optarg);
+        break;
+      case 'e':
+        state.concurrency_type = StringToConcurrencyType(optarg);
+        break;
+      case 'h':
+        Usage(stderr);
+        break;
+
+      default:
+        fprintf(stderr, "\nUnknown option: -%c-\n", c);
+        Usage(stderr);
+    }
+  }
+
+  // Print configuration
+  ValidateScaleFactor(state);
+  ValidateColumnCount(state);
+  ValidateBackendCount(state);
+  ValidateOperationCount(state);
+  ValidateUpdateRatio(state);
+  ValidateZipfTheta(state);
+  ValidateIndexType(state);
+  ValidateConcurrencyType(state);
+
+  std::cout << std::setw(20) << std::left << "transactions "
+            << " : " << state.transactions << std::endl;
+}
+
+}  // namespace ycsb
+}  // namespace benchmark
+}  // namespace peloton
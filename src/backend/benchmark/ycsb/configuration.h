@@ -0,0 +1,63 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// configuration.h
+//
+// Identification: benchmark/ycsb/configuration.h
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <string>
+#include <getopt.h>
+#include <vector>
+#include <sys/time.h>
+#include <iostream>
+
+#include "backend/storage/data_table.h"
+
+namespace peloton {
+namespace benchmark {
+namespace ycsb {
+
+class configuration {
+ public:
+  // size of the table (x 1000 tuples)
+  int scale_factor;
+
+  // # of value columns
+  int column_count;
+
+  // # of concurrent backends
+  int backend_count;
+
+  // # of transactions per backend
+  unsigned long transactions;
+
+  // # of tuples accessed per transaction
+  int operation_count;
+
+  // fraction of the accesses that are updates
+  double update_ratio;
+
+  // zipfian skew of the accessed keys (0 = uniform)
+  double zipf_theta;
+
+  // primary key index
+  IndexType index_type;
+
+  // concurrency control
+  ConcurrencyType concurrency_type;
+};
+
+void Usage(FILE *out);
+
+void ParseArguments(int argc, char *argv[], configuration &state);
+
+}  // namespace ycsb
+}  // namespace benchmark
+}  // namespace peloton
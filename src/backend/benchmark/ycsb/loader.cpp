@@ -0,0 +1,123 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// loader.cpp
+//
+// Identification: benchmark/ycsb/loader.cpp
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <iostream>
+#include <cassert>
+
+#include "backend/benchmark/ycsb/loader.h"
+#include "backend/catalog/schema.h"
+#include "backend/common/value_factory.h"
+#include "backend/concurrency/transaction.h"
+#include "backend/concurrency/transaction_manager.h"
+#include "backend/index/index_factory.h"
+#include "backend/storage/tuple.h"
+#include "backend/storage/data_table.h"
+#include "backend/storage/table_factory.h"
+
+namespace peloton {
+namespace benchmark {
+namespace ycsb {
+
+storage::DataTable *user_table;
+
+void CreateTable() {
+  const oid_t col_count = state.column_count + 1;
+  const bool is_inlined = true;
+
+  // Create schema first
+  std::vector<catalog::Column> columns;
+
+  for (oid_t col_itr = 0; col_itr < col_count; col_itr++) {
+    auto column =
+        catalog::Column(VALUE_TYPE_INTEGER, GetTypeSize(VALUE_TYPE_INTEGER),
+                        "" + std::to_string(col_itr), is_inlined);
+
+    columns.push_back(column);
+  }
+
+  catalog::Schema *table_schema = new catalog::Schema(columns);
+  std::string table_name("USERTABLE");
+
+  /////////////////////////////////////////////////////////
+  // Create table.
+  /////////////////////////////////////////////////////////
+
+  // Clean up
+  delete user_table;
+
+  bool own_schema = true;
+  bool adapt_table = false;
+  user_table = storage::TableFactory::GetDataTable(
+      INVALID_OID, INVALID_OID, table_schema, table_name,
+      DEFAULT_TUPLES_PER_TILEGROUP, own_schema, adapt_table);
+
+  // PRIMARY INDEX
+  std::vector<oid_t> key_attrs = {0};
+  auto tuple_schema = user_table->GetSchema();
+  catalog::Schema *key_schema =
+      catalog::Schema::CopySchema(tuple_schema, key_attrs);
+  key_schema->SetIndexedColumns(key_attrs);
+
+  bool unique = true;
+
+  index::IndexMetadata *index_metadata = new index::IndexMetadata(
+      "primary_index", 123, state.index_type,
+      INDEX_CONSTRAINT_TYPE_PRIMARY_KEY, tuple_schema, key_schema, unique);
+
+  index::Index *pkey_index = index::IndexFactory::GetInstance(index_metadata);
+  user_table->AddIndex(pkey_index);
+}
+
+void LoadTable() {
+  const oid_t col_count = state.column_count + 1;
+  const int tuple_count = state.scale_factor * 1000;
+
+  auto table_schema = user_table->GetSchema();
+
+  /////////////////////////////////////////////////////////
+  // Load in the data
+  /////////////////////////////////////////////////////////
+
+  auto &txn_manager = concurrency::TransactionManager::GetInstance();
+  const bool allocate = true;
+  auto txn = txn_manager.BeginTransaction();
+  std::unique_ptr<VarlenPool> pool(new VarlenPool(BACKEND_TYPE_MM));
+
+  for (int rowid = 0; rowid < tuple_count; rowid++) {
+    storage::Tuple tuple(table_schema, allocate);
+
+    for (oid_t col_itr = 0; col_itr < col_count; col_itr++) {
+      auto value = ValueFactory::GetIntegerValue(rowid);
+      tuple.SetValue(col_itr, value, pool.get());
+    }
+
+    ItemPointer tuple_slot_id = user_table->InsertTuple(txn, &tuple);
+    assert(tuple_slot_id.block != INVALID_OID);
+    assert(tuple_slot_id.offset != INVALID_OID);
+    txn->RecordInsert(tuple_slot_id);
+  }
+
+  txn_manager.CommitTransaction();
+}
+
+void CreateAndLoadTable() {
+  CreateTable();
+
+  LoadTable();
+}
+
+}  // namespace ycsb
+}  // namespace benchmark
+}  // namespace peloton
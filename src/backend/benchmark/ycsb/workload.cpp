@@ -0,0 +1,245 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// workload.cpp
+//
+// Identification: benchmark/ycsb/workload.cpp
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <thread>
+#include <algorithm>
+#include <numeric>
+
+#include "backend/benchmark/ycsb/workload.h"
+#include "backend/benchmark/ycsb/loader.h"
+#include "backend/common/value_factory.h"
+#include "backend/concurrency/transaction.h"
+#include "backend/concurrency/transaction_manager.h"
+#include "backend/executor/executor_context.h"
+#include "backend/executor/index_scan_executor.h"
+#include "backend/executor/logical_tile.h"
+#include "backend/executor/update_executor.h"
+#include "backend/expression/expression_util.h"
+#include "backend/planner/index_scan_plan.h"
+#include "backend/planner/project_info.h"
+#include "backend/planner/update_plan.h"
+#include "backend/storage/data_table.h"
+
+namespace peloton {
+namespace benchmark {
+namespace ycsb {
+
+/**
+ * Zipfian key generator, as in YCSB (Gray et al, "Quickly generating
+ * billion-record synthetic databases"). Key 0 is the hottest.
+ */
+class ZipfDistribution {
+ public:
+  ZipfDistribution(uint64_t n, double theta) : n(n), theta(theta) {
+    double zeta_2 = Zeta(2);
+    zeta_n = Zeta(n);
+    alpha = 1.0 / (1.0 - theta);
+    eta = (1 - std::pow(2.0 / n, 1 - theta)) / (1 - zeta_2 / zeta_n);
+  }
+
+  template <typename Generator>
+  uint64_t operator()(Generator &generator) {
+    double u = std::uniform_real_distribution<double>(0, 1)(generator);
+    double uz = u * zeta_n;
+
+    if (uz < 1) return 0;
+    if (uz < 1 + std::pow(0.5, theta)) return 1;
+
+    uint64_t key = n * std::pow(eta * u - eta + 1, alpha);
+    return std::min(key, n - 1);
+  }
+
+ private:
+  double Zeta(uint64_t count) const {
+    double sum = 0;
+    for (uint64_t i = 1; i <= count; i++) sum += 1.0 / std::pow(i, theta);
+    return sum;
+  }
+
+  uint64_t n;
+
+  double theta;
+
+  double zeta_n;
+
+  double alpha;
+
+  double eta;
+};
+
+struct BackendResult {
+  unsigned long committed = 0;
+
+  unsigned long aborted = 0;
+
+  // latency of the committed transactions (us)
+  std::vector<double> latencies;
+};
+
+static planner::IndexScanPlan *MakeKeyScan(int key) {
+  std::vector<oid_t> column_ids(state.column_count + 1);
+  std::iota(column_ids.begin(), column_ids.end(), 0);
+
+  std::vector<oid_t> key_column_ids = {0};
+  std::vector<ExpressionType> expr_types = {EXPRESSION_TYPE_COMPARE_EQUAL};
+  std::vector<Value> values = {ValueFactory::GetIntegerValue(key)};
+  std::vector<expression::AbstractExpression *> runtime_keys;
+
+  planner::IndexScanPlan::IndexScanDesc index_scan_desc(
+      user_table->GetIndex(0), key_column_ids, expr_types, values,
+      runtime_keys);
+
+  return new planner::IndexScanPlan(user_table, nullptr, column_ids,
+                                    index_scan_desc);
+}
+
+static bool RunRead(executor::ExecutorContext *context, int key) {
+  std::unique_ptr<planner::IndexScanPlan> scan_node(MakeKeyScan(key));
+  executor::IndexScanExecutor scan_executor(scan_node.get(), context);
+
+  if (scan_executor.Init() == false) return false;
+
+  while (scan_executor.Execute()) {
+    std::unique_ptr<executor::LogicalTile> result_tile(
+        scan_executor.GetOutput());
+  }
+
+  return true;
+}
+
+static bool RunUpdate(executor::ExecutorContext *context, int key, int value) {
+  std::unique_ptr<planner::IndexScanPlan> scan_node(MakeKeyScan(key));
+  executor::IndexScanExecutor scan_executor(scan_node.get(), context);
+
+  // Set the first value column, and keep the rest
+  planner::ProjectInfo::TargetList target_list;
+  planner::ProjectInfo::DirectMapList direct_map_list;
+  target_list.emplace_back(
+      1, expression::ConstantValueFactory(ValueFactory::GetIntegerValue(value)));
+  for (oid_t col_itr = 0; col_itr <= (oid_t)state.column_count; col_itr++) {
+    if (col_itr == 1) continue;
+    direct_map_list.emplace_back(col_itr,
+                                 std::pair<oid_t, oid_t>(0, col_itr));
+  }
+
+  planner::UpdatePlan update_node(
+      user_table, new planner::ProjectInfo(std::move(target_list),
+                                           std::move(direct_map_list)));
+
+  executor::UpdateExecutor update_executor(&update_node, context);
+  update_executor.AddChild(&scan_executor);
+
+  if (update_executor.Init() == false) return false;
+
+  update_executor.Execute();
+
+  return context->GetTransaction()->GetResult() == RESULT_SUCCESS;
+}
+
+// Read or update operation_count keys in every transaction
+static void RunBackend(int backend_id, BackendResult *result) {
+  auto &txn_manager = concurrency::TransactionManager::GetInstance();
+  const uint64_t tuple_count = state.scale_factor * 1000;
+
+  std::mt19937 generator(backend_id);
+  ZipfDistribution key_distribution(tuple_count, state.zipf_theta);
+  std::bernoulli_distribution update_distribution(state.update_ratio);
+
+  result->latencies.reserve(state.transactions);
+
+  for (unsigned long txn_itr = 0; txn_itr < state.transactions; txn_itr++) {
+    auto start = std::chrono::steady_clock::now();
+
+    auto txn = txn_manager.BeginTransaction();
+    std::unique_ptr<executor::ExecutorContext> context(
+        new executor::ExecutorContext(txn));
+    bool status = true;
+
+    for (int op_itr = 0; op_itr < state.operation_count && status; op_itr++) {
+      int key = key_distribution(generator);
+
+      if (update_distribution(generator)) {
+        status = RunUpdate(context.get(), key, txn_itr);
+      } else {
+        status = RunRead(context.get(), key);
+      }
+    }
+
+    if (status == false) {
+      txn_manager.AbortTransaction();
+      result->aborted++;
+      continue;
+    }
+
+    if (txn_manager.CommitTransaction() != RESULT_SUCCESS) {
+      result->aborted++;
+      continue;
+    }
+
+    auto end = std::chrono::steady_clock::now();
+    result->latencies.push_back(
+        std::chrono::duration<double, std::micro>(end - start).count());
+    result->committed++;
+  }
+}
+
+void RunWorkload() {
+  std::vector<BackendResult> results(state.backend_count);
+  std::vector<std::thread> backends;
+
+  auto start = std::chrono::steady_clock::now();
+
+  for (int backend_itr = 0; backend_itr < state.backend_count; backend_itr++) {
+    backends.push_back(
+        std::thread(RunBackend, backend_itr, &results[backend_itr]));
+  }
+
+  for (auto &backend : backends) backend.join();
+
+  auto end = std::chrono::steady_clock::now();
+  double duration = std::chrono::duration<double>(end - start).count();
+
+  unsigned long committed = 0, aborted = 0;
+  std::vector<double> latencies;
+  for (auto &result : results) {
+    committed += result.committed;
+    aborted += result.aborted;
+    latencies.insert(latencies.end(), result.latencies.begin(),
+                     result.latencies.end());
+  }
+
+  std::sort(latencies.begin(), latencies.end());
+  auto percentile = [&latencies](double fraction) {
+    if (latencies.empty()) return 0.0;
+    return latencies[(size_t)(fraction * (latencies.size() - 1))];
+  };
+
+  std::cout << std::setw(20) << std::left << "throughput "
+            << " : " << committed / duration << " txn/s" << std::endl;
+  std::cout << std::setw(20) << std::left << "abort_rate "
+            << " : " << (double)aborted / (committed + aborted) << std::endl;
+  std::cout << std::setw(20) << std::left << "latency (us) "
+            << " : p50 " << percentile(0.5) << " p95 " << percentile(0.95)
+            << " p99 " << percentile(0.99) << std::endl;
+}
+
+}  // namespace ycsb
+}  // namespace benchmark
+}  // namespace peloton
@@ -0,0 +1,49 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// ycsb.cpp
+//
+// Identification: benchmark/ycsb/ycsb.cpp
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <iostream>
+#include <fstream>
+
+#include "backend/benchmark/ycsb/ycsb.h"
+#include "backend/benchmark/ycsb/configuration.h"
+#include "backend/benchmark/ycsb/loader.h"
+#include "backend/benchmark/ycsb/workload.h"
+#include "backend/concurrency/transaction_manager.h"
+
+namespace peloton {
+namespace benchmark {
+namespace ycsb {
+
+configuration state;
+
+// Main Entry Point
+void RunBenchmark() {
+  auto &txn_manager = concurrency::TransactionManager::GetInstance();
+  txn_manager.SetConcurrencyType(state.concurrency_type);
+
+  CreateAndLoadTable();
+
+  RunWorkload();
+}
+
+}  // namespace ycsb
+}  // namespace benchmark
+}  // namespace peloton
+
+int main(int argc, char **argv) {
+  peloton::benchmark::ycsb::ParseArguments(argc, argv,
+                                           peloton::benchmark::ycsb::state);
+
+  peloton::benchmark::ycsb::RunBenchmark();
+
+  return 0;
+}
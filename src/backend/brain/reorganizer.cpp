@@ -0,0 +1,33 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// reorganizer.cpp
+//
+// Identification: src/backend/brain/reorganizer.cpp
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "backend/brain/reorganizer.h"
+#include "backend/storage/database.h"
+
+namespace peloton {
+namespace brain {
+
+Reorganizer::Reorganizer(storage::Database *database,
+                         std::chrono::milliseconds interval, double theta)
+    : database(database),
+      theta(theta),
+      worker("Reorganizer for database " + std::to_string(database->GetOid()),
+             interval, [this] { Reorganize(); }) {}
+
+Reorganizer::~Reorganizer() { Stop(); }
+
+oid_t Reorganizer::Reorganize() {
+  return database->ReorganizeTables(theta);
+}
+
+}  // End brain namespace
+}  // End peloton namespace
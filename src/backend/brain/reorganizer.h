@@ -0,0 +1,85 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// reorganizer.h
+//
+// Identification: src/backend/brain/reorganizer.h
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <chrono>
+
+#include "backend/common/background_worker.h"
+#include "backend/common/types.h"
+
+namespace peloton {
+
+namespace storage {
+class Database;
+}
+
+namespace brain {
+
+// Time between two reorganization passes
+#define REORGANIZER_INTERVAL_MS 1000
+
+// Min fraction of columns that must move to transform a tile group
+#define REORGANIZER_THETA 0.1
+
+//===--------------------------------------------------------------------===//
+// Reorganizer
+//===--------------------------------------------------------------------===//
+
+/**
+ * Background thread that adapts the layout of the tables in a database.
+ *
+ * Every pass, each adaptive table folds its recent samples into the clusterer
+ * to find the dominant partition and then transforms its cold tile groups to
+ * that partition. Transformed tile groups are swapped in via the catalog
+ * locator, so concurrent scans are never blocked.
+ */
+class Reorganizer {
+  Reorganizer(Reorganizer const &) = delete;
+
+ public:
+  Reorganizer(storage::Database *database,
+              std::chrono::milliseconds interval =
+                  std::chrono::milliseconds(REORGANIZER_INTERVAL_MS),
+              double theta = REORGANIZER_THETA);
+
+  ~Reorganizer();
+
+  // start the background thread
+  void Start() { worker.Start(); }
+
+  // stop the background thread and wait for it to finish
+  void Stop() { worker.Stop(); }
+
+  bool IsRunning() const { return worker.IsRunning(); }
+
+  // do a single pass over the database
+  // returns the number of transformed tile groups
+  oid_t Reorganize();
+
+ private:
+  //===--------------------------------------------------------------------===//
+  // MEMBERS
+  //===--------------------------------------------------------------------===//
+
+  // database being reorganized
+  storage::Database *database;
+
+  // transformation threshold
+  double theta;
+
+  // background thread
+  BackgroundWorker worker;
+};
+
+}  // End brain namespace
+}  // End peloton namespace
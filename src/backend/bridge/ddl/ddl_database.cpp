@@ -19,6 +19,13 @@
 #include "nodes/parsenodes.h"
 #include "commands/dbcommands.h"
 
+//===--------------------------------------------------------------------===//
+// GUC Variables
+//===--------------------------------------------------------------------===//
+
+// Compress the cold tile groups
+extern bool peloton_compression;
+
 namespace peloton {
 namespace bridge {
 
@@ -93,6 +100,19 @@ bool DDLDatabase::CreateDatabase(oid_t database_oid) {
   if (database == nullptr) {
     storage::Database *db = new storage::Database(database_oid);
     manager.AddDatabase(db);
+
+    // Adapt the layout of the tables in the background
+    if (peloton_layout_mode == LAYOUT_HYBRID) {
+      db->StartReorganizer();
+    }
+
+    // Compress the cold tile groups in the background
+    if (peloton_compression == true) {
+      db->StartFreezer();
+    }
+
+    // Reclaim the obsolete tuple versions in the background
+    db->StartGarbageCollector();
   } else {
     LOG_TRACE("Database(%lu) already exists", database_oid);
     return false;
@@ -37,6 +37,8 @@ executor::AbstractExecutor *BuildExecutorTree(
 
 void CleanExecutorTree(executor::AbstractExecutor *root);
 
+bool IsReadOnlyPlan(const planner::AbstractPlan *plan);
+
 /**
  * @brief Build a executor tree and execute it.
  * @return status of execution.
@@ -60,7 +62,13 @@ peloton_status PlanExecutor::ExecutePlan(const planner::AbstractPlan *plan,
   // This happens for single statement queries in PG
   if (txn == nullptr) {
     single_statement_txn = true;
-    txn = txn_manager.BeginTransaction();
+
+    // Queries that do not modify anything skip the commit machinery
+    if (IsReadOnlyPlan(plan)) {
+      txn = txn_manager.BeginReadOnlyTransaction();
+    } else {
+      txn = txn_manager.BeginTransaction();
+    }
   }
   assert(txn);
 
@@ -174,6 +182,29 @@ void PlanExecutor::PrintPlan(const planner::AbstractPlan *plan,
   }
 }
 
+/**
+ * @brief Check whether the plan tree has any modifying plan node.
+ * @param The plan tree
+ * @return true if the plan only reads.
+ */
+bool IsReadOnlyPlan(const planner::AbstractPlan *plan) {
+  switch (plan->GetPlanNodeType()) {
+    case PLAN_NODE_TYPE_UPDATE:
+    case PLAN_NODE_TYPE_INSERT:
+    case PLAN_NODE_TYPE_DELETE:
+      return false;
+
+    default:
+      break;
+  }
+
+  for (auto child : plan->GetChildren()) {
+    if (IsReadOnlyPlan(child) == false) return false;
+  }
+
+  return true;
+}
+
 /**
  * @brief Build Executor Context
  */
@@ -0,0 +1,66 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// background_worker.cpp
+//
+// Identification: src/backend/common/background_worker.cpp
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "backend/common/background_worker.h"
+#include "backend/common/logger.h"
+
+namespace peloton {
+
+BackgroundWorker::BackgroundWorker(const std::string &name,
+                                   std::chrono::milliseconds interval,
+                                   std::function<void()> pass)
+    : name(name), interval(interval), pass(pass) {}
+
+BackgroundWorker::~BackgroundWorker() { Stop(); }
+
+void BackgroundWorker::Start() {
+  {
+    std::lock_guard<std::mutex> lock(worker_mutex);
+    if (running == true) return;
+    running = true;
+  }
+
+  worker_thread = std::thread(&BackgroundWorker::Run, this);
+}
+
+void BackgroundWorker::Stop() {
+  {
+    std::lock_guard<std::mutex> lock(worker_mutex);
+    if (running == false) return;
+    running = false;
+  }
+
+  // Wake up the background thread
+  worker_cv.notify_all();
+
+  if (worker_thread.joinable()) worker_thread.join();
+}
+
+void BackgroundWorker::Run() {
+  LOG_INFO("%s started", name.c_str());
+
+  std::unique_lock<std::mutex> lock(worker_mutex);
+
+  while (running == true) {
+    // Sleep till the next pass or till we are stopped
+    worker_cv.wait_for(lock, interval);
+    if (running == false) break;
+
+    lock.unlock();
+    pass();
+    lock.lock();
+  }
+
+  LOG_INFO("%s stopped", name.c_str());
+}
+
+}  // End peloton namespace
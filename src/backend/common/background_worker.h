@@ -0,0 +1,81 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// background_worker.h
+//
+// Identification: src/backend/common/background_worker.h
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace peloton {
+
+//===--------------------------------------------------------------------===//
+// Background Worker
+//===--------------------------------------------------------------------===//
+
+/**
+ * Background thread that runs a pass periodically.
+ *
+ * The thread sleeps for the interval between two passes, and wakes up
+ * right away when it is stopped. A running pass is never interrupted.
+ */
+class BackgroundWorker {
+  BackgroundWorker(BackgroundWorker const &) = delete;
+
+ public:
+  BackgroundWorker(const std::string &name, std::chrono::milliseconds interval,
+                   std::function<void()> pass);
+
+  ~BackgroundWorker();
+
+  // start the background thread
+  void Start();
+
+  // stop the background thread and wait for it to finish
+  void Stop();
+
+  bool IsRunning() const { return running; }
+
+ private:
+  // main loop of the background thread
+  void Run();
+
+  //===--------------------------------------------------------------------===//
+  // MEMBERS
+  //===--------------------------------------------------------------------===//
+
+  // name used in the log
+  std::string name;
+
+  // time between two passes
+  std::chrono::milliseconds interval;
+
+  // work done in every pass
+  std::function<void()> pass;
+
+  // background thread
+  std::thread worker_thread;
+
+  // is the background thread running ?
+  std::atomic<bool> running = ATOMIC_VAR_INIT(false);
+
+  // synch helpers
+  std::mutex worker_mutex;
+
+  std::condition_variable worker_cv;
+};
+
+}  // End peloton namespace
@@ -0,0 +1,191 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// huge_page_allocator.cpp
+//
+// Identification: src/backend/common/huge_page_allocator.cpp
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "backend/common/huge_page_allocator.h"
+#include "backend/common/logger.h"
+
+#include <sys/mman.h>
+
+#include <cstdint>
+#include <fstream>
+#include <new>
+#include <string>
+
+//===--------------------------------------------------------------------===//
+// GUC Variables
+//===--------------------------------------------------------------------===//
+
+// Back in-memory data with huge pages
+extern bool peloton_huge_pages;
+
+namespace peloton {
+
+#define THP_ENABLED_FILE "/sys/kernel/mm/transparent_hugepage/enabled"
+
+// Round the size up to a multiple of the given alignment
+static size_t AlignSize(size_t size, size_t alignment) {
+  return ((size + alignment - 1) / alignment) * alignment;
+}
+
+// Get the chunk address of an address in a chunk
+static char *GetChunkAddress(void *address) {
+  uintptr_t location = reinterpret_cast<uintptr_t>(address);
+  return reinterpret_cast<char *>(location & ~(uintptr_t)(HUGE_PAGE_SIZE - 1));
+}
+
+HugePageAllocator &HugePageAllocator::GetInstance(void) {
+  static HugePageAllocator huge_page_allocator;
+  return huge_page_allocator;
+}
+
+HugePageAllocator::HugePageAllocator()
+    : enabled(peloton_huge_pages),
+      transparent_huge_pages(false),
+      chunk_count(0),
+      arena(nullptr),
+      allocation_count(0),
+      huge_page_allocation_count(0) {
+  // The selected mode is in brackets, e.g. "always [madvise] never"
+  std::ifstream thp_file(THP_ENABLED_FILE);
+  std::string thp_mode;
+  if (thp_file.good()) std::getline(thp_file, thp_mode);
+  transparent_huge_pages = (thp_mode.empty() == false &&
+                            thp_mode.find("[never]") == std::string::npos);
+}
+
+HugePageAllocator::~HugePageAllocator() {
+  if (allocation_count > 0) {
+    LOG_INFO("Huge pages :: %lu of %lu allocations",
+             huge_page_allocation_count.load(), allocation_count.load());
+  }
+
+  // Memory that is still in use is left to the OS
+}
+
+char *HugePageAllocator::MapChunk(size_t length, bool &huge_pages) {
+  // Try the reserved huge pages first, these are always 2MB aligned
+  void *address = mmap(nullptr, length, PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+  if (address != MAP_FAILED) {
+    huge_pages = true;
+    return reinterpret_cast<char *>(address);
+  }
+
+  // Otherwise, map a larger range and trim it to a 2MB boundary, so that
+  // the kernel can back it with transparent huge pages
+  size_t mapped_length = length + HUGE_PAGE_SIZE;
+  address = mmap(nullptr, mapped_length, PROT_READ | PROT_WRITE,
+                 MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (address == MAP_FAILED) return nullptr;
+
+  char *mapped_start = reinterpret_cast<char *>(address);
+  char *start = GetChunkAddress(mapped_start + HUGE_PAGE_SIZE - 1);
+  char *mapped_end = mapped_start + mapped_length;
+
+  if (start > mapped_start) munmap(mapped_start, start - mapped_start);
+  if (mapped_end > start + length) {
+    munmap(start + length, mapped_end - (start + length));
+  }
+
+  huge_pages = transparent_huge_pages &&
+               madvise(start, length, MADV_HUGEPAGE) == 0;
+  return start;
+}
+
+void HugePageAllocator::UnmapChunk(char *address, size_t length) {
+  munmap(address, length);
+}
+
+void *HugePageAllocator::Allocate(size_t size) {
+  if (enabled == false) return ::operator new(size);
+
+  if (size == 0) size = 1;
+  std::lock_guard<std::mutex> lock(allocator_mutex);
+
+  // Large allocations get a chunk of their own
+  if (size > HUGE_PAGE_MAX_ARENA_ALLOCATION) {
+    size_t length = AlignSize(size, HUGE_PAGE_SIZE);
+    bool huge_pages = false;
+    char *address = MapChunk(length, huge_pages);
+    if (address == nullptr) return ::operator new(size);
+
+    chunks[address] = {length, length, 1, huge_pages};
+    chunk_count++;
+
+    allocation_count++;
+    if (huge_pages) huge_page_allocation_count++;
+    return address;
+  }
+
+  // Start a new arena if the current one is full
+  size = AlignSize(size, HUGE_PAGE_ARENA_ALIGNMENT);
+  if (arena == nullptr || chunks[arena].used + size > HUGE_PAGE_SIZE) {
+    // Unmap the full arena if all of its allocations are released
+    if (arena != nullptr && chunks[arena].live_count == 0) {
+      UnmapChunk(arena, HUGE_PAGE_SIZE);
+      chunks.erase(arena);
+      chunk_count--;
+    }
+    arena = nullptr;
+
+    bool huge_pages = false;
+    char *address = MapChunk(HUGE_PAGE_SIZE, huge_pages);
+    if (address == nullptr) return ::operator new(size);
+
+    chunks[address] = {HUGE_PAGE_SIZE, 0, 0, huge_pages};
+    chunk_count++;
+    arena = address;
+  }
+
+  auto &chunk = chunks[arena];
+  char *address = arena + chunk.used;
+  chunk.used += size;
+  chunk.live_count++;
+
+  allocation_count++;
+  if (chunk.huge_pages) huge_page_allocation_count++;
+  return address;
+}
+
+void HugePageAllocator::Release(void *address) {
+  if (address == nullptr) return;
+
+  if (chunk_count > 0) {
+    std::lock_guard<std::mutex> lock(allocator_mutex);
+
+    char *chunk_address = GetChunkAddress(address);
+    auto chunk_itr = chunks.find(chunk_address);
+    if (chunk_itr != chunks.end() &&
+        reinterpret_cast<char *>(address) <
+            chunk_address + chunk_itr->second.length) {
+      auto &chunk = chunk_itr->second;
+      chunk.live_count--;
+
+      // Keep the current arena around for later allocations
+      if (chunk.live_count == 0 && chunk_address != arena) {
+        UnmapChunk(chunk_address, chunk.length);
+        chunks.erase(chunk_itr);
+        chunk_count--;
+      }
+      return;
+    }
+  }
+
+  ::operator delete(address);
+}
+
+size_t HugePageAllocator::GetChunkCount() {
+  std::lock_guard<std::mutex> lock(allocator_mutex);
+  return chunks.size();
+}
+
+}  // End peloton namespace
@@ -0,0 +1,126 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// huge_page_allocator.h
+//
+// Identification: src/backend/common/huge_page_allocator.h
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <unordered_map>
+
+namespace peloton {
+
+//===--------------------------------------------------------------------===//
+// Huge Page Allocator
+//===--------------------------------------------------------------------===//
+
+#define HUGE_PAGE_SIZE (2 * 1024 * 1024)
+
+// Larger allocations get a mapping of their own
+#define HUGE_PAGE_MAX_ARENA_ALLOCATION (HUGE_PAGE_SIZE / 2)
+
+// Alignment of allocations within an arena
+#define HUGE_PAGE_ARENA_ALIGNMENT 64
+
+/**
+ * Backs in-memory tiles, pools and index structures with 2MB pages to cut
+ * down on TLB misses.
+ *
+ * Memory is mapped in 2MB aligned chunks, with MAP_HUGETLB if the kernel
+ * has reserved huge pages, or else with madvise(MADV_HUGEPAGE). Small
+ * allocations are carved out of a shared arena chunk, which is unmapped once
+ * all of its allocations are released. Large allocations get their own
+ * chunk.
+ *
+ * When disabled, allocations go to the regular heap.
+ */
+class HugePageAllocator {
+  HugePageAllocator(HugePageAllocator const &) = delete;
+
+ public:
+  // global singleton
+  static HugePageAllocator &GetInstance(void);
+
+  HugePageAllocator();
+  ~HugePageAllocator();
+
+  void *Allocate(size_t size);
+
+  void Release(void *address);
+
+  //===--------------------------------------------------------------------===//
+  // Accessors
+  //===--------------------------------------------------------------------===//
+
+  // Only affects later allocations
+  void SetEnabled(bool value) { enabled = value; }
+
+  bool IsEnabled() const { return enabled; }
+
+  // Number of allocations made while enabled
+  size_t GetAllocationCount() const { return allocation_count; }
+
+  // Number of allocations that got huge pages
+  size_t GetHugePageAllocationCount() const {
+    return huge_page_allocation_count;
+  }
+
+  // Number of chunks that are currently mapped
+  size_t GetChunkCount();
+
+ private:
+  struct Chunk {
+    // length of the mapping
+    size_t length;
+
+    // bytes handed out so far (arena chunks only)
+    size_t used;
+
+    // allocations that are not released yet
+    size_t live_count;
+
+    // did the chunk get huge pages ?
+    bool huge_pages;
+  };
+
+  // Map a 2MB aligned chunk of the given length
+  char *MapChunk(size_t length, bool &huge_pages);
+
+  // Unmap the chunk at the given address
+  void UnmapChunk(char *address, size_t length);
+
+  //===--------------------------------------------------------------------===//
+  // MEMBERS
+  //===--------------------------------------------------------------------===//
+
+  std::atomic<bool> enabled;
+
+  // are transparent huge pages enabled by the kernel ?
+  bool transparent_huge_pages;
+
+  // chunk address -> chunk
+  std::unordered_map<char *, Chunk> chunks;
+
+  // number of mapped chunks, to skip the lookup when there are none
+  std::atomic<size_t> chunk_count;
+
+  // current arena chunk
+  char *arena;
+
+  std::atomic<size_t> allocation_count;
+
+  std::atomic<size_t> huge_page_allocation_count;
+
+  std::mutex allocator_mutex;
+};
+
+}  // End peloton namespace
@@ -0,0 +1,190 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// numa_manager.cpp
+//
+// Identification: src/backend/common/numa_manager.cpp
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "backend/common/numa_manager.h"
+#include "backend/common/logger.h"
+
+#include <cassert>
+#include <sched.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <linux/mempolicy.h>
+
+#include <fstream>
+#include <sstream>
+#include <string>
+
+namespace peloton {
+
+#define NUMA_NODE_DIR "/sys/devices/system/node/"
+
+// Max number of nodes in the node mask passed to mbind
+#define NUMA_MAX_NODES (8 * sizeof(unsigned long))
+
+// Parse a sysfs cpu or node list like "0-3,8-11"
+static std::vector<int> ParseList(const std::string &list) {
+  std::vector<int> items;
+  std::stringstream list_stream(list);
+  std::string range;
+
+  while (std::getline(list_stream, range, ',')) {
+    if (range.empty()) continue;
+
+    auto dash = range.find('-');
+    int first = std::stoi(range.substr(0, dash));
+    int last = first;
+    if (dash != std::string::npos) last = std::stoi(range.substr(dash + 1));
+
+    for (int item = first; item <= last; item++) items.push_back(item);
+  }
+
+  return items;
+}
+
+// Read the first line of a sysfs file
+static std::string ReadLine(const std::string &file_name) {
+  std::ifstream file(file_name);
+  std::string line;
+  if (file.good()) std::getline(file, line);
+  return line;
+}
+
+NumaManager &NumaManager::GetInstance(void) {
+  static NumaManager numa_manager;
+  return numa_manager;
+}
+
+NumaManager::NumaManager()
+    : node_count(1),
+      placement_type(NUMA_PLACEMENT_TYPE_LOCAL),
+      next_node(0) {
+  std::vector<int> nodes;
+  try {
+    nodes = ParseList(ReadLine(std::string(NUMA_NODE_DIR) + "online"));
+  } catch (const std::exception &) {
+    nodes.clear();
+  }
+
+  // Fallback to a single node
+  if (nodes.empty() || nodes.back() >= (int)NUMA_MAX_NODES) {
+    nodes = {0};
+  }
+
+  node_count = nodes.back() + 1;
+  node_cpus.resize(node_count);
+
+  for (auto node : nodes) {
+    std::string cpu_list = ReadLine(std::string(NUMA_NODE_DIR) + "node" +
+                                    std::to_string(node) + "/cpulist");
+    try {
+      node_cpus[node] = ParseList(cpu_list);
+    } catch (const std::exception &) {
+      node_cpus[node].clear();
+    }
+
+    for (auto cpu : node_cpus[node]) {
+      if (cpu >= (int)cpu_nodes.size()) cpu_nodes.resize(cpu + 1, 0);
+      cpu_nodes[cpu] = node;
+    }
+  }
+
+  LOG_INFO("NUMA nodes :: %d", node_count);
+}
+
+int NumaManager::GetCurrentNode() const {
+  if (IsAvailable() == false) return 0;
+
+  int cpu = sched_getcpu();
+  if (cpu < 0 || cpu >= (int)cpu_nodes.size()) return 0;
+
+  return cpu_nodes[cpu];
+}
+
+const std::vector<int> &NumaManager::GetNodeCpus(int node) const {
+  assert(node >= 0 && node < node_count);
+  return node_cpus[node];
+}
+
+int NumaManager::GetPlacementNode() {
+  if (IsAvailable() == false) return 0;
+
+  switch (placement_type) {
+    case NUMA_PLACEMENT_TYPE_ROUND_ROBIN:
+      return next_node++ % node_count;
+
+    case NUMA_PLACEMENT_TYPE_LOCAL:
+    default:
+      return GetCurrentNode();
+  }
+}
+
+void *NumaManager::Allocate(size_t size, int node) const {
+  assert(node >= 0 && node < node_count);
+  if (size == 0) return nullptr;
+
+  // The mapping is page-aligned and ours alone, so binding it cannot move
+  // anybody else's pages
+  void *address = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (address == MAP_FAILED) return nullptr;
+
+  // Prefer the node, so that we can still allocate when it is full. No
+  // page was touched yet, so there is nothing to move.
+  if (IsAvailable() == true) {
+    unsigned long node_mask = 1UL << node;
+    long status = syscall(SYS_mbind, address, size, MPOL_PREFERRED,
+                          &node_mask, NUMA_MAX_NODES, 0);
+    if (status != 0) {
+      LOG_TRACE("Could not bind memory to node %d", node);
+    }
+  }
+
+  return address;
+}
+
+void NumaManager::Release(void *address, size_t size) const {
+  if (address == nullptr) return;
+
+  munmap(address, size);
+}
+
+bool NumaManager::PinThread(int node) const {
+  if (IsAvailable() == false || node_cpus[node].empty()) return false;
+
+  cpu_set_t cpu_set;
+  CPU_ZERO(&cpu_set);
+  for (auto cpu : node_cpus[node]) CPU_SET(cpu, &cpu_set);
+
+  if (sched_setaffinity(0, sizeof(cpu_set), &cpu_set) != 0) {
+    LOG_TRACE("Could not pin thread to node %d", node);
+    return false;
+  }
+
+  return true;
+}
+
+bool NumaManager::GetThreadCpus(cpu_set_t &cpu_set) const {
+  CPU_ZERO(&cpu_set);
+  return sched_getaffinity(0, sizeof(cpu_set), &cpu_set) == 0;
+}
+
+bool NumaManager::SetThreadCpus(const cpu_set_t &cpu_set) const {
+  if (sched_setaffinity(0, sizeof(cpu_set), &cpu_set) != 0) {
+    LOG_TRACE("Could not restore the cpus of the thread");
+    return false;
+  }
+
+  return true;
+}
+
+}  // End peloton namespace
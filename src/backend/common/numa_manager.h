@@ -0,0 +1,111 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// numa_manager.h
+//
+// Identification: src/backend/common/numa_manager.h
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <vector>
+
+#include <sched.h>
+
+#include "backend/common/types.h"
+
+namespace peloton {
+
+//===--------------------------------------------------------------------===//
+// NUMA Manager
+//===--------------------------------------------------------------------===//
+
+/**
+ * Tracks the NUMA topology of the machine and places memory and threads
+ * on its nodes.
+ *
+ * The topology is read from sysfs, and memory is bound with the raw mbind
+ * system call, so that we do not depend on libnuma. Only memory that is
+ * mapped here is bound, before it is touched, so that nothing else that
+ * shares its pages is moved. On machines with a single node, or when NUMA
+ * is not supported, everything is on node 0 and the placement calls are
+ * no-ops.
+ */
+class NumaManager {
+  NumaManager(NumaManager const &) = delete;
+
+ public:
+  // global singleton
+  static NumaManager &GetInstance(void);
+
+  NumaManager();
+
+  // Is there more than one node ?
+  bool IsAvailable() const { return node_count > 1; }
+
+  int GetNodeCount() const { return node_count; }
+
+  // Get the node of the cpu the calling thread runs on
+  int GetCurrentNode() const;
+
+  // Get the cpus of the given node
+  const std::vector<int> &GetNodeCpus(int node) const;
+
+  //===--------------------------------------------------------------------===//
+  // Placement
+  //===--------------------------------------------------------------------===//
+
+  void SetPlacementType(NumaPlacementType type) { placement_type = type; }
+
+  NumaPlacementType GetPlacementType() const { return placement_type; }
+
+  // Pick the node for new data as per the placement policy
+  int GetPlacementNode();
+
+  // Map zeroed memory whose pages go to the given node when they are
+  // first touched
+  // returns nullptr if the memory could not be mapped
+  void *Allocate(size_t size, int node) const;
+
+  // Unmap memory that was mapped by Allocate
+  void Release(void *address, size_t size) const;
+
+  // Restrict the calling thread to the cpus of the given node
+  // returns false if the thread could not be pinned
+  bool PinThread(int node) const;
+
+  // Get the cpus the calling thread may run on, to restore them later
+  // returns false if they could not be read
+  bool GetThreadCpus(cpu_set_t &cpu_set) const;
+
+  // Let the calling thread run on the given cpus again
+  // returns false if the thread could not be moved
+  bool SetThreadCpus(const cpu_set_t &cpu_set) const;
+
+ private:
+  //===--------------------------------------------------------------------===//
+  // MEMBERS
+  //===--------------------------------------------------------------------===//
+
+  // number of nodes
+  int node_count;
+
+  // cpus of every node
+  std::vector<std::vector<int>> node_cpus;
+
+  // node of every cpu
+  std::vector<int> cpu_nodes;
+
+  // placement policy for new data
+  NumaPlacementType placement_type;
+
+  // next node for round robin placement
+  std::atomic<unsigned int> next_node;
+};
+
+}  // End peloton namespace
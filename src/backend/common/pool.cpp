@@ -10,11 +10,79 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
+
 #include "backend/common/pool.h"
 
 namespace peloton {
 
+//===--------------------------------------------------------------------===//
+// Thread-local segments
+//===--------------------------------------------------------------------===//
+
+// Number of pools whose segments are cached by each thread
+#define THREAD_SEGMENT_CACHE_SIZE 8
+
+// Part of a chunk that a thread allocates from without locking
+struct ThreadSegment {
+  ~ThreadSegment() { Retire(); }
+
+  // Count the unused tail as freed in its pool, unless it was purged
+  void Retire() {
+    if (counters != nullptr && counters->epoch == pool_epoch) {
+      counters->freed_size += end - next;
+    }
+    counters.reset();
+    next = nullptr;
+    end = nullptr;
+  }
+
+  // counters and epoch of the pool the segment was carved from, the
+  // counters outlive the pool, so they are never mistaken for the ones of
+  // a new pool at the same address
+  std::shared_ptr<VarlenPoolCounters> counters;
+  uint64_t pool_epoch = 0;
+
+  char *next = nullptr;
+  char *end = nullptr;
+
+  // when the segment was last used, to evict the least recently used one
+  uint64_t last_use = 0;
+};
+
+// Segments of the recently used pools
+thread_local static ThreadSegment thread_segments[THREAD_SEGMENT_CACHE_SIZE];
+
+thread_local static uint64_t thread_segment_clock = 0;
+
+// Find the segment of the pool, or evict the least recently used one
+static ThreadSegment &GetThreadSegment(VarlenPoolCounters *counters) {
+  ThreadSegment *victim = &thread_segments[0];
+  for (auto &segment : thread_segments) {
+    if (segment.counters.get() == counters) {
+      victim = &segment;
+      break;
+    }
+    if (segment.last_use < victim->last_use) victim = &segment;
+  }
+
+  victim->last_use = ++thread_segment_clock;
+  return *victim;
+}
+
+// Round up to keep allocations 8 byte aligned
+static inline std::size_t AlignSize(std::size_t size) {
+  return (size + 7) & ~static_cast<std::size_t>(7);
+}
+
+//===--------------------------------------------------------------------===//
+// Memory Pool
+//===--------------------------------------------------------------------===//
+
 void VarlenPool::Init() {
+  counters = std::make_shared<VarlenPoolCounters>();
+  segment_size = std::min<std::size_t>(THREAD_SEGMENT_SIZE, allocation_size);
+
   auto &storage_manager = storage::StorageManager::GetInstance();
   char *storage = reinterpret_cast<char *>(
       storage_manager.Allocate(backend_type, allocation_size));
@@ -36,61 +104,87 @@ VarlenPool::~VarlenPool() {
 
 // Allocate a continous block of memory of the specified size.
 void *VarlenPool::Allocate(std::size_t size) {
-  void *retval = nullptr;
+  // Ensure 8 byte alignment of future allocations
+  size = AlignSize(size);
 
-  // Protect using pool lock
-  // TODO: Can make locking more fine-grained
-  {
-    std::lock_guard<std::mutex> pool_lock(pool_mutex);
+  // Large blocks are directly allocated from the chunks
+  if (size > segment_size / 4) {
+    return AllocateShared(size);
+  }
 
-    // See if there is space in the current chunk
-    Chunk *current_chunk = &chunks[current_chunk_index];
-    if (size > current_chunk->size - current_chunk->offset) {
-      // Not enough space. Check if it is greater than our allocation size.
-      if (size > allocation_size) {
-        // Allocate an oversize chunk that will not be reused.
-        auto &storage_manager = storage::StorageManager::GetInstance();
-        char *storage = reinterpret_cast<char *>(
-            storage_manager.Allocate(backend_type, size));
+  auto &segment = GetThreadSegment(counters.get());
+  uint64_t epoch = counters->epoch.load(std::memory_order_acquire);
 
-        oversize_chunks.push_back(Chunk(nexthigher(size), storage));
-        Chunk &newChunk = oversize_chunks.back();
-        newChunk.offset = size;
-        return newChunk.chunk_data;
-      }
+  // Check if we have a segment of this pool that is still valid
+  if (segment.counters != counters || segment.pool_epoch != epoch) {
+    segment.Retire();
+    segment.counters = counters;
+    segment.pool_epoch = epoch;
+  }
 
-      // Check if there is an already allocated chunk we can use.
-      current_chunk_index++;
+  // Grab a new segment if there is not enough space in the current one
+  if (static_cast<std::size_t>(segment.end - segment.next) < size) {
+    counters->freed_size += segment.end - segment.next;
 
-      if (current_chunk_index < chunks.size()) {
-        current_chunk = &chunks[current_chunk_index];
-        current_chunk->offset = size;
-        return current_chunk->chunk_data;
-      } else {
-        // Need to allocate a new chunk
-        auto &storage_manager = storage::StorageManager::GetInstance();
-        char *storage = reinterpret_cast<char *>(
-            storage_manager.Allocate(backend_type, allocation_size));
+    segment.next = reinterpret_cast<char *>(AllocateShared(segment_size));
+    segment.end = segment.next + segment_size;
+  }
 
-        chunks.push_back(Chunk(allocation_size, storage));
-        Chunk &new_chunk = chunks.back();
-        new_chunk.offset = size;
-        return new_chunk.chunk_data;
-      }
+  // No need to lock, as only this thread allocates from the segment
+  void *retval = segment.next;
+  segment.next += size;
+
+  return retval;
+}
+
+void *VarlenPool::AllocateShared(std::size_t size) {
+  // Protect using pool lock
+  std::lock_guard<std::mutex> pool_lock(pool_mutex);
+
+  // See if there is space in the current chunk
+  Chunk *current_chunk = &chunks[current_chunk_index];
+  if (size > current_chunk->size - current_chunk->offset) {
+    // Not enough space. Check if it is greater than our allocation size.
+    if (size > allocation_size) {
+      // Allocate an oversize chunk that will not be reused.
+      auto &storage_manager = storage::StorageManager::GetInstance();
+      char *storage = reinterpret_cast<char *>(
+          storage_manager.Allocate(backend_type, size));
+
+      oversize_chunks.push_back(Chunk(nexthigher(size), storage));
+      Chunk &newChunk = oversize_chunks.back();
+      newChunk.offset = size;
+      return newChunk.chunk_data;
     }
 
-    // Get the offset into the current chunk. Then increment the
-    // offset counter by the amount being allocated.
-    retval = current_chunk->chunk_data + current_chunk->offset;
-    current_chunk->offset += size;
+    // The rest of the current chunk is not going to be used
+    counters->freed_size += current_chunk->size - current_chunk->offset;
+
+    // Check if there is an already allocated chunk we can use.
+    current_chunk_index++;
 
-    // Ensure 8 byte alignment of future allocations
-    current_chunk->offset += (8 - (current_chunk->offset % 8));
-    if (current_chunk->offset > current_chunk->size) {
-      current_chunk->offset = current_chunk->size;
+    if (current_chunk_index < chunks.size()) {
+      current_chunk = &chunks[current_chunk_index];
+      current_chunk->offset = size;
+      return current_chunk->chunk_data;
+    } else {
+      // Need to allocate a new chunk
+      auto &storage_manager = storage::StorageManager::GetInstance();
+      char *storage = reinterpret_cast<char *>(
+          storage_manager.Allocate(backend_type, allocation_size));
+
+      chunks.push_back(Chunk(allocation_size, storage));
+      Chunk &new_chunk = chunks.back();
+      new_chunk.offset = size;
+      return new_chunk.chunk_data;
     }
   }
 
+  // Get the offset into the current chunk. Then increment the
+  // offset counter by the amount being allocated.
+  void *retval = current_chunk->chunk_data + current_chunk->offset;
+  current_chunk->offset += size;
+
   return retval;
 }
 
@@ -100,11 +194,19 @@ void *VarlenPool::AllocateZeroes(std::size_t size) {
   return ::memset(Allocate(size), 0, size);
 }
 
+void VarlenPool::Free(void *ptr __attribute__((unused)), std::size_t size) {
+  counters->freed_size += AlignSize(size);
+}
+
 void VarlenPool::Purge() {
   // Protect using pool lock
   {
     std::lock_guard<std::mutex> pool_lock(pool_mutex);
 
+    // Invalidate the segments handed out to threads
+    counters->epoch++;
+    counters->freed_size = 0;
+
     // Erase any oversize chunks that were allocated
     const std::size_t numOversizeChunks = oversize_chunks.size();
     for (std::size_t ii = 0; ii < numOversizeChunks; ii++) {
@@ -19,6 +19,8 @@
 #include <climits>
 #include <string.h>
 
+#include <atomic>
+#include <memory>
 #include <mutex>
 
 #include "backend/storage/storage_manager.h"
@@ -27,6 +29,9 @@ namespace peloton {
 
 static const size_t TEMP_POOL_CHUNK_SIZE = 1024 * 1024;  // 1 MB
 
+// Size of the chunk segments handed out to each thread
+static const size_t THREAD_SEGMENT_SIZE = 16 * 1024;  // 16 KB
+
 //===--------------------------------------------------------------------===//
 // Chunk of memory allocated on the heap
 //===--------------------------------------------------------------------===//
@@ -58,10 +63,29 @@ inline T nexthigher(T k) {
 // Memory Pool
 //===--------------------------------------------------------------------===//
 
+// Counters of a pool, shared with the segments cached by the threads, so
+// that a segment of a destroyed pool can still be told apart and retired
+struct VarlenPoolCounters {
+  // bumped on purge to invalidate the segments of all threads
+  std::atomic<uint64_t> epoch = ATOMIC_VAR_INIT(0);
+
+  // allocated memory that is no longer used
+  std::atomic<int64_t> freed_size = ATOMIC_VAR_INIT(0);
+};
+
 /**
  * A memory pool that provides fast allocation and deallocation. The
  * only way to release memory is to free all memory in the pool by
  * calling purge.
+ *
+ * Each thread allocates from its own segment of a chunk by bumping a
+ * pointer, without any locking. The pool lock is only taken to carve a
+ * new segment out of the chunks, or for allocations that are too large
+ * for a segment.
+ *
+ * Memory that is no longer used (freed blocks, and the unused tails of
+ * segments and chunks) is tracked, so that owners of long-lived pools
+ * can tell when it is worth compacting them.
  */
 class VarlenPool {
   VarlenPool(const VarlenPool &) = delete;
@@ -96,11 +120,21 @@ class VarlenPool {
   // initialized to 0s
   void *AllocateZeroes(std::size_t size);
 
+  // Mark a block allocated from this pool as no longer used.
+  // The memory is only reclaimed when the pool is purged.
+  void Free(void *ptr, std::size_t size);
+
   void Purge();
 
   int64_t GetAllocatedMemory();
 
+  // Get the amount of allocated memory that is no longer used
+  int64_t GetFreedMemory() const { return counters->freed_size; }
+
  private:
+  // Allocate a block from the chunks, under the pool lock
+  void *AllocateShared(std::size_t size);
+
   // backend type
   BackendType backend_type;
 
@@ -113,6 +147,12 @@ class VarlenPool {
   std::vector<Chunk> oversize_chunks;
 
   std::mutex pool_mutex;
+
+  // epoch and freed memory, also used to find the segments of each thread
+  std::shared_ptr<VarlenPoolCounters> counters;
+
+  // size of the segments handed out to threads
+  std::size_t segment_size;
 };
 
 }  // End peloton namespace
@@ -180,6 +180,76 @@ BackendType StringToBackendType(std::string str) {
   return BACKEND_TYPE_INVALID;
 }
 
+std::string EncodingTypeToString(EncodingType type) {
+  std::string ret;
+
+  switch (type) {
+    case (ENCODING_TYPE_NONE):
+      return "NONE";
+    case (ENCODING_TYPE_DICTIONARY):
+      return "DICTIONARY";
+    case (ENCODING_TYPE_RLE):
+      return "RLE";
+    case (ENCODING_TYPE_FOR):
+      return "FOR";
+    case (ENCODING_TYPE_INVALID):
+      return "INVALID";
+    default: {
+      char buffer[32];
+      ::snprintf(buffer, 32, "UNKNOWN[%d] ", type);
+      ret = buffer;
+    }
+  }
+  return (ret);
+}
+
+std::string NumaPlacementTypeToString(NumaPlacementType type) {
+  std::string ret;
+
+  switch (type) {
+    case (NUMA_PLACEMENT_TYPE_LOCAL):
+      return "LOCAL";
+    case (NUMA_PLACEMENT_TYPE_ROUND_ROBIN):
+      return "ROUND_ROBIN";
+    case (NUMA_PLACEMENT_TYPE_INVALID):
+      return "INVALID";
+    default: {
+      char buffer[32];
+      ::snprintf(buffer, 32, "UNKNOWN[%d] ", type);
+      ret = buffer;
+    }
+  }
+  return (ret);
+}
+
+std::string ConcurrencyTypeToString(ConcurrencyType type) {
+  std::string ret;
+
+  switch (type) {
+    case (CONCURRENCY_TYPE_MVCC):
+      return "MVCC";
+    case (CONCURRENCY_TYPE_OCC):
+      return "OCC";
+    case (CONCURRENCY_TYPE_INVALID):
+      return "INVALID";
+    default: {
+      char buffer[32];
+      ::snprintf(buffer, 32, "UNKNOWN[%d] ", type);
+      ret = buffer;
+    }
+  }
+  return (ret);
+}
+
+ConcurrencyType StringToConcurrencyType(std::string str) {
+  if (str == "MVCC") {
+    return CONCURRENCY_TYPE_MVCC;
+  } else if (str == "OCC") {
+    return CONCURRENCY_TYPE_OCC;
+  }
+  return CONCURRENCY_TYPE_INVALID;
+}
+
 //===--------------------------------------------------------------------===//
 // Value <--> String Utilities
 //===--------------------------------------------------------------------===//
@@ -991,6 +1061,15 @@ std::string LogRecordTypeToString(LogRecordType type) {
     case LOGRECORD_TYPE_PELOTON_TUPLE_UPDATE: {
       return "LOGRECORD_TYPE_PELOTON_TUPLE_UPDATE";
     }
+    case LOGRECORD_TYPE_ARIES_TUPLE_DELTA_UPDATE: {
+      return "LOGRECORD_TYPE_ARIES_TUPLE_DELTA_UPDATE";
+    }
+    case LOGRECORD_TYPE_COMPRESSED_BLOCK: {
+      return "LOGRECORD_TYPE_COMPRESSED_BLOCK";
+    }
+    case LOGRECORD_TYPE_DURABLE_CID: {
+      return "LOGRECORD_TYPE_DURABLE_CID";
+    }
   }
   return "INVALID";
 }
@@ -334,6 +334,41 @@ enum BackendType {
   BACKEND_TYPE_FILE = 2  // on mmap file
 };
 
+//===--------------------------------------------------------------------===//
+// Column Encoding Types
+//===--------------------------------------------------------------------===//
+
+enum EncodingType {
+  ENCODING_TYPE_INVALID = 0,  // invalid encoding type
+
+  ENCODING_TYPE_NONE = 1,        // uncompressed
+  ENCODING_TYPE_DICTIONARY = 2,  // bit-packed codes into a dictionary
+  ENCODING_TYPE_RLE = 3,         // run-length encoding
+  ENCODING_TYPE_FOR = 4          // bit-packed offsets from a frame of reference
+};
+
+//===--------------------------------------------------------------------===//
+// NUMA Placement Types
+//===--------------------------------------------------------------------===//
+
+enum NumaPlacementType {
+  NUMA_PLACEMENT_TYPE_INVALID = 0,  // invalid placement type
+
+  NUMA_PLACEMENT_TYPE_LOCAL = 1,       // on the node of the allocating thread
+  NUMA_PLACEMENT_TYPE_ROUND_ROBIN = 2  // spread over all the nodes
+};
+
+//===--------------------------------------------------------------------===//
+// Concurrency Control Types
+//===--------------------------------------------------------------------===//
+
+enum ConcurrencyType {
+  CONCURRENCY_TYPE_INVALID = 0,  // invalid concurrency control type
+
+  CONCURRENCY_TYPE_MVCC = 1,  // snapshot reads, first updater wins
+  CONCURRENCY_TYPE_OCC = 2    // MVCC plus read set validation at commit
+};
+
 //===--------------------------------------------------------------------===//
 // Index Types
 //===--------------------------------------------------------------------===//
@@ -634,7 +669,17 @@ enum LogRecordType {
 
   LOGRECORD_TYPE_PELOTON_TUPLE_INSERT = 12,
   LOGRECORD_TYPE_PELOTON_TUPLE_DELETE = 13,
-  LOGRECORD_TYPE_PELOTON_TUPLE_UPDATE = 14
+  LOGRECORD_TYPE_PELOTON_TUPLE_UPDATE = 14,
+
+  // Update that only has the changed columns of the new tuple
+  LOGRECORD_TYPE_ARIES_TUPLE_DELTA_UPDATE = 15,
+
+  // Block of log records, compressed together
+  LOGRECORD_TYPE_COMPRESSED_BLOCK = 16,
+
+  // The commits up to its cid that were logged to the log stream are
+  // before it
+  LOGRECORD_TYPE_DURABLE_CID = 17
 };
 
 // ------------------------------------------------------------------
@@ -735,6 +780,13 @@ bool IsSimilarToPeloton(LoggingType logging_type);
 std::string BackendTypeToString(BackendType type);
 BackendType StringToBackendType(std::string str);
 
+std::string EncodingTypeToString(EncodingType type);
+
+std::string NumaPlacementTypeToString(NumaPlacementType type);
+
+std::string ConcurrencyTypeToString(ConcurrencyType type);
+ConcurrencyType StringToConcurrencyType(std::string str);
+
 std::string ValueTypeToString(ValueType type);
 ValueType StringToValueType(std::string str);
 
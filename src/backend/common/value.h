@@ -2980,6 +2980,9 @@ inline void Value::DeserializeFromAllocateForStorage(ValueType type,
       char *storage = AllocateValueStorage(length, varlen_pool);
       const char *str = (const char *)input.GetRawPointer(length);
       ::memcpy(storage, str, length);
+      // The value refers to its Varlen, like an allocated value
+      SetSourceInlined(false);
+      SetCleanUp(varlen_pool == nullptr);
       break;
     }
     case VALUE_TYPE_DECIMAL: {
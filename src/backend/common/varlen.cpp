@@ -13,6 +13,8 @@
 #include "backend/common/varlen.h"
 #include "backend/common/pool.h"
 
+#include <cassert>
+
 namespace peloton {
 
 Varlen *Varlen::Create(size_t size, VarlenPool *data_pool) {
@@ -37,6 +39,13 @@ Varlen *Varlen::Clone(const Varlen &src, VarlenPool *data_pool) {
   return rv;
 }
 
+void Varlen::Free(Varlen *varlen, VarlenPool *data_pool) {
+  assert(varlen->varlen_temp_pool == false);
+
+  data_pool->Free(varlen->varlen_string_ptr, varlen->varlen_size);
+  data_pool->Free(varlen, sizeof(Varlen));
+}
+
 // Construct varlen in heap
 Varlen::Varlen(size_t size) {
   varlen_size = size + sizeof(Varlen *);
@@ -52,6 +52,10 @@ class Varlen {
    */
   static Varlen *Clone(const Varlen &src, VarlenPool *data_pool = NULL);
 
+  /// Give the memory of the given Varlen back to the data pool it was
+  /// created in. varlen must not be used afterwards
+  static void Free(Varlen *varlen, VarlenPool *data_pool);
+
   char *Get();
   const char *Get() const;
 
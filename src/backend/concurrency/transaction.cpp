@@ -18,29 +18,97 @@
 #include <chrono>
 #include <thread>
 #include <iomanip>
+#include <new>
+#include <stdlib.h>
 
 namespace peloton {
 namespace concurrency {
 
-void Transaction::RecordInsert(ItemPointer location) {
-  inserted_tuples[location.block].push_back(location.offset);
+//===--------------------------------------------------------------------===//
+// Transaction Pool
+//===--------------------------------------------------------------------===//
+
+// Free transactions of a thread, freed when the thread exits
+struct TransactionFreeList {
+  ~TransactionFreeList() {
+    for (auto txn : txns) delete txn;
+  }
+
+  std::vector<Transaction *> txns;
+};
+
+static thread_local TransactionFreeList transaction_free_list;
+
+void *Transaction::operator new(size_t size) {
+  void *ptr = nullptr;
+  if (posix_memalign(&ptr, alignof(Transaction), size) != 0) {
+    throw std::bad_alloc();
+  }
+  return ptr;
 }
 
-void Transaction::RecordDelete(ItemPointer location) {
-  deleted_tuples[location.block].push_back(location.offset);
+void Transaction::operator delete(void *ptr) { free(ptr); }
+
+Transaction *Transaction::Allocate(txn_id_t txn_id, cid_t last_cid) {
+  auto &txns = transaction_free_list.txns;
+  if (txns.empty()) return new Transaction(txn_id, last_cid);
+
+  auto txn = txns.back();
+  txns.pop_back();
+  txn->Reset(txn_id, last_cid);
+
+  return txn;
+}
+
+void Transaction::Recycle(Transaction *txn) {
+  auto &txns = transaction_free_list.txns;
+  if (txns.size() >= TRANSACTION_POOL_SIZE) {
+    delete txn;
+    return;
+  }
+
+  txns.push_back(txn);
 }
 
-const std::map<oid_t, std::vector<oid_t>> &Transaction::GetInsertedTuples() {
-  return inserted_tuples;
+void Transaction::Reset(txn_id_t txn_id_, cid_t last_cid_) {
+  txn_id = txn_id_;
+  cid = INVALID_CID;
+  last_cid = last_cid_;
+  ref_count = BASE_REF_COUNT;
+  read_only = false;
+  active_slot = INVALID_OID;
+  track_reads = false;
+  result_ = peloton::RESULT_SUCCESS;
+
+  // keeps the memory of the write sets
+  ResetState();
 }
 
-const std::map<oid_t, std::vector<oid_t>> &Transaction::GetDeletedTuples() {
-  return deleted_tuples;
+void Transaction::RecordInsert(ItemPointer location) {
+  // A read-only txn never commits writes, so it fails instead
+  if (read_only == true) {
+    LOG_WARN("Insert in read-only txn : %lu", txn_id);
+    result_ = peloton::RESULT_FAILURE;
+    return;
+  }
+
+  inserted_tuples.Add(location);
+}
+
+void Transaction::RecordDelete(ItemPointer location) {
+  if (read_only == true) {
+    LOG_WARN("Delete in read-only txn : %lu", txn_id);
+    result_ = peloton::RESULT_FAILURE;
+    return;
+  }
+
+  deleted_tuples.Add(location);
 }
 
 void Transaction::ResetState(void) {
-  inserted_tuples.clear();
-  deleted_tuples.clear();
+  inserted_tuples.Clear();
+  deleted_tuples.Clear();
+  read_set.clear();
 }
 
 
@@ -50,11 +118,7 @@ const std::string Transaction::GetInfo() const{
   os << "\tTxn :: @" << this << " ID : " << std::setw(4) << txn_id
      << " Commit ID : " << std::setw(4) << cid
      << " Last Commit ID : " << std::setw(4) << last_cid
-     << " Result : " << result_;
-
-  if (next == nullptr) {
-    os << " Next : " << std::setw(4) << next->txn_id;
-  }
+     << " Read Only : " << read_only << " Result : " << result_;
 
   os << " Ref count : " << std::setw(4) << ref_count << "\n";
   return os.str();
@@ -16,20 +16,38 @@
 #include "backend/common/exception.h"
 #include "backend/common/printable.h"
 #include "backend/concurrency/transaction_manager.h"
+#include "backend/concurrency/write_set.h"
 
 #include <atomic>
 #include <cassert>
 #include <vector>
-#include <map>
 
 namespace peloton {
 namespace concurrency {
 
+// Max number of free transactions cached by a thread
+#define TRANSACTION_POOL_SIZE 64
+
+// Version read by a transaction, validated at commit under OCC
+struct ReadEntry {
+  ItemPointer location;
+
+  // begin cid of the version when it was read
+  cid_t begin_cid;
+};
+
 //===--------------------------------------------------------------------===//
 // Transaction
 //===--------------------------------------------------------------------===//
 
-class Transaction : public Printable {
+/**
+ * Transactions are cache line aligned, and their hot fields come first, so
+ * that the ref count and commit ids of concurrent transactions do not share
+ * a cache line. The transaction manager takes them from a free list of the
+ * beginning thread, and they go back to the free list of whichever thread
+ * drops the last reference.
+ */
+class __attribute__((aligned(64))) Transaction : public Printable {
   friend class TransactionManager;
 
   Transaction(Transaction const &) = delete;
@@ -39,23 +57,24 @@ class Transaction : public Printable {
       : txn_id(INVALID_TXN_ID),
         cid(INVALID_CID),
         last_cid(INVALID_CID),
-        ref_count(BASE_REF_COUNT),
-        waiting_to_commit(false),
-        next(nullptr) {}
+        ref_count(BASE_REF_COUNT) {}
 
   Transaction(txn_id_t txn_id, cid_t last_cid)
       : txn_id(txn_id),
         cid(INVALID_CID),
         last_cid(last_cid),
-        ref_count(BASE_REF_COUNT),
-        waiting_to_commit(false),
-        next(nullptr) {}
-
-  ~Transaction() {
-    if (next != nullptr) {
-      next->DecrementRefCount();
-    }
-  }
+        ref_count(BASE_REF_COUNT) {}
+
+  // Keep the alignment on the heap
+  static void *operator new(size_t size);
+
+  static void operator delete(void *ptr);
+
+  // Get a transaction from the free list of the calling thread
+  static Transaction *Allocate(txn_id_t txn_id, cid_t last_cid);
+
+  // Give the transaction back to the free list of the calling thread
+  static void Recycle(Transaction *txn);
 
   //===--------------------------------------------------------------------===//
   // Mutators and Accessors
@@ -67,15 +86,24 @@ class Transaction : public Printable {
 
   inline cid_t GetLastCommitId() const { return last_cid; }
 
+  inline bool IsReadOnly() const { return read_only; }
+
   // record inserted tuple
   void RecordInsert(ItemPointer location);
 
   // record deleted tuple
   void RecordDelete(ItemPointer location);
 
-  const std::map<oid_t, std::vector<oid_t>> &GetInsertedTuples();
+  const WriteSet &GetInsertedTuples() const { return inserted_tuples; }
+
+  const WriteSet &GetDeletedTuples() const { return deleted_tuples; }
+
+  // record a version read by the txn, if it keeps a read set
+  inline void RecordRead(ItemPointer location, cid_t begin_cid);
 
-  const std::map<oid_t, std::vector<oid_t>> &GetDeletedTuples();
+  inline bool IsTrackingReads() const { return track_reads; }
+
+  const std::vector<ReadEntry> &GetReadSet() const { return read_set; }
 
   // reset inserted tuples and deleted tuples
   // used by recovery (logging)
@@ -95,6 +123,10 @@ class Transaction : public Printable {
   // Get result and status
   inline Result GetResult() const;
 
+ private:
+  // Get ready to be used by a new transaction
+  void Reset(txn_id_t txn_id, cid_t last_cid);
+
  protected:
   //===--------------------------------------------------------------------===//
   // Data members
@@ -112,17 +144,23 @@ class Transaction : public Printable {
   // references
   std::atomic<size_t> ref_count;
 
-  // waiting for commit ?
-  std::atomic<bool> waiting_to_commit;
+  // read-only txns cannot record any writes
+  bool read_only = false;
 
-  // cid context
-  Transaction *next __attribute__((aligned(16)));
+  // slot in the active transaction registry, if the txn has one
+  oid_t active_slot = INVALID_OID;
+
+  // keep a read set for validation ?
+  bool track_reads = false;
 
   // inserted tuples
-  std::map<oid_t, std::vector<oid_t>> inserted_tuples;
+  WriteSet inserted_tuples;
 
   // deleted tuples
-  std::map<oid_t, std::vector<oid_t>> deleted_tuples;
+  WriteSet deleted_tuples;
+
+  // read versions, only kept under OCC
+  std::vector<ReadEntry> read_set;
 
   // synch helpers
   std::mutex txn_mutex;
@@ -135,12 +173,17 @@ inline void Transaction::IncrementRefCount() { ++ref_count; }
 
 inline void Transaction::DecrementRefCount() {
   // DROP transaction when ref count reaches 0
+  // it is recycled, so that the next transaction does not allocate
   // this returns the value immediately preceding the assignment
   if (ref_count.fetch_sub(1) == 1) {
-    delete this;
+    Recycle(this);
   }
 }
 
+inline void Transaction::RecordRead(ItemPointer location, cid_t begin_cid) {
+  if (track_reads) read_set.push_back({location, begin_cid});
+}
+
 inline void Transaction::SetResult(Result result) { result_ = result; }
 
 inline Result Transaction::GetResult() const { return result_; }
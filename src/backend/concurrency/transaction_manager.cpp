@@ -10,6 +10,7 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
 #include <chrono>
 #include <thread>
 #include <iomanip>
@@ -25,6 +26,7 @@
 #include "backend/common/exception.h"
 #include "backend/common/logger.h"
 #include "backend/storage/tile_group.h"
+#include "backend/storage/tile_group_header.h"
 
 namespace peloton {
 namespace concurrency {
@@ -32,22 +34,45 @@ namespace concurrency {
 // Current transaction for the backend thread
 thread_local Transaction *current_txn;
 
+// Registry slot of the backend thread, given back when the thread exits
+struct ActiveSlotHandle {
+  ~ActiveSlotHandle() {
+    if (slot != INVALID_OID) {
+      TransactionManager::GetInstance().ReleaseActiveSlot(slot);
+    }
+  }
+
+  oid_t slot = INVALID_OID;
+
+  // all the slots were taken when we tried to claim one
+  bool exhausted = false;
+};
+
+static thread_local ActiveSlotHandle active_slot_handle;
+
 TransactionManager::TransactionManager() {
   next_txn_id = ATOMIC_VAR_INIT(START_TXN_ID);
-  next_cid = ATOMIC_VAR_INIT(START_CID);
 
-  // BASE transaction
-  // All transactions are based on this transaction
-  last_txn = new Transaction(START_TXN_ID, START_CID);
-  last_txn->cid = START_CID;
+  // All transactions are based on the START_CID snapshot
+  next_cid = START_CID;
   last_cid = START_CID;
-}
 
-TransactionManager::~TransactionManager() {
-  // delete BASE txn
-  delete last_txn;
+  for (auto &commit_slot : commit_ring) commit_slot.cid = INVALID_CID;
+
+  for (auto &active_slot : active_slots) {
+    active_slot.claimed = false;
+    active_slot.snapshot_cid = INVALID_CID;
+    active_slot.txn = nullptr;
+  }
+
+  txn_table_count = 0;
+
+  concurrency_type = CONCURRENCY_TYPE_MVCC;
+  validation_abort_count = 0;
 }
 
+TransactionManager::~TransactionManager() {}
+
 txn_id_t TransactionManager::GetNextTransactionId() {
   if (next_txn_id == MAX_TXN_ID) {
     throw TransactionException("Txn id equals MAX_TXN_ID");
@@ -56,10 +81,98 @@ txn_id_t TransactionManager::GetNextTransactionId() {
   return next_txn_id++;
 }
 
+//===--------------------------------------------------------------------===//
+// Active Transaction Registry
+//===--------------------------------------------------------------------===//
+
+oid_t TransactionManager::GetActiveSlot() {
+  if (active_slot_handle.slot != INVALID_OID) return active_slot_handle.slot;
+  if (active_slot_handle.exhausted) return INVALID_OID;
+
+  // Claim a free slot for this thread
+  for (oid_t slot_itr = 0; slot_itr < ACTIVE_TXN_SLOT_COUNT; slot_itr++) {
+    bool claimed = false;
+    if (active_slots[slot_itr].claimed.compare_exchange_strong(claimed,
+                                                              true)) {
+      active_slot_handle.slot = slot_itr;
+      return slot_itr;
+    }
+  }
+
+  LOG_TRACE("No free slot in the active transaction registry");
+  active_slot_handle.exhausted = true;
+  return INVALID_OID;
+}
+
+void TransactionManager::ReleaseActiveSlot(oid_t slot) {
+  auto &active_slot = active_slots[slot];
+
+  active_slot.txn = nullptr;
+  active_slot.snapshot_cid = INVALID_CID;
+  active_slot.claimed = false;
+}
+
+/**
+ * A txn announces its snapshot in the slot of its thread before using it.
+ * GetOldestActiveCid reads last_cid before it scans the slots, so if it
+ * missed the announcement, last_cid was read again after it and must have
+ * moved. In that case we retry with the new last_cid.
+ */
+Transaction *TransactionManager::RegisterTransaction(bool read_only) {
+  Transaction *txn = nullptr;
+  auto txn_id = GetNextTransactionId();
+  oid_t slot = GetActiveSlot();
+
+  // Use the registry, unless this thread already has an active txn there
+  if (slot != INVALID_OID && active_slots[slot].txn == nullptr) {
+    auto &active_slot = active_slots[slot];
+
+    cid_t snapshot_cid;
+    do {
+      snapshot_cid = last_cid;
+      active_slot.snapshot_cid = snapshot_cid;
+    } while (snapshot_cid != last_cid);
+
+    txn = Transaction::Allocate(txn_id, snapshot_cid);
+    txn->active_slot = slot;
+    txn->read_only = read_only;
+    txn->track_reads = IsTrackingReads(read_only);
+    active_slot.txn = txn;
+
+    return txn;
+  }
+
+  // Otherwise, take the snapshot and register the txn atomically w.r.t.
+  // GetOldestActiveCid, so that its snapshot is never reclaimed
+  txn_table_count++;
+  {
+    std::lock_guard<std::mutex> lock(txn_table_mutex);
+    txn = Transaction::Allocate(txn_id, GetLastCommitId());
+    txn->read_only = read_only;
+    txn->track_reads = IsTrackingReads(read_only);
+    txn_table[txn->txn_id] = txn;
+  }
+
+  return txn;
+}
+
+void TransactionManager::UnregisterTransaction(Transaction *txn) {
+  if (txn->active_slot != INVALID_OID) {
+    auto &active_slot = active_slots[txn->active_slot];
+    active_slot.txn = nullptr;
+    active_slot.snapshot_cid = INVALID_CID;
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(txn_table_mutex);
+    if (txn_table.erase(txn->txn_id) > 0) txn_table_count--;
+  }
+}
+
 // Begin a new transaction
 Transaction *TransactionManager::BeginTransaction() {
-  Transaction *next_txn =
-      new Transaction(GetNextTransactionId(), GetLastCommitId());
+  Transaction *next_txn = RegisterTransaction(false);
 
   // Log the BEGIN TXN record
   {
@@ -78,30 +191,122 @@ Transaction *TransactionManager::BeginTransaction() {
   return next_txn;
 }
 
+Transaction *TransactionManager::BeginReadOnlyTransaction() {
+  // We still register the txn, so that its snapshot is never reclaimed
+  Transaction *next_txn = RegisterTransaction(true);
+
+  // Update the next txn
+  current_txn = next_txn;
+
+  return next_txn;
+}
+
+void TransactionManager::EndReadOnlyTransaction() {
+  // clear txn entry in txn table
+  EndTransaction(current_txn, false);
+
+  // drop a reference
+  current_txn->DecrementRefCount();
+
+  current_txn = nullptr;
+}
+
+Transaction *TransactionManager::GetTransaction(txn_id_t txn_id) {
+  for (auto &active_slot : active_slots) {
+    Transaction *txn = active_slot.txn;
+    if (txn != nullptr && txn->txn_id == txn_id) return txn;
+  }
+
+  std::lock_guard<std::mutex> lock(txn_table_mutex);
+
+  auto txn_itr = txn_table.find(txn_id);
+  if (txn_itr == txn_table.end()) return nullptr;
+
+  return txn_itr->second;
+}
+
+std::vector<Transaction *> TransactionManager::GetCurrentTransactions() {
+  std::vector<Transaction *> txns;
+
+  for (auto &active_slot : active_slots) {
+    Transaction *txn = active_slot.txn;
+    if (txn != nullptr) txns.push_back(txn);
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(txn_table_mutex);
+    for (auto entry : txn_table) txns.push_back(entry.second);
+  }
+
+  return txns;
+}
+
+cid_t TransactionManager::GetOldestActiveCid() {
+  // Future transactions see at least the last commit
+  // This must be read before the slots, see RegisterTransaction
+  cid_t oldest_cid = GetLastCommitId();
+
+  for (auto &active_slot : active_slots) {
+    cid_t snapshot_cid = active_slot.snapshot_cid;
+    if (snapshot_cid != INVALID_CID) {
+      oldest_cid = std::min(oldest_cid, snapshot_cid);
+    }
+  }
+
+  // Only lock if there are txns without a slot
+  if (txn_table_count > 0) {
+    std::lock_guard<std::mutex> lock(txn_table_mutex);
+    for (auto entry : txn_table) {
+      oldest_cid = std::min(oldest_cid, entry.second->GetLastCommitId());
+    }
+  }
+
+  return oldest_cid;
+}
+
+void TransactionManager::AdvanceCommitId(cid_t cid) {
+  if (next_cid >= cid) return;
+
+  // The commits of the log are all done
+  next_cid = cid;
+  last_cid = cid;
+}
+
 bool TransactionManager::IsValid(txn_id_t txn_id) {
   return (txn_id < next_txn_id);
 }
 
 void TransactionManager::ResetStates(void) {
   next_txn_id = ATOMIC_VAR_INIT(START_TXN_ID);
-  next_cid = ATOMIC_VAR_INIT(START_CID);
 
-  // BASE transaction
-  // All transactions are based on this transaction
-  delete last_txn;
-  last_txn = new Transaction(START_TXN_ID, START_CID);
-  last_txn->cid = START_CID;
+  // All transactions are based on the START_CID snapshot
+  next_cid = START_CID;
   last_cid = START_CID;
 
-  for (auto txn : txn_table) {
-    auto curr_txn = txn.second;
-    delete curr_txn;
+  for (auto &commit_slot : commit_ring) commit_slot.cid = INVALID_CID;
+
+  // the txns are reclaimed when their ref count drops to zero
+  // the threads keep their registry slots
+  for (auto &active_slot : active_slots) {
+    active_slot.txn = nullptr;
+    active_slot.snapshot_cid = INVALID_CID;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(txn_table_mutex);
+    txn_table.clear();
+    txn_table_count = 0;
   }
-  txn_table.clear();
 }
 
 void TransactionManager::EndTransaction(Transaction *txn,
                                         bool sync __attribute__((unused))) {
+  // Clear txn entry in the registry
+  UnregisterTransaction(txn);
+
+  // Nothing was logged for a read-only txn
+  if (txn->IsReadOnly()) return;
+
   // Log the END TXN record
   {
     auto &log_manager = logging::LogManager::GetInstance();
@@ -109,12 +314,27 @@ void TransactionManager::EndTransaction(Transaction *txn,
       auto logger = log_manager.GetBackendLogger();
       auto record = new logging::TransactionRecord(
           LOGRECORD_TYPE_TRANSACTION_END, txn->txn_id);
-      logger->Log(record);
 
       // Check for sync commit
       // If true, wait for the fronted logger to flush the data
-      if (log_manager.GetSyncCommit()) {
-        logger->WaitForFlushing();
+      // With group commit, we only wait for our own record, and not for
+      // everything else in the backend logger
+      if (log_manager.GetSyncCommit() && log_manager.GetGroupCommit()) {
+        auto durable = record->GetDurableFuture();
+        logger->Log(record);
+        durable.wait();
+      } else {
+        logger->Log(record);
+        if (log_manager.GetSyncCommit()) {
+          logger->WaitForFlushing();
+        }
+      }
+
+      // With several log streams, the commits before ours may be in the
+      // other streams, so wait until they are durable too
+      if (log_manager.GetSyncCommit() && txn->cid != INVALID_CID &&
+          log_manager.ActiveFrontendLoggerCount() > 1) {
+        log_manager.WaitForDurableCommit(txn->cid);
       }
     }
   }
@@ -129,51 +349,44 @@ TransactionManager &TransactionManager::GetInstance() {
   return txn_manager;
 }
 
+/**
+ * Commits take their cid with a fetch-add, and finish in any order. A done
+ * commit marks its slot in the pending commit ring, and last_cid is then
+ * moved past all the consecutive done commits in one step, by whichever
+ * committer gets there first. So snapshots never include a commit whose
+ * modifications are still being applied, and no commit waits on a latch.
+ */
 void TransactionManager::BeginCommitPhase(Transaction *txn) {
-  // successor in the transaction list will point to us
-  txn->IncrementRefCount();
-
-  {
-    std::lock_guard<std::mutex> lock(txn_table_mutex);
-
-    // append to the pending transaction list
-    last_txn->next = txn;
-
-    // the last transaction pointer also points to us
-    txn->IncrementRefCount();
-
-    // assign cid to the txn
-    txn->cid = last_txn->cid + 1;
-
-    auto tmp = last_txn;
-    last_txn = txn;
-
-    // drop a reference to previous last transaction pointer
-    tmp->DecrementRefCount();
-  }
+  // assign cid to the txn
+  txn->cid = ++next_cid;
 }
 
 void TransactionManager::CommitModifications(Transaction *txn, bool sync
                                              __attribute__((unused))) {
   auto &manager = catalog::Manager::GetInstance();
 
+  // The write sets visit one tile group at a time, so we only look up
+  // a tile group when we move on to the next one
+  oid_t tile_group_id = INVALID_OID;
+  std::shared_ptr<storage::TileGroup> tile_group;
+
   // (A) commit inserts
-  auto inserted_tuples = txn->GetInsertedTuples();
-  for (auto entry : inserted_tuples) {
-    oid_t tile_group_id = entry.first;
-    auto tile_group = manager.GetTileGroup(tile_group_id);
-    for (auto tuple_slot : entry.second)
-      tile_group->CommitInsertedTuple(tuple_slot, txn->txn_id, txn->cid);
-  }
+  txn->GetInsertedTuples().ForEach([&](oid_t block, oid_t tuple_slot) {
+    if (block != tile_group_id) {
+      tile_group_id = block;
+      tile_group = manager.GetTileGroup(tile_group_id);
+    }
+    tile_group->CommitInsertedTuple(tuple_slot, txn->txn_id, txn->cid);
+  });
 
   // (B) commit deletes
-  auto deleted_tuples = txn->GetDeletedTuples();
-  for (auto entry : deleted_tuples) {
-    oid_t tile_group_id = entry.first;
-    auto tile_group = manager.GetTileGroup(tile_group_id);
-    for (auto tuple_slot : entry.second)
-      tile_group->CommitDeletedTuple(tuple_slot, txn->txn_id, txn->cid);
-  }
+  txn->GetDeletedTuples().ForEach([&](oid_t block, oid_t tuple_slot) {
+    if (block != tile_group_id) {
+      tile_group_id = block;
+      tile_group = manager.GetTileGroup(tile_group_id);
+    }
+    tile_group->CommitDeletedTuple(tuple_slot, txn->txn_id, txn->cid);
+  });
 
   // Log the COMMIT TXN record
   {
@@ -182,92 +395,140 @@ void TransactionManager::CommitModifications(Transaction *txn, bool sync
       auto logger = log_manager.GetBackendLogger();
       auto record = new logging::TransactionRecord(
           LOGRECORD_TYPE_TRANSACTION_COMMIT, txn->txn_id);
+      record->SetCommitId(txn->cid);
       logger->Log(record);
     }
   }
 }
 
-void TransactionManager::CommitPendingTransactions(
-    std::vector<Transaction *> &pending_txns, Transaction *txn) {
-  // add ourself to the list
-  pending_txns.push_back(txn);
+void TransactionManager::AdvanceLastCommitId() {
+  cid_t current_cid = last_cid;
 
-  // commit all pending transactions
-  auto next_txn = txn->next;
+  while (true) {
+    // Skip over the consecutive commits that are done
+    cid_t done_cid = current_cid;
+    while (commit_ring[(done_cid + 1) % COMMIT_RING_SIZE].cid ==
+           done_cid + 1) {
+      done_cid++;
+    }
 
-  while (next_txn != nullptr && next_txn->waiting_to_commit == true) {
-    // try to increment last finished cid
-    if (atomic_cas(&last_cid, next_txn->cid - 1, next_txn->cid)) {
-      // if that worked, add transaction to list
-      pending_txns.push_back(next_txn);
-      LOG_TRACE("Pending Txn  : %lu ", next_txn->txn_id);
+    // Nothing to do, the next commit is not done yet
+    if (done_cid == current_cid) break;
 
-      next_txn = next_txn->next;
-      continue;
-    }
-    // it did not work, so some other txn must have squeezed in
-    // so, stop processing commit dependencies
-    else {
-      break;
+    // Make them visible at once; if some other txn moved last_cid first,
+    // try again from there
+    if (last_cid.compare_exchange_weak(current_cid, done_cid)) {
+      LOG_TRACE("Advanced last cid : %lu -> %lu ", current_cid, done_cid);
+      current_cid = done_cid;
     }
   }
 }
 
-std::vector<Transaction *> TransactionManager::EndCommitPhase(Transaction *txn,
-                                                              bool sync) {
-  std::vector<Transaction *> txn_list;
+void TransactionManager::MarkCommitDone(cid_t cid) {
+  // The slot was last used by the commit COMMIT_RING_SIZE cids ago, so wait
+  // till it is visible. This only happens with that many commits in flight.
+  while (cid - last_cid > COMMIT_RING_SIZE) {
+    std::this_thread::yield();
+  }
 
-  // try to increment last commit id
-  if (atomic_cas(&last_cid, txn->cid - 1, txn->cid)) {
-    LOG_TRACE("update lcid worked : %lu ", txn->txn_id);
+  // mark the commit as done
+  commit_ring[cid % COMMIT_RING_SIZE].cid = cid;
 
-    // everything went fine and the txn was committed
-    // if that worked, commit all pending transactions
-    CommitPendingTransactions(txn_list, txn);
+  // make it visible along with the other done commits
+  AdvanceLastCommitId();
+}
 
-  }
-  // it did not work, so add to waiting list
-  // some other transaction with lower commit id will commit us later
-  else {
-    LOG_TRACE("add to wait list : %lu ", txn->txn_id);
+void TransactionManager::EndCommitPhase(Transaction *txn, bool sync) {
+  MarkCommitDone(txn->cid);
+
+  // clear txn entry in txn table
+  EndTransaction(txn, sync);
+}
 
-    txn->waiting_to_commit = true;
+/**
+ * The read set is validated after the txn takes its cid. Its writes are
+ * already owned in the tuple headers by then. A txn that takes over one of
+ * our read versions after the validation gets a larger cid, so it is
+ * serialized after us. Any txn that deleted, or still owns, one of our
+ * read versions fails the validation.
+ */
+bool TransactionManager::ValidateReadSet(Transaction *txn) {
+  auto &manager = catalog::Manager::GetInstance();
+
+  oid_t tile_group_id = INVALID_OID;
+  storage::TileGroupHeader *tile_group_header = nullptr;
 
-    // make sure that the transaction we are waiting for has not finished
-    // before we could add ourselves to the list of pending transactions
-    // we try incrementing the last finished cid again
-    if (atomic_cas(&last_cid, txn->cid - 1, txn->cid)) {
-      // it worked on the second try
-      txn->waiting_to_commit = false;
+  for (auto &entry : txn->GetReadSet()) {
+    // Our own inserts are not committed, nobody else can see them
+    if (entry.begin_cid == MAX_CID) continue;
 
-      CommitPendingTransactions(txn_list, txn);
+    if (entry.location.block != tile_group_id) {
+      tile_group_id = entry.location.block;
+      auto tile_group = manager.GetTileGroup(tile_group_id);
+      if (tile_group == nullptr) return false;
+      tile_group_header = tile_group->GetHeader();
     }
-  }
 
-  // clear txn entry in txn table
-  EndTransaction(txn, sync);
+    oid_t tuple_slot = entry.location.offset;
+    txn_id_t owner_id = tile_group_header->GetTransactionId(tuple_slot);
 
-  return std::move(txn_list);
+    // Our own writes are fine
+    if (owner_id == txn->txn_id) continue;
+
+    // Being written by another txn
+    if (owner_id != INITIAL_TXN_ID) return false;
+
+    // Deleted since we read it, or the slot holds another version now
+    if (tile_group_header->GetEndCommitId(tuple_slot) != MAX_CID ||
+        tile_group_header->GetBeginCommitId(tuple_slot) != entry.begin_cid) {
+      return false;
+    }
+  }
+
+  return true;
 }
 
-void TransactionManager::CommitTransaction(bool sync) {
+Result TransactionManager::CommitTransaction(bool sync) {
+  // Nothing to commit for a read-only txn, unless it tried to write
+  if (current_txn->IsReadOnly()) {
+    Result result = current_txn->GetResult();
+    EndReadOnlyTransaction();
+    return result == RESULT_FAILURE ? RESULT_FAILURE : RESULT_SUCCESS;
+  }
+
   LOG_INFO("Committing peloton txn : %lu ", current_txn->GetTransactionId());
   // begin commit phase : get cid and add to transaction list
   BeginCommitPhase(current_txn);
 
+  // validate the read set under OCC
+  if (current_txn->IsTrackingReads() && ValidateReadSet(current_txn) == false) {
+    LOG_TRACE("Read set validation failed : %lu ",
+              current_txn->GetTransactionId());
+    validation_abort_count++;
+
+    // Nothing is committed under our cid
+    MarkCommitDone(current_txn->cid);
+
+    current_txn->SetResult(RESULT_ABORTED);
+    AbortTransaction();
+    return RESULT_ABORTED;
+  }
+
   // commit all modifications
   CommitModifications(current_txn, sync);
 
-  // end commit phase : increment last_cid and process pending txns if needed
-  std::vector<Transaction *> committed_txns = EndCommitPhase(current_txn, sync);
+  // end commit phase : advance last_cid past the done commits
+  EndCommitPhase(current_txn, sync);
 
-  // process all committed txns
-  for (auto committed_txn : committed_txns) committed_txn->DecrementRefCount();
+  // drop a reference
+  current_txn->DecrementRefCount();
 
   // XXX LOG : group commit entry
   // we already record commit entry in CommitModifications, isn't it?
 
   current_txn = nullptr;
+
+  return RESULT_SUCCESS;
 }
 
 //===--------------------------------------------------------------------===//
@@ -275,6 +536,12 @@ void TransactionManager::CommitTransaction(bool sync) {
 //===--------------------------------------------------------------------===//
 
 void TransactionManager::AbortTransaction() {
+  // Nothing to roll back for a read-only txn
+  if (current_txn->IsReadOnly()) {
+    EndReadOnlyTransaction();
+    return;
+  }
+
   LOG_INFO("Aborting peloton txn : %lu ", current_txn->GetTransactionId());
   // Log the ABORT TXN record
   {
@@ -289,24 +556,27 @@ void TransactionManager::AbortTransaction() {
 
   auto &manager = catalog::Manager::GetInstance();
 
+  oid_t tile_group_id = INVALID_OID;
+  std::shared_ptr<storage::TileGroup> tile_group;
+
   // (A) rollback inserts
   const txn_id_t txn_id = current_txn->GetTransactionId();
-  auto inserted_tuples = current_txn->GetInsertedTuples();
-  for (auto entry : inserted_tuples) {
-    oid_t tile_group_id = entry.first;
-    auto tile_group = manager.GetTileGroup(tile_group_id);
-    for (auto tuple_slot : entry.second)
-      tile_group->AbortInsertedTuple(tuple_slot);
-  }
+  current_txn->GetInsertedTuples().ForEach([&](oid_t block, oid_t tuple_slot) {
+    if (block != tile_group_id) {
+      tile_group_id = block;
+      tile_group = manager.GetTileGroup(tile_group_id);
+    }
+    tile_group->AbortInsertedTuple(tuple_slot);
+  });
 
   // (B) rollback deletes
-  auto deleted_tuples = current_txn->GetDeletedTuples();
-  for (auto entry : current_txn->GetDeletedTuples()) {
-    oid_t tile_group_id = entry.first;
-    auto tile_group = manager.GetTileGroup(tile_group_id);
-    for (auto tuple_slot : entry.second)
-      tile_group->AbortDeletedTuple(tuple_slot, txn_id);
-  }
+  current_txn->GetDeletedTuples().ForEach([&](oid_t block, oid_t tuple_slot) {
+    if (block != tile_group_id) {
+      tile_group_id = block;
+      tile_group = manager.GetTileGroup(tile_group_id);
+    }
+    tile_group->AbortDeletedTuple(tuple_slot, txn_id);
+  });
 
   EndTransaction(current_txn, false);
 
@@ -25,6 +25,14 @@ namespace concurrency {
 
 typedef unsigned int TransactionId;
 
+// Number of commits that can be in flight before their cids are reused in
+// the pending commit ring
+#define COMMIT_RING_SIZE 1024
+
+// Number of threads that can announce their transactions in the active
+// transaction registry, the others fall back to the txn table
+#define ACTIVE_TXN_SLOT_COUNT 256
+
 class Transaction;
 
 extern thread_local Transaction *current_txn;
@@ -45,6 +53,21 @@ class TransactionManager {
   // Get last commit id for visibility checks
   cid_t GetLastCommitId() { return last_cid; }
 
+  // Get the last assigned commit id, the commits up to it may still be
+  // running
+  cid_t GetLastAssignedCommitId() { return next_cid; }
+
+  // Concurrency control policy of the new transactions
+  // Under OCC, transactions keep a read set that is validated at commit,
+  // which makes them serializable. Read-only transactions still only read
+  // their snapshot.
+  void SetConcurrencyType(ConcurrencyType type) { concurrency_type = type; }
+
+  ConcurrencyType GetConcurrencyType() const { return concurrency_type; }
+
+  // Number of txns aborted by the read set validation
+  size_t GetValidationAbortCount() const { return validation_abort_count; }
+
   //===--------------------------------------------------------------------===//
   // Transaction processing
   //===--------------------------------------------------------------------===//
@@ -54,6 +77,11 @@ class TransactionManager {
   // Begin a new transaction
   Transaction *BeginTransaction();
 
+  // Begin a read-only transaction
+  // It only takes a snapshot, it gets no commit id and is not logged.
+  // CommitTransaction and AbortTransaction just release it.
+  Transaction *BeginReadOnlyTransaction();
+
   // Get entry in transaction table
   Transaction *GetTransaction(txn_id_t txn_id);
 
@@ -63,24 +91,35 @@ class TransactionManager {
   // Get the list of current transactions
   std::vector<Transaction *> GetCurrentTransactions();
 
+  // Get the oldest snapshot still in use by an active transaction.
+  // Versions invalidated at or before it are not visible to any
+  // active or future transaction. Does not take any lock, unless some
+  // transactions had to fall back to the txn table.
+  cid_t GetOldestActiveCid();
+
+  // Give back the registry slot of an exiting thread
+  void ReleaseActiveSlot(oid_t slot);
+
   // validity checks
   bool IsValid(txn_id_t txn_id);
 
   // used by recovery testing
   void ResetStates(void);
 
+  // Make the next commit ids follow the given cid, which recovery found in
+  // the log. Only called while nothing commits.
+  void AdvanceCommitId(cid_t cid);
+
   // COMMIT
 
   void BeginCommitPhase(Transaction *txn);
 
   void CommitModifications(Transaction *txn, bool sync = true);
 
-  void CommitPendingTransactions(std::vector<Transaction *> &txns,
-                                 Transaction *txn);
-
-  std::vector<Transaction *> EndCommitPhase(Transaction *txn, bool sync = true);
+  void EndCommitPhase(Transaction *txn, bool sync = true);
 
-  void CommitTransaction(bool sync = true);
+  // returns RESULT_ABORTED if the txn failed its validation and was aborted
+  Result CommitTransaction(bool sync = true);
 
   // ABORT
 
@@ -93,18 +132,78 @@ class TransactionManager {
 
   std::atomic<txn_id_t> next_txn_id;
 
+  // last assigned commit id
   std::atomic<cid_t> next_cid;
 
-  cid_t last_cid __attribute__((aligned(16)));
+  // all the commits up to this commit id are done
+  std::atomic<cid_t> last_cid;
+
+  // Slot of a commit in the pending commit ring
+  // Padded, as neighbouring slots are written by concurrent commits
+  struct CommitSlot {
+    std::atomic<cid_t> cid;
+  } __attribute__((aligned(64)));
+
+  // Done commits that may not be visible yet, at their cid's slot
+  CommitSlot commit_ring[COMMIT_RING_SIZE];
+
+  // Slot of a thread in the active transaction registry
+  // Only the owning thread writes it, padded to avoid false sharing
+  struct ActiveTxnSlot {
+    // owned by a thread ?
+    std::atomic<bool> claimed;
 
-  Transaction *last_txn;
+    // snapshot of the active txn, INVALID_CID if there is none
+    std::atomic<cid_t> snapshot_cid;
 
-  // Table tracking all active transactions
+    // active txn of the owning thread
+    std::atomic<Transaction *> txn;
+  } __attribute__((aligned(64)));
+
+  // Active transaction registry
+  ActiveTxnSlot active_slots[ACTIVE_TXN_SLOT_COUNT];
+
+  // Table tracking the active transactions without a registry slot,
+  // that is nested txns or threads beyond ACTIVE_TXN_SLOT_COUNT
   // Our transaction id -> our transaction
   // Sync access with txn_table_mutex
   std::map<txn_id_t, Transaction *> txn_table;
 
   std::mutex txn_table_mutex;
+
+  // number of txns that are or are about to be in the txn table
+  std::atomic<size_t> txn_table_count;
+
+  // concurrency control policy
+  ConcurrencyType concurrency_type;
+
+  std::atomic<size_t> validation_abort_count;
+
+  // Get the registry slot of the calling thread, if it has one
+  oid_t GetActiveSlot();
+
+  // Register the txn and take its snapshot
+  Transaction *RegisterTransaction(bool read_only);
+
+  // Remove the txn from the registry
+  void UnregisterTransaction(Transaction *txn);
+
+  // Move last_cid past the commits that are done
+  void AdvanceLastCommitId();
+
+  // Mark the commit as done and make it visible when possible
+  void MarkCommitDone(cid_t cid);
+
+  // Check that no read version was changed by another txn
+  bool ValidateReadSet(Transaction *txn);
+
+  // Should a new txn keep a read set ?
+  bool IsTrackingReads(bool read_only) const {
+    return read_only == false && concurrency_type == CONCURRENCY_TYPE_OCC;
+  }
+
+  // Release the current read-only transaction
+  void EndReadOnlyTransaction();
 };
 
 }  // End concurrency namespace
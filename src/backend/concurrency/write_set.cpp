@@ -0,0 +1,90 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// write_set.cpp
+//
+// Identification: src/backend/concurrency/write_set.cpp
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "backend/concurrency/write_set.h"
+
+#include <algorithm>
+
+namespace peloton {
+namespace concurrency {
+
+// Fibonacci hashing of the block into the index
+static inline size_t GetIndexSlot(oid_t block, size_t index_size) {
+  return (block * 2654435769u) & (index_size - 1);
+}
+
+WriteSet::WriteSet() : group_index(WRITE_SET_INDEX_SIZE, INVALID_OID) {}
+
+void WriteSet::Add(const ItemPointer &location) {
+  oid_t group_offset = GetGroup(location.block);
+  auto &group = groups[group_offset];
+
+  oid_t entry_offset = entries.size();
+  entries.push_back({location.offset, INVALID_OID});
+
+  // Chain it to the end of its group
+  if (group.first_entry == INVALID_OID) {
+    group.first_entry = entry_offset;
+  } else {
+    entries[group.last_entry].next_entry = entry_offset;
+  }
+  group.last_entry = entry_offset;
+}
+
+void WriteSet::Clear() {
+  if (groups.empty() == false) {
+    std::fill(group_index.begin(), group_index.end(), INVALID_OID);
+  }
+
+  entries.clear();
+  groups.clear();
+}
+
+oid_t WriteSet::GetGroup(oid_t block) {
+  // Keep the index at most half full
+  if ((groups.size() + 1) * 2 > group_index.size()) {
+    GrowIndex();
+  }
+
+  size_t index_size = group_index.size();
+  size_t slot = GetIndexSlot(block, index_size);
+
+  // Linear probing
+  while (group_index[slot] != INVALID_OID) {
+    oid_t group_offset = group_index[slot];
+    if (groups[group_offset].block == block) return group_offset;
+    slot = (slot + 1) & (index_size - 1);
+  }
+
+  oid_t group_offset = groups.size();
+  groups.push_back({block, INVALID_OID, INVALID_OID});
+  group_index[slot] = group_offset;
+
+  return group_offset;
+}
+
+void WriteSet::GrowIndex() {
+  size_t index_size = group_index.size() * 2;
+  group_index.assign(index_size, INVALID_OID);
+
+  // Re-insert all the groups
+  for (oid_t group_offset = 0; group_offset < groups.size(); group_offset++) {
+    size_t slot = GetIndexSlot(groups[group_offset].block, index_size);
+    while (group_index[slot] != INVALID_OID) {
+      slot = (slot + 1) & (index_size - 1);
+    }
+    group_index[slot] = group_offset;
+  }
+}
+
+}  // End concurrency namespace
+}  // End peloton namespace
@@ -0,0 +1,112 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// write_set.h
+//
+// Identification: src/backend/concurrency/write_set.h
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "backend/common/types.h"
+
+#include <vector>
+
+namespace peloton {
+namespace concurrency {
+
+// Initial number of slots in the group index (power of two)
+#define WRITE_SET_INDEX_SIZE 16
+
+//===--------------------------------------------------------------------===//
+// Write Set
+//===--------------------------------------------------------------------===//
+
+/**
+ * Append-only set of tuple locations written by a transaction.
+ *
+ * The locations are kept in a flat array, and the entries of the same tile
+ * group are chained together. A small open-addressing index maps a tile
+ * group to its chain, so that ForEach can visit the locations one tile group
+ * at a time. Clear keeps all the memory around, so a transaction object
+ * that is reused does not allocate once its write set is large enough.
+ */
+class WriteSet {
+  WriteSet(WriteSet const &) = delete;
+
+ public:
+  WriteSet();
+
+  // Append a location
+  void Add(const ItemPointer &location);
+
+  // Drop all the locations, but keep the memory
+  void Clear();
+
+  // Visit all the locations, grouped by tile group
+  // function is called with the tile group id and the tuple slot
+  template <typename Function>
+  void ForEach(Function function) const {
+    for (auto &group : groups) {
+      for (oid_t entry_itr = group.first_entry; entry_itr != INVALID_OID;
+           entry_itr = entries[entry_itr].next_entry) {
+        function(group.block, entries[entry_itr].offset);
+      }
+    }
+  }
+
+  //===--------------------------------------------------------------------===//
+  // Accessors
+  //===--------------------------------------------------------------------===//
+
+  size_t GetSize() const { return entries.size(); }
+
+  bool IsEmpty() const { return entries.empty(); }
+
+  // Get the number of distinct tile groups
+  size_t GetGroupCount() const { return groups.size(); }
+
+ private:
+  // Find the group of the block, or add a new one
+  oid_t GetGroup(oid_t block);
+
+  // Double the size of the group index
+  void GrowIndex();
+
+  //===--------------------------------------------------------------------===//
+  // MEMBERS
+  //===--------------------------------------------------------------------===//
+
+  struct Entry {
+    // tuple slot
+    oid_t offset;
+
+    // next entry in the same tile group
+    oid_t next_entry;
+  };
+
+  struct Group {
+    // tile group id
+    oid_t block;
+
+    oid_t first_entry;
+
+    oid_t last_entry;
+  };
+
+  // entries in the order they were added
+  std::vector<Entry> entries;
+
+  // groups in the order they were first seen
+  std::vector<Group> groups;
+
+  // open-addressing index : block -> group, INVALID_OID marks a free slot
+  std::vector<oid_t> group_index;
+};
+
+}  // End concurrency namespace
+}  // End peloton namespace
@@ -94,6 +94,17 @@ bool DeleteExecutor::DExecute() {
 
     peloton::ItemPointer delete_location(tile_group_id, physical_tuple_id);
 
+    // try to delete the tuple
+    // this might fail due to a concurrent operation that has latched the tuple
+    // we try it before logging, so that a conflict aborts without extra work
+    bool status = target_table_->DeleteTuple(transaction_, delete_location);
+
+    if (status == false) {
+      LOG_INFO("Fail to delete. Set txn failure");
+      transaction_->SetResult(peloton::Result::RESULT_FAILURE);
+      return false;
+    }
+
     // Logging
     {
       auto &log_manager = logging::LogManager::GetInstance();
@@ -108,16 +119,6 @@ bool DeleteExecutor::DExecute() {
       }
     }
 
-    // try to delete the tuple
-    // this might fail due to a concurrent operation that has latched the tuple
-    bool status = target_table_->DeleteTuple(transaction_, delete_location);
-
-    if (status == false) {
-      LOG_INFO("Fail to delete. Set txn failure");
-      transaction_->SetResult(peloton::Result::RESULT_FAILURE);
-      return false;
-    }
-
     executor_context_->num_processed += 1;  // deleted one
     transaction_->RecordDelete(delete_location);
   }
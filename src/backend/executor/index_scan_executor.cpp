@@ -24,7 +24,9 @@
 #include "backend/expression/container_tuple.h"
 #include "backend/index/index.h"
 #include "backend/storage/data_table.h"
+#include "backend/storage/tile.h"
 #include "backend/storage/tile_group.h"
+#include "backend/storage/tile_group_header.h"
 #include "backend/common/logger.h"
 
 namespace peloton {
@@ -174,6 +176,19 @@ bool IndexScanExecutor::ExecIndexLookup() {
   result = LogicalTileFactory::WrapTileGroups(tuple_locations, full_column_ids_,
                                               txn_id, commit_id);
 
+  // Record the versions we read, for validation under OCC
+  if (transaction_->IsTrackingReads()) {
+    for (auto logical_tile : result) {
+      auto tile_group = logical_tile->GetBaseTile(0)->GetTileGroup();
+      auto tile_group_header = tile_group->GetHeader();
+      for (auto tuple_id : logical_tile->GetPositionLists()[0]) {
+        transaction_->RecordRead(
+            ItemPointer(tile_group->GetTileGroupId(), tuple_id),
+            tile_group_header->GetBeginCommitId(tuple_id));
+      }
+    }
+  }
+
   done_ = true;
 
   LOG_TRACE("Result tiles : %lu", result.size());
@@ -78,8 +78,8 @@ bool InsertExecutor::DExecute() {
     auto target_table_schema = target_table_->GetSchema();
     auto column_count = target_table_schema->GetColumnCount();
 
-    std::unique_ptr<storage::Tuple> tuple(
-        new storage::Tuple(target_table_schema, true));
+    std::vector<std::unique_ptr<storage::Tuple>> tuples;
+    std::vector<const storage::Tuple *> batch;
 
     // Go over the logical tile
     for (oid_t tuple_id : *logical_tile) {
@@ -87,21 +87,27 @@ bool InsertExecutor::DExecute() {
                                                         tuple_id);
 
       // Materialize the logical tile tuple
+      tuples.emplace_back(new storage::Tuple(target_table_schema, true));
       for (oid_t column_itr = 0; column_itr < column_count; column_itr++)
-        tuple->SetValue(column_itr, cur_tuple.GetValue(column_itr),
-                        executor_pool);
-
-      peloton::ItemPointer location =
-          target_table_->InsertTuple(transaction_, tuple.get());
-      if (location.block == INVALID_OID) {
-        transaction_->SetResult(peloton::Result::RESULT_FAILURE);
-        return false;
-      }
-      transaction_->RecordInsert(location);
+        tuples.back()->SetValue(column_itr, cur_tuple.GetValue(column_itr),
+                                executor_pool);
+
+      batch.push_back(tuples.back().get());
+    }
+
+    // Insert the whole tile as one batch
+    auto locations = target_table_->InsertTuples(transaction_, batch);
+    if (locations.size() != batch.size()) {
+      transaction_->SetResult(peloton::Result::RESULT_FAILURE);
+      return false;
+    }
 
-      executor_context_->num_processed += 1;  // insert one
+    for (auto location : locations) {
+      transaction_->RecordInsert(location);
     }
 
+    executor_context_->num_processed += locations.size();
+
     return true;
   }
   // Inserting a collection of tuples from plan node
@@ -125,33 +131,38 @@ bool InsertExecutor::DExecute() {
     }
 
     // Bulk Insert Mode
-    for (oid_t insert_itr = 0; insert_itr < bulk_insert_count; insert_itr++) {
-      // Carry out insertion
-      ItemPointer location =
-          target_table_->InsertTuple(transaction_, tuple.get());
+    // Carry out insertion as one batch
+    std::vector<const storage::Tuple *> batch(bulk_insert_count, tuple.get());
+    auto locations = target_table_->InsertTuples(transaction_, batch);
+
+    if (locations.size() != batch.size()) {
+      LOG_INFO("Failed to Insert. Set txn failure.");
+      transaction_->SetResult(peloton::Result::RESULT_FAILURE);
+      return false;
+    }
+
+    for (auto location : locations) {
       LOG_INFO("Inserted into location: %lu, %lu", location.block,
                location.offset);
-
-      if (location.block == INVALID_OID) {
-        LOG_INFO("Failed to Insert. Set txn failure.");
-        transaction_->SetResult(peloton::Result::RESULT_FAILURE);
-        return false;
-      }
       transaction_->RecordInsert(location);
+    }
+
+    // Logging
+    if (locations.empty() == false) {
+      auto &log_manager = logging::LogManager::GetInstance();
 
-      // Logging
-      {
-        auto &log_manager = logging::LogManager::GetInstance();
+      if (log_manager.IsInLoggingMode()) {
+        auto logger = log_manager.GetBackendLogger();
+        std::vector<logging::LogRecord *> records;
 
-        if (log_manager.IsInLoggingMode()) {
-          auto logger = log_manager.GetBackendLogger();
-          auto record = logger->GetTupleRecord(
+        for (auto location : locations) {
+          records.push_back(logger->GetTupleRecord(
               LOGRECORD_TYPE_TUPLE_INSERT, transaction_->GetTransactionId(),
               target_table_->GetOid(), location, INVALID_ITEMPOINTER,
-              tuple.get());
-
-          logger->Log(record);
+              tuple.get()));
         }
+
+        logger->LogBatch(records);
       }
     }
 
@@ -16,15 +16,18 @@
 #include <utility>
 #include <vector>
 
+#include "backend/common/numa_manager.h"
 #include "backend/common/types.h"
 #include "backend/executor/logical_tile.h"
 #include "backend/executor/logical_tile_factory.h"
 #include "backend/executor/executor_context.h"
 #include "backend/expression/abstract_expression.h"
 #include "backend/expression/container_tuple.h"
+#include "backend/expression/tuple_value_expression.h"
 #include "backend/storage/data_table.h"
 #include "backend/storage/tile_group_header.h"
 #include "backend/storage/tile.h"
+#include "backend/storage/zone_map.h"
 #include "backend/common/logger.h"
 
 namespace peloton {
@@ -38,6 +41,12 @@ SeqScanExecutor::SeqScanExecutor(const planner::AbstractPlan *node,
                                  ExecutorContext *executor_context)
     : AbstractScanExecutor(node, executor_context) {}
 
+/**
+ * @brief Lets the thread run on all its cpus again, if the scan was cut
+ * short.
+ */
+SeqScanExecutor::~SeqScanExecutor() { UnpinFromNumaNode(); }
+
 /**
  * @brief Let base class DInit() first, then do mine.
  * @return true on success, false otherwise.
@@ -53,6 +62,9 @@ bool SeqScanExecutor::DInit() {
   target_table_ = node.GetTable();
 
   current_tile_group_offset_ = START_OID;
+  skipped_tile_group_count_ = 0;
+  numa_node_ = -1;
+  numa_range_count_ = 0;
 
   if (target_table_ != nullptr) {
     table_tile_group_count_ = target_table_->GetTileGroupCount();
@@ -116,6 +128,21 @@ bool SeqScanExecutor::DExecute() {
       auto tile_group =
           target_table_->GetTileGroup(current_tile_group_offset_++);
 
+      // Skip the tile group if its zone map rules out the predicate
+      if (predicate_ != nullptr &&
+          CanSkipTileGroup(tile_group.get(), predicate_)) {
+        skipped_tile_group_count_++;
+        LOG_TRACE("Skipped tile group %lu using zone map",
+                  tile_group->GetTileGroupId());
+        continue;
+      }
+
+      // Scan the tile group on its node
+      PinToNumaNode(tile_group->GetNumaNode());
+
+      // Read ahead the tiles if they are backed by a file
+      tile_group->AdviseSequentialScan();
+
       storage::TileGroupHeader *tile_group_header = tile_group->GetHeader();
 
       auto transaction_ = executor_context_->GetTransaction();
@@ -150,6 +177,15 @@ bool SeqScanExecutor::DExecute() {
         }
       }
 
+      // Record the versions we read, for validation under OCC
+      if (transaction_->IsTrackingReads()) {
+        for (auto tuple_id : position_list) {
+          transaction_->RecordRead(
+              ItemPointer(tile_group->GetTileGroupId(), tuple_id),
+              tile_group_header->GetBeginCommitId(tuple_id));
+        }
+      }
+
       logical_tile->AddPositionList(std::move(position_list));
 
       // Don't return empty tiles
@@ -160,10 +196,123 @@ bool SeqScanExecutor::DExecute() {
       SetOutput(logical_tile.release());
       return true;
     }
+
+    UnpinFromNumaNode();
   }
 
+  LOG_TRACE("Seq Scan executor :: skipped %lu tile groups",
+            skipped_tile_group_count_);
+
   return false;
 }
 
+/**
+ * @brief Pins the thread to the node at the start of every range of tile
+ * groups on the same node, so that they are scanned from local memory.
+ * The cpus of the thread are saved first, to be restored after the scan.
+ * @param numa_node Node of the next tile group.
+ */
+void SeqScanExecutor::PinToNumaNode(int numa_node) {
+  if (numa_node == numa_node_) return;
+
+  numa_node_ = numa_node;
+  numa_range_count_++;
+
+  auto &numa_manager = NumaManager::GetInstance();
+  if (numa_manager.IsAvailable() == false) return;
+
+  if (thread_pinned_ == false) {
+    if (numa_manager.GetThreadCpus(unpinned_cpus_) == false) return;
+    thread_pinned_ = true;
+  }
+
+  numa_manager.PinThread(numa_node);
+}
+
+/**
+ * @brief Lets the thread run on the cpus it had before the scan.
+ */
+void SeqScanExecutor::UnpinFromNumaNode() {
+  if (thread_pinned_ == false) return;
+
+  NumaManager::GetInstance().SetThreadCpus(unpinned_cpus_);
+  thread_pinned_ = false;
+}
+
+/**
+ * @brief Checks the tile group's zone map against the predicate.
+ * Only conjunctions of simple comparisons between a column and a
+ * constant or parameter are considered, everything else is kept.
+ * @return true if no tuple in the tile group can satisfy the predicate.
+ */
+bool SeqScanExecutor::CanSkipTileGroup(
+    const storage::TileGroup *tile_group,
+    const expression::AbstractExpression *expr) const {
+  auto expr_type = expr->GetExpressionType();
+
+  switch (expr_type) {
+    case EXPRESSION_TYPE_CONJUNCTION_AND:
+      return CanSkipTileGroup(tile_group, expr->GetLeft()) ||
+             CanSkipTileGroup(tile_group, expr->GetRight());
+
+    case EXPRESSION_TYPE_CONJUNCTION_OR:
+      return CanSkipTileGroup(tile_group, expr->GetLeft()) &&
+             CanSkipTileGroup(tile_group, expr->GetRight());
+
+    case EXPRESSION_TYPE_COMPARE_EQUAL:
+    case EXPRESSION_TYPE_COMPARE_NOTEQUAL:
+    case EXPRESSION_TYPE_COMPARE_LESSTHAN:
+    case EXPRESSION_TYPE_COMPARE_GREATERTHAN:
+    case EXPRESSION_TYPE_COMPARE_LESSTHANOREQUALTO:
+    case EXPRESSION_TYPE_COMPARE_GREATERTHANOREQUALTO:
+      break;
+
+    default:
+      return false;
+  }
+
+  auto left = expr->GetLeft();
+  auto right = expr->GetRight();
+  if (left == nullptr || right == nullptr) return false;
+
+  // Normalize to "column <op> value"
+  if (right->GetExpressionType() == EXPRESSION_TYPE_VALUE_TUPLE) {
+    std::swap(left, right);
+    switch (expr_type) {
+      case EXPRESSION_TYPE_COMPARE_LESSTHAN:
+        expr_type = EXPRESSION_TYPE_COMPARE_GREATERTHAN;
+        break;
+      case EXPRESSION_TYPE_COMPARE_GREATERTHAN:
+        expr_type = EXPRESSION_TYPE_COMPARE_LESSTHAN;
+        break;
+      case EXPRESSION_TYPE_COMPARE_LESSTHANOREQUALTO:
+        expr_type = EXPRESSION_TYPE_COMPARE_GREATERTHANOREQUALTO;
+        break;
+      case EXPRESSION_TYPE_COMPARE_GREATERTHANOREQUALTO:
+        expr_type = EXPRESSION_TYPE_COMPARE_LESSTHANOREQUALTO;
+        break;
+      default:
+        break;
+    }
+  }
+
+  if (left->GetExpressionType() != EXPRESSION_TYPE_VALUE_TUPLE) return false;
+
+  auto right_type = right->GetExpressionType();
+  if (right_type != EXPRESSION_TYPE_VALUE_CONSTANT &&
+      right_type != EXPRESSION_TYPE_VALUE_PARAMETER)
+    return false;
+
+  auto tuple_value_expr =
+      static_cast<const expression::TupleValueExpression *>(left);
+  if (tuple_value_expr->GetTupleIdx() != 0) return false;
+
+  oid_t column_id = tuple_value_expr->GetColumnId();
+  Value value = right->Evaluate(nullptr, nullptr, executor_context_);
+
+  auto zone_map = tile_group->GetZoneMap();
+  return !zone_map->CouldSatisfy(column_id, expr_type, value);
+}
+
 }  // namespace executor
 }  // namespace peloton
@@ -12,6 +12,8 @@
 
 #pragma once
 
+#include <sched.h>
+
 #include "backend/planner/seq_scan_plan.h"
 #include "backend/executor/abstract_scan_executor.h"
 
@@ -28,12 +30,27 @@ class SeqScanExecutor : public AbstractScanExecutor {
   explicit SeqScanExecutor(const planner::AbstractPlan *node,
                            ExecutorContext *executor_context);
 
+  ~SeqScanExecutor();
+
+  /** @brief Number of tile groups skipped using zone maps so far. */
+  oid_t GetSkippedTileGroupCount() const { return skipped_tile_group_count_; }
+
+  /** @brief Number of ranges of tile groups on the same NUMA node so far. */
+  oid_t GetNumaRangeCount() const { return numa_range_count_; }
+
  protected:
   bool DInit();
 
   bool DExecute();
 
  private:
+  bool CanSkipTileGroup(const storage::TileGroup *tile_group,
+                        const expression::AbstractExpression *expr) const;
+
+  void PinToNumaNode(int numa_node);
+
+  void UnpinFromNumaNode();
+
   //===--------------------------------------------------------------------===//
   // Executor State
   //===--------------------------------------------------------------------===//
@@ -44,6 +61,20 @@ class SeqScanExecutor : public AbstractScanExecutor {
   /** @brief Keeps track of the number of tile groups to scan. */
   oid_t table_tile_group_count_ = INVALID_OID;
 
+  /** @brief Number of tile groups skipped using zone maps. */
+  oid_t skipped_tile_group_count_ = 0;
+
+  /** @brief NUMA node of the tile groups being scanned, -1 before any. */
+  int numa_node_ = -1;
+
+  /** @brief Number of ranges of tile groups on the same NUMA node. */
+  oid_t numa_range_count_ = 0;
+
+  /** @brief Whether the thread is pinned, and its cpus from before. */
+  bool thread_pinned_ = false;
+
+  cpu_set_t unpinned_cpus_;
+
   //===--------------------------------------------------------------------===//
   // Plan Info
   //===--------------------------------------------------------------------===//
@@ -79,6 +79,18 @@ bool UpdateExecutor::DExecute() {
   auto transaction_ = executor_context_->GetTransaction();
   auto tile_group_id = tile_group->GetTileGroupId();
 
+  // The columns that the update sets, the others keep their old values
+  std::vector<oid_t> changed_columns;
+  for (auto &target : project_info_->GetTargetList()) {
+    changed_columns.push_back(target.first);
+  }
+  for (auto &direct_map : project_info_->GetDirectMapList()) {
+    if (direct_map.first != direct_map.second.second ||
+        direct_map.second.first != 0) {
+      changed_columns.push_back(direct_map.first);
+    }
+  }
+
   // Update tuples in given table
   for (oid_t visible_tuple_id : *source_tile) {
     oid_t physical_tuple_id = pos_lists[0][visible_tuple_id];
@@ -123,9 +135,9 @@ bool UpdateExecutor::DExecute() {
 
       if (log_manager.IsInLoggingMode()) {
         auto logger = log_manager.GetBackendLogger();
-        auto record = logger->GetTupleRecord(
-            LOGRECORD_TYPE_TUPLE_UPDATE, transaction_->GetTransactionId(),
-            target_table_->GetOid(), location, delete_location, new_tuple);
+        auto record = logger->GetTupleUpdateRecord(
+            transaction_->GetTransactionId(), target_table_->GetOid(),
+            location, delete_location, new_tuple, changed_columns);
 
         logger->Log(record);
       }
@@ -47,6 +47,33 @@ bool BTreeIndex<KeyType, ValueType, KeyComparator, KeyEqualityChecker>::InsertEn
   return true;
 }
 
+template <typename KeyType, typename ValueType, class KeyComparator, class KeyEqualityChecker>
+bool BTreeIndex<KeyType, ValueType, KeyComparator, KeyEqualityChecker>::InsertEntries(
+    const std::vector<storage::Tuple *> &keys,
+    const std::vector<ItemPointer> &locations) {
+  assert(keys.size() == locations.size());
+
+  // Build the keys outside the latch
+  std::vector<std::pair<KeyType, ValueType>> entries(keys.size());
+  for (size_t entry_itr = 0; entry_itr < keys.size(); entry_itr++) {
+    entries[entry_itr].first.SetFromKey(keys[entry_itr]);
+    entries[entry_itr].second = locations[entry_itr];
+  }
+
+  {
+    index_lock.WriteLock();
+
+    // Insert the key, val pairs
+    for (auto &entry : entries) {
+      container.insert(entry);
+    }
+
+    index_lock.Unlock();
+  }
+
+  return true;
+}
+
 template <typename KeyType, typename ValueType, class KeyComparator, class KeyEqualityChecker>
 bool BTreeIndex<KeyType, ValueType, KeyComparator, KeyEqualityChecker>::DeleteEntry(
     const storage::Tuple *key, const ItemPointer location) {
@@ -123,13 +150,14 @@ BTreeIndex<KeyType, ValueType, KeyComparator, KeyEqualityChecker>::Scan(
     if (special_case == true) {
 
       start_key.reset(new storage::Tuple(metadata->GetKeySchema(), true));
-      index_key.SetFromKey(start_key.get());
 
       // Construct the lower bound key tuple
       all_constraints_are_equal =
           ConstructLowerBoundTuple(start_key.get(), values, key_column_ids, expr_types);
       LOG_TRACE("All constraints are equal : %d ", all_constraints_are_equal);
 
+      index_key.SetFromKey(start_key.get());
+
       // Set scan begin iterator
       scan_begin_itr = container.equal_range(index_key).first;
     }
@@ -45,6 +45,9 @@ class BTreeIndex : public Index {
 
   bool InsertEntry(const storage::Tuple *key, const ItemPointer location);
 
+  bool InsertEntries(const std::vector<storage::Tuple *> &keys,
+                     const std::vector<ItemPointer> &locations);
+
   bool DeleteEntry(const storage::Tuple *key, const ItemPointer location);
 
   std::vector<ItemPointer> Scan(const std::vector<Value> &values,
@@ -509,7 +509,7 @@ bool BWTree<KeyType, ValueType, KeyComparator, KeyEqualityChecker>::Exists(
     const KeyType &key) {
   PID leaf_pid = GetLeafNodePID(key);
 
-  if (leaf_pid < 0) {
+  if (leaf_pid == NULL_PID) {
     return false;
   }
 
@@ -528,7 +528,7 @@ BWTree<KeyType, ValueType, KeyComparator, KeyEqualityChecker>::Search(
   std::vector<DataPairType> result;
 
   PID leaf_pid = GetLeafNodePID(key);
-  if (leaf_pid < 0) {
+  if (leaf_pid == NULL_PID) {
     return result;
   }
 
@@ -23,6 +23,8 @@
 #include <atomic>
 #include <iostream>
 
+#include "backend/common/huge_page_allocator.h"
+
 #define BWTREE_MAX(a, b) ((a) < (b) ? (b) : (a))
 #define BWTREE_NODE_SIZE 256
 #define MAPPING_TABLE_SIZE 4096
@@ -373,7 +375,10 @@ class BWTree {
   };
 
   struct MappingTable {
-    Node **table = new Node *[MAPPING_TABLE_SIZE]();
+    // Backed by huge pages if enabled, as every probe goes through it
+    Node **table = static_cast<Node **>(
+        HugePageAllocator::GetInstance().Allocate(MAPPING_TABLE_SIZE *
+                                                  sizeof(Node *)));
 
     inline void Initialize() { std::fill_n(table, MAPPING_TABLE_SIZE, 0); }
 
@@ -423,7 +428,7 @@ class BWTree {
       return false;
     }
 
-    ~MappingTable() { delete[] table; }
+    ~MappingTable() { HugePageAllocator::GetInstance().Release(table); }
   };
 
  private:
@@ -1158,7 +1163,8 @@ class BWTree {
     PID current_pid = m_root;
     Node *current = GetNode(m_root);
 
-    if (!current) return -1;
+    // Empty tree
+    if (!current) return NULL_PID;
 
     // Keep traversing tree until we find the target leaf node
     while (!current->IsLeaf()) {
@@ -191,6 +191,18 @@ Index::Index(IndexMetadata *metadata) : metadata(metadata) {
   pool = new VarlenPool(BACKEND_TYPE_MM);
 }
 
+bool Index::InsertEntries(const std::vector<storage::Tuple *> &keys,
+                          const std::vector<ItemPointer> &locations) {
+  assert(keys.size() == locations.size());
+
+  bool status = true;
+  for (size_t entry_itr = 0; entry_itr < keys.size(); entry_itr++) {
+    status &= InsertEntry(keys[entry_itr], locations[entry_itr]);
+  }
+
+  return status;
+}
+
 const std::string Index::GetInfo() const {
   std::stringstream os;
 
@@ -118,6 +118,11 @@ class Index : public Printable {
   virtual bool InsertEntry(const storage::Tuple *key,
                            const ItemPointer location) = 0;
 
+  // insert a batch of index entries, the i-th key linked to the i-th location
+  // by default, the entries are inserted one at a time
+  virtual bool InsertEntries(const std::vector<storage::Tuple *> &keys,
+                             const std::vector<ItemPointer> &locations);
+
   // delete the index entry linked to given tuple and location
   virtual bool DeleteEntry(const storage::Tuple *key,
                            const ItemPointer location) = 0;
@@ -38,15 +38,50 @@ BackendLogger *BackendLogger::GetBackendLogger(LoggingType logging_type) {
 }
 
 /**
- * @brief set the wait flush to false
+ * @brief Construct a log record of an update
+ * By default, the record has the whole new tuple.
+ * @param changed columns of the new tuple
+ */
+LogRecord *BackendLogger::GetTupleUpdateRecord(
+    txn_id_t txn_id, oid_t table_oid, ItemPointer insert_location,
+    ItemPointer delete_location, void *data,
+    __attribute__((unused)) const std::vector<oid_t> &changed_columns,
+    oid_t db_oid) {
+  return GetTupleRecord(LOGRECORD_TYPE_TUPLE_UPDATE, txn_id, table_oid,
+                        insert_location, delete_location, data, db_oid);
+}
+
+/**
+ * @brief set the wait flush to false, and wake up the records that were
+ * released from the log buffer
  */
 void BackendLogger::Commit(void) {
   std::lock_guard<std::mutex> lock(flush_notify_mutex);
-  // Only need to commit if they are waiting for us to flush
-  if (wait_for_flushing) {
-    wait_for_flushing = false;
-    flush_notify_cv.notify_all();
+  wait_for_flushing = false;
+
+  if (durable_records.empty() == false) {
+    auto released_position = log_buffer.GetReleasedPosition();
+    auto durable_itr = durable_records.begin();
+    for (; durable_itr != durable_records.end(); durable_itr++) {
+      if (durable_itr->first > released_position) break;
+      durable_itr->second->SetDurable();
+      delete durable_itr->second;
+    }
+    durable_records.erase(durable_records.begin(), durable_itr);
   }
+
+  // The log buffer may have been released, even if nobody truncated
+  flush_notify_cv.notify_all();
+}
+
+/**
+ * @brief keep the record until the log buffer is released past the position
+ * @param position
+ * @param record
+ */
+void BackendLogger::AddDurableRecord(uint64_t position, LogRecord *record) {
+  std::lock_guard<std::mutex> lock(flush_notify_mutex);
+  durable_records.emplace_back(position, record);
 }
 
 /**
@@ -89,7 +124,8 @@ bool BackendLogger::IsWaitingForFlushing(void) {
   // wait_for_flushing is false.
   // For example, if backend logger enqueues the log record right after
   // frontend logger collect data and not truncated yet.
-  if (wait_for_flushing || GetLocalQueueSize() > 0) {
+  if (wait_for_flushing || GetLocalQueueSize() > 0 ||
+      log_buffer.IsEmpty() == false) {
     return true;
   } else {
     return false;
@@ -17,6 +17,7 @@
 #include <condition_variable>
 
 #include "backend/logging/logger.h"
+#include "backend/logging/log_buffer.h"
 #include "backend/logging/log_record.h"
 
 namespace peloton {
@@ -34,6 +35,9 @@ class BackendLogger : public Logger {
     for (auto log_record : local_queue) {
       delete log_record;
     }
+    for (auto durable_record : durable_records) {
+      delete durable_record.second;
+    }
   }
 
   static BackendLogger *GetBackendLogger(LoggingType logging_type);
@@ -54,6 +58,9 @@ class BackendLogger : public Logger {
 
   size_t GetLocalQueueSize(void);
 
+  // Get the buffer of the serialized log records
+  LogBuffer &GetLogBuffer(void) { return log_buffer; }
+
   //===--------------------------------------------------------------------===//
   // Virtual Functions
   //===--------------------------------------------------------------------===//
@@ -65,6 +72,9 @@ class BackendLogger : public Logger {
   // Log the given record
   virtual void Log(LogRecord *record) = 0;
 
+  // Log the given records as one batch
+  virtual void LogBatch(const std::vector<LogRecord *> &records) = 0;
+
   // Construct a log record with tuple information
   virtual LogRecord *GetTupleRecord(LogRecordType log_record_type,
                                     txn_id_t txn_id, oid_t table_oid,
@@ -73,12 +83,31 @@ class BackendLogger : public Logger {
                                     void *data = nullptr,
                                     oid_t db_oid = INVALID_OID) = 0;
 
+  // Construct a log record of an update, the columns that are not changed
+  // are the same as in the deleted tuple
+  virtual LogRecord *GetTupleUpdateRecord(
+      txn_id_t txn_id, oid_t table_oid, ItemPointer insert_location,
+      ItemPointer delete_location, void *data,
+      const std::vector<oid_t> &changed_columns, oid_t db_oid = INVALID_OID);
+
  protected:
   bool IsWaitingForFlushing(void);
 
+  // Keep the record until the buffer is released past the given position,
+  // and then wake up whoever waits for it to be durable
+  void AddDurableRecord(uint64_t position, LogRecord *record);
+
   std::vector<LogRecord *> local_queue;
   std::mutex local_queue_mutex;
 
+  // serialized log records, collected by the frontend logger without
+  // taking a lock
+  LogBuffer log_buffer;
+
+  // records that are waited for, with their end position in the buffer
+  // protected by flush_notify_mutex
+  std::vector<std::pair<uint64_t, LogRecord *>> durable_records;
+
   // wait for the frontend to flush
   // need to ensure synchronous commit
   bool wait_for_flushing = false;
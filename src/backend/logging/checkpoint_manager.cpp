@@ -0,0 +1,436 @@
+/*-------------------------------------------------------------------------
+ *
+ * checkpoint_manager.cpp
+ * file description
+ *
+ * Copyright(c) 2015, CMU
+ *
+ * /peloton/src/backend/logging/checkpoint_manager.cpp
+ *
+ *-------------------------------------------------------------------------
+ */
+
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cstdio>
+#include <memory>
+#include <vector>
+
+#include "backend/catalog/manager.h"
+#include "backend/catalog/schema.h"
+#include "backend/common/logger.h"
+#include "backend/common/pool.h"
+#include "backend/common/serializer.h"
+#include "backend/common/value.h"
+#include "backend/concurrency/transaction.h"
+#include "backend/logging/checkpoint_manager.h"
+#include "backend/logging/log_reader.h"
+#include "backend/storage/database.h"
+#include "backend/storage/data_table.h"
+#include "backend/storage/tile_group.h"
+#include "backend/storage/tile_group_header.h"
+#include "backend/storage/tuple.h"
+
+namespace peloton {
+namespace logging {
+
+// Frames of a checkpoint file
+enum CheckpointFrameType {
+  CHECKPOINT_FRAME_TYPE_INVALID = 0,
+
+  CHECKPOINT_FRAME_TYPE_HEADER = 1,
+  CHECKPOINT_FRAME_TYPE_TILE_GROUP = 2,
+  CHECKPOINT_FRAME_TYPE_FOOTER = 3
+};
+
+//===--------------------------------------------------------------------===//
+// Utility functions
+//===--------------------------------------------------------------------===//
+
+
+static size_t BeginFrame(SerializeOutput &output, CheckpointFrameType type);
+
+static void EndFrame(SerializeOutput &output, size_t start);
+
+static void WriteOutput(CopySerializeOutput &output, FILE *checkpoint_file);
+
+static CheckpointFrameType GetNextFrame(const char *checkpoint,
+                                        size_t checkpoint_size, size_t &offset,
+                                        size_t &frame_size);
+
+static size_t SerializeTileGroup(SerializeOutput &output,
+                                 concurrency::Transaction *txn,
+                                 storage::DataTable *table,
+                                 storage::TileGroup *tile_group);
+
+CheckpointManager::CheckpointManager(std::string file_name)
+    : file_name(file_name) {}
+
+/**
+ * @brief Write the tuples of all the tables that are visible to the txn
+ * @param read-only txn, whose snapshot is the checkpoint
+ * @param log offsets, the checkpoint covers every log stream before its
+ * offset
+ * @return false if the checkpoint could not be written
+ */
+bool CheckpointManager::WriteCheckpoint(
+    concurrency::Transaction *txn, const std::vector<size_t> &log_offsets_) {
+  auto snapshot_cid = txn->GetLastCommitId();
+
+  // Write a new file, it replaces the old checkpoint once it is complete
+  auto new_file_name = file_name + ".new";
+  FILE *checkpoint_file = fopen(new_file_name.c_str(), "wb");
+  if (checkpoint_file == NULL) {
+    LOG_ERROR("Could not open the checkpoint file %s", new_file_name.c_str());
+    return false;
+  }
+
+  CopySerializeOutput output;
+
+  // Header
+  auto frame_start = BeginFrame(output, CHECKPOINT_FRAME_TYPE_HEADER);
+  output.WriteInt(CHECKPOINT_MAGIC);
+  output.WriteInt(CHECKPOINT_VERSION);
+  output.WriteLong(snapshot_cid);
+  output.WriteInt(static_cast<int32_t>(log_offsets_.size()));
+  for (auto log_offset : log_offsets_) {
+    output.WriteLong(log_offset);
+  }
+  EndFrame(output, frame_start);
+  WriteOutput(output, checkpoint_file);
+
+  // Tile groups of all the tables
+  auto &manager = catalog::Manager::GetInstance();
+  size_t tile_group_count = 0;
+  size_t visible_tuple_count = 0;
+  oid_t max_id = 0;
+
+  for (oid_t database_itr = 0; database_itr < manager.GetDatabaseCount();
+       database_itr++) {
+    auto database = manager.GetDatabase(database_itr);
+
+    for (oid_t table_itr = 0; table_itr < database->GetTableCount();
+         table_itr++) {
+      auto table = database->GetTable(table_itr);
+
+      for (oid_t tile_group_itr = 0;
+           tile_group_itr < table->GetTileGroupCount(); tile_group_itr++) {
+        auto tile_group = table->GetTileGroup(tile_group_itr);
+
+        visible_tuple_count +=
+            SerializeTileGroup(output, txn, table, tile_group.get());
+        WriteOutput(output, checkpoint_file);
+
+        max_id = std::max(max_id, tile_group->GetTileGroupId());
+        tile_group_count++;
+      }
+    }
+  }
+
+  // Footer, so that we know the file is complete
+  frame_start = BeginFrame(output, CHECKPOINT_FRAME_TYPE_FOOTER);
+  output.WriteInt(CHECKPOINT_MAGIC);
+  output.WriteLong(tile_group_count);
+  EndFrame(output, frame_start);
+  WriteOutput(output, checkpoint_file);
+
+  // Make it durable, then replace the old checkpoint
+  bool status = (ferror(checkpoint_file) == 0 && fflush(checkpoint_file) == 0 &&
+                 fdatasync(fileno(checkpoint_file)) == 0);
+  fclose(checkpoint_file);
+
+  if (status == false ||
+      rename(new_file_name.c_str(), file_name.c_str()) != 0) {
+    LOG_ERROR("Could not write the checkpoint file %s", file_name.c_str());
+    std::remove(new_file_name.c_str());
+    return false;
+  }
+
+  checkpoint_cid = snapshot_cid;
+  log_offsets = log_offsets_;
+  max_tile_group_id = max_id;
+  tuple_count = visible_tuple_count;
+
+  LOG_INFO("Checkpoint :: cid %lu, %lu tuples in %lu tile groups, log offset %lu",
+           checkpoint_cid, tuple_count, tile_group_count, GetLogOffset());
+
+  return true;
+}
+
+bool CheckpointManager::HasCheckpoint(void) const {
+  return access(file_name.c_str(), F_OK) == 0;
+}
+
+/**
+ * @brief Insert the tuples of the checkpoint at their locations
+ * Nothing is inserted unless the checkpoint is complete.
+ * @param txn that inserts the tuples
+ * @param pool for allocating non-inlined values
+ * @return false if there is no complete checkpoint
+ */
+bool CheckpointManager::LoadCheckpoint(concurrency::Transaction *txn,
+                                       VarlenPool *pool) {
+  FILE *checkpoint_file = fopen(file_name.c_str(), "rb");
+  if (checkpoint_file == NULL) {
+    return false;
+  }
+
+  // Read the whole checkpoint
+  struct stat checkpoint_stats;
+  fstat(fileno(checkpoint_file), &checkpoint_stats);
+  size_t checkpoint_size = checkpoint_stats.st_size;
+
+  std::unique_ptr<char[]> checkpoint(new char[checkpoint_size]);
+  size_t ret = fread(checkpoint.get(), 1, checkpoint_size, checkpoint_file);
+  fclose(checkpoint_file);
+
+  if (ret != checkpoint_size) {
+    LOG_ERROR("Could not read the checkpoint file %s", file_name.c_str());
+    return false;
+  }
+
+  // Header
+  size_t offset = 0;
+  size_t frame_size = 0;
+  if (GetNextFrame(checkpoint.get(), checkpoint_size, offset, frame_size) !=
+      CHECKPOINT_FRAME_TYPE_HEADER) {
+    LOG_ERROR("Checkpoint file %s has no header", file_name.c_str());
+    return false;
+  }
+
+  ReferenceSerializeInputBE header(checkpoint.get() + offset, frame_size);
+  header.ReadInt();
+  auto magic = header.ReadInt();
+  auto version = header.ReadInt();
+  if (magic != CHECKPOINT_MAGIC || version < 1 ||
+      version > CHECKPOINT_VERSION) {
+    LOG_ERROR("Checkpoint file %s has an unknown format", file_name.c_str());
+    return false;
+  }
+  cid_t loaded_cid = header.ReadLong();
+
+  // The first version only has the offset of a single log
+  int32_t log_offset_count = (version == 1) ? 1 : header.ReadInt();
+  std::vector<size_t> loaded_log_offsets;
+  for (int32_t offset_itr = 0; offset_itr < log_offset_count; offset_itr++) {
+    loaded_log_offsets.push_back(header.ReadLong());
+  }
+  offset += frame_size;
+
+  // Find the tile groups, up to the footer
+  std::vector<std::pair<size_t, size_t>> tile_group_frames;
+  bool complete = false;
+
+  while (true) {
+    auto frame_type =
+        GetNextFrame(checkpoint.get(), checkpoint_size, offset, frame_size);
+
+    if (frame_type == CHECKPOINT_FRAME_TYPE_TILE_GROUP) {
+      tile_group_frames.push_back({offset, frame_size});
+      offset += frame_size;
+      continue;
+    }
+
+    if (frame_type == CHECKPOINT_FRAME_TYPE_FOOTER) {
+      ReferenceSerializeInputBE footer(checkpoint.get() + offset, frame_size);
+      footer.ReadInt();
+      complete = (footer.ReadInt() == CHECKPOINT_MAGIC &&
+                  static_cast<size_t>(footer.ReadLong()) ==
+                      tile_group_frames.size());
+    }
+    break;
+  }
+
+  if (complete == false) {
+    LOG_ERROR("Checkpoint file %s is not complete", file_name.c_str());
+    return false;
+  }
+
+  // Insert the tuples of every tile group
+  auto &manager = catalog::Manager::GetInstance();
+  auto txn_id = txn->GetTransactionId();
+  size_t loaded_tuple_count = 0;
+  oid_t max_id = 0;
+
+  for (auto tile_group_frame : tile_group_frames) {
+    ReferenceSerializeInputBE input(checkpoint.get() + tile_group_frame.first,
+                                    tile_group_frame.second);
+    input.ReadInt();
+
+    oid_t database_oid = input.ReadInt();
+    oid_t table_oid = input.ReadInt();
+    oid_t tile_group_id = input.ReadInt();
+    oid_t tile_group_tuple_count = input.ReadInt();
+
+    std::vector<oid_t> tuple_slots(tile_group_tuple_count);
+    for (auto &tuple_slot : tuple_slots) {
+      tuple_slot = input.ReadInt();
+    }
+
+    auto database = manager.GetDatabaseWithOid(database_oid);
+    storage::DataTable *table = nullptr;
+    if (database != nullptr) {
+      table = database->GetTableWithOid(table_oid);
+    }
+    if (table == nullptr) {
+      LOG_ERROR("Checkpoint :: table %lu of database %lu does not exist",
+                table_oid, database_oid);
+      return false;
+    }
+
+    // Create the tile group if the table doesn't already have it
+    auto tile_group = manager.GetTileGroup(tile_group_id);
+    if (tile_group == nullptr) {
+      table->AddTileGroupWithOid(tile_group_id);
+      tile_group = manager.GetTileGroup(tile_group_id);
+    }
+    max_id = std::max(max_id, tile_group_id);
+
+    // Assemble the tuples, one column after the other
+    auto schema = table->GetSchema();
+    std::vector<std::unique_ptr<storage::Tuple>> tuples;
+    for (oid_t tuple_itr = 0; tuple_itr < tile_group_tuple_count;
+         tuple_itr++) {
+      tuples.emplace_back(new storage::Tuple(schema, true));
+    }
+
+    for (oid_t column_itr = 0; column_itr < schema->GetColumnCount();
+         column_itr++) {
+      auto type = schema->GetType(column_itr);
+      for (auto &tuple : tuples) {
+        Value value;
+        value.DeserializeFromAllocateForStorage(type, input, pool);
+        tuple->SetValue(column_itr, value, pool);
+      }
+    }
+
+    // Insert them at their slots
+    for (oid_t tuple_itr = 0; tuple_itr < tile_group_tuple_count;
+         tuple_itr++) {
+      auto tuple_slot = tuple_slots[tuple_itr];
+      if (tile_group->InsertTuple(txn_id, tuple_slot,
+                                  tuples[tuple_itr].get()) == INVALID_OID) {
+        LOG_ERROR("Checkpoint :: could not insert tuple %lu of tile group %lu",
+                  tuple_slot, tile_group_id);
+        return false;
+      }
+      txn->RecordInsert(ItemPointer(tile_group_id, tuple_slot));
+    }
+
+    table->IncreaseNumberOfTuplesBy(tile_group_tuple_count);
+    loaded_tuple_count += tile_group_tuple_count;
+  }
+
+  checkpoint_cid = loaded_cid;
+  log_offsets = loaded_log_offsets;
+  max_tile_group_id = max_id;
+  tuple_count = loaded_tuple_count;
+
+  LOG_INFO("Checkpoint :: loaded %lu tuples of cid %lu, log offset %lu",
+           tuple_count, checkpoint_cid, GetLogOffset());
+
+  return true;
+}
+
+//===--------------------------------------------------------------------===//
+// Utility functions
+//===--------------------------------------------------------------------===//
+
+/**
+ * @brief Start a frame, EndFrame fills in its length
+ * @return the position of the length
+ */
+static size_t BeginFrame(SerializeOutput &output, CheckpointFrameType type) {
+  output.WriteEnumInSingleByte(type);
+
+  size_t start = output.Position();
+  output.WriteInt(0);
+
+  return start;
+}
+
+static void EndFrame(SerializeOutput &output, size_t start) {
+  output.WriteIntAt(
+      start, static_cast<int32_t>(output.Position() - start - sizeof(int32_t)));
+}
+
+/**
+ * @brief Append the output to the file, and reset it
+ * Errors are checked once the whole file is written.
+ */
+static void WriteOutput(CopySerializeOutput &output, FILE *checkpoint_file) {
+  fwrite(output.Data(), sizeof(char), output.Size(), checkpoint_file);
+  output.Reset();
+}
+
+/**
+ * @brief Get the frame at the offset
+ * @param offset, moved to the length of the frame
+ * @param frame size, including its length
+ * @return the frame type, or invalid if the frame is broken
+ */
+static CheckpointFrameType GetNextFrame(const char *checkpoint,
+                                        size_t checkpoint_size, size_t &offset,
+                                        size_t &frame_size) {
+  if (offset >= checkpoint_size) {
+    return CHECKPOINT_FRAME_TYPE_INVALID;
+  }
+
+  auto frame_type = static_cast<CheckpointFrameType>(checkpoint[offset]);
+
+  frame_size =
+      LogReader::GetFrameSize(checkpoint, checkpoint_size, offset + 1);
+  if (frame_size == 0) {
+    return CHECKPOINT_FRAME_TYPE_INVALID;
+  }
+
+  offset++;
+  return frame_type;
+}
+
+/**
+ * @brief Serialize the tuples of the tile group that are visible to the txn
+ * @return the number of visible tuples
+ */
+static size_t SerializeTileGroup(SerializeOutput &output,
+                                 concurrency::Transaction *txn,
+                                 storage::DataTable *table,
+                                 storage::TileGroup *tile_group) {
+  auto header = tile_group->GetHeader();
+  auto txn_id = txn->GetTransactionId();
+  auto snapshot_cid = txn->GetLastCommitId();
+
+  // The slots of the visible tuples
+  std::vector<oid_t> tuple_slots;
+  auto next_tuple_slot = tile_group->GetNextTupleSlot();
+  for (oid_t tuple_slot = 0; tuple_slot < next_tuple_slot; tuple_slot++) {
+    if (header->IsVisible(tuple_slot, txn_id, snapshot_cid)) {
+      tuple_slots.push_back(tuple_slot);
+    }
+  }
+
+  auto frame_start = BeginFrame(output, CHECKPOINT_FRAME_TYPE_TILE_GROUP);
+  output.WriteInt(table->GetDatabaseOid());
+  output.WriteInt(table->GetOid());
+  output.WriteInt(tile_group->GetTileGroupId());
+  output.WriteInt(tuple_slots.size());
+  for (auto tuple_slot : tuple_slots) {
+    output.WriteInt(tuple_slot);
+  }
+
+  // Then, the values of one column after the other
+  auto column_count = table->GetSchema()->GetColumnCount();
+  for (oid_t column_itr = 0; column_itr < column_count; column_itr++) {
+    for (auto tuple_slot : tuple_slots) {
+      tile_group->GetValue(tuple_slot, column_itr).SerializeTo(output);
+    }
+  }
+
+  EndFrame(output, frame_start);
+
+  return tuple_slots.size();
+}
+
+}  // namespace logging
+}  // namespace peloton
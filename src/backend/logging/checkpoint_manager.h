@@ -0,0 +1,105 @@
+/*-------------------------------------------------------------------------
+ *
+ * checkpoint_manager.h
+ * file description
+ *
+ * Copyright(c) 2015, CMU
+ *
+ * /peloton/src/backend/logging/checkpoint_manager.h
+ *
+ *-------------------------------------------------------------------------
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "backend/common/types.h"
+
+namespace peloton {
+
+class VarlenPool;
+
+namespace concurrency {
+class Transaction;
+}
+
+namespace logging {
+
+// Identifies a checkpoint file and its format
+#define CHECKPOINT_MAGIC 0x434b5054
+#define CHECKPOINT_VERSION 2
+
+//===--------------------------------------------------------------------===//
+// Checkpoint Manager
+//===--------------------------------------------------------------------===//
+
+/**
+ * Writes the tuples that are visible in a snapshot to a checkpoint file,
+ * and loads them back during recovery.
+ *
+ * The snapshot is the one of a read-only transaction, so a checkpoint does
+ * not block the writers, and the garbage collector keeps the versions that
+ * it still has to read. The tuples keep their locations, since the log
+ * after the checkpoint refers to them.
+ *
+ * The file holds a header, a frame per tile group and a footer. A tile
+ * group frame has the slots of the visible tuples, and then the values of
+ * one column after the other. Like a log record, every frame starts with a
+ * type byte and its length. The new file replaces the old one once it is
+ * complete, so there is always one whole checkpoint.
+ *
+ * The header has the offset where the redo starts in every log stream.
+ */
+class CheckpointManager {
+ public:
+  CheckpointManager(std::string file_name);
+
+  // Write the tuples that are visible to the txn
+  // the checkpoint covers every log stream before its log offset
+  bool WriteCheckpoint(concurrency::Transaction *txn,
+                       const std::vector<size_t> &log_offsets);
+
+  // Is there a checkpoint file ?
+  bool HasCheckpoint(void) const;
+
+  // Insert the tuples of the checkpoint as the given txn
+  // returns false if there is no complete checkpoint
+  bool LoadCheckpoint(concurrency::Transaction *txn, VarlenPool *pool);
+
+  //===--------------------------------------------------------------------===//
+  // Accessors, of the last written or loaded checkpoint
+  //===--------------------------------------------------------------------===//
+
+  cid_t GetCheckpointCid(void) const { return checkpoint_cid; }
+
+  // Where the redo starts in the log stream, 0 if it is not in the
+  // checkpoint
+  size_t GetLogOffset(oid_t logger_id = 0) const {
+    return logger_id < log_offsets.size() ? log_offsets[logger_id] : 0;
+  }
+
+  oid_t GetMaxTileGroupId(void) const { return max_tile_group_id; }
+
+  size_t GetTupleCount(void) const { return tuple_count; }
+
+ private:
+  //===--------------------------------------------------------------------===//
+  // Member Variables
+  //===--------------------------------------------------------------------===//
+
+  std::string file_name;
+
+  cid_t checkpoint_cid = INVALID_CID;
+
+  // of every log stream
+  std::vector<size_t> log_offsets;
+
+  oid_t max_tile_group_id = 0;
+
+  size_t tuple_count = 0;
+};
+
+}  // namespace logging
+}  // namespace peloton
@@ -10,9 +10,11 @@
  *-------------------------------------------------------------------------
  */
 
+#include <chrono>
 #include <thread>
 
 #include "backend/common/logger.h"
+#include "backend/concurrency/transaction_manager.h"
 #include "backend/logging/log_manager.h"
 #include "backend/logging/frontend_logger.h"
 #include "backend/logging/loggers/aries_frontend_logger.h"
@@ -24,7 +26,7 @@ int64_t peloton_wait_timeout = 0;
 namespace peloton {
 namespace logging {
 
-FrontendLogger::FrontendLogger() {
+FrontendLogger::FrontendLogger(oid_t logger_id) : logger_id(logger_id) {
   logger_type = LOGGER_TYPE_FRONTEND;
 
   if (peloton_wait_timeout != 0) {
@@ -40,12 +42,14 @@ FrontendLogger::~FrontendLogger() {
 
 /** * @brief Return the frontend logger based on logging type
  * @param logging type can be stdout(debug), aries, peloton
+ * @param id of the log stream, only the aries logging has more than one
  */
-FrontendLogger *FrontendLogger::GetFrontendLogger(LoggingType logging_type) {
+FrontendLogger *FrontendLogger::GetFrontendLogger(LoggingType logging_type,
+                                                  oid_t logger_id) {
   FrontendLogger *frontendLogger = nullptr;
 
   if (IsSimilarToARIES(logging_type) == true) {
-    frontendLogger = new AriesFrontendLogger();
+    frontendLogger = new AriesFrontendLogger(logger_id);
   } else if (IsSimilarToPeloton(logging_type) == true) {
     frontendLogger = new PelotonFrontendLogger();
   } else {
@@ -79,6 +83,12 @@ void FrontendLogger::MainLoop(void) {
       // RECOVERY MODE
       /////////////////////////////////////////////////////////////////////
 
+      // The first frontend logger recovers the log streams of all of them
+      if (logger_id != 0) {
+        log_manager.WaitForMode(LOGGING_STATUS_TYPE_RECOVERY, false);
+        break;
+      }
+
       // First, do recovery if needed
       DoRecovery();
 
@@ -100,13 +110,23 @@ void FrontendLogger::MainLoop(void) {
   // LOGGING MODE
   /////////////////////////////////////////////////////////////////////
 
+  // Take checkpoints in the background, of all the log streams
+  std::thread checkpoint_thread;
+  if (logger_id == 0 && log_manager.GetCheckpointInterval() > 0) {
+    checkpoint_thread = std::thread(&FrontendLogger::CheckpointLoop, this);
+  }
+
   // Periodically, wake up and do logging
   while (log_manager.GetStatus() == LOGGING_STATUS_TYPE_LOGGING) {
     // Collect LogRecords from all backend loggers
-    CollectLogRecordsFromBackendLoggers();
+    if (log_manager.GetGroupCommit()) {
+      CollectLogRecordsForGroupCommit();
+    } else {
+      CollectLogRecordsFromBackendLoggers();
+    }
 
     // Flush the data to the file
-    FlushLogRecords();
+    FlushCollectedLogRecords();
   }
 
   /////////////////////////////////////////////////////////////////////
@@ -118,16 +138,16 @@ void FrontendLogger::MainLoop(void) {
 
   // flush any remaining log records
   CollectLogRecordsFromBackendLoggers();
-  FlushLogRecords();
+  FlushCollectedLogRecords();
 
-  /////////////////////////////////////////////////////////////////////
-  // SLEEP MODE
-  /////////////////////////////////////////////////////////////////////
+  LOG_INFO("Flushes :: %lu Flushed log records :: %lu",
+           log_manager.GetFlushCount(), log_manager.GetFlushedRecordCount());
 
-  LOG_TRACE("Frontendlogger] Sleep Mode");
+  if (checkpoint_thread.joinable()) {
+    checkpoint_thread.join();
+  }
 
-  // Setting frontend logger status to sleep
-  log_manager.SetLoggingStatus(LOGGING_STATUS_TYPE_SLEEP);
+  // The log manager enters SLEEP mode once all frontend loggers are done
 }
 
 /**
@@ -146,11 +166,25 @@ void FrontendLogger::CollectLogRecordsFromBackendLoggers() {
     std::this_thread::sleep_for(sleep_period);
   }
 
+  // The records of the commits up to the last cid are in the backend
+  // loggers by now, so they are collected below
+  collected_cid = concurrency::TransactionManager::GetInstance()
+                      .GetLastCommitId();
+
   {
     std::lock_guard<std::mutex> lock(backend_logger_mutex);
 
-    // Look at the local queues of the backend loggers
+    // Look at the log buffers and the local queues of the backend loggers
     for (auto backend_logger : backend_loggers) {
+      // Collect the serialized records in place
+      auto span_count = collected_spans.size();
+      collected_span_record_count +=
+          backend_logger->GetLogBuffer().Collect(collected_spans);
+      for (auto span_itr = span_count; span_itr < collected_spans.size();
+           span_itr++) {
+        collected_bytes += collected_spans[span_itr].iov_len;
+      }
+
       auto local_queue_size = backend_logger->GetLocalQueueSize();
 
       // Skip current backend_logger, nothing to do
@@ -159,7 +193,9 @@ void FrontendLogger::CollectLogRecordsFromBackendLoggers() {
       // Shallow copy the log record from backend_logger to here
       for (oid_t log_record_itr = 0; log_record_itr < local_queue_size;
            log_record_itr++) {
-        global_queue.push_back(backend_logger->GetLogRecord(log_record_itr));
+        auto record = backend_logger->GetLogRecord(log_record_itr);
+        collected_bytes += record->GetMessageLength();
+        global_queue.push_back(record);
       }
 
       // truncate the local queue
@@ -170,6 +206,97 @@ void FrontendLogger::CollectLogRecordsFromBackendLoggers() {
   need_to_collect_new_log_records = false;
 }
 
+/**
+ * @brief Collect the log records of a group commit
+ * The window starts with the first collected record, so an idle frontend
+ * logger does not flush empty groups.
+ */
+void FrontendLogger::CollectLogRecordsForGroupCommit() {
+  auto &log_manager = LogManager::GetInstance();
+  auto window = std::chrono::microseconds(log_manager.GetGroupCommitWindow());
+  auto budget = log_manager.GetGroupCommitBudget();
+
+  // Wait for the first record, or with several log streams, for commits
+  // that the other streams wait to become durable here
+  bool multiple_streams = (log_manager.ActiveFrontendLoggerCount() > 1);
+  while (global_queue.empty() && collected_spans.empty() &&
+         (multiple_streams == false || collected_cid <= durable_cid) &&
+         log_manager.GetStatus() == LOGGING_STATUS_TYPE_LOGGING) {
+    CollectLogRecordsFromBackendLoggers();
+  }
+
+  // Then, keep collecting until the window closes
+  auto window_start = std::chrono::steady_clock::now();
+  while (collected_bytes < budget &&
+         std::chrono::steady_clock::now() - window_start < window &&
+         log_manager.GetStatus() == LOGGING_STATUS_TYPE_LOGGING) {
+    CollectLogRecordsFromBackendLoggers();
+  }
+}
+
+/**
+ * @brief Flush the collected log records and update the flush statistics
+ */
+void FrontendLogger::FlushCollectedLogRecords() {
+  auto record_count = global_queue.size() + collected_span_record_count;
+
+  FlushLogRecords();
+
+  if (record_count > 0) {
+    LogManager::GetInstance().RecordFlush(record_count);
+  }
+  collected_bytes = 0;
+  collected_span_record_count = 0;
+}
+
+/**
+ * @brief Take a checkpoint every checkpoint interval
+ * Stops once the logging mode is over.
+ */
+void FrontendLogger::CheckpointLoop(void) {
+  auto &log_manager = LogManager::GetInstance();
+  auto interval = std::chrono::seconds(log_manager.GetCheckpointInterval());
+  auto poll_period = std::chrono::milliseconds(CHECKPOINT_POLL_PERIOD);
+  auto last_checkpoint = std::chrono::steady_clock::now();
+
+  while (log_manager.GetStatus() == LOGGING_STATUS_TYPE_LOGGING) {
+    std::this_thread::sleep_for(poll_period);
+    if (std::chrono::steady_clock::now() - last_checkpoint < interval) {
+      continue;
+    }
+
+    DoCheckpoint();
+    last_checkpoint = std::chrono::steady_clock::now();
+  }
+}
+
+/**
+ * @brief Publish that the commits up to the cid are durable in this stream
+ * and wake up the commits that wait for it
+ * @param cid
+ */
+void FrontendLogger::SetDurableCommitId(cid_t cid) {
+  if (cid <= durable_cid) return;
+
+  durable_cid = cid;
+  LogManager::GetInstance().NotifyDurableCommit();
+}
+
+/**
+ * @brief Release the collected bytes of the log buffers
+ * Must only be called once the collected spans are written out
+ */
+void FrontendLogger::ReleaseCollectedLogBuffers() {
+  {
+    std::lock_guard<std::mutex> lock(backend_logger_mutex);
+    for (auto backend_logger : backend_loggers) {
+      backend_logger->GetLogBuffer().Release();
+    }
+  }
+
+  collected_spans.clear();
+}
+
 /**
  * @brief Store backend logger
  * @param backend logger
@@ -182,6 +309,11 @@ void FrontendLogger::AddBackendLogger(BackendLogger *backend_logger) {
   }
 }
 
+/**
+ * @brief Remove backend logger
+ * @param backend logger
+ * @return false if it is connected to another frontend logger
+ */
 bool FrontendLogger::RemoveBackendLogger(BackendLogger *_backend_logger) {
   {
     std::lock_guard<std::mutex> lock(backend_logger_mutex);
@@ -196,7 +328,9 @@ bool FrontendLogger::RemoveBackendLogger(BackendLogger *_backend_logger) {
       }
     }
 
-    assert(offset < backend_loggers.size());
+    if (offset >= backend_loggers.size()) {
+      return false;
+    }
     backend_loggers.erase(backend_loggers.begin() + offset);
   }
 
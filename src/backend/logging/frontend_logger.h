@@ -12,11 +12,13 @@
 
 #pragma once
 
+#include <atomic>
 #include <iostream>
 #include <mutex>
 #include <condition_variable>
 #include <vector>
 #include <unistd.h>
+#include <sys/uio.h>
 
 #include "backend/common/types.h"
 #include "backend/logging/logger.h"
@@ -25,26 +27,45 @@
 namespace peloton {
 namespace logging {
 
+// How often the checkpoint thread checks whether the logging is over
+// (in milliseconds)
+#define CHECKPOINT_POLL_PERIOD 10
+
 //===--------------------------------------------------------------------===//
 // Frontend Logger
 //===--------------------------------------------------------------------===//
 
 class FrontendLogger : public Logger {
  public:
-  FrontendLogger();
+  FrontendLogger(oid_t logger_id = 0);
 
   ~FrontendLogger();
 
-  static FrontendLogger *GetFrontendLogger(LoggingType logging_type);
+  static FrontendLogger *GetFrontendLogger(LoggingType logging_type,
+                                           oid_t logger_id = 0);
 
   void MainLoop(void);
 
   void CollectLogRecordsFromBackendLoggers(void);
 
+  // Keep collecting until the group commit window elapses or its budget
+  // is used up
+  void CollectLogRecordsForGroupCommit(void);
+
+  void FlushCollectedLogRecords(void);
+
   void AddBackendLogger(BackendLogger *backend_logger);
 
   bool RemoveBackendLogger(BackendLogger *backend_logger);
 
+  // Take a checkpoint every checkpoint interval, while logging
+  void CheckpointLoop(void);
+
+  oid_t GetLoggerId(void) const { return logger_id; }
+
+  // Get the cid up to which the commits of this log stream are durable
+  cid_t GetDurableCommitId(void) const { return durable_cid; }
+
   //===--------------------------------------------------------------------===//
   // Virtual Functions
   //===--------------------------------------------------------------------===//
@@ -55,7 +76,21 @@ class FrontendLogger : public Logger {
   // Restore database
   virtual void DoRecovery(void) = 0;
 
+  // Take a checkpoint and truncate the log before it
+  // returns false if no checkpoint was taken
+  virtual bool DoCheckpoint(void) { return false; }
+
  protected:
+  // Give the collected bytes back to the log buffers of the backend loggers
+  // once they are flushed
+  void ReleaseCollectedLogBuffers(void);
+
+  // The commits up to the cid are durable in this log stream
+  void SetDurableCommitId(cid_t cid);
+
+  // id of the log stream, the first frontend logger recovers all of them
+  oid_t logger_id;
+
   // Associated backend loggers
   std::vector<BackendLogger *> backend_loggers;
 
@@ -66,12 +101,27 @@ class FrontendLogger : public Logger {
   // Global queue
   std::vector<LogRecord *> global_queue;
 
+  // Spans of the bytes collected from the log buffers of the backend loggers
+  std::vector<struct iovec> collected_spans;
+
+  // number of records in the collected spans
+  size_t collected_span_record_count = 0;
+
   // period with which it collects log records from backend loggers
   // (in microseconds)
   int64_t wait_timeout = 5;
 
   // used to indicate if backend has new logs
   bool need_to_collect_new_log_records = false;
+
+  // size of the messages collected since the last flush
+  size_t collected_bytes = 0;
+
+  // the commits up to this cid were collected, if they are in this stream
+  cid_t collected_cid = INVALID_CID;
+
+  // the commits up to this cid are durable, if they are in this stream
+  std::atomic<cid_t> durable_cid = ATOMIC_VAR_INIT(0);
 };
 
 }  // namespace logging
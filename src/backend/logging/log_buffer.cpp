@@ -0,0 +1,213 @@
+/*-------------------------------------------------------------------------
+ *
+ * log_buffer.cpp
+ * file description
+ *
+ * Copyright(c) 2015, CMU
+ *
+ * /peloton/src/backend/logging/log_buffer.cpp
+ *
+ *-------------------------------------------------------------------------
+ */
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <limits>
+#include <thread>
+
+#include "backend/logging/log_buffer.h"
+
+namespace peloton {
+namespace logging {
+
+#define LOG_BUFFER_MASK (static_cast<uint64_t>(LOG_BUFFER_SIZE) - 1)
+
+// no padding in the ring
+#define INVALID_PADDING_POSITION std::numeric_limits<uint64_t>::max()
+
+LogBuffer::LogBuffer()
+    : output(*this),
+      published_position(0),
+      published_record_count(0),
+      padding_position(INVALID_PADDING_POSITION),
+      released_position(0) {}
+
+/**
+ * @brief Serialize the record after the appended records
+ * @param log record
+ * @return false if the record is larger than a quarter of the ring
+ */
+bool LogBuffer::Append(LogRecord *record) {
+  if (buffer == nullptr) {
+    buffer.reset(new char[LOG_BUFFER_SIZE]);
+  }
+
+  // Publish a large batch early, the consumer cannot release unpublished
+  // bytes, so they must leave room for the next record
+  if (appended_position - GetPublishedPosition() > LOG_BUFFER_SIZE / 4) {
+    Publish();
+  }
+
+  output.Begin(appended_position);
+  record->SerializeTo(output);
+
+  if (output.IsOversized()) {
+    output.Abort();
+    return false;
+  }
+
+  appended_position = output.GetEndPosition();
+  appended_record_count++;
+  return true;
+}
+
+/**
+ * @brief Make the appended records visible to the consumer
+ */
+void LogBuffer::Publish(void) {
+  // The position goes first, see Collect
+  published_position.store(appended_position, std::memory_order_release);
+  published_record_count.store(appended_record_count,
+                               std::memory_order_release);
+}
+
+/**
+ * @brief Collect the published bytes that were not collected yet
+ * @param spans of the collected bytes
+ * @return the number of collected records
+ */
+size_t LogBuffer::Collect(std::vector<struct iovec> &spans) {
+  // Read the count before the position, so that we never count records
+  // whose bytes we did not collect. We may collect the bytes of records
+  // that we count in a later call though, so always add up the count.
+  auto record_count = published_record_count.load(std::memory_order_acquire);
+  auto end_position = published_position.load(std::memory_order_acquire);
+
+  if (end_position != collected_position) {
+    // Skip the padding before the front of the ring, if any
+    auto padding = padding_position.load(std::memory_order_acquire);
+    if (padding >= collected_position && padding < end_position) {
+      AddSpans(spans, collected_position, padding);
+      collected_position = (padding | LOG_BUFFER_MASK) + 1;
+    }
+
+    AddSpans(spans, collected_position, end_position);
+    collected_position = end_position;
+  }
+
+  auto collected_count = record_count - collected_record_count;
+  collected_record_count = record_count;
+
+  return collected_count;
+}
+
+/**
+ * @brief Give the collected bytes back to the producer
+ */
+void LogBuffer::Release(void) {
+  released_position.store(collected_position, std::memory_order_release);
+}
+
+size_t LogBuffer::GetWritableSize(uint64_t position) const {
+  size_t end_of_ring = LOG_BUFFER_SIZE - (position & LOG_BUFFER_MASK);
+  size_t free_space = GetReleasedPosition() + LOG_BUFFER_SIZE - position;
+  return std::min(end_of_ring, free_space);
+}
+
+void LogBuffer::WaitForSpace(uint64_t end_position) const {
+  // Otherwise, we would wait for ourselves
+  assert(end_position - GetPublishedPosition() <= LOG_BUFFER_SIZE);
+
+  while (end_position - GetReleasedPosition() > LOG_BUFFER_SIZE) {
+    std::this_thread::yield();
+  }
+}
+
+void LogBuffer::AddSpans(std::vector<struct iovec> &spans,
+                         uint64_t start_position,
+                         uint64_t end_position) const {
+  // The bytes may still cross the end of the ring, when a record ends
+  // exactly there
+  while (start_position < end_position) {
+    size_t offset = start_position & LOG_BUFFER_MASK;
+    size_t length = std::min<uint64_t>(end_position - start_position,
+                                       LOG_BUFFER_SIZE - offset);
+
+    spans.push_back({buffer.get() + offset, length});
+    start_position += length;
+  }
+}
+
+//===--------------------------------------------------------------------===//
+// Record Output
+//===--------------------------------------------------------------------===//
+
+void LogBuffer::RecordOutput::Begin(uint64_t position) {
+  start_position = position;
+  begin_padding_position =
+      log_buffer.padding_position.load(std::memory_order_relaxed);
+  overflow.reset();
+
+  SetPosition(0);
+  Initialize(log_buffer.buffer.get() + (position & LOG_BUFFER_MASK),
+             GetCapacity());
+}
+
+/**
+ * @brief Make room for the record, moving it to the front of the ring
+ * if it does not fit before the end
+ * A record that is larger than a quarter of the ring is serialized off the
+ * ring, so that Append can turn it down.
+ * @param minimum_desired size of the record
+ */
+void LogBuffer::RecordOutput::Expand(size_t minimum_desired) {
+  if (minimum_desired > LOG_BUFFER_SIZE / 4 || overflow != nullptr) {
+    size_t overflow_size = std::max(minimum_desired, 2 * Size());
+    std::unique_ptr<char[]> new_overflow(new char[overflow_size]);
+    std::memcpy(new_overflow.get(), Data(), Size());
+
+    overflow = std::move(new_overflow);
+    Initialize(overflow.get(), overflow_size);
+    return;
+  }
+
+  size_t offset = start_position & LOG_BUFFER_MASK;
+  if (offset + minimum_desired > LOG_BUFFER_SIZE) {
+    uint64_t front_position = start_position + (LOG_BUFFER_SIZE - offset);
+    log_buffer.WaitForSpace(front_position + minimum_desired);
+
+    // Move what we have serialized so far
+    std::memmove(log_buffer.buffer.get(), log_buffer.buffer.get() + offset,
+                 Size());
+
+    log_buffer.padding_position.store(start_position,
+                                      std::memory_order_release);
+    start_position = front_position;
+  } else {
+    log_buffer.WaitForSpace(start_position + minimum_desired);
+  }
+
+  Initialize(log_buffer.buffer.get() + (start_position & LOG_BUFFER_MASK),
+             GetCapacity());
+}
+
+size_t LogBuffer::RecordOutput::GetCapacity(void) const {
+  // Even in an empty ring, so that a large record always reaches Expand
+  return std::min<size_t>(log_buffer.GetWritableSize(start_position),
+                          LOG_BUFFER_SIZE / 4);
+}
+
+/**
+ * @brief Forget the record, and the padding that its move left
+ * The consumer ignores the padding until it is published, so it can still
+ * be taken back.
+ */
+void LogBuffer::RecordOutput::Abort(void) {
+  log_buffer.padding_position.store(begin_padding_position,
+                                    std::memory_order_release);
+  overflow.reset();
+}
+
+}  // namespace logging
+}  // namespace peloton
@@ -0,0 +1,180 @@
+/*-------------------------------------------------------------------------
+ *
+ * log_buffer.h
+ * file description
+ *
+ * Copyright(c) 2015, CMU
+ *
+ * /peloton/src/backend/logging/log_buffer.h
+ *
+ *-------------------------------------------------------------------------
+ */
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <sys/uio.h>
+
+#include "backend/common/serializer.h"
+#include "backend/logging/log_record.h"
+
+namespace peloton {
+namespace logging {
+
+// Size of the log buffer of a backend logger (power of two)
+#define LOG_BUFFER_SIZE (4 * 1024 * 1024)
+
+//===--------------------------------------------------------------------===//
+// Log Buffer
+//===--------------------------------------------------------------------===//
+
+/**
+ * Ring of serialized log records, with a single producer (the backend
+ * logger) and a single consumer (the frontend logger).
+ *
+ * The records are serialized in place, and the producer publishes them by
+ * moving the published position forward. The consumer collects the
+ * published bytes as spans that point into the ring, writes them out and
+ * then releases them, which gives the space back to the producer. So
+ * neither side takes a lock, and the record bytes are never copied.
+ *
+ * Positions grow monotonically, and the offset in the ring is the position
+ * modulo the size. A record never wraps around: when it does not fit before
+ * the end of the ring, the rest of the ring is left as padding and the
+ * record is moved to the front.
+ *
+ * A record must fit in a quarter of the ring, next to the unpublished bytes
+ * and the padding. A larger one is not appended, the backend logger hands
+ * it over in its own message instead.
+ */
+class LogBuffer {
+  LogBuffer(LogBuffer const &) = delete;
+
+ public:
+  LogBuffer();
+
+  //===--------------------------------------------------------------------===//
+  // Producer
+  //===--------------------------------------------------------------------===//
+
+  // Serialize the record after the appended records
+  // waits for the consumer when the ring is full
+  // returns false if the record is too large for the ring, nothing is
+  // appended then
+  bool Append(LogRecord *record);
+
+  // Make the appended records visible to the consumer
+  void Publish(void);
+
+  // Get the position after the last appended record
+  uint64_t GetAppendedPosition(void) const { return appended_position; }
+
+  //===--------------------------------------------------------------------===//
+  // Consumer
+  //===--------------------------------------------------------------------===//
+
+  // Add the published bytes that were not collected yet to the spans
+  // returns the number of collected records
+  size_t Collect(std::vector<struct iovec> &spans);
+
+  // Give the collected bytes back to the producer
+  void Release(void);
+
+  //===--------------------------------------------------------------------===//
+  // Accessors
+  //===--------------------------------------------------------------------===//
+
+  uint64_t GetPublishedPosition(void) const {
+    return published_position.load(std::memory_order_acquire);
+  }
+
+  uint64_t GetReleasedPosition(void) const {
+    return released_position.load(std::memory_order_acquire);
+  }
+
+  // Is everything that was published released ?
+  bool IsEmpty(void) const {
+    return GetReleasedPosition() == GetPublishedPosition();
+  }
+
+ private:
+  // Serializes a record at the given position of the ring
+  class RecordOutput : public SerializeOutput {
+   public:
+    RecordOutput(LogBuffer &log_buffer) : log_buffer(log_buffer) {}
+
+    void Begin(uint64_t position);
+
+    uint64_t GetEndPosition(void) const { return start_position + Size(); }
+
+    // Did the record turn out too large for the ring ?
+    bool IsOversized(void) const { return overflow != nullptr; }
+
+    // Undo the move of the record to the front of the ring, if any
+    void Abort(void);
+
+   protected:
+    void Expand(size_t minimum_desired);
+
+   private:
+    // Room for the record at its position
+    size_t GetCapacity(void) const;
+
+    LogBuffer &log_buffer;
+
+    // position of the record in the ring
+    uint64_t start_position = 0;
+
+    // padding position before the record
+    uint64_t begin_padding_position = 0;
+
+    // the oversized record is serialized here, off the ring
+    std::unique_ptr<char[]> overflow;
+  };
+
+  // Get the number of bytes that can be written at the position without
+  // wrapping around or overwriting unreleased bytes
+  size_t GetWritableSize(uint64_t position) const;
+
+  // Wait until the consumer released the bytes below end - LOG_BUFFER_SIZE
+  void WaitForSpace(uint64_t end_position) const;
+
+  // Add the spans of the bytes between the positions
+  void AddSpans(std::vector<struct iovec> &spans, uint64_t start_position,
+                uint64_t end_position) const;
+
+  //===--------------------------------------------------------------------===//
+  // MEMBERS
+  //===--------------------------------------------------------------------===//
+
+  // the ring, allocated with the first record
+  std::unique_ptr<char[]> buffer;
+
+  RecordOutput output;
+
+  // producer only
+  uint64_t appended_position = 0;
+
+  size_t appended_record_count = 0;
+
+  // written by the producer
+  std::atomic<uint64_t> published_position;
+
+  std::atomic<size_t> published_record_count;
+
+  // start of the padding left by the last wrap around
+  std::atomic<uint64_t> padding_position;
+
+  // consumer only
+  uint64_t collected_position = 0;
+
+  size_t collected_record_count = 0;
+
+  // written by the consumer
+  std::atomic<uint64_t> released_position;
+};
+
+}  // namespace logging
+}  // namespace peloton
@@ -0,0 +1,656 @@
+/*-------------------------------------------------------------------------
+ *
+ * log_file.cpp
+ * file description
+ *
+ * Copyright(c) 2015, CMU
+ *
+ * /peloton/src/backend/logging/log_file.cpp
+ *
+ *-------------------------------------------------------------------------
+ */
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+
+#include "backend/common/logger.h"
+#include "backend/logging/log_file.h"
+#include "backend/logging/log_reader.h"
+
+namespace peloton {
+namespace logging {
+
+//===--------------------------------------------------------------------===//
+// Utility functions
+//===--------------------------------------------------------------------===//
+
+static std::string GetSpareFileName(std::string file_name) {
+  return file_name + ".spare";
+}
+
+/**
+ * @brief Split the file name into its directory and its name
+ */
+static std::pair<std::string, std::string> SplitFileName(
+    std::string file_name) {
+  auto separator = file_name.rfind('/');
+  if (separator == std::string::npos) {
+    return {".", file_name};
+  }
+
+  return {file_name.substr(0, separator + 1), file_name.substr(separator + 1)};
+}
+
+/**
+ * @brief List the numbers of the segments of a log
+ * @return the segment numbers, in order
+ */
+static std::vector<size_t> ListSegments(std::string file_name) {
+  std::vector<size_t> segment_numbers;
+  auto names = SplitFileName(file_name);
+  auto prefix = names.second + ".";
+
+  DIR *dir = opendir(names.first.c_str());
+  if (dir == nullptr) return segment_numbers;
+
+  struct dirent *entry;
+  while ((entry = readdir(dir)) != nullptr) {
+    std::string entry_name = entry->d_name;
+    if (entry_name == names.second) {
+      segment_numbers.push_back(0);
+      continue;
+    }
+
+    // The other segments add their number to the name
+    if (entry_name.compare(0, prefix.size(), prefix) != 0 ||
+        entry_name.size() == prefix.size()) {
+      continue;
+    }
+    auto suffix = entry_name.substr(prefix.size());
+    if (std::all_of(suffix.begin(), suffix.end(), ::isdigit) == false) {
+      continue;
+    }
+    segment_numbers.push_back(std::stoul(suffix));
+  }
+  closedir(dir);
+
+  std::sort(segment_numbers.begin(), segment_numbers.end());
+  return segment_numbers;
+}
+
+/**
+ * @brief Write the whole data at the offset
+ * @return false on error
+ */
+static bool WriteAll(int fd, const char *data, size_t size, size_t offset) {
+  size_t written = 0;
+
+  while (written < size) {
+    ssize_t ret = pwrite(fd, data + written, size - written, offset + written);
+    if (ret < 0 && errno == EINTR) continue;
+    if (ret < 0) {
+      LOG_ERROR("Error occured in pwrite(%d)", errno);
+      return false;
+    }
+    written += ret;
+  }
+
+  return true;
+}
+
+/**
+ * @brief Write the spans at the offset, with as few system calls as possible
+ * @param spans, consumed as they are written
+ * @return false on error
+ */
+static bool WriteSpansAt(int fd, struct iovec *spans, size_t span_count,
+                         size_t offset) {
+  size_t span_offset = 0;
+
+  while (span_offset < span_count) {
+    int count = std::min<size_t>(span_count - span_offset, IOV_MAX);
+    ssize_t ret = pwritev(fd, &spans[span_offset], count, offset);
+    if (ret < 0) {
+      if (errno == EINTR) continue;
+      LOG_ERROR("Error occured in pwritev(%d)", errno);
+      return false;
+    }
+    offset += ret;
+
+    // Skip the written spans, and the written part of a partial one
+    size_t written = ret;
+    while (span_offset < span_count && written >= spans[span_offset].iov_len) {
+      written -= spans[span_offset].iov_len;
+      span_offset++;
+    }
+    if (written > 0) {
+      auto &span = spans[span_offset];
+      span.iov_base = static_cast<char *>(span.iov_base) + written;
+      span.iov_len -= written;
+    }
+  }
+
+  return true;
+}
+
+/**
+ * @brief Fill a part of a file with zeros
+ * @return false on error
+ */
+static bool ZeroFile(std::string file_name, size_t offset, size_t size) {
+  // Without direct io, as the range is not aligned
+  int fd = open(file_name.c_str(), O_WRONLY);
+  if (fd == -1) return false;
+
+  bool status = (fallocate(fd, FALLOC_FL_ZERO_RANGE, offset, size) == 0);
+
+  // The file system may not support it, write the zeros then
+  if (status == false) {
+    std::unique_ptr<char[]> zeros(new char[LOG_BLOCK_SIZE]());
+    status = true;
+    for (size_t zeroed = 0; zeroed < size && status; zeroed += LOG_BLOCK_SIZE) {
+      status = WriteAll(fd, zeros.get(),
+                        std::min<size_t>(size - zeroed, LOG_BLOCK_SIZE),
+                        offset + zeroed);
+    }
+  }
+
+  close(fd);
+  return status;
+}
+
+//===--------------------------------------------------------------------===//
+// Log File
+//===--------------------------------------------------------------------===//
+
+LogFile::LogFile(std::string file_name, bool direct_io)
+    : file_name(file_name), direct_io(direct_io) {}
+
+LogFile::~LogFile() {
+  for (auto &segment : segments) {
+    close(segment.fd);
+  }
+
+  if (spare_fd != -1) {
+    close(spare_fd);
+  }
+
+  free(write_buffer);
+}
+
+std::string LogFile::GetSegmentFileName(std::string file_name,
+                                        size_t segment_number) {
+  if (segment_number == 0) return file_name;
+
+  return file_name + "." + std::to_string(segment_number);
+}
+
+/**
+ * @brief Open the segments, and find the end of the log in the last one
+ * The part of the last segment after the end is filled with zeros, so that
+ * nothing of a torn write is read after the next records.
+ * @return false on error
+ */
+bool LogFile::Open(void) {
+  if (direct_io) {
+    void *buffer = nullptr;
+    if (posix_memalign(&buffer, LOG_BLOCK_SIZE, LOG_WRITE_BUFFER_SIZE) != 0) {
+      LOG_ERROR("Could not allocate the write buffer");
+      return false;
+    }
+    write_buffer = static_cast<char *>(buffer);
+  }
+
+  auto segment_numbers = ListSegments(file_name);
+
+  // A new log
+  if (segment_numbers.empty()) {
+    int fd = AllocateSegment(GetSegmentFileName(file_name, 0));
+    if (fd == -1) return false;
+    SyncDirectory();
+
+    segments.push_back({0, fd, LOG_SEGMENT_SIZE});
+    log_end = 0;
+    return true;
+  }
+
+  // Only the segments after a missing one are of use, a larger segment
+  // takes the numbers of the segments it covers
+  size_t first_itr = 0;
+  for (size_t segment_itr = 1; segment_itr < segment_numbers.size();
+       segment_itr++) {
+    auto prev_number = segment_numbers[segment_itr - 1];
+    struct stat prev_stats;
+    size_t prev_segment_count = 1;
+    if (stat(GetSegmentFileName(file_name, prev_number).c_str(),
+             &prev_stats) == 0 &&
+        static_cast<size_t>(prev_stats.st_size) > LOG_SEGMENT_SIZE) {
+      prev_segment_count = prev_stats.st_size / LOG_SEGMENT_SIZE;
+    }
+
+    if (segment_numbers[segment_itr] != prev_number + prev_segment_count) {
+      LOG_ERROR("Log segment %lu is missing", prev_number + prev_segment_count);
+      first_itr = segment_itr;
+    }
+  }
+
+  for (size_t segment_itr = first_itr; segment_itr < segment_numbers.size();
+       segment_itr++) {
+    auto segment_number = segment_numbers[segment_itr];
+    auto segment_file_name = GetSegmentFileName(file_name, segment_number);
+
+    int fd = OpenSegment(segment_file_name, O_RDWR);
+    if (fd == -1) {
+      LOG_ERROR("Could not open the log segment %s (%d)",
+                segment_file_name.c_str(), errno);
+      return false;
+    }
+
+    struct stat segment_stats;
+    fstat(fd, &segment_stats);
+    size_t segment_size = segment_stats.st_size;
+    segments.push_back({segment_number, fd, segment_size});
+
+    if (segment_size > LOG_SEGMENT_SIZE &&
+        segment_size % LOG_SEGMENT_SIZE != 0) {
+      LOG_ERROR("Log segment %s is not a multiple of a segment",
+                segment_file_name.c_str());
+      return false;
+    }
+  }
+
+  // The spare segment is empty already
+  spare_fd = OpenSegment(GetSpareFileName(file_name), O_RDWR);
+
+  // Find the end of the log, the last segment starts with a record
+  auto &segment = segments.back();
+  size_t segment_end = 0;
+  {
+    LogReader log_reader(segment.fd, 0, segment.size);
+    RawLogRecord record;
+    while (log_reader.ReadRecord(record))
+      ;
+    segment_end = log_reader.GetOffset();
+  }
+
+  auto segment_file_name =
+      GetSegmentFileName(file_name, segment.segment_number);
+  if (segment.size > segment_end &&
+      ZeroFile(segment_file_name, segment_end, segment.size - segment_end) ==
+          false) {
+    LOG_ERROR("Could not clear the end of the log");
+    return false;
+  }
+
+  // Allocate the rest of the segment
+  if (segment.size < LOG_SEGMENT_SIZE) {
+    if (fallocate(segment.fd, 0, 0, LOG_SEGMENT_SIZE) != 0 &&
+        ftruncate(segment.fd, LOG_SEGMENT_SIZE) != 0) {
+      LOG_ERROR("Could not allocate the log segment (%d)", errno);
+      return false;
+    }
+    segment.size = LOG_SEGMENT_SIZE;
+  }
+  fsync(segment.fd);
+
+  log_end = segment.segment_number * LOG_SEGMENT_SIZE + segment_end;
+
+  // The staging buffer starts with the last partial block
+  size_t partial_size = segment_end % LOG_BLOCK_SIZE;
+  if (direct_io && partial_size > 0) {
+    size_t block_start = segment_end - partial_size;
+    if (pread(segment.fd, write_buffer, LOG_BLOCK_SIZE, block_start) !=
+        LOG_BLOCK_SIZE) {
+      LOG_ERROR("Could not read the end of the log (%d)", errno);
+      return false;
+    }
+  }
+
+  return true;
+}
+
+/**
+ * @brief Write the spans at the end of the log
+ * The spans that do not fit in the last segment go to the next one. A span
+ * larger than a segment grows the empty segment it starts.
+ * @param spans, consumed as they are written
+ * @return false on error
+ */
+bool LogFile::Write(std::vector<struct iovec> &spans) {
+  size_t span_offset = 0;
+
+  while (span_offset < spans.size()) {
+    LogSegment segment;
+    {
+      std::lock_guard<std::mutex> lock(segment_mutex);
+      segment = segments.back();
+    }
+    size_t segment_offset =
+        log_end - segment.segment_number * LOG_SEGMENT_SIZE;
+
+    // The spans that fit in the segment
+    size_t span_end = span_offset;
+    size_t write_size = 0;
+    while (span_end < spans.size() &&
+           segment_offset + write_size + spans[span_end].iov_len <=
+               segment.size) {
+      write_size += spans[span_end].iov_len;
+      span_end++;
+    }
+
+    // Go on in the next segment, or grow the empty one for a larger span
+    if (span_end == span_offset) {
+      bool status;
+      if (segment_offset == 0) {
+        status = GrowSegment(spans[span_offset].iov_len);
+      } else {
+        status = AddSegment();
+      }
+      if (status == false) return false;
+      continue;
+    }
+
+    bool status;
+    if (direct_io) {
+      status = WriteDirect(segment, spans, span_offset, span_end);
+    } else {
+      status = WriteSpansAt(segment.fd, &spans[span_offset],
+                            span_end - span_offset, segment_offset);
+    }
+    if (status == false) return false;
+
+    log_end += write_size;
+    need_sync = true;
+    span_offset = span_end;
+  }
+
+  return true;
+}
+
+/**
+ * @brief Write the spans in direct mode, through the staging buffer
+ * The buffer starts with the last partial block of the segment, and only
+ * whole blocks are written, with zeros after the end of the log.
+ * @return false on error
+ */
+bool LogFile::WriteDirect(LogSegment &segment,
+                          std::vector<struct iovec> &spans, size_t span_offset,
+                          size_t span_end) {
+  size_t segment_offset = log_end - segment.segment_number * LOG_SEGMENT_SIZE;
+  size_t buffered_size = segment_offset % LOG_BLOCK_SIZE;
+  size_t block_start = segment_offset - buffered_size;
+
+  for (size_t span_itr = span_offset; span_itr < span_end; span_itr++) {
+    auto data = static_cast<const char *>(spans[span_itr].iov_base);
+    size_t size = spans[span_itr].iov_len;
+
+    while (size > 0) {
+      size_t copy_size =
+          std::min<size_t>(size, LOG_WRITE_BUFFER_SIZE - buffered_size);
+      memcpy(write_buffer + buffered_size, data, copy_size);
+      buffered_size += copy_size;
+      data += copy_size;
+      size -= copy_size;
+
+      // Write out the full buffer
+      if (buffered_size == LOG_WRITE_BUFFER_SIZE) {
+        if (WriteAll(segment.fd, write_buffer, LOG_WRITE_BUFFER_SIZE,
+                     block_start) == false) {
+          return false;
+        }
+        block_start += LOG_WRITE_BUFFER_SIZE;
+        buffered_size = 0;
+      }
+    }
+  }
+
+  if (buffered_size == 0) return true;
+
+  // Write out the rest, up to the end of its last block
+  size_t partial_size = buffered_size % LOG_BLOCK_SIZE;
+  size_t write_size = buffered_size;
+  if (partial_size > 0) {
+    write_size += LOG_BLOCK_SIZE - partial_size;
+    memset(write_buffer + buffered_size, 0, write_size - buffered_size);
+  }
+  if (WriteAll(segment.fd, write_buffer, write_size, block_start) == false) {
+    return false;
+  }
+
+  // Keep the last partial block for the next write
+  if (partial_size > 0) {
+    memmove(write_buffer, write_buffer + buffered_size - partial_size,
+            partial_size);
+  }
+
+  return true;
+}
+
+/**
+ * @brief Make the writes durable
+ * Only the data is synced, the segments do not change their size.
+ * @return false on error
+ */
+bool LogFile::Sync(void) {
+  if (need_sync == false) return true;
+
+  int fd;
+  {
+    std::lock_guard<std::mutex> lock(segment_mutex);
+    fd = segments.back().fd;
+  }
+
+  int ret = fdatasync(fd);
+  if (ret != 0) {
+    LOG_ERROR("Error occured in fdatasync(%d)", errno);
+    return false;
+  }
+
+  need_sync = false;
+  return true;
+}
+
+/**
+ * @brief Open the next segment, from the spare one if there is one
+ * The last segment is synced first, so that a segment is never durable
+ * before the ones before it.
+ * @return false on error
+ */
+bool LogFile::AddSegment(void) {
+  if (Sync() == false) return false;
+
+  std::lock_guard<std::mutex> lock(segment_mutex);
+  auto &last_segment = segments.back();
+  auto segment_number =
+      last_segment.segment_number + last_segment.size / LOG_SEGMENT_SIZE;
+  auto segment_file_name = GetSegmentFileName(file_name, segment_number);
+
+  int fd = -1;
+  if (spare_fd != -1 &&
+      rename(GetSpareFileName(file_name).c_str(), segment_file_name.c_str()) ==
+          0) {
+    fd = spare_fd;
+    spare_fd = -1;
+  } else {
+    fd = AllocateSegment(segment_file_name);
+    if (fd == -1) return false;
+  }
+  SyncDirectory();
+
+  segments.push_back({segment_number, fd, LOG_SEGMENT_SIZE});
+  log_end = segment_number * LOG_SEGMENT_SIZE;
+  return true;
+}
+
+/**
+ * @brief Open a segment file, with direct io if it is enabled
+ * Falls back to buffered writes if the file system does not support it.
+ * @return its descriptor, or -1 on error
+ */
+int LogFile::OpenSegment(std::string segment_file_name, int flags) {
+  int fd = open(segment_file_name.c_str(), flags | (direct_io ? O_DIRECT : 0),
+                0644);
+  if (fd == -1 && direct_io && errno == EINVAL) {
+    LOG_WARN("Direct io is not supported for the log, using buffered io");
+    direct_io = false;
+    fd = open(segment_file_name.c_str(), flags, 0644);
+  }
+
+  return fd;
+}
+
+/**
+ * @brief Allocate a new segment file
+ * @return its descriptor, or -1 on error
+ */
+int LogFile::AllocateSegment(std::string segment_file_name) {
+  int fd = OpenSegment(segment_file_name, O_RDWR | O_CREAT | O_TRUNC);
+  if (fd == -1) {
+    LOG_ERROR("Could not create the log segment %s (%d)",
+              segment_file_name.c_str(), errno);
+    return -1;
+  }
+
+  // The file system may not support allocating, the size is fixed then
+  if (fallocate(fd, 0, 0, LOG_SEGMENT_SIZE) != 0 &&
+      ftruncate(fd, LOG_SEGMENT_SIZE) != 0) {
+    LOG_ERROR("Could not allocate the log segment (%d)", errno);
+    close(fd);
+    return -1;
+  }
+  fsync(fd);
+
+  return fd;
+}
+
+/**
+ * @brief Grow the empty last segment, so that it holds the span
+ * It takes the numbers of the segments it covers, so the offsets in the log
+ * stay the same.
+ * @return false on error
+ */
+bool LogFile::GrowSegment(size_t span_size) {
+  size_t segment_size =
+      (span_size + LOG_SEGMENT_SIZE - 1) / LOG_SEGMENT_SIZE * LOG_SEGMENT_SIZE;
+
+  std::lock_guard<std::mutex> lock(segment_mutex);
+  auto &segment = segments.back();
+  if (fallocate(segment.fd, 0, 0, segment_size) != 0 &&
+      ftruncate(segment.fd, segment_size) != 0) {
+    LOG_ERROR("Could not grow the log segment (%d)", errno);
+    return false;
+  }
+  fsync(segment.fd);
+
+  segment.size = segment_size;
+  return true;
+}
+
+/**
+ * @brief Allocate the spare segment if there is none
+ */
+void LogFile::PrepareSpareSegment(void) {
+  std::lock_guard<std::mutex> lock(segment_mutex);
+  if (spare_fd != -1) return;
+
+  spare_fd = AllocateSegment(GetSpareFileName(file_name));
+  SyncDirectory();
+}
+
+/**
+ * @brief Free the segments before the offset
+ * The first one is emptied and kept as the spare segment, if there is no
+ * spare one yet and it is not a larger one. The last segment is always
+ * kept.
+ * @param log offset
+ */
+void LogFile::Truncate(size_t log_offset) {
+  std::lock_guard<std::mutex> lock(segment_mutex);
+  bool truncated = false;
+
+  while (segments.size() > 1 &&
+         segments.front().segment_number * LOG_SEGMENT_SIZE +
+                 segments.front().size <=
+             log_offset) {
+    auto segment = segments.front();
+    segments.erase(segments.begin());
+    truncated = true;
+
+    auto segment_file_name =
+        GetSegmentFileName(file_name, segment.segment_number);
+    auto spare_file_name = GetSpareFileName(file_name);
+    if (spare_fd == -1 && segment.size == LOG_SEGMENT_SIZE &&
+        ZeroFile(segment_file_name, 0, LOG_SEGMENT_SIZE) == true &&
+        rename(segment_file_name.c_str(), spare_file_name.c_str()) == 0) {
+      spare_fd = segment.fd;
+      continue;
+    }
+
+    close(segment.fd);
+    unlink(segment_file_name.c_str());
+  }
+
+  if (truncated) SyncDirectory();
+}
+
+/**
+ * @brief Remove all the segments of a log
+ */
+void LogFile::Remove(std::string file_name) {
+  for (auto segment_number : ListSegments(file_name)) {
+    unlink(GetSegmentFileName(file_name, segment_number).c_str());
+  }
+  unlink(GetSpareFileName(file_name).c_str());
+}
+
+bool LogFile::Exists(std::string file_name) {
+  return ListSegments(file_name).empty() == false;
+}
+
+size_t LogFile::GetLogStart(void) {
+  std::lock_guard<std::mutex> lock(segment_mutex);
+  if (segments.empty()) return 0;
+
+  return segments.front().segment_number * LOG_SEGMENT_SIZE;
+}
+
+/**
+ * @brief Get the segments that have a part of the log between the offsets
+ */
+std::vector<LogSegment> LogFile::GetSegments(size_t log_start,
+                                             size_t log_end) {
+  std::vector<LogSegment> log_segments;
+
+  std::lock_guard<std::mutex> lock(segment_mutex);
+  for (auto &segment : segments) {
+    size_t segment_start = segment.segment_number * LOG_SEGMENT_SIZE;
+    if (segment_start < log_end && segment_start + segment.size > log_start) {
+      log_segments.push_back(segment);
+    }
+  }
+
+  return log_segments;
+}
+
+/**
+ * @brief Make the creation and renaming of the segments durable
+ */
+void LogFile::SyncDirectory(void) {
+  auto dir_name = SplitFileName(file_name).first;
+  int dir_fd = open(dir_name.c_str(), O_RDONLY | O_DIRECTORY);
+  if (dir_fd == -1) return;
+
+  fsync(dir_fd);
+  close(dir_fd);
+}
+
+}  // namespace logging
+}  // namespace peloton
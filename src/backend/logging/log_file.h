@@ -0,0 +1,170 @@
+/*-------------------------------------------------------------------------
+ *
+ * log_file.h
+ * file description
+ *
+ * Copyright(c) 2015, CMU
+ *
+ * /peloton/src/backend/logging/log_file.h
+ *
+ *-------------------------------------------------------------------------
+ */
+
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <sys/uio.h>
+
+#include "backend/common/types.h"
+
+namespace peloton {
+namespace logging {
+
+// Size of a log segment (a multiple of the page size)
+#define LOG_SEGMENT_SIZE (16 * 1024 * 1024)
+
+// Alignment of the direct writes
+#define LOG_BLOCK_SIZE 4096
+
+// Size of the staging buffer of the direct writes (a multiple of the block)
+#define LOG_WRITE_BUFFER_SIZE (1024 * 1024)
+
+// A segment of the log
+struct LogSegment {
+  // its number, it starts at the number times the segment size in the log
+  size_t segment_number;
+
+  int fd;
+
+  // size of the file, a multiple of the segment size for a larger span
+  size_t size;
+};
+
+//===--------------------------------------------------------------------===//
+// Log File
+//===--------------------------------------------------------------------===//
+
+/**
+ * A log, as a sequence of segment files of a fixed size.
+ *
+ * The first segment is the log file itself, and the others add their
+ * number to its name. A segment is allocated at once, so the writes do not
+ * change its size, and syncing them does not have to sync the metadata of
+ * the file. The unused part of a segment is zeros, which ends the records.
+ *
+ * The records never go over the end of a segment, the spans that do not
+ * fit are written to the next one. So the offset of a record in the log is
+ * the start of its segment plus its offset in the segment, and every
+ * segment starts with a record. A span larger than a segment starts a
+ * segment of its own, which is as large as the multiple of the segment
+ * size that holds it, and takes the numbers of the segments it covers.
+ *
+ * The writes are appended to the page cache, or with direct mode, go
+ * through an aligned buffer straight to the device. The last partial block
+ * is then written again by the next write.
+ *
+ * Once the log before an offset is not needed anymore, the segments before
+ * it are emptied and kept as a spare segment, which is the next one used.
+ */
+class LogFile {
+  LogFile(LogFile const &) = delete;
+
+ public:
+  LogFile(std::string file_name, bool direct_io);
+
+  ~LogFile();
+
+  // Open the segments, and find the end of the log in the last one
+  // returns false on error
+  bool Open(void);
+
+  // Write the spans at the end of the log
+  // Each span has whole records
+  // returns false on error
+  bool Write(std::vector<struct iovec> &spans);
+
+  // Make the writes durable
+  bool Sync(void);
+
+  // Allocate the spare segment if there is none, so that moving to the
+  // next segment does not wait for it
+  void PrepareSpareSegment(void);
+
+  // Free the segments before the offset
+  void Truncate(size_t log_offset);
+
+  // Remove all the segments of a log
+  static void Remove(std::string file_name);
+
+  // Does the log have any segment ?
+  static bool Exists(std::string file_name);
+
+  //===--------------------------------------------------------------------===//
+  // Accessors
+  //===--------------------------------------------------------------------===//
+
+  // Get the offset of the first segment in the log
+  size_t GetLogStart(void);
+
+  // Get the offset where the next records are written
+  size_t GetLogEnd(void) const { return log_end; }
+
+  // Get the segments that have a part of the log between the offsets
+  std::vector<LogSegment> GetSegments(size_t log_start, size_t log_end);
+
+  static std::string GetSegmentFileName(std::string file_name,
+                                        size_t segment_number);
+
+ private:
+  // Open the next segment, from the spare one if there is one
+  bool AddSegment(void);
+
+  // Open a segment file, with direct io if it is supported
+  // returns its descriptor, or -1 on error
+  int OpenSegment(std::string segment_file_name, int flags);
+
+  // Allocate a new segment file
+  int AllocateSegment(std::string segment_file_name);
+
+  // Grow the empty last segment, so that it holds the span
+  bool GrowSegment(size_t span_size);
+
+  // Write in direct mode, through the staging buffer
+  bool WriteDirect(LogSegment &segment, std::vector<struct iovec> &spans,
+                   size_t span_offset, size_t span_end);
+
+  // Make the creation and renaming of the segments durable
+  void SyncDirectory(void);
+
+  //===--------------------------------------------------------------------===//
+  // Member Variables
+  //===--------------------------------------------------------------------===//
+
+  std::string file_name;
+
+  bool direct_io;
+
+  // Sync access to the segments and the spare segment with segment mutex
+  // Only the writer adds segments
+  std::vector<LogSegment> segments;
+
+  std::mutex segment_mutex;
+
+  // fd of the spare segment, or -1
+  int spare_fd = -1;
+
+  // offset where the next records are written
+  size_t log_end = 0;
+
+  // was the last segment written since the last sync ?
+  bool need_sync = false;
+
+  // staging buffer of the direct writes, holds the last partial block
+  char *write_buffer = nullptr;
+};
+
+}  // namespace logging
+}  // namespace peloton
@@ -34,13 +34,25 @@ LogManager::~LogManager() {}
  * @param logging type can be stdout(debug), aries, peloton
  */
 void LogManager::StartStandbyMode() {
-  // If frontend logger doesn't exist
-  if (frontend_logger == nullptr) {
-    frontend_logger = FrontendLogger::GetFrontendLogger(peloton_logging_mode);
+  // If frontend loggers don't exist
+  if (frontend_loggers.empty()) {
+    // Only the aries logging has more than one log
+    size_t logger_count = std::max(frontend_logger_count, size_t(1));
+    if (IsSimilarToARIES(peloton_logging_mode) == false && logger_count > 1) {
+      LOG_WARN("Only the aries logging has more than one frontend logger");
+      logger_count = 1;
+    }
+
+    for (oid_t logger_id = 0; logger_id < logger_count; logger_id++) {
+      auto frontend_logger =
+          FrontendLogger::GetFrontendLogger(peloton_logging_mode, logger_id);
+      if (frontend_logger == nullptr) break;
+      frontend_loggers.push_back(frontend_logger);
+    }
   }
 
   // If frontend logger still doesn't exist, then we disabled logging
-  if (frontend_logger == nullptr) {
+  if (frontend_loggers.empty()) {
     LOG_INFO("We have disabled logging");
     return;
   }
@@ -48,8 +60,22 @@ void LogManager::StartStandbyMode() {
   // Toggle status in log manager map
   SetLoggingStatus(LOGGING_STATUS_TYPE_STANDBY);
 
-  // Launch the frontend logger's main loop
-  frontend_logger->MainLoop();
+  // Launch the frontend loggers' main loops, this thread runs the first one
+  std::vector<std::thread> logger_threads;
+  for (size_t logger_itr = 1; logger_itr < frontend_loggers.size();
+       logger_itr++) {
+    logger_threads.push_back(std::thread(&FrontendLogger::MainLoop,
+                                         frontend_loggers[logger_itr]));
+  }
+  frontend_loggers.front()->MainLoop();
+
+  for (auto &logger_thread : logger_threads) {
+    logger_thread.join();
+  }
+
+  // Setting frontend logger status to sleep, once all of them are done
+  LOG_TRACE("Frontendlogger] Sleep Mode");
+  SetLoggingStatus(LOGGING_STATUS_TYPE_SLEEP);
 }
 
 void LogManager::StartRecoveryMode() {
@@ -100,8 +126,8 @@ bool LogManager::EndLogging() {
 
   LOG_INFO("Escaped from MainLoop");
 
-  // Remove the frontend logger
-  if (RemoveFrontendLogger()) {
+  // Remove the frontend loggers
+  if (RemoveFrontendLoggers()) {
     ResetLoggingStatusMap();
     LOG_INFO("Terminated successfully");
     return true;
@@ -117,6 +143,7 @@ bool LogManager::EndLogging() {
 /**
  * @brief Return the backend logger based on logging type
     and store it into the vector
+ * The backend loggers are spread over the frontend loggers round-robin.
  * @param logging type can be stdout(debug), aries, peloton
  */
 BackendLogger *LogManager::GetBackendLogger() {
@@ -126,31 +153,70 @@ BackendLogger *LogManager::GetBackendLogger() {
   // if so, create backend logger and store it in frontend logger
   {
     // If frontend logger exists
-    if (frontend_logger != nullptr) {
+    if (frontend_loggers.empty() == false) {
       backend_logger = BackendLogger::GetBackendLogger(peloton_logging_mode);
       if (!backend_logger->IsConnectedToFrontend()) {
-        frontend_logger->AddBackendLogger(backend_logger);
+        auto logger_itr = next_frontend_logger++ % frontend_loggers.size();
+        frontend_loggers[logger_itr]->AddBackendLogger(backend_logger);
       }
     }
   }
 
-  if (frontend_logger == nullptr) {
+  if (frontend_loggers.empty()) {
     LOG_ERROR("Frontend logger doesn't exist!!");
   }
 
   return backend_logger;
 }
 
+/**
+ * @brief Take a checkpoint with the first frontend logger, if there is one
+ */
+bool LogManager::TakeCheckpoint(void) {
+  if (frontend_loggers.empty()) {
+    return false;
+  }
+
+  return frontend_loggers.front()->DoCheckpoint();
+}
+
+/**
+ * @brief Wait until the commits up to the cid are durable in all the logs
+ * Stops waiting once the frontend loggers are gone.
+ * @param cid
+ */
+void LogManager::WaitForDurableCommit(cid_t cid) {
+  std::unique_lock<std::mutex> wait_lock(logging_status_mutex);
+
+  while ((logging_status == LOGGING_STATUS_TYPE_LOGGING ||
+          logging_status == LOGGING_STATUS_TYPE_TERMINATE) &&
+         GetDurableCommitId() < cid) {
+    logging_status_cv.wait(wait_lock);
+  }
+}
+
+void LogManager::NotifyDurableCommit(void) {
+  std::lock_guard<std::mutex> lock(logging_status_mutex);
+  logging_status_cv.notify_all();
+}
+
+cid_t LogManager::GetDurableCommitId(void) {
+  cid_t durable_cid = MAX_CID;
+  for (auto frontend_logger : frontend_loggers) {
+    durable_cid = std::min(durable_cid, frontend_logger->GetDurableCommitId());
+  }
+
+  return durable_cid;
+}
+
 bool LogManager::RemoveBackendLogger(BackendLogger *backend_logger) {
   bool status = false;
 
   // Check whether the frontend logger exists or not
   // if so, remove backend logger otherwise return false
-  {
-    // If frontend logger exists
-    if (frontend_logger != nullptr) {
-      status = frontend_logger->RemoveBackendLogger(backend_logger);
-    }
+  for (auto frontend_logger : frontend_loggers) {
+    status = frontend_logger->RemoveBackendLogger(backend_logger);
+    if (status == true) break;
   }
 
   return status;
@@ -158,17 +224,26 @@ bool LogManager::RemoveBackendLogger(BackendLogger *backend_logger) {
 
 /**
  * @brief Find Frontend Logger in Log Manager
- * @param logging type can be stdout(debug), aries, peloton
+ * @param id of the frontend logger
  * @return the frontend logger otherwise nullptr
  */
-FrontendLogger *LogManager::GetFrontendLogger() { return frontend_logger; }
+FrontendLogger *LogManager::GetFrontendLogger(oid_t logger_id) {
+  if (logger_id >= frontend_loggers.size()) {
+    return nullptr;
+  }
 
-bool LogManager::RemoveFrontendLogger() {
-  // Erase frontend logger
-  delete frontend_logger;
+  return frontend_loggers[logger_id];
+}
+
+bool LogManager::RemoveFrontendLoggers() {
+  // Erase frontend loggers
+  for (auto frontend_logger : frontend_loggers) {
+    delete frontend_logger;
+  }
 
   // Reset
-  frontend_logger = nullptr;
+  frontend_loggers.clear();
+  next_frontend_logger = 0;
 
   return true;
 }
@@ -184,7 +259,7 @@ void LogManager::ResetLoggingStatusMap() {
 }
 
 size_t LogManager::ActiveFrontendLoggerCount(void) {
-  return (frontend_logger != nullptr);
+  return frontend_loggers.size();
 }
 
 /**
@@ -228,5 +303,13 @@ std::string LogManager::GetLogFileName(void) {
   return log_file_name;
 }
 
+std::string LogManager::GetLogFileName(oid_t logger_id) {
+  if (logger_id == 0) {
+    return GetLogFileName();
+  }
+
+  return GetLogFileName() + ".stream" + std::to_string(logger_id);
+}
+
 }  // namespace logging
 }  // namespace peloton
@@ -13,8 +13,11 @@
 #pragma once
 
 #include "backend/logging/logger.h"
+#include <algorithm>
+#include <atomic>
 #include <mutex>
 #include <map>
+#include <thread>
 #include <vector>
 #include <condition_variable>
 
@@ -33,6 +36,18 @@ extern char *peloton_log_directory;
 namespace peloton {
 namespace logging {
 
+// Default group commit window (in microseconds)
+#define GROUP_COMMIT_WINDOW 500
+
+// Default group commit budget (in bytes)
+#define GROUP_COMMIT_BUDGET (256 * 1024)
+
+// Default checkpoint interval (in seconds), 0 disables the checkpoints
+#define CHECKPOINT_INTERVAL 0
+
+// Default number of frontend loggers
+#define FRONTEND_LOGGER_COUNT 1
+
 //===--------------------------------------------------------------------===//
 // Log Manager
 //===--------------------------------------------------------------------===//
@@ -88,8 +103,105 @@ class LogManager {
 
   bool GetSyncCommit(void) const { return syncronization_commit; }
 
+  // Whether to group the sync commits into one flush ?
+  // The frontend logger keeps collecting log records until the window
+  // elapses or the budget is used up, and then flushes them at once.
+  // Each committing transaction only waits for its own record.
+  void SetGroupCommit(bool group_commit_) { group_commit = group_commit_; }
+
+  bool GetGroupCommit(void) const { return group_commit; }
+
+  // Group commit window (in microseconds)
+  void SetGroupCommitWindow(int64_t window) { group_commit_window = window; }
+
+  int64_t GetGroupCommitWindow(void) const { return group_commit_window; }
+
+  // Group commit budget (in bytes)
+  void SetGroupCommitBudget(size_t budget) { group_commit_budget = budget; }
+
+  size_t GetGroupCommitBudget(void) const { return group_commit_budget; }
+
+  // Number of threads that replay the log during recovery
+  // 0 means one per core
+  void SetRecoveryThreadCount(size_t count) { recovery_thread_count = count; }
+
+  size_t GetRecoveryThreadCount(void) const {
+    if (recovery_thread_count != 0) return recovery_thread_count;
+    return std::max(std::thread::hardware_concurrency(), 1u);
+  }
+
+  // Checkpoint interval (in seconds)
+  // Every interval, the frontend logger takes a checkpoint in the background
+  // and truncates the log before it. Recovery then loads the checkpoint and
+  // only replays the log after it.
+  void SetCheckpointInterval(int64_t interval) {
+    checkpoint_interval = interval;
+  }
+
+  int64_t GetCheckpointInterval(void) const { return checkpoint_interval; }
+
+  // Whether to write the log with direct io, bypassing the page cache ?
+  // The log goes through an aligned buffer straight to the device, where
+  // the file system supports it.
+  void SetDirectIO(bool direct_io_) { direct_io = direct_io_; }
+
+  bool GetDirectIO(void) const { return direct_io; }
+
+  // Whether to log only the changed columns of an update ?
+  // Recovery then takes the other columns from the deleted tuple.
+  void SetDeltaUpdate(bool delta_update_) { delta_update = delta_update_; }
+
+  bool GetDeltaUpdate(void) const { return delta_update; }
+
+  // Whether to compress the log records in blocks before writing them ?
+  void SetLogCompression(bool log_compression_) {
+    log_compression = log_compression_;
+  }
+
+  bool GetLogCompression(void) const { return log_compression; }
+
+  // Number of frontend loggers, each with its own log file
+  // The backend loggers are spread over them round-robin, and recovery
+  // merges their logs in commit order. A sync commit then also waits until
+  // the commits before it are durable in all the logs. Only the aries
+  // logging has more than one.
+  void SetFrontendLoggerCount(size_t count) { frontend_logger_count = count; }
+
+  size_t GetFrontendLoggerCount(void) const { return frontend_logger_count; }
+
+  // Wait until the commits up to the cid are durable in all the logs
+  void WaitForDurableCommit(cid_t cid);
+
+  // Wake up the commits that wait, once a log is durable up to a new cid
+  void NotifyDurableCommit(void);
+
+  // Get the cid up to which the commits are durable in all the logs
+  cid_t GetDurableCommitId(void);
+
+  // Take a checkpoint now, instead of waiting for the interval
+  // returns false if no checkpoint was taken
+  bool TakeCheckpoint(void);
+
+  // Flush statistics
+  void RecordFlush(size_t record_count) {
+    flush_count++;
+    flushed_record_count += record_count;
+  }
+
+  size_t GetFlushCount(void) const { return flush_count; }
+
+  size_t GetFlushedRecordCount(void) const { return flushed_record_count; }
+
+  void ResetFlushStats(void) {
+    flush_count = 0;
+    flushed_record_count = 0;
+  }
+
   size_t ActiveFrontendLoggerCount(void);
 
+  // Get the frontend logger with the id, or nullptr
+  FrontendLogger *GetFrontendLogger(oid_t logger_id);
+
   BackendLogger *GetBackendLogger();
 
   bool RemoveBackendLogger(BackendLogger *backend_logger);
@@ -98,6 +210,14 @@ class LogManager {
 
   std::string GetLogFileName(void);
 
+  // Get the log file of a frontend logger, the first one has the log file
+  // and the others are next to it
+  std::string GetLogFileName(oid_t logger_id);
+
+  std::string GetCheckpointFileName(void) {
+    return GetLogFileName() + ".checkpoint";
+  }
+
   bool HasPelotonFrontendLogger() const {
     return (peloton_logging_mode == LOGGING_TYPE_NVM_NVM);
   }
@@ -110,16 +230,18 @@ class LogManager {
   // Utility Functions
   //===--------------------------------------------------------------------===//
 
-  FrontendLogger *GetFrontendLogger();
-
-  bool RemoveFrontendLogger();
+  bool RemoveFrontendLoggers();
 
   //===--------------------------------------------------------------------===//
   // Data members
   //===--------------------------------------------------------------------===//
 
-  // There is only one frontend_logger of a given type -- stdout, aries, peloton
-  FrontendLogger *frontend_logger = nullptr;
+  // The frontend loggers of a given type -- stdout, aries, peloton
+  // The first one does the recovery and takes the checkpoints
+  std::vector<FrontendLogger *> frontend_loggers;
+
+  // the frontend logger that the next backend logger goes to
+  std::atomic<size_t> next_frontend_logger = ATOMIC_VAR_INIT(0);
 
   LoggingStatus logging_status = LOGGING_STATUS_TYPE_INVALID;
 
@@ -129,6 +251,29 @@ class LogManager {
 
   bool syncronization_commit = false;
 
+  bool group_commit = false;
+
+  int64_t group_commit_window = GROUP_COMMIT_WINDOW;
+
+  size_t group_commit_budget = GROUP_COMMIT_BUDGET;
+
+  size_t recovery_thread_count = 0;
+
+  int64_t checkpoint_interval = CHECKPOINT_INTERVAL;
+
+  bool direct_io = false;
+
+  bool delta_update = true;
+
+  bool log_compression = false;
+
+  size_t frontend_logger_count = FRONTEND_LOGGER_COUNT;
+
+  // number of non-empty flushes, and of the log records in them
+  std::atomic<size_t> flush_count = ATOMIC_VAR_INIT(0);
+
+  std::atomic<size_t> flushed_record_count = ATOMIC_VAR_INIT(0);
+
   std::string log_file_name;
 };
 
@@ -0,0 +1,364 @@
+/*-------------------------------------------------------------------------
+ *
+ * log_reader.cpp
+ * file description
+ *
+ * Copyright(c) 2015, CMU
+ *
+ * /peloton/src/backend/logging/log_reader.cpp
+ *
+ *-------------------------------------------------------------------------
+ */
+
+#include <sys/mman.h>
+#include <unistd.h>
+#include <zlib.h>
+#include <algorithm>
+#include <cerrno>
+
+#include "backend/common/logger.h"
+#include "backend/common/serializer.h"
+#include "backend/logging/log_reader.h"
+
+namespace peloton {
+namespace logging {
+
+/**
+ * @brief Map the log file from the log start to the log end
+ * @param log file descriptor
+ * @param log start
+ * @param log end, that is at most the size of the log file
+ */
+LogReader::LogReader(int log_file_fd, size_t log_start, size_t log_end)
+    : log_start(log_start),
+      log_size(log_end > log_start ? log_end - log_start : 0) {
+  if (log_size == 0) return;
+
+  // The mapping has to start at a page boundary
+  size_t page_size = sysconf(_SC_PAGESIZE);
+  size_t mapping_start = log_start - (log_start % page_size);
+  mapping_size = log_end - mapping_start;
+
+  void *ret = mmap(nullptr, mapping_size, PROT_READ, MAP_PRIVATE, log_file_fd,
+                   mapping_start);
+  if (ret != MAP_FAILED) {
+    mapping = static_cast<char *>(ret);
+    log = mapping + (log_start - mapping_start);
+
+    // We go over the log once, from the front to the back
+    if (madvise(mapping, mapping_size, MADV_SEQUENTIAL) != 0) {
+      LOG_WARN("Error occured in madvise(%d)", errno);
+    }
+    return;
+  }
+
+  // Otherwise, read it into memory
+  LOG_WARN("Could not map the log file (%d), reading it", errno);
+  mapping_size = 0;
+  ReadIntoBuffer({{0, log_file_fd, log_end}});
+}
+
+/**
+ * @brief Map the segments of the log file from the log start to the log end
+ * The segments are mapped next to each other, in a range that is reserved
+ * first. A larger segment takes the place of the segments it covers.
+ * @param log file
+ * @param log start
+ * @param log end, that is at most the end of the log file
+ */
+LogReader::LogReader(LogFile &log_file, size_t log_start, size_t log_end)
+    : log_start(log_start),
+      log_size(log_end > log_start ? log_end - log_start : 0),
+      segment_size(LOG_SEGMENT_SIZE) {
+  if (log_size == 0) return;
+
+  auto segments = log_file.GetSegments(log_start, log_end);
+  if (segments.empty() ||
+      segments.front().segment_number * segment_size > log_start ||
+      segments.back().segment_number * segment_size + segments.back().size <
+          log_end) {
+    LOG_ERROR("Log segments are missing");
+    return;
+  }
+
+  size_t first_segment_start = segments.front().segment_number * segment_size;
+  mapping_size = segments.back().segment_number * segment_size +
+                 segments.back().size - first_segment_start;
+  void *ret = mmap(nullptr, mapping_size, PROT_NONE,
+                   MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+  bool mapped = (ret != MAP_FAILED);
+  if (mapped) {
+    mapping = static_cast<char *>(ret);
+
+    for (size_t segment_itr = 0; segment_itr < segments.size() && mapped;
+         segment_itr++) {
+      auto &segment = segments[segment_itr];
+      size_t segment_start = segment.segment_number * segment_size;
+      mapped = (mmap(mapping + (segment_start - first_segment_start),
+                     segment.size, PROT_READ, MAP_PRIVATE | MAP_FIXED,
+                     segment.fd, 0) != MAP_FAILED);
+    }
+  }
+
+  if (mapped) {
+    log = mapping + (log_start - first_segment_start);
+
+    // We go over the log once, from the front to the back
+    if (madvise(mapping, mapping_size, MADV_SEQUENTIAL) != 0) {
+      LOG_WARN("Error occured in madvise(%d)", errno);
+    }
+    return;
+  }
+
+  // Otherwise, read it into memory
+  LOG_WARN("Could not map the log file (%d), reading it", errno);
+  if (mapping != nullptr) {
+    munmap(mapping, mapping_size);
+    mapping = nullptr;
+  }
+  mapping_size = 0;
+  ReadIntoBuffer(segments);
+}
+
+/**
+ * @brief Read the log from the segments into memory
+ * @param segments, in order, the first one has the log start
+ */
+void LogReader::ReadIntoBuffer(const std::vector<LogSegment> &segments) {
+  buffer.reset(new char[log_size]);
+
+  size_t offset = 0;
+  for (auto &segment : segments) {
+    size_t segment_start = segment.segment_number * segment_size;
+    size_t segment_end = segment_start + segment.size;
+
+    while (offset < log_size && log_start + offset < segment_end) {
+      size_t read_size = std::min(log_size - offset,
+                                  segment_end - (log_start + offset));
+      ssize_t ret = pread(segment.fd, buffer.get() + offset, read_size,
+                          log_start + offset - segment_start);
+      if (ret < 0 && errno == EINTR) continue;
+      if (ret <= 0) break;
+      offset += ret;
+    }
+  }
+
+  if (offset < log_size) {
+    LOG_ERROR("Could not read the log file");
+    buffer.reset();
+    return;
+  }
+
+  log = buffer.get();
+}
+
+LogReader::~LogReader() {
+  if (mapping != nullptr) {
+    munmap(mapping, mapping_size);
+  }
+}
+
+/**
+ * @brief Read the record at the current offset, and move past it
+ * The records of a compressed block are read from its uncompressed copy,
+ * and have the offset of the block.
+ * @param record, points into the log
+ * @return false at the end of the log, or at a torn or unknown record
+ */
+bool LogReader::ReadRecord(RawLogRecord &record) {
+  // The rest of the compressed block comes first
+  if (block != nullptr && block_read_offset == block_size) {
+    block = nullptr;
+  }
+
+  if (block != nullptr) {
+    if (ParseRecord(block, block_size, block_read_offset, record) == false) {
+      // The log ends before the broken block
+      LOG_ERROR("Broken log record in a compressed block");
+      read_offset = block_log_offset - log_start;
+      block = nullptr;
+      return false;
+    }
+    record.offset = block_log_offset;
+    return true;
+  }
+
+  if (log == nullptr || read_offset >= log_size) return false;
+
+  // The zeros at the end of a segment are followed by the next segment,
+  // a segment that starts with zeros is empty
+  if (log[read_offset] == LOGRECORD_TYPE_INVALID && segment_size != 0) {
+    size_t position = log_start + read_offset;
+    size_t next_segment_start = position - (position % segment_size) +
+                                segment_size;
+    if (position % segment_size == 0 ||
+        next_segment_start >= log_start + log_size) {
+      return false;
+    }
+    read_offset = next_segment_start - log_start;
+  }
+
+  if (log[read_offset] == LOGRECORD_TYPE_COMPRESSED_BLOCK) {
+    if (ReadBlock() == false) return false;
+    return ReadRecord(record);
+  }
+
+  size_t offset = read_offset;
+  if (ParseRecord(log, log_size, offset, record) == false) return false;
+
+  record.offset = log_start + read_offset;
+  read_offset = offset;
+  return true;
+}
+
+/**
+ * @brief Uncompress the block at the current offset, and move past it
+ * @return false if the block is torn or broken
+ */
+bool LogReader::ReadBlock(void) {
+  size_t offset = read_offset + 1;
+
+  // Check for torn log write
+  auto frame_size = GetFrameSize(log, log_size, offset);
+  if (frame_size < 2 * sizeof(int32_t)) return false;
+
+  ReferenceSerializeInputBE frame(log + offset, frame_size);
+  frame.ReadInt();
+  int32_t uncompressed_size = frame.ReadInt();
+  if (uncompressed_size < 0 ||
+      static_cast<size_t>(uncompressed_size) > LOG_SEGMENT_SIZE) {
+    return false;
+  }
+
+  const char *compressed = log + offset + 2 * sizeof(int32_t);
+  uLongf block_length = uncompressed_size;
+  std::unique_ptr<char[]> uncompressed(new char[uncompressed_size + 1]);
+  int ret = uncompress(reinterpret_cast<Bytef *>(uncompressed.get()),
+                       &block_length,
+                       reinterpret_cast<const Bytef *>(compressed),
+                       frame_size - 2 * sizeof(int32_t));
+  if (ret != Z_OK ||
+      block_length != static_cast<uLongf>(uncompressed_size)) {
+    LOG_ERROR("Could not uncompress a log block (%d)", ret);
+    return false;
+  }
+
+  // The records point into the block as long as the reader is there
+  block = uncompressed.get();
+  block_size = block_length;
+  block_read_offset = 0;
+  block_log_offset = log_start + read_offset;
+  blocks.push_back(std::move(uncompressed));
+
+  read_offset = offset + frame_size;
+  return true;
+}
+
+/**
+ * @brief Parse the record at the offset of the data
+ * @param data
+ * @param data size
+ * @param offset, moved past the record
+ * @param record, points into the data
+ * @return false at a torn or unknown record
+ */
+bool LogReader::ParseRecord(const char *data, size_t data_size,
+                            size_t &offset, RawLogRecord &record) {
+  size_t record_offset = offset;
+
+  // The first byte identifies log record type
+  auto record_type = static_cast<LogRecordType>(data[record_offset]);
+  record_offset++;
+
+  bool has_body = false;
+  switch (record_type) {
+    case LOGRECORD_TYPE_TRANSACTION_BEGIN:
+    case LOGRECORD_TYPE_TRANSACTION_COMMIT:
+    case LOGRECORD_TYPE_TRANSACTION_END:
+    case LOGRECORD_TYPE_TRANSACTION_ABORT:
+    case LOGRECORD_TYPE_TRANSACTION_DONE:
+    case LOGRECORD_TYPE_DURABLE_CID:
+    case LOGRECORD_TYPE_ARIES_TUPLE_DELETE:
+    case LOGRECORD_TYPE_PELOTON_TUPLE_INSERT:
+    case LOGRECORD_TYPE_PELOTON_TUPLE_DELETE:
+    case LOGRECORD_TYPE_PELOTON_TUPLE_UPDATE:
+      break;
+
+    // The new version of the tuple, or its changed columns, is in the body
+    case LOGRECORD_TYPE_ARIES_TUPLE_INSERT:
+    case LOGRECORD_TYPE_ARIES_TUPLE_UPDATE:
+    case LOGRECORD_TYPE_ARIES_TUPLE_DELTA_UPDATE:
+      has_body = true;
+      break;
+
+    default:
+      return false;
+  }
+
+  // Check for torn log write
+  auto header_size = GetFrameSize(data, data_size, record_offset);
+  if (header_size == 0) return false;
+
+  record.type = record_type;
+  record.header = data + record_offset;
+  record.header_size = header_size;
+  record_offset += header_size;
+
+  record.body = nullptr;
+  record.body_size = 0;
+  if (has_body) {
+    auto body_size = GetFrameSize(data, data_size, record_offset);
+    if (body_size == 0) return false;
+
+    record.body = data + record_offset;
+    record.body_size = body_size;
+    record_offset += body_size;
+  }
+
+  offset = record_offset;
+  return true;
+}
+
+/**
+ * @brief Move to the given offset of the log file
+ * @return false if it is out of the part that is read
+ */
+bool LogReader::Seek(size_t offset) {
+  if (offset < log_start || offset > log_start + log_size) return false;
+
+  read_offset = offset - log_start;
+  block = nullptr;
+  return true;
+}
+
+/**
+ * @brief get the size of the frame at the offset
+ *  TupleRecord consiss of two frame ( header and Body)
+ *  Transaction Record has a single frame
+ * @return the frame size, including its length, or 0 if the frame is broken
+ */
+size_t LogReader::GetFrameSize(const char *data, size_t data_size,
+                               size_t offset) {
+  // Check if the frame size is broken
+  if (offset + sizeof(int32_t) > data_size) {
+    return 0;
+  }
+
+  // Read next 4 bytes as an integer
+  ReferenceSerializeInputBE frame_check(data + offset, sizeof(int32_t));
+  int32_t frame_length = frame_check.ReadInt();
+  if (frame_length < 0) {
+    return 0;
+  }
+
+  // Check if the frame is broken
+  size_t frame_size = frame_length + sizeof(int32_t);
+  if (offset + frame_size > data_size) {
+    return 0;
+  }
+
+  return frame_size;
+}
+
+}  // namespace logging
+}  // namespace peloton
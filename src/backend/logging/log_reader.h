@@ -0,0 +1,155 @@
+/*-------------------------------------------------------------------------
+ *
+ * log_reader.h
+ * file description
+ *
+ * Copyright(c) 2015, CMU
+ *
+ * /peloton/src/backend/logging/log_reader.h
+ *
+ *-------------------------------------------------------------------------
+ */
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "backend/common/types.h"
+#include "backend/logging/log_file.h"
+
+namespace peloton {
+namespace logging {
+
+// A log record, as it is in the log
+struct RawLogRecord {
+  LogRecordType type = LOGRECORD_TYPE_INVALID;
+
+  // offset of the record in the log file, or of its compressed block
+  size_t offset = 0;
+
+  // header frame, starting with its length
+  const char *header = nullptr;
+
+  size_t header_size = 0;
+
+  // body frame of a tuple record that has one, or nullptr
+  const char *body = nullptr;
+
+  size_t body_size = 0;
+};
+
+//===--------------------------------------------------------------------===//
+// Log Reader
+//===--------------------------------------------------------------------===//
+
+/**
+ * Reads the records of a log file in place.
+ *
+ * A part of the log file is mapped, and the kernel is told that it is read
+ * sequentially, so that it reads ahead and drops the pages behind. The
+ * records point into the mapping, which stays valid as long as the reader,
+ * so nothing is copied. Every frame is checked against the end of the
+ * mapping, and a torn or unknown record ends the log.
+ *
+ * The segments of a log file are mapped one after the other, so the log
+ * is contiguous in memory. The zeros at the end of a segment are skipped.
+ *
+ * A compressed block is uncompressed when it is reached, and kept as long
+ * as the reader, so that its records stay valid too.
+ *
+ * If the log cannot be mapped, it is read into memory instead.
+ */
+class LogReader {
+  LogReader(LogReader const &) = delete;
+
+ public:
+  // Read the log file from the log start to the log end
+  LogReader(int log_file_fd, size_t log_start, size_t log_end);
+
+  // Read the segments of the log file from the log start to the log end
+  LogReader(LogFile &log_file, size_t log_start, size_t log_end);
+
+  ~LogReader();
+
+  // Could the log be read ?
+  bool IsValid(void) const { return log != nullptr || log_size == 0; }
+
+  // Read the record at the current offset, and move past it
+  // returns false at the end of the log, or at a torn or unknown record
+  bool ReadRecord(RawLogRecord &record);
+
+  // Move to the given offset of the log file
+  // returns false if it is out of the part that is read
+  bool Seek(size_t offset);
+
+  //===--------------------------------------------------------------------===//
+  // Accessors
+  //===--------------------------------------------------------------------===//
+
+  // Get the offset of the next record in the log file
+  size_t GetOffset(void) const { return log_start + read_offset; }
+
+  size_t GetLogStart(void) const { return log_start; }
+
+  size_t GetLogEnd(void) const { return log_start + log_size; }
+
+  // Get the size of the frame at the offset, including its length
+  // returns 0 if the frame is broken
+  static size_t GetFrameSize(const char *data, size_t data_size,
+                             size_t offset);
+
+ private:
+  // Read the log into memory
+  void ReadIntoBuffer(const std::vector<LogSegment> &segments);
+
+  // Uncompress the block at the current offset, and move past it
+  bool ReadBlock(void);
+
+  // Parse the record at the offset of the data, and move past it
+  static bool ParseRecord(const char *data, size_t data_size, size_t &offset,
+                          RawLogRecord &record);
+
+  //===--------------------------------------------------------------------===//
+  // Member Variables
+  //===--------------------------------------------------------------------===//
+
+  // offset of the first byte that is read in the log file
+  size_t log_start;
+
+  // the log, from the log start on
+  const char *log = nullptr;
+
+  size_t log_size;
+
+  // offset of the next record, from the log start
+  size_t read_offset = 0;
+
+  // the mapping starts at a page boundary before the log start
+  char *mapping = nullptr;
+
+  size_t mapping_size = 0;
+
+  // size of the segments, or 0 if the log is a single file
+  size_t segment_size = 0;
+
+  // copy of the log, when it cannot be mapped
+  std::unique_ptr<char[]> buffer;
+
+  // the compressed block whose records are read, or nullptr
+  const char *block = nullptr;
+
+  size_t block_size = 0;
+
+  // offset of the next record, in the block
+  size_t block_read_offset = 0;
+
+  // offset of the block in the log file
+  size_t block_log_offset = 0;
+
+  // uncompressed blocks that were read
+  std::vector<std::unique_ptr<char[]>> blocks;
+};
+
+}  // namespace logging
+}  // namespace peloton
@@ -19,6 +19,7 @@
  *     - HEADER
  *       - Header length         : int
  *       - Transaction Id        : txn_id_t
+ *       - Commit Id             : cid_t (of a commit or durable cid, if set)
  *
  *     Tuple Record :
  *       - LogRecordType         : enum
@@ -32,10 +33,24 @@
  *     -BODY
  *       - Body length           : int
  *       - Data                  : void*
+ *
+ *     Delta Update Body :
+ *       - Body length           : int
+ *       - Column count          : short
+ *       - Column id, Value      : short, Value (for each changed column)
+ *
+ *     Compressed Block :
+ *       - LogRecordType         : enum
+ *       - Block length          : int
+ *       - Uncompressed length   : int
+ *       - Compressed records    : zlib stream
 */
 
 #pragma once
 
+#include <future>
+#include <memory>
+
 #include "backend/common/types.h"
 #include "backend/bridge/ddl/bridge.h"
 #include "backend/common/serializer.h"
@@ -60,7 +75,20 @@ class LogRecord {
 
   txn_id_t GetTransactionId() const { return txn_id; }
 
-  virtual bool Serialize(CopySerializeOutput &output) = 0;
+  // Serialize the record at the current position of the output
+  virtual bool SerializeTo(SerializeOutput &output) = 0;
+
+  // Serialize the record into its own message
+  bool Serialize(CopySerializeOutput &output) {
+    output.Reset();
+    bool status = SerializeTo(output);
+
+    message_length = output.Size();
+    message = new char[message_length];
+    memcpy(message, output.Data(), message_length);
+
+    return status;
+  }
 
   virtual void Print(void) = 0;
 
@@ -68,6 +96,24 @@ class LogRecord {
 
   size_t GetMessageLength(void) const { return message_length; }
 
+  // Get a future that is ready once the record is durable
+  // must be called before the record is handed to a backend logger
+  std::future<void> GetDurableFuture(void) {
+    durable_promise = std::make_shared<std::promise<void>>();
+    return durable_promise->get_future();
+  }
+
+  // Does anyone wait for the record to be durable ?
+  bool HasDurableWaiter(void) const { return durable_promise != nullptr; }
+
+  // Wake up whoever waits for the record to be durable
+  void SetDurable(void) {
+    if (durable_promise != nullptr) {
+      durable_promise->set_value();
+      durable_promise.reset();
+    }
+  }
+
  protected:
   LogRecordType log_record_type = LOGRECORD_TYPE_INVALID;
 
@@ -78,6 +124,9 @@ class LogRecord {
 
   // length of the message
   size_t message_length = 0;
+
+  // set only if someone waits for the record to be durable
+  std::shared_ptr<std::promise<void>> durable_promise;
 };
 
 }  // namespace logging
@@ -30,13 +30,66 @@ AriesBackendLogger *AriesBackendLogger::GetInstance() {
  * @param log record
  */
 void AriesBackendLogger::Log(LogRecord *record) {
-  // Enqueue the serialized log record into the queue
-  record->Serialize(output_buffer);
+  // Serialize the log record into the log buffer
+  AppendToLogBuffer(record);
 
+  log_buffer.Publish();
+}
+
+/**
+ * @brief log a batch of LogRecords
+ * @param log records
+ */
+void AriesBackendLogger::LogBatch(const std::vector<LogRecord *> &records) {
+  // Serialize all the records before publishing them together
+  for (auto record : records) {
+    AppendToLogBuffer(record);
+  }
+
+  log_buffer.Publish();
+}
+
+/**
+ * @brief serialize the record into the log buffer, the record is not needed
+ * afterwards unless someone waits for it to be durable
+ * @param log record
+ */
+void AriesBackendLogger::AppendToLogBuffer(LogRecord *record) {
+  if (log_buffer.Append(record) == false) {
+    QueueLargeRecord(record);
+    return;
+  }
+
+  // Register it before publishing, so that the frontend logger cannot
+  // flush it before we know about it
+  if (record->HasDurableWaiter()) {
+    AddDurableRecord(log_buffer.GetAppendedPosition(), record);
+  } else {
+    delete record;
+  }
+}
+
+/**
+ * @brief hand a record that is too large for the log buffer to the frontend
+ * logger in its own message
+ * The frontend logger writes the local queue after the log buffer, so the
+ * record waits for the records before it, and the records after it wait
+ * for the record.
+ * @param log record
+ */
+void AriesBackendLogger::QueueLargeRecord(LogRecord *record) {
+  log_buffer.Publish();
+  WaitForFlushing();
+
+  CopySerializeOutput output;
+  record->Serialize(output);
   {
     std::lock_guard<std::mutex> lock(local_queue_mutex);
     local_queue.push_back(record);
   }
+
+  // The frontend logger deletes the record once it is flushed
+  WaitForFlushing();
 }
 
 LogRecord *AriesBackendLogger::GetTupleRecord(LogRecordType log_record_type,
@@ -74,5 +127,29 @@ LogRecord *AriesBackendLogger::GetTupleRecord(LogRecordType log_record_type,
   return record;
 }
 
+/**
+ * @brief Construct a log record of an update
+ * With delta updates, the record only has the changed columns of the new
+ * tuple, and recovery takes the others from the deleted tuple.
+ * @param changed columns of the new tuple
+ */
+LogRecord *AriesBackendLogger::GetTupleUpdateRecord(
+    txn_id_t txn_id, oid_t table_oid, ItemPointer insert_location,
+    ItemPointer delete_location, void *data,
+    const std::vector<oid_t> &changed_columns, oid_t db_oid) {
+  auto &log_manager = LogManager::GetInstance();
+  if (log_manager.GetDeltaUpdate() == false) {
+    return GetTupleRecord(LOGRECORD_TYPE_TUPLE_UPDATE, txn_id, table_oid,
+                          insert_location, delete_location, data, db_oid);
+  }
+
+  auto record = new TupleRecord(LOGRECORD_TYPE_ARIES_TUPLE_DELTA_UPDATE,
+                                txn_id, table_oid, insert_location,
+                                delete_location, data, db_oid);
+  record->SetChangedColumns(changed_columns);
+
+  return record;
+}
+
 }  // namespace logging
 }  // namespace peloton
@@ -32,6 +32,8 @@ class AriesBackendLogger : public BackendLogger {
 
   void Log(LogRecord *record);
 
+  void LogBatch(const std::vector<LogRecord *> &records);
+
   void TruncateLocalQueue(oid_t offset);
 
   LogRecord *GetTupleRecord(LogRecordType log_record_type, txn_id_t txn_id,
@@ -39,10 +41,18 @@ class AriesBackendLogger : public BackendLogger {
                             ItemPointer delete_location, void *data = nullptr,
                             oid_t db_oid = INVALID_OID);
 
+  LogRecord *GetTupleUpdateRecord(txn_id_t txn_id, oid_t table_oid,
+                                  ItemPointer insert_location,
+                                  ItemPointer delete_location, void *data,
+                                  const std::vector<oid_t> &changed_columns,
+                                  oid_t db_oid = INVALID_OID);
+
  private:
   AriesBackendLogger() { logging_type = LOGGING_TYPE_DRAM_NVM; }
 
-  CopySerializeOutput output_buffer;
+  void AppendToLogBuffer(LogRecord *record);
+
+  void QueueLargeRecord(LogRecord *record);
 };
 
 }  // namespace logging
@@ -12,11 +12,22 @@
 
 #include <sys/stat.h>
 #include <sys/mman.h>
+#include <sys/uio.h>
+#include <fcntl.h>
+#include <zlib.h>
+#include <climits>
+#include <cerrno>
+#include <algorithm>
+#include <memory>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
 
 #include "backend/catalog/manager.h"
 #include "backend/catalog/schema.h"
 #include "backend/common/pool.h"
 #include "backend/concurrency/transaction.h"
+#include "backend/concurrency/transaction_manager.h"
 #include "backend/logging/log_manager.h"
 #include "backend/logging/records/transaction_record.h"
 #include "backend/logging/records/tuple_record.h"
@@ -25,6 +36,7 @@
 #include "backend/storage/database.h"
 #include "backend/storage/data_table.h"
 #include "backend/storage/tile_group.h"
+#include "backend/storage/tile_group_header.h"
 #include "backend/storage/tuple.h"
 #include "backend/common/logger.h"
 
@@ -37,47 +49,35 @@ namespace logging {
 
 size_t GetLogFileSize(int log_file_fd);
 
-bool IsFileTruncated(FILE *log_file, size_t size_to_read, size_t log_file_size);
-
-size_t GetNextFrameSize(FILE *log_file, size_t log_file_size);
-
-LogRecordType GetNextLogRecordType(FILE *log_file, size_t log_file_size);
-
-bool ReadTransactionRecordHeader(TransactionRecord &txn_record, FILE *log_file,
-                                 size_t log_file_size);
-
-bool ReadTupleRecordHeader(TupleRecord &tuple_record, FILE *log_file,
-                           size_t log_file_size);
-
-storage::Tuple *ReadTupleRecordBody(catalog::Schema *schema, VarlenPool *pool,
-                                    FILE *log_file, size_t log_file_size);
+void CompressSpans(std::vector<struct iovec> &spans,
+                   std::vector<std::string> &blocks);
 
 // Wrappers
 storage::DataTable *GetTable(TupleRecord tupleRecord);
 
 /**
- * @brief Open logfile and file descriptor
+ * @brief Open the segments of the log file of the log stream
+ * @param id of the log stream
  */
-AriesFrontendLogger::AriesFrontendLogger() {
+AriesFrontendLogger::AriesFrontendLogger(oid_t logger_id)
+    : FrontendLogger(logger_id),
+      log_file(LogManager::GetInstance().GetLogFileName(logger_id),
+               LogManager::GetInstance().GetDirectIO()),
+      checkpoint_manager(LogManager::GetInstance().GetCheckpointFileName()) {
   logging_type = LOGGING_TYPE_DRAM_NVM;
 
   LOG_INFO("Log File Name :: %s", GetLogFileName().c_str());
 
-  // open log file and file descriptor
-  // we open it in append + binary mode
-  log_file = fopen(GetLogFileName().c_str(), "ab+");
-  if (log_file == NULL) {
-    LOG_ERROR("LogFile is NULL");
-  }
-
-  // also, get the descriptor
-  log_file_fd = fileno(log_file);
-  if (log_file_fd == -1) {
-    LOG_ERROR("log_file_fd is -1");
+  // open the segments, and find the end of the log
+  if (log_file.Open() == false) {
+    LOG_ERROR("Could not open the log file");
   }
 
   // allocate pool
   recovery_pool = new VarlenPool(BACKEND_TYPE_MM);
+
+  // Everything in the log so far is flushed
+  flushed_log_offset = log_file.GetLogEnd();
 }
 
 /**
@@ -88,12 +88,6 @@ AriesFrontendLogger::~AriesFrontendLogger() {
     delete log_record;
   }
 
-  // close the log file
-  int ret = fclose(log_file);
-  if (ret != 0) {
-    LOG_ERROR("Error occured while closing LogFile");
-  }
-
   // clean up pool
   delete recovery_pool;
 }
@@ -102,26 +96,60 @@ AriesFrontendLogger::~AriesFrontendLogger() {
  * @brief flush all the log records to the file
  */
 void AriesFrontendLogger::FlushLogRecords(void) {
-  // First, write all the record in the queue
-  for (auto record : global_queue) {
-    fwrite(record->GetMessage(), sizeof(char), record->GetMessageLength(),
-           log_file);
-  }
+  // With several log streams, mark that the commits up to the collected cid
+  // are in this stream, so that the commits after them in the other streams
+  // can become durable
+  cid_t marked_cid = INVALID_CID;
+  TransactionRecord durable_cid_record(LOGRECORD_TYPE_DURABLE_CID);
+  if (LogManager::GetInstance().ActiveFrontendLoggerCount() > 1 &&
+      collected_cid > durable_cid) {
+    marked_cid = collected_cid;
+    durable_cid_record.SetCommitId(marked_cid);
+
+    CopySerializeOutput output;
+    durable_cid_record.Serialize(output);
+    collected_spans.push_back({durable_cid_record.GetMessage(),
+                               durable_cid_record.GetMessageLength()});
+  }
+
+  // Nothing to write, so no need to sync
+  if (collected_spans.empty() == false || global_queue.empty() == false) {
+    // First, write all the collected bytes and the records in the queue
+    for (auto record : global_queue) {
+      collected_spans.push_back({record->GetMessage(),
+                                 record->GetMessageLength()});
+    }
 
-  // Then, flush
-  int ret = fflush(log_file);
-  if (ret != 0) {
-    LOG_ERROR("Error occured in fflush(%d)", ret);
-  }
+    // The compressed blocks take the place of their records
+    std::vector<std::string> compressed_blocks;
+    if (LogManager::GetInstance().GetLogCompression()) {
+      CompressSpans(collected_spans, compressed_blocks);
+    }
+
+    if (log_file.Write(collected_spans) == false) {
+      LOG_ERROR("Could not write the log records");
+    }
 
-  // Finally, sync
-  ret = fsync(log_file_fd);
-  if (ret != 0) {
-    LOG_ERROR("Error occured in fsync(%d)", ret);
+    // Then, sync the data, the segments keep their size
+    if (log_file.Sync() == false) {
+      LOG_ERROR("Could not sync the log file");
+    }
+
+    // The commit records were logged after their cids were assigned
+    auto &txn_manager = concurrency::TransactionManager::GetInstance();
+    {
+      std::lock_guard<std::mutex> lock(flushed_log_mutex);
+      flushed_log_offset = log_file.GetLogEnd();
+      flushed_log_cid = txn_manager.GetLastAssignedCommitId();
+    }
   }
 
-  // Clean up the frontend logger's queue
+  // The backend loggers can reuse their log buffers now
+  ReleaseCollectedLogBuffers();
+
+  // Clean up the frontend logger's queue, and wake up the waiting commits
   for (auto record : global_queue) {
+    record->SetDurable();
     delete record;
   }
   global_queue.clear();
@@ -133,6 +161,14 @@ void AriesFrontendLogger::FlushLogRecords(void) {
       backend_logger->Commit();
     }
   }
+
+  // The commits in the other streams can be acknowledged now
+  if (marked_cid != INVALID_CID) {
+    SetDurableCommitId(marked_cid);
+  }
+
+  // Get the next segment ready, now that the commits do not wait for it
+  log_file.PrepareSpareSegment();
 }
 
 //===--------------------------------------------------------------------===//
@@ -140,604 +176,798 @@ void AriesFrontendLogger::FlushLogRecords(void) {
 //===--------------------------------------------------------------------===//
 
 /**
- * @brief Recovery system based on log file
+ * @brief Recovery system based on the checkpoint and the log file
+ * First, the tuples of the checkpoint are loaded, if there is one. Then, a
+ * sequential pass reads the log after the checkpoint and keeps the tuple
+ * operations of the committed transactions, so that the others are never
+ * replayed. Last, the operations are replayed in parallel, split by tile
+ * group. All the operations on a tuple slot are in the same tile group, so
+ * they are still replayed in log order.
+ * The first frontend logger recovers the log streams of all of them.
  */
 void AriesFrontendLogger::DoRecovery() {
-  // Set log file size
-  log_file_size = GetLogFileSize(log_file_fd);
-
-  // Go over the log size if needed
-  if (log_file_size > 0) {
-    bool reached_end_of_file = false;
-
-    // Start the recovery transaction
-    auto &txn_manager = concurrency::TransactionManager::GetInstance();
+  auto streams = GetLogStreams();
 
-    // Although we call BeginTransaction here, recovery txn will not be
-    // recoreded in log file since we are in recovery mode
-    auto recovery_txn = txn_manager.BeginTransaction();
+  // The logs of all the streams, and of the retired ones after them
+  std::vector<LogFile *> log_files;
+  for (auto stream : streams) {
+    log_files.push_back(&stream->log_file);
+  }
+  if (logger_id == 0 &&
+      LogManager::GetInstance().GetFrontendLogger(0) == this) {
+    OpenRetiredLogFiles(streams.size());
+  }
+  for (auto &retired_log_file : retired_log_files) {
+    log_files.push_back(retired_log_file.get());
+  }
 
-    // Go over each log record in the log file
-    while (reached_end_of_file == false) {
-      // Read the first byte to identify log record type
-      // If that is not possible, then wrap up recovery
-      auto record_type = GetNextLogRecordType(log_file, log_file_size);
+  // Nothing to recover
+  bool has_log = false;
+  for (auto stream_log_file : log_files) {
+    has_log = has_log || (stream_log_file->GetLogEnd() > 0);
+  }
+  if (has_log == false && checkpoint_manager.HasCheckpoint() == false) {
+    return;
+  }
 
-      switch (record_type) {
-        case LOGRECORD_TYPE_TRANSACTION_BEGIN:
-          AddTransactionToRecoveryTable();
-          break;
+  // Start the recovery transaction
+  auto &txn_manager = concurrency::TransactionManager::GetInstance();
 
-        case LOGRECORD_TYPE_TRANSACTION_END:
-          RemoveTransactionFromRecoveryTable();
-          break;
+  // Although we call BeginTransaction here, recovery txn will not be
+  // recoreded in log file since we are in recovery mode
+  auto recovery_txn = txn_manager.BeginTransaction();
+  auto txn_id = recovery_txn->GetTransactionId();
+  auto last_cid = recovery_txn->GetLastCommitId();
 
-        case LOGRECORD_TYPE_TRANSACTION_COMMIT:
-          MoveCommittedTuplesToRecoveryTxn(recovery_txn);
-          break;
+  redo_after_checkpoint =
+      checkpoint_manager.LoadCheckpoint(recovery_txn, recovery_pool);
+  cid_t max_cid = 0;
+  if (redo_after_checkpoint == true) {
+    max_oid = std::max(max_oid, checkpoint_manager.GetMaxTileGroupId());
+    max_cid = checkpoint_manager.GetCheckpointCid();
+  }
 
-        case LOGRECORD_TYPE_TRANSACTION_ABORT:
-          AbortTuplesFromRecoveryTable();
-          break;
+  // Go over the log streams after the checkpoint if needed
+  // The operations point into the logs, so keep them until they are replayed
+  std::vector<std::unique_ptr<LogReader>> log_readers;
+  bool has_redo = false;
+  for (oid_t stream_itr = 0; stream_itr < log_files.size(); stream_itr++) {
+    auto &stream_log_file = *log_files[stream_itr];
 
-        case LOGRECORD_TYPE_ARIES_TUPLE_INSERT:
-          InsertTuple(recovery_txn);
-          break;
+    // The records end before the log end
+    size_t log_end = stream_log_file.GetLogEnd();
 
-        case LOGRECORD_TYPE_ARIES_TUPLE_DELETE:
-          DeleteTuple(recovery_txn);
-          break;
+    // The checkpoint covers the log before its offset
+    size_t log_start = 0;
+    if (redo_after_checkpoint == true) {
+      log_start = checkpoint_manager.GetLogOffset(stream_itr);
 
-        case LOGRECORD_TYPE_ARIES_TUPLE_UPDATE:
-          UpdateTuple(recovery_txn);
-          break;
-
-        default:
-          reached_end_of_file = true;
-          break;
+      if (log_start > log_end) {
+        LOG_ERROR("Log file is shorter than the checkpoint");
+        log_start = log_end;
       }
+    } else if (stream_log_file.GetLogStart() > 0) {
+      LOG_ERROR("The beginning of the log is missing");
+      log_start = stream_log_file.GetLogStart();
     }
 
-    // Commit the recovery transaction
-    txn_manager.CommitTransaction();
-
-    // Finally, abort ACTIVE transactions in recovery_txn_table
-    AbortActiveTransactions();
-
-    // After finishing recovery, set the next oid with maximum oid
-    // observed during the recovery
-    auto &manager = catalog::Manager::GetInstance();
-    manager.SetNextOid(max_oid);
+    log_readers.emplace_back(new LogReader(stream_log_file, log_start,
+                                           log_end));
+    if (log_start < log_end) {
+      if (log_readers.back()->IsValid() == false) {
+        LOG_ERROR("Could not read the log file");
+        recovery_txn->SetResult(Result::RESULT_FAILURE);
+      }
+      has_redo = true;
+    }
   }
-}
 
-/**
- * @brief Add new txn to recovery table
- */
-void AriesFrontendLogger::AddTransactionToRecoveryTable() {
-  // read transaction information from the log file
-  TransactionRecord txn_record(LOGRECORD_TYPE_TRANSACTION_BEGIN);
+  std::vector<RedoPartition> partitions;
+  std::deque<std::string> rebuilt_tuples;
+  bool dropped_commits = false;
+  if (has_redo) {
+    // Analysis
+    auto &log_manager = LogManager::GetInstance();
+    partitions.resize(log_manager.GetRecoveryThreadCount());
+    max_cid = std::max(max_cid,
+                       CollectRedoOperations(log_readers, partitions, txn_id,
+                                             rebuilt_tuples, dropped_commits));
+
+    // Redo, this thread takes the first partition
+    std::vector<std::thread> redo_threads;
+    for (size_t partition_itr = 1; partition_itr < partitions.size();
+         partition_itr++) {
+      if (partitions[partition_itr].operations.empty()) continue;
+      redo_threads.push_back(std::thread(&AriesFrontendLogger::RedoOperations,
+                                         this,
+                                         std::ref(partitions[partition_itr]),
+                                         txn_id, last_cid));
+    }
+    RedoOperations(partitions.front(), txn_id, last_cid);
 
-  // Check for torn log write
-  if (ReadTransactionRecordHeader(txn_record, log_file, log_file_size) ==
-      false) {
-    return;
+    for (auto &redo_thread : redo_threads) {
+      redo_thread.join();
+    }
   }
 
-  auto txn_id = txn_record.GetTransactionId();
-
-  // create the new txn object and added it into recovery recovery_txn_table
-  concurrency::Transaction *txn =
-      new concurrency::Transaction(txn_id, INVALID_CID);
-  recovery_txn_table.insert(std::make_pair(txn_id, txn));
-  LOG_TRACE("Added txd id %d object in table", (int)txn_id);
-}
+  // Hand the replayed tuples over to the recovery transaction
+  for (auto &partition : partitions) {
+    for (auto location : partition.inserted_tuples) {
+      recovery_txn->RecordInsert(location);
+    }
+    for (auto location : partition.deleted_tuples) {
+      recovery_txn->RecordDelete(location);
+    }
+    for (auto tuple_count_change : partition.tuple_count_changes) {
+      tuple_count_change.first->IncreaseNumberOfTuplesBy(
+          tuple_count_change.second);
+    }
 
-/**
- * @brief Remove txn from recovery table
- */
-void AriesFrontendLogger::RemoveTransactionFromRecoveryTable() {
-  // read transaction information from the log file
-  TransactionRecord txn_record(LOGRECORD_TYPE_TRANSACTION_END);
+    max_oid = std::max(max_oid, partition.max_oid);
 
-  // Check for torn log write
-  if (ReadTransactionRecordHeader(txn_record, log_file, log_file_size) ==
-      false) {
-    return;
+    if (partition.failed) {
+      // TODO: We need to abort on failure !
+      recovery_txn->SetResult(Result::RESULT_FAILURE);
+    }
   }
 
-  auto txn_id = txn_record.GetTransactionId();
+  // The next commits come after the ones in the log, so that the log
+  // streams can still be ordered by cid
+  txn_manager.AdvanceCommitId(max_cid);
 
-  // remove txn from recovery txn table
-  if (recovery_txn_table.find(txn_id) != recovery_txn_table.end()) {
-    auto txn = recovery_txn_table.at(txn_id);
-    recovery_txn_table.erase(txn_id);
+  // Commit the recovery transaction
+  txn_manager.CommitTransaction();
 
-    // drop the txn as well
-    delete txn;
-    LOG_TRACE("Erase txd id %d object in table", (int)txn_id);
-  } else {
-    LOG_TRACE("Erase txd id %d not found in recovery txn table", (int)txn_id);
+  // After finishing recovery, set the next oid with maximum oid
+  // observed during the recovery
+  auto &manager = catalog::Manager::GetInstance();
+  manager.SetNextOid(max_oid);
+
+  // The next markers would make the dropped commits look durable, and the
+  // retired streams are not checkpointed anymore
+  if (dropped_commits == true || retired_log_files.empty() == false) {
+    log_readers.clear();
+    if (CheckpointRecoveredLogs(log_files) == true) {
+      for (oid_t stream_itr = streams.size(); stream_itr < log_files.size();
+           stream_itr++) {
+        retired_log_files[stream_itr - streams.size()].reset();
+        LogFile::Remove(
+            LogManager::GetInstance().GetLogFileName(stream_itr));
+      }
+      retired_log_files.clear();
+    }
   }
 }
 
 /**
- * @brief move tuples from current txn to recovery txn so that we can commit
- * them later
- * @param recovery txn
+ * @brief Open the log files of the streams after the given count
+ * @param number of streams that have a frontend logger
  */
-void AriesFrontendLogger::MoveCommittedTuplesToRecoveryTxn(
-    concurrency::Transaction *recovery_txn) {
-  // read transaction information from the log file
-  TransactionRecord txn_record(LOGRECORD_TYPE_TRANSACTION_COMMIT);
-
-  // Check for torn log write
-  if (ReadTransactionRecordHeader(txn_record, log_file, log_file_size) ==
-      false) {
-    return;
-  }
-
-  // Get info about the transaction from recovery table
-  auto txn_id = txn_record.GetTransactionId();
-  if (recovery_txn_table.find(txn_id) != recovery_txn_table.end()) {
-    auto txn = recovery_txn_table.at(txn_id);
-    // Copy inserted/deleted tuples to recovery transaction
-    MoveTuples(recovery_txn, txn);
-
-    LOG_TRACE("Commit txd id %d object in table", (int)txn_id);
-  } else {
-    LOG_TRACE("Commit txd id %d not found in recovery txn table", (int)txn_id);
+void AriesFrontendLogger::OpenRetiredLogFiles(oid_t stream_count) {
+  auto &log_manager = LogManager::GetInstance();
+
+  for (oid_t stream_itr = stream_count;
+       LogFile::Exists(log_manager.GetLogFileName(stream_itr));
+       stream_itr++) {
+    LOG_INFO("Recovering the retired log stream %lu", stream_itr);
+
+    std::unique_ptr<LogFile> retired_log_file(
+        new LogFile(log_manager.GetLogFileName(stream_itr), false));
+    if (retired_log_file->Open() == false) {
+      LOG_ERROR("Could not open the retired log stream %lu", stream_itr);
+      break;
+    }
+    retired_log_files.push_back(std::move(retired_log_file));
   }
 }
 
 /**
- * @brief Move Tuples from log record-based local transaction to recovery
- * transaction
- * @param destination
- * @param source
+ * @brief Checkpoint the recovered database, with the redo starting at the
+ * end of every log file
+ * All the txns in the logs are over, the ones that did not commit never
+ * will, so nothing before the ends has to be read again.
+ * @param log files, of the streams and then of the retired streams
+ * @return false if no checkpoint was taken
  */
-void AriesFrontendLogger::MoveTuples(concurrency::Transaction *destination,
-                                     concurrency::Transaction *source) {
-  // This is the local transaction
-  auto inserted_tuples = source->GetInsertedTuples();
-  // Record the inserts in recovery txn
-  for (auto entry : inserted_tuples) {
-    oid_t tile_group_id = entry.first;
-    for (auto tuple_slot : entry.second) {
-      destination->RecordInsert(ItemPointer(tile_group_id, tuple_slot));
-    }
-  }
+bool AriesFrontendLogger::CheckpointRecoveredLogs(
+    const std::vector<LogFile *> &log_files) {
+  std::lock_guard<std::mutex> checkpoint_lock(checkpoint_mutex);
+  auto &txn_manager = concurrency::TransactionManager::GetInstance();
 
-  // Record the deletes in recovery txn
-  auto deleted_tuples = source->GetDeletedTuples();
-  for (auto entry : deleted_tuples) {
-    oid_t tile_group_id = entry.first;
-    for (auto tuple_slot : entry.second) {
-      destination->RecordDelete(ItemPointer(tile_group_id, tuple_slot));
-    }
+  std::vector<size_t> log_offsets;
+  for (auto stream_log_file : log_files) {
+    log_offsets.push_back(stream_log_file->GetLogEnd());
   }
 
-  // Clear inserted/deleted tuples from txn, just in case
-  source->ResetState();
-}
+  auto txn = txn_manager.BeginReadOnlyTransaction();
+  auto status = checkpoint_manager.WriteCheckpoint(txn, log_offsets);
+  txn_manager.CommitTransaction();
 
-/**
- * @brief abort tuple
- */
-void AriesFrontendLogger::AbortTuplesFromRecoveryTable() {
-  // read transaction information from the log file
-  TransactionRecord txn_record(LOGRECORD_TYPE_TRANSACTION_ABORT);
-
-  // Check for torn log write
-  if (ReadTransactionRecordHeader(txn_record, log_file, log_file_size) ==
-      false) {
-    return;
+  if (status == false) {
+    LOG_ERROR("Could not checkpoint the recovered logs");
+    return false;
   }
 
-  auto txn_id = txn_record.GetTransactionId();
-
-  // Get info about the transaction from recovery table
-  if (recovery_txn_table.find(txn_id) != recovery_txn_table.end()) {
-    auto txn = recovery_txn_table.at(txn_id);
-    AbortTuples(txn);
-    LOG_INFO("Abort txd id %d object in table", (int)txn_id);
-  } else {
-    LOG_INFO("Abort txd id %d not found in recovery txn table", (int)txn_id);
+  for (oid_t stream_itr = 0; stream_itr < log_files.size(); stream_itr++) {
+    log_files[stream_itr]->Truncate(log_offsets[stream_itr]);
   }
+
+  return true;
 }
 
 /**
- * @brief Abort tuples inside txn
- * @param txn
+ * @brief Get the frontend loggers of all the log streams
+ * @return the frontend loggers, this one first
  */
-void AriesFrontendLogger::AbortTuples(concurrency::Transaction *txn) {
-  LOG_INFO("Abort txd id %d object in table", (int)txn->GetTransactionId());
-
-  auto &manager = catalog::Manager::GetInstance();
-
-  // Record the aborted inserts in recovery txn
-  auto inserted_tuples = txn->GetInsertedTuples();
-  for (auto entry : inserted_tuples) {
-    oid_t tile_group_id = entry.first;
-    auto tile_group = manager.GetTileGroup(tile_group_id);
+std::vector<AriesFrontendLogger *> AriesFrontendLogger::GetLogStreams(void) {
+  std::vector<AriesFrontendLogger *> streams = {this};
 
-    for (auto tuple_slot : entry.second) {
-      tile_group.get()->AbortInsertedTuple(tuple_slot);
-    }
+  // Only the first frontend logger goes over the other streams
+  auto &log_manager = LogManager::GetInstance();
+  if (logger_id != 0 || log_manager.GetFrontendLogger(0) != this) {
+    return streams;
   }
 
-  // Record the aborted deletes in recovery txn
-  auto deleted_tuples = txn->GetDeletedTuples();
-  for (auto entry : txn->GetDeletedTuples()) {
-    oid_t tile_group_id = entry.first;
-    auto tile_group = manager.GetTileGroup(tile_group_id);
-
-    for (auto tuple_slot : entry.second) {
-      tile_group.get()->AbortDeletedTuple(tuple_slot, txn->GetTransactionId());
-    }
+  for (oid_t stream_itr = 1;
+       stream_itr < log_manager.ActiveFrontendLoggerCount(); stream_itr++) {
+    streams.push_back(static_cast<AriesFrontendLogger *>(
+        log_manager.GetFrontendLogger(stream_itr)));
   }
 
-  // Clear inserted/deleted tuples from txn, just in case
-  txn->ResetState();
+  return streams;
 }
 
 /**
- * @brief Abort tuples inside txn table
+ * @brief Read the log streams, and split the tuple operations of the
+ * committed transactions into the partitions, by tile group
+ * A torn record ends the log of a stream. The new tuple of a delta update
+ * is rebuilt here, in log order, from the last version of the tuple that it
+ * changes, so that the partitions do not depend on each other.
+ * A txn is logged in a single stream, so with several streams, the txns are
+ * replayed in commit order. Only the commits up to the smallest cid that
+ * every stream marked as durable are replayed, as the later ones may be
+ * missing from some stream. A stream that a single frontend logger wrote
+ * has no marks, all of its commits are durable. An empty stream holds back
+ * no commit.
+ * @param log readers, of every stream
+ * @param partitions
+ * @param txn id of the recovery txn
+ * @param rebuilt tuples, that the operations of the delta updates point to
+ * @param set if some commits were not replayed, as they were not durable
+ * in every stream
+ * @return the largest cid in the logs
  */
-void AriesFrontendLogger::AbortActiveTransactions() {
-  // Clean up the recovery table to ignore active transactions
-  for (auto active_txn_entry : recovery_txn_table) {
-    // clean up the transaction
-    auto active_txn = active_txn_entry.second;
-    AbortTuples(active_txn);
-    delete active_txn;
-  }
+cid_t AriesFrontendLogger::CollectRedoOperations(
+    std::vector<std::unique_ptr<LogReader>> &log_readers,
+    std::vector<RedoPartition> &partitions, txn_id_t txn_id,
+    std::deque<std::string> &rebuilt_tuples, bool &dropped_commits) {
+  // Tuple operations of all the transactions, in log order
+  std::vector<std::pair<txn_id_t, RedoOperation>> operations;
+  std::unordered_map<txn_id_t, cid_t> committed_txns;
+  bool has_delta_update = false;
+  cid_t max_cid = 0;
+
+  // The commits up to this cid are in every stream
+  cid_t durable_cid = MAX_CID;
+
+  // Cache the tables, as looking them up takes a few locks
+  std::map<std::pair<oid_t, oid_t>, storage::DataTable *> tables;
+
+  for (auto &log_reader : log_readers) {
+    // The checkpoint has the commits up to its cid
+    cid_t stream_durable_cid = redo_after_checkpoint
+                                   ? checkpoint_manager.GetCheckpointCid()
+                                   : 0;
+
+    bool has_records = false;
+    bool has_marks = false;
+    cid_t stream_max_cid = 0;
+
+    RawLogRecord record;
+    while (log_reader->ReadRecord(record)) {
+      ReferenceSerializeInputBE header(record.header, record.header_size);
+      has_records = true;
+
+      switch (record.type) {
+        case LOGRECORD_TYPE_TRANSACTION_COMMIT: {
+          TransactionRecord txn_record(record.type);
+          txn_record.Deserialize(header);
+          committed_txns[txn_record.GetTransactionId()] =
+              txn_record.GetCommitId();
+          stream_max_cid = std::max(stream_max_cid, txn_record.GetCommitId());
+        } break;
+
+        case LOGRECORD_TYPE_DURABLE_CID: {
+          TransactionRecord txn_record(record.type);
+          txn_record.Deserialize(header);
+          stream_durable_cid =
+              std::max(stream_durable_cid, txn_record.GetCommitId());
+          stream_max_cid = std::max(stream_max_cid, txn_record.GetCommitId());
+          has_marks = true;
+        } break;
 
-  recovery_txn_table.clear();
-}
+        case LOGRECORD_TYPE_ARIES_TUPLE_INSERT:
+        case LOGRECORD_TYPE_ARIES_TUPLE_DELETE:
+        case LOGRECORD_TYPE_ARIES_TUPLE_UPDATE:
+        case LOGRECORD_TYPE_ARIES_TUPLE_DELTA_UPDATE: {
+          TupleRecord tuple_record(record.type);
+          tuple_record.DeserializeHeader(header);
+          auto record_txn_id = tuple_record.GetTransactionId();
+
+          auto table_key = std::make_pair(tuple_record.GetDatabaseOid(),
+                                          tuple_record.GetTableId());
+          auto table_itr = tables.find(table_key);
+          if (table_itr == tables.end()) {
+            table_itr =
+                tables.insert({table_key, GetTable(tuple_record)}).first;
+          }
+          auto table = table_itr->second;
+
+          // Remove the old version
+          if (record.type != LOGRECORD_TYPE_ARIES_TUPLE_INSERT) {
+            operations.push_back(
+                {record_txn_id,
+                 {false, table, tuple_record.GetDeleteLocation(), nullptr, 0,
+                  INVALID_ITEMPOINTER}});
+          }
+
+          // Add the new version, its tuple is in the body
+          if (record.type == LOGRECORD_TYPE_ARIES_TUPLE_INSERT ||
+              record.type == LOGRECORD_TYPE_ARIES_TUPLE_UPDATE) {
+            operations.push_back(
+                {record_txn_id,
+                 {true, table, tuple_record.GetInsertLocation(), record.body,
+                  record.body_size, INVALID_ITEMPOINTER}});
+          }
+
+          // Or only its changed columns
+          if (record.type == LOGRECORD_TYPE_ARIES_TUPLE_DELTA_UPDATE) {
+            operations.push_back(
+                {record_txn_id,
+                 {true, table, tuple_record.GetInsertLocation(), record.body,
+                  record.body_size, tuple_record.GetDeleteLocation()}});
+            has_delta_update = true;
+          }
+        } break;
 
-/**
- * @brief read tuple record from log file and add them tuples to recovery txn
- * @param recovery txn
- */
-void AriesFrontendLogger::InsertTuple(concurrency::Transaction *recovery_txn) {
-  TupleRecord tuple_record(LOGRECORD_TYPE_ARIES_TUPLE_INSERT);
+        default:
+          // Only the committed transactions matter
+          break;
+      }
+    }
 
-  // Check for torn log write
-  if (ReadTupleRecordHeader(tuple_record, log_file, log_file_size) == false) {
-    LOG_ERROR("Could not read tuple record header.");
-    return;
+    if (has_marks == false) {
+      stream_durable_cid = has_records
+                               ? std::max(stream_durable_cid, stream_max_cid)
+                               : MAX_CID;
+    }
+
+    durable_cid = std::min(durable_cid, stream_durable_cid);
+    max_cid = std::max(max_cid, stream_max_cid);
   }
 
-  auto txn_id = tuple_record.GetTransactionId();
-  if (recovery_txn_table.find(txn_id) == recovery_txn_table.end()) {
-    LOG_ERROR("Insert txd id %d not found in recovery txn table", (int)txn_id);
-    return;
+  bool multiple_streams = (log_readers.size() > 1);
+  if (multiple_streams) {
+    for (auto committed_txn : committed_txns) {
+      if (committed_txn.second > durable_cid) dropped_commits = true;
+    }
   }
 
-  auto table = GetTable(tuple_record);
+  // Keep the operations of the committed transactions, with their cid
+  std::vector<std::pair<cid_t, RedoOperation>> committed_operations;
+  for (auto &operation : operations) {
+    auto committed_txn_itr = committed_txns.find(operation.first);
+    if (committed_txn_itr == committed_txns.end()) continue;
 
-  // Read off the tuple record body from the log
-  auto tuple = ReadTupleRecordBody(table->GetSchema(), recovery_pool, log_file,
-                                   log_file_size);
+    auto commit_cid = committed_txn_itr->second;
+    if (multiple_streams && commit_cid > durable_cid) continue;
 
-  // Check for torn log write
-  if (tuple == nullptr) {
-    return;
+    committed_operations.push_back({commit_cid, operation.second});
   }
 
-  auto target_location = tuple_record.GetInsertLocation();
-  auto tile_group_id = target_location.block;
-  auto tuple_slot = target_location.offset;
+  // Order the streams by commit, the operations of a txn keep their order
+  if (multiple_streams) {
+    std::stable_sort(committed_operations.begin(), committed_operations.end(),
+                     [](const std::pair<cid_t, RedoOperation> &lhs,
+                        const std::pair<cid_t, RedoOperation> &rhs) {
+                       return lhs.first < rhs.first;
+                     });
+  }
 
-  auto &manager = catalog::Manager::GetInstance();
-  auto tile_group = manager.GetTileGroup(tile_group_id);
+  // Last version of the tuples that the committed txns inserted
+  std::unordered_map<uint64_t, std::pair<const char *, size_t>> tuples;
+  auto get_tuple_key = [](ItemPointer location) {
+    return (static_cast<uint64_t>(location.block) << 32) | location.offset;
+  };
 
-  auto txn = recovery_txn_table.at(txn_id);
+  // Split the operations of the committed transactions
+  size_t redo_count = 0;
+  for (auto &committed_operation : committed_operations) {
+    auto &operation = committed_operation.second;
 
-  // Create new tile group if table doesn't already have that tile group
-  if (tile_group == nullptr) {
-    table->AddTileGroupWithOid(tile_group_id);
-    tile_group = manager.GetTileGroup(tile_group_id);
-    if (max_oid < tile_group_id) {
-      max_oid = tile_group_id;
+    if (operation.base_location.block != INVALID_OID) {
+      const char *base_data = nullptr;
+      size_t base_size = 0;
+      auto tuple_itr = tuples.find(get_tuple_key(operation.base_location));
+      if (tuple_itr != tuples.end()) {
+        base_data = tuple_itr->second.first;
+        base_size = tuple_itr->second.second;
+      }
+
+      rebuilt_tuples.emplace_back();
+      if (RebuildTuple(operation, base_data, base_size, txn_id,
+                       rebuilt_tuples.back()) == false) {
+        // The checkpoint already has the new tuple if it lacks the old one
+        if (redo_after_checkpoint == false) {
+          LOG_ERROR("Could not rebuild the tuple of a delta update");
+          partitions.front().failed = true;
+        }
+        continue;
+      }
+      operation.tuple_data = rebuilt_tuples.back().data();
+      operation.tuple_size = rebuilt_tuples.back().size();
     }
-  }
 
-  // Do the insert !
-  auto inserted_tuple_slot = tile_group->InsertTuple(
-      recovery_txn->GetTransactionId(), tuple_slot, tuple);
+    if (has_delta_update && operation.is_insert) {
+      tuples[get_tuple_key(operation.location)] = {operation.tuple_data,
+                                                   operation.tuple_size};
+    }
 
-  if (inserted_tuple_slot == INVALID_OID) {
-    // TODO: We need to abort on failure !
-    recovery_txn->SetResult(Result::RESULT_FAILURE);
-  } else {
-    txn->RecordInsert(target_location);
-    table->IncreaseNumberOfTuplesBy(1);
+    auto block = operation.location.block;
+    partitions[block % partitions.size()].operations.push_back(operation);
+    redo_count++;
   }
 
-  delete tuple;
+  LOG_INFO("Recovery :: committed txns %lu, redo operations %lu of %lu",
+           committed_txns.size(), redo_count, operations.size());
+
+  return max_cid;
 }
 
 /**
- * @brief read tuple record from log file and add them tuples to recovery txn
- * @param recovery txn
+ * @brief Rebuild the new tuple of a delta update
+ * The columns that it does not change are taken from the tuple that it
+ * changes, which the log inserted before, or else the checkpoint has.
+ * @param operation, its tuple data has the changed columns
+ * @param serialized tuple that it changes, or nullptr to take it from the
+ * table
+ * @param size of the serialized tuple
+ * @param txn id of the recovery txn
+ * @param serialized new tuple
+ * @return false if the tuple that it changes is not there
  */
-void AriesFrontendLogger::DeleteTuple(concurrency::Transaction *recovery_txn) {
-  TupleRecord tuple_record(LOGRECORD_TYPE_ARIES_TUPLE_DELETE);
-
-  // Check for torn log write
-  if (ReadTupleRecordHeader(tuple_record, log_file, log_file_size) == false) {
-    return;
-  }
+bool AriesFrontendLogger::RebuildTuple(RedoOperation &operation,
+                                       const char *base_data, size_t base_size,
+                                       txn_id_t txn_id,
+                                       std::string &tuple_data) {
+  auto schema = operation.table->GetSchema();
+  storage::Tuple tuple(schema, true);
+
+  if (base_data != nullptr) {
+    ReferenceSerializeInputBE base_body(base_data, base_size);
+    tuple.DeserializeFrom(base_body, recovery_pool);
+  } else {
+    auto &manager = catalog::Manager::GetInstance();
+    auto base_location = operation.base_location;
+    auto tile_group = manager.GetTileGroup(base_location.block);
+    if (tile_group == nullptr ||
+        tile_group->GetHeader()->GetTransactionId(base_location.offset) !=
+            txn_id) {
+      return false;
+    }
 
-  auto txn_id = tuple_record.GetTransactionId();
-  if (recovery_txn_table.find(txn_id) == recovery_txn_table.end()) {
-    LOG_TRACE("Delete txd id %d not found in recovery txn table", (int)txn_id);
-    return;
+    auto column_count = schema->GetColumnCount();
+    for (oid_t column_itr = 0; column_itr < column_count; column_itr++) {
+      tuple.SetValue(column_itr,
+                     tile_group->GetValue(base_location.offset, column_itr),
+                     recovery_pool);
+    }
   }
 
-  auto table = GetTable(tuple_record);
-
-  ItemPointer delete_location = tuple_record.GetDeleteLocation();
+  // Then, the changed columns
+  ReferenceSerializeInputBE delta_body(operation.tuple_data,
+                                       operation.tuple_size);
+  delta_body.ReadInt();
+  int16_t changed_column_count = delta_body.ReadShort();
+  for (int16_t column_itr = 0; column_itr < changed_column_count;
+       column_itr++) {
+    oid_t column_id = delta_body.ReadShort();
+    if (column_id >= schema->GetColumnCount()) return false;
 
-  // Try to delete the tuple
-  bool status = table->DeleteTuple(recovery_txn, delete_location);
-  if (status == false) {
-    // TODO: We need to abort on failure !
-    recovery_txn->SetResult(Result::RESULT_FAILURE);
-    return;
+    // The value frees its copy, the tuple has its own in the pool
+    Value value;
+    value.DeserializeFromAllocateForStorage(schema->GetType(column_id),
+                                            delta_body, nullptr);
+    tuple.SetValue(column_id, value, recovery_pool);
   }
 
-  auto txn = recovery_txn_table.at(txn_id);
-  txn->RecordDelete(delete_location);
+  CopySerializeOutput output;
+  tuple.SerializeTo(output);
+  tuple_data.assign(output.Data(), output.Size());
+
+  return true;
 }
 
 /**
- * @brief read tuple record from log file and add them tuples to recovery txn
- * @param recovery txn
+ * @brief Replay the operations of a partition as the recovery txn
+ * An insert overwrites the slot, and a delete only removes a tuple that we
+ * recovered. So after a checkpoint, the operations that it already has
+ * do not change the outcome, even when a slot was reused.
+ * @param partition
+ * @param txn id of the recovery txn
+ * @param last cid of the recovery txn
  */
-void AriesFrontendLogger::UpdateTuple(concurrency::Transaction *recovery_txn) {
-  TupleRecord tuple_record(LOGRECORD_TYPE_ARIES_TUPLE_UPDATE);
-
-  // Check for torn log write
-  if (ReadTupleRecordHeader(tuple_record, log_file, log_file_size) == false) {
-    return;
-  }
-
-  auto txn_id = tuple_record.GetTransactionId();
-  if (recovery_txn_table.find(txn_id) == recovery_txn_table.end()) {
-    LOG_TRACE("Update txd id %d not found in recovery txn table", (int)txn_id);
-    return;
-  }
+void AriesFrontendLogger::RedoOperations(RedoPartition &partition,
+                                         txn_id_t txn_id, cid_t last_cid) {
+  auto &manager = catalog::Manager::GetInstance();
 
-  auto txn = recovery_txn_table.at(txn_id);
+  oid_t tile_group_id = INVALID_OID;
+  std::shared_ptr<storage::TileGroup> tile_group;
 
-  auto table = GetTable(tuple_record);
+  for (auto &operation : partition.operations) {
+    auto table = operation.table;
+    auto location = operation.location;
 
-  auto tuple = ReadTupleRecordBody(table->GetSchema(), recovery_pool, log_file,
-                                   log_file_size);
+    if (location.block != tile_group_id || tile_group == nullptr) {
+      tile_group_id = location.block;
+      tile_group = manager.GetTileGroup(tile_group_id);
+    }
 
-  // Check for torn log write
-  if (tuple == nullptr) {
-    return;
-  }
+    if (operation.is_insert) {
+      // Create new tile group if table doesn't already have that tile group
+      if (tile_group == nullptr) {
+        table->AddTileGroupWithOid(tile_group_id);
+        tile_group = manager.GetTileGroup(tile_group_id);
+        partition.max_oid = std::max(partition.max_oid, tile_group_id);
+      }
 
-  // First, redo the delete
-  ItemPointer delete_location = tuple_record.GetDeleteLocation();
+      ReferenceSerializeInputBE tuple_body(operation.tuple_data,
+                                           operation.tuple_size);
+      storage::Tuple tuple(table->GetSchema(), true);
+      tuple.DeserializeFrom(tuple_body, recovery_pool);
+
+      // Do we replace a tuple that we recovered ?
+      bool recovered = (tile_group->GetHeader()->GetTransactionId(
+                            location.offset) == txn_id);
+
+      // Do the insert !
+      auto inserted_tuple_slot =
+          tile_group->InsertTuple(txn_id, location.offset, &tuple);
+      if (inserted_tuple_slot == INVALID_OID) {
+        partition.failed = true;
+        continue;
+      }
 
-  bool status = table->DeleteTuple(recovery_txn, delete_location);
-  if (status == false) {
-    recovery_txn->SetResult(Result::RESULT_FAILURE);
-  } else {
-    txn->RecordDelete(delete_location);
+      if (recovered == true) continue;
 
-    auto target_location = tuple_record.GetInsertLocation();
-    auto tile_group_id = target_location.block;
-    auto tuple_slot = target_location.offset;
-    auto &manager = catalog::Manager::GetInstance();
-    auto tile_group = manager.GetTileGroup(tile_group_id);
+      partition.inserted_tuples.push_back(location);
+      partition.tuple_count_changes[table]++;
+    } else {
+      // The checkpoint may not have the tuple anymore
+      if (tile_group == nullptr ||
+          tile_group->GetHeader()->GetTransactionId(location.offset) !=
+              txn_id) {
+        if (redo_after_checkpoint == false) partition.failed = true;
+        continue;
+      }
 
-    // Create new tile group if table doesn't already have that tile group
-    if (tile_group == nullptr) {
-      table->AddTileGroupWithOid(tile_group_id);
-      tile_group = manager.GetTileGroup(tile_group_id);
-      if (max_oid < tile_group_id) {
-        max_oid = tile_group_id;
+      if (tile_group->DeleteTuple(txn_id, location.offset, last_cid) ==
+          false) {
+        partition.failed = true;
+        continue;
       }
-    }
 
-    // Do the insert !
-    auto inserted_tuple_slot = tile_group->InsertTuple(
-        recovery_txn->GetTransactionId(), tuple_slot, tuple);
-    if (inserted_tuple_slot == INVALID_OID) {
-      recovery_txn->SetResult(Result::RESULT_FAILURE);
-    } else {
-      txn->RecordInsert(target_location);
+      partition.deleted_tuples.push_back(location);
+      partition.tuple_count_changes[table]--;
     }
   }
-
-  delete tuple;
 }
 
 //===--------------------------------------------------------------------===//
-// Utility functions
+// Checkpoint
 //===--------------------------------------------------------------------===//
 
 /**
- * @brief Measure the size of log file
- * @return the size if the log file exists otherwise 0
+ * @brief Take a fuzzy checkpoint, and truncate the log before it
+ * The checkpoint has the snapshot of a read-only txn that sees all the
+ * commits of the flushed log, so the writers keep going meanwhile. The redo
+ * starts at the first record of the txns that were still running in the
+ * flushed log, the replay of the commits that the snapshot already has is
+ * idempotent. The first frontend logger checkpoints all the log streams.
+ * @return false if no checkpoint was taken
  */
-size_t GetLogFileSize(int log_file_fd) {
-  struct stat log_stats;
-
-  fstat(log_file_fd, &log_stats);
-  return log_stats.st_size;
-}
+bool AriesFrontendLogger::DoCheckpoint(void) {
+  std::lock_guard<std::mutex> checkpoint_lock(checkpoint_mutex);
+  auto &txn_manager = concurrency::TransactionManager::GetInstance();
+  auto &log_manager = LogManager::GetInstance();
+  auto streams = GetLogStreams();
+
+  // The flushed log of every stream
+  std::vector<size_t> flushed_offsets;
+  cid_t flushed_cid = 0;
+  bool has_new_log = false;
+  for (oid_t stream_itr = 0; stream_itr < streams.size(); stream_itr++) {
+    auto stream = streams[stream_itr];
+    {
+      std::lock_guard<std::mutex> lock(stream->flushed_log_mutex);
+      flushed_offsets.push_back(stream->flushed_log_offset);
+      flushed_cid = std::max(flushed_cid, stream->flushed_log_cid);
+    }
 
-bool IsFileTruncated(FILE *log_file, size_t size_to_read,
-                     size_t log_file_size) {
-  // Cache current position
-  size_t current_position = ftell(log_file);
+    has_new_log = has_new_log || (flushed_offsets.back() >
+                                  checkpoint_manager.GetLogOffset(stream_itr));
+  }
 
-  // Check if the actual file size is less than the expected file size
-  // Current position + frame length
-  if (current_position + size_to_read <= log_file_size) {
+  // Nothing was logged since the last checkpoint
+  if (has_new_log == false) {
     return false;
-  } else {
-    fseek(log_file, 0, SEEK_END);
-    return true;
   }
-}
 
-/**
- * @brief get the next frame size
- *  TupleRecord consiss of two frame ( header and Body)
- *  Transaction Record has a single frame
- * @return the next frame size
- */
-size_t GetNextFrameSize(FILE *log_file, size_t log_file_size) {
-  size_t frame_size;
-  char buffer[sizeof(int32_t)];
-
-  // Check if the frame size is broken
-  if (IsFileTruncated(log_file, sizeof(buffer), log_file_size)) {
-    return 0;
+  // Wait until the commits of the flushed log are visible
+  while (txn_manager.GetLastCommitId() < flushed_cid) {
+    if (log_manager.GetStatus() != LOGGING_STATUS_TYPE_LOGGING) {
+      return false;
+    }
+    std::this_thread::yield();
   }
 
-  // Otherwise, read the frame size
-  size_t ret = fread(buffer, 1, sizeof(buffer), log_file);
-  if (ret <= 0) {
-    LOG_ERROR("Error occured in fread ");
+  std::vector<size_t> log_offsets;
+  for (oid_t stream_itr = 0; stream_itr < streams.size(); stream_itr++) {
+    log_offsets.push_back(streams[stream_itr]->GetRedoStartOffset(
+        checkpoint_manager.GetLogOffset(stream_itr),
+        flushed_offsets[stream_itr]));
   }
 
-  // Read next 4 bytes as an integer
-  CopySerializeInputBE frameCheck(buffer, sizeof(buffer));
-  frame_size = (frameCheck.ReadInt()) + sizeof(buffer);
-  ;
+  auto txn = txn_manager.BeginReadOnlyTransaction();
+  auto status = checkpoint_manager.WriteCheckpoint(txn, log_offsets);
+  txn_manager.CommitTransaction();
 
-  // Move back by 4 bytes
-  // So that tuple deserializer works later as expected
-  int res = fseek(log_file, -sizeof(buffer), SEEK_CUR);
-  if (res == -1) {
-    LOG_ERROR("Error occured in fseek ");
-  }
-
-  // Check if the frame is broken
-  if (IsFileTruncated(log_file, frame_size, log_file_size)) {
-    return 0;
+  // The segments before the checkpoint are not needed anymore
+  if (status == true) {
+    for (oid_t stream_itr = 0; stream_itr < streams.size(); stream_itr++) {
+      streams[stream_itr]->log_file.Truncate(log_offsets[stream_itr]);
+    }
   }
 
-  return frame_size;
+  return status;
 }
 
 /**
- * @brief Read single byte so that we can distinguish the log record type
- * @return log record type otherwise return invalid log record type,
- * which menas there is no more log in the log file
+ * @brief Find where the redo has to start after a checkpoint
+ * The txns that were running at the last checkpoint have no record before
+ * its log offset, so the log is read from there on.
+ * @param log start, where the redo of the last checkpoint starts
+ * @param log end, the end of the flushed log
+ * @return the offset of the first record of the txns that did not finish
+ * before the log end, or the log end if all of them finished
  */
-LogRecordType GetNextLogRecordType(FILE *log_file, size_t log_file_size) {
-  char buffer;
-
-  // Check if the log record type is broken
-  if (IsFileTruncated(log_file, 1, log_file_size)) {
-    LOG_ERROR("Log file is truncated");
-    return LOGRECORD_TYPE_INVALID;
+size_t AriesFrontendLogger::GetRedoStartOffset(size_t log_start,
+                                               size_t log_end) {
+  LogReader log_reader(log_file, log_start, log_end);
+  if (log_reader.IsValid() == false) {
+    LOG_ERROR("Could not read the log file");
+    return log_start;
+  }
+
+  // First record of the running txns
+  std::map<txn_id_t, size_t> running_txns;
+
+  RawLogRecord record;
+  while (log_reader.ReadRecord(record)) {
+    ReferenceSerializeInputBE header(record.header, record.header_size);
+
+    switch (record.type) {
+      case LOGRECORD_TYPE_TRANSACTION_BEGIN: {
+        TransactionRecord txn_record(record.type);
+        txn_record.Deserialize(header);
+        running_txns.emplace(txn_record.GetTransactionId(), record.offset);
+      } break;
+
+      case LOGRECORD_TYPE_TRANSACTION_COMMIT:
+      case LOGRECORD_TYPE_TRANSACTION_END:
+      case LOGRECORD_TYPE_TRANSACTION_ABORT: {
+        TransactionRecord txn_record(record.type);
+        txn_record.Deserialize(header);
+        running_txns.erase(txn_record.GetTransactionId());
+      } break;
+
+      case LOGRECORD_TYPE_ARIES_TUPLE_INSERT:
+      case LOGRECORD_TYPE_ARIES_TUPLE_DELETE:
+      case LOGRECORD_TYPE_ARIES_TUPLE_UPDATE:
+      case LOGRECORD_TYPE_ARIES_TUPLE_DELTA_UPDATE: {
+        TupleRecord tuple_record(record.type);
+        tuple_record.DeserializeHeader(header);
+        running_txns.emplace(tuple_record.GetTransactionId(), record.offset);
+      } break;
+
+      default:
+        break;
+    }
   }
 
-  // Otherwise, read the log record type
-  int ret = fread((void *)&buffer, 1, sizeof(char), log_file);
-  if (ret <= 0) {
-    LOG_ERROR("Could not read from log file");
-    return LOGRECORD_TYPE_INVALID;
+  size_t redo_start_offset = log_reader.GetOffset();
+  for (auto running_txn : running_txns) {
+    redo_start_offset = std::min(redo_start_offset, running_txn.second);
   }
 
-  CopySerializeInputBE input(&buffer, sizeof(char));
-  LogRecordType log_record_type = (LogRecordType)(input.ReadEnumInSingleByte());
-
-  return log_record_type;
+  return redo_start_offset;
 }
 
+//===--------------------------------------------------------------------===//
+// Utility functions
+//===--------------------------------------------------------------------===//
+
 /**
- * @brief Read TransactionRecord
- * @param txn_record
+ * @brief Measure the size of log file
+ * @return the size if the log file exists otherwise 0
  */
-bool ReadTransactionRecordHeader(TransactionRecord &txn_record, FILE *log_file,
-                                 size_t log_file_size) {
-  // Check if frame is broken
-  auto header_size = GetNextFrameSize(log_file, log_file_size);
-  if (header_size == 0) {
-    return false;
-  }
-
-  // Read header
-  char header[header_size];
-  size_t ret = fread(header, 1, sizeof(header), log_file);
-  if (ret <= 0) {
-    LOG_ERROR("Error occured in fread ");
-  }
-
-  CopySerializeInputBE txn_header(header, header_size);
-  txn_record.Deserialize(txn_header);
+size_t GetLogFileSize(int log_file_fd) {
+  struct stat log_stats;
 
-  return true;
+  fstat(log_file_fd, &log_stats);
+  return log_stats.st_size;
 }
 
 /**
- * @brief Read TupleRecordHeader
- * @param tuple_record
+ * @brief Compress the records of the spans in blocks
+ * A block has whole spans, and so whole records. The spans of a block that
+ * does not get smaller are kept as they are, and so are the spans larger
+ * than a block, which could be larger than a segment.
+ * @param spans, replaced by the spans of the blocks
+ * @param compressed blocks
  */
-bool ReadTupleRecordHeader(TupleRecord &tuple_record, FILE *log_file,
-                           size_t log_file_size) {
-  // Check if frame is broken
-  auto header_size = GetNextFrameSize(log_file, log_file_size);
-  if (header_size == 0) {
-    LOG_ERROR("Header size is zero ");
-    return false;
-  }
-
-  // Read header
-  char header[header_size];
-  size_t ret = fread(header, 1, sizeof(header), log_file);
-  if (ret <= 0) {
-    LOG_ERROR("Error occured in fread ");
-  }
+void CompressSpans(std::vector<struct iovec> &spans,
+                   std::vector<std::string> &blocks) {
+  const size_t block_header_size = sizeof(char) + 2 * sizeof(int32_t);
+  std::vector<struct iovec> block_spans;
+  std::string uncompressed;
+
+  blocks.reserve(spans.size());
+  size_t span_itr = 0;
+  while (span_itr < spans.size()) {
+    if (spans[span_itr].iov_len > LOG_COMPRESSION_BLOCK_SIZE) {
+      block_spans.push_back(spans[span_itr]);
+      span_itr++;
+      continue;
+    }
 
-  CopySerializeInputBE tuple_header(header, header_size);
-  tuple_record.DeserializeHeader(tuple_header);
+    // Collect the spans of the block
+    size_t first_span_itr = span_itr;
+    uncompressed.clear();
+    while (span_itr < spans.size() &&
+           uncompressed.size() < LOG_COMPRESSION_BLOCK_SIZE &&
+           spans[span_itr].iov_len <= LOG_COMPRESSION_BLOCK_SIZE) {
+      uncompressed.append(static_cast<char *>(spans[span_itr].iov_base),
+                          spans[span_itr].iov_len);
+      span_itr++;
+    }
 
-  return true;
-}
+    uLongf compressed_size = compressBound(uncompressed.size());
+    std::string block(block_header_size + compressed_size, '\0');
+    int ret = compress2(
+        reinterpret_cast<Bytef *>(&block[block_header_size]), &compressed_size,
+        reinterpret_cast<const Bytef *>(uncompressed.data()),
+        uncompressed.size(), Z_BEST_SPEED);
+
+    if (ret != Z_OK || compressed_size + block_header_size >=
+                           uncompressed.size()) {
+      block_spans.insert(block_spans.end(), spans.begin() + first_span_itr,
+                         spans.begin() + span_itr);
+      continue;
+    }
 
-/**
- * @brief Read TupleRecordBody
- * @param schema
- * @param pool
- * @return tuple
- */
-storage::Tuple *ReadTupleRecordBody(catalog::Schema *schema, VarlenPool *pool,
-                                    FILE *log_file, size_t log_file_size) {
-  // Check if the frame is broken
-  size_t body_size = GetNextFrameSize(log_file, log_file_size);
-  if (body_size == 0) {
-    LOG_ERROR("Body size is zero ");
-    return nullptr;
-  }
+    // The type, and the frame with the uncompressed size and the block
+    block.resize(block_header_size + compressed_size);
+    ReferenceSerializeOutput output(&block[0], block_header_size);
+    output.WriteEnumInSingleByte(LOGRECORD_TYPE_COMPRESSED_BLOCK);
+    output.WriteInt(static_cast<int32_t>(sizeof(int32_t) + compressed_size));
+    output.WriteInt(static_cast<int32_t>(uncompressed.size()));
 
-  // Read Body
-  char body[body_size];
-  int ret = fread(body, 1, sizeof(body), log_file);
-  if (ret <= 0) {
-    LOG_ERROR("Error occured in fread ");
+    blocks.push_back(std::move(block));
+    block_spans.push_back({&blocks.back()[0], blocks.back().size()});
   }
 
-  CopySerializeInputBE tuple_body(body, body_size);
-
-  // We create a tuple based on the message
-  storage::Tuple *tuple = new storage::Tuple(schema, true);
-  tuple->DeserializeFrom(tuple_body, pool);
-
-  return tuple;
+  spans.swap(block_spans);
 }
 
 /**
@@ -760,7 +990,7 @@ storage::DataTable *GetTable(TupleRecord tuple_record) {
 
 std::string AriesFrontendLogger::GetLogFileName(void) {
   auto &log_manager = logging::LogManager::GetInstance();
-  return log_manager.GetLogFileName();
+  return log_manager.GetLogFileName(logger_id);
 }
 
 }  // namespace logging
@@ -12,25 +12,80 @@
 
 #pragma once
 
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
 #include "backend/logging/frontend_logger.h"
+#include "backend/logging/checkpoint_manager.h"
+#include "backend/logging/log_file.h"
+#include "backend/logging/log_reader.h"
 
 namespace peloton {
 
 class VarlenPool;
 
-namespace concurrency {
-class Transaction;
+namespace storage {
+class DataTable;
 }
 
 namespace logging {
 
+// Size of the log records that are compressed together, if compression is on
+#define LOG_COMPRESSION_BLOCK_SIZE (256 * 1024)
+
+//===--------------------------------------------------------------------===//
+// Recovery
+//===--------------------------------------------------------------------===//
+
+// Tuple insert or delete of a committed transaction, read off the log
+struct RedoOperation {
+  // insert or delete ?
+  bool is_insert;
+
+  storage::DataTable *table;
+
+  ItemPointer location;
+
+  // serialized tuple of an insert, points into the log
+  const char *tuple_data;
+
+  size_t tuple_size;
+
+  // tuple that a delta update changes, whose tuple data is then the
+  // changed columns, or INVALID_ITEMPOINTER
+  ItemPointer base_location;
+};
+
+// The operations that one thread replays, in log order, and their effects
+struct RedoPartition {
+  std::vector<RedoOperation> operations;
+
+  // inserted and deleted tuples, for the recovery txn
+  std::vector<ItemPointer> inserted_tuples;
+
+  std::vector<ItemPointer> deleted_tuples;
+
+  // change in the number of tuples of every table
+  std::map<storage::DataTable *, int64_t> tuple_count_changes;
+
+  // largest tile group id that was added
+  oid_t max_oid = 0;
+
+  // did an operation fail ?
+  bool failed = false;
+};
+
 //===--------------------------------------------------------------------===//
 // Aries Frontend Logger
 //===--------------------------------------------------------------------===//
 
 class AriesFrontendLogger : public FrontendLogger {
  public:
-  AriesFrontendLogger(void);
+  AriesFrontendLogger(oid_t logger_id = 0);
 
   ~AriesFrontendLogger(void);
 
@@ -42,43 +97,58 @@ class AriesFrontendLogger : public FrontendLogger {
 
   void DoRecovery(void);
 
-  void AddTransactionToRecoveryTable(void);
+  //===--------------------------------------------------------------------===//
+  // Checkpoint
+  //===--------------------------------------------------------------------===//
 
-  void RemoveTransactionFromRecoveryTable(void);
+  bool DoCheckpoint(void);
 
-  void MoveCommittedTuplesToRecoveryTxn(concurrency::Transaction *recovery_txn);
+ private:
+  std::string GetLogFileName(void);
 
-  void AbortTuplesFromRecoveryTable(void);
+  // Get the frontend loggers of all the log streams, this one first
+  std::vector<AriesFrontendLogger *> GetLogStreams(void);
 
-  void MoveTuples(concurrency::Transaction *destination,
-                  concurrency::Transaction *source);
+  // Open the log files of the streams beyond the frontend logger count,
+  // that an earlier run with more frontend loggers left
+  void OpenRetiredLogFiles(oid_t stream_count);
 
-  void InsertTuple(concurrency::Transaction *recovery_txn);
+  // Analysis : read the log streams, and split the tuple operations of the
+  // committed transactions into partitions by tile group
+  // returns the largest cid in the logs, and whether some commits were not
+  // durable in every stream
+  cid_t CollectRedoOperations(
+      std::vector<std::unique_ptr<LogReader>> &log_readers,
+      std::vector<RedoPartition> &partitions, txn_id_t txn_id,
+      std::deque<std::string> &rebuilt_tuples, bool &dropped_commits);
 
-  void DeleteTuple(concurrency::Transaction *recovery_txn);
+  // Checkpoint the recovered database at the end of all the log files, so
+  // that the recovered logs are never read again
+  bool CheckpointRecoveredLogs(const std::vector<LogFile *> &log_files);
 
-  void UpdateTuple(concurrency::Transaction *recovery_txn);
+  // Rebuild the new tuple of a delta update from the tuple that it changes
+  bool RebuildTuple(RedoOperation &operation, const char *base_data,
+                    size_t base_size, txn_id_t txn_id,
+                    std::string &tuple_data);
 
-  void AbortActiveTransactions();
+  // Redo : replay the operations of a partition
+  void RedoOperations(RedoPartition &partition, txn_id_t txn_id,
+                      cid_t last_cid);
 
-  void AbortTuples(concurrency::Transaction *txn);
-
- private:
-  std::string GetLogFileName(void);
+  // Find where the redo has to start after a checkpoint, that is before the
+  // first record of every txn that did not finish in the part of the log
+  size_t GetRedoStartOffset(size_t log_start, size_t log_end);
 
   //===--------------------------------------------------------------------===//
   // Member Variables
   //===--------------------------------------------------------------------===//
 
-  // File pointer and descriptor
-  FILE *log_file;
-  int log_file_fd;
-
-  // Size of the log file
-  size_t log_file_size;
+  // Segments of the log
+  LogFile log_file;
 
-  // Txn table during recovery
-  std::map<txn_id_t, concurrency::Transaction *> recovery_txn_table;
+  // Log files of the streams that have no frontend logger anymore, they are
+  // only read by the recovery
+  std::vector<std::unique_ptr<LogFile>> retired_log_files;
 
   // Keep tracking max oid for setting next_oid in manager
   // For active processing after recovery
@@ -86,6 +156,24 @@ class AriesFrontendLogger : public FrontendLogger {
 
   // pool for allocating non-inlined values
   VarlenPool *recovery_pool;
+
+  // Did the recovery load a checkpoint ? Then the redo may come across
+  // operations that the checkpoint already has.
+  bool redo_after_checkpoint = false;
+
+  CheckpointManager checkpoint_manager;
+
+  // Only one checkpoint at a time
+  std::mutex checkpoint_mutex;
+
+  // End of the flushed log, and the last cid that was assigned when it was
+  // flushed. The commits in the flushed log are not later than that cid.
+  // Sync access with flushed_log_mutex
+  size_t flushed_log_offset = 0;
+
+  cid_t flushed_log_cid = 0;
+
+  std::mutex flushed_log_mutex;
 };
 
 }  // namespace logging
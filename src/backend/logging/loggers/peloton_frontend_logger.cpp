@@ -29,14 +29,6 @@ namespace logging {
 
 size_t GetLogFileSize(int log_file_fd);
 
-LogRecordType GetNextLogRecordType(FILE *log_file, size_t log_file_size);
-
-bool ReadTransactionRecordHeader(TransactionRecord &txn_record, FILE *log_file,
-                                 size_t log_file_size);
-
-bool ReadTupleRecordHeader(TupleRecord &tuple_record, FILE *log_file,
-                           size_t log_file_size);
-
 /**
  * @brief create NVM backed log pool
  */
@@ -81,12 +73,22 @@ void PelotonFrontendLogger::FlushLogRecords(void) {
   std::vector<txn_id_t> committed_txn_list;
   std::vector<txn_id_t> not_committed_txn_list;
   std::set<oid_t> modified_tile_group_set;
+  std::vector<LogRecord *> transaction_records;
 
   //===--------------------------------------------------------------------===//
   // Collect the log records
   //===--------------------------------------------------------------------===//
 
   for (auto record : global_queue) {
+    // Keep the transaction records until they are durable
+    if (record->GetType() == LOGRECORD_TYPE_TRANSACTION_BEGIN ||
+        record->GetType() == LOGRECORD_TYPE_TRANSACTION_COMMIT ||
+        record->GetType() == LOGRECORD_TYPE_TRANSACTION_ABORT ||
+        record->GetType() == LOGRECORD_TYPE_TRANSACTION_END ||
+        record->GetType() == LOGRECORD_TYPE_TRANSACTION_DONE) {
+      transaction_records.push_back(record);
+    }
+
     switch (record->GetType()) {
       case LOGRECORD_TYPE_TRANSACTION_BEGIN:
         global_peloton_log_record_pool.CreateTransactionLogList(
@@ -192,6 +194,12 @@ void PelotonFrontendLogger::FlushLogRecords(void) {
     global_peloton_log_record_pool.RemoveTransactionLogList(txn_id);
   }
 
+  // Wake up the waiting commits
+  for (auto record : transaction_records) {
+    record->SetDurable();
+    delete record;
+  }
+
   // Notify the backend loggers
   {
     std::lock_guard<std::mutex> lock(backend_logger_mutex);
@@ -242,10 +250,10 @@ void PelotonFrontendLogger::WriteTransactionLogRecord(
     LOG_ERROR("Error occured in fflush(%d)", ret);
   }
 
-  // Finally, sync
-  ret = fsync(log_file_fd);
+  // Finally, sync the data, and the size of the file that it needs
+  ret = fdatasync(log_file_fd);
   if (ret != 0) {
-    LOG_ERROR("Error occured in fsync(%d)", ret);
+    LOG_ERROR("Error occured in fdatasync(%d)", ret);
   }
 }
 
@@ -420,34 +428,25 @@ void PelotonFrontendLogger::DoRecovery() {
 
   // Go over the log size if needed
   if (log_file_size > 0) {
-    bool reached_end_of_file = false;
+    LogReader log_reader(log_file_fd, 0, log_file_size);
 
-    // check whether first item is LOGRECORD_TYPE_TRANSACTION_COMMIT
+    // check whether last item is LOGRECORD_TYPE_TRANSACTION_COMMIT
     // if not, no need to do recovery.
     // if yes, need to replay all log records before we hit
     // LOGRECORD_TYPE_TRANSACTION_DONE
-    bool need_recovery = NeedRecovery();
+    bool need_recovery = NeedRecovery(log_reader);
     if (need_recovery == true) {
-      TransactionRecord dummy_transaction_record(LOGRECORD_TYPE_INVALID);
       cid_t current_commit_id = INVALID_CID;
 
-      // Go over each log record in the log file
-      while (reached_end_of_file == false) {
-        // Read the first byte to identify log record type
-        // If that is not possible, then wrap up recovery
-        LogRecordType log_type = GetNextLogRecordType(log_file, log_file_size);
-
-        switch (log_type) {
-          case LOGRECORD_TYPE_TRANSACTION_DONE:
-          case LOGRECORD_TYPE_TRANSACTION_COMMIT: {
-            // read but do nothing
-            ReadTransactionRecordHeader(dummy_transaction_record, log_file,
-                                        log_file_size);
-          } break;
+      // Go over each log record in the log file, until the end of the log
+      RawLogRecord record;
+      while (log_reader.ReadRecord(record)) {
+        ReferenceSerializeInputBE header(record.header, record.header_size);
 
+        switch (record.type) {
           case LOGRECORD_TYPE_PELOTON_TUPLE_INSERT: {
-            TupleRecord insert_record(LOGRECORD_TYPE_PELOTON_TUPLE_INSERT);
-            ReadTupleRecordHeader(insert_record, log_file, log_file_size);
+            TupleRecord insert_record(record.type);
+            insert_record.DeserializeHeader(header);
 
             auto insert_location = insert_record.GetInsertLocation();
             auto info = SetInsertCommitMark(insert_location);
@@ -455,8 +454,8 @@ void PelotonFrontendLogger::DoRecovery() {
           } break;
 
           case LOGRECORD_TYPE_PELOTON_TUPLE_DELETE: {
-            TupleRecord delete_record(LOGRECORD_TYPE_PELOTON_TUPLE_DELETE);
-            ReadTupleRecordHeader(delete_record, log_file, log_file_size);
+            TupleRecord delete_record(record.type);
+            delete_record.DeserializeHeader(header);
 
             auto delete_location = delete_record.GetDeleteLocation();
             auto info = SetDeleteCommitMark(delete_location);
@@ -464,8 +463,8 @@ void PelotonFrontendLogger::DoRecovery() {
           } break;
 
           case LOGRECORD_TYPE_PELOTON_TUPLE_UPDATE: {
-            TupleRecord update_record(LOGRECORD_TYPE_PELOTON_TUPLE_UPDATE);
-            ReadTupleRecordHeader(update_record, log_file, log_file_size);
+            TupleRecord update_record(record.type);
+            update_record.DeserializeHeader(header);
 
             auto delete_location = update_record.GetDeleteLocation();
             SetDeleteCommitMark(delete_location);
@@ -476,7 +475,7 @@ void PelotonFrontendLogger::DoRecovery() {
           } break;
 
           default:
-            reached_end_of_file = true;
+            // Nothing to do for the transaction records
             break;
         }
       }
@@ -499,23 +498,27 @@ void PelotonFrontendLogger::DoRecovery() {
   }
 }
 
-// Check whether need to recovery, if yes, reset fseek to the right place.
-bool PelotonFrontendLogger::NeedRecovery(void) {
-  // Otherwise, read the last transaction record
-  fseek(log_file, -TransactionRecord::GetTransactionRecordSize(), SEEK_END);
+// Check whether need to recovery, if yes, move the reader to the right place.
+bool PelotonFrontendLogger::NeedRecovery(LogReader &log_reader) {
+  size_t txn_record_size = TransactionRecord::GetTransactionRecordSize();
+  if (log_file_size < txn_record_size) {
+    return false;
+  }
 
-  // Get its type
-  auto log_record_type = GetNextLogRecordType(log_file, log_file_size);
+  // Otherwise, read the last transaction record
+  RawLogRecord record;
+  log_reader.Seek(log_file_size - txn_record_size);
+  if (log_reader.ReadRecord(record) == false) {
+    return false;
+  }
 
   // Check if the previous transaction run is broken
-  if (log_record_type == LOGRECORD_TYPE_TRANSACTION_COMMIT) {
+  if (record.type == LOGRECORD_TYPE_TRANSACTION_COMMIT) {
     TransactionRecord txn_record(LOGRECORD_TYPE_TRANSACTION_COMMIT);
 
     // read the last written out transaction log record
-    if (ReadTransactionRecordHeader(txn_record, log_file, log_file_size) ==
-        false) {
-      return false;
-    }
+    ReferenceSerializeInputBE header(record.header, record.header_size);
+    txn_record.Deserialize(header);
 
     // Peloton log records items have fixed size.
     // Compute log offset based on txn_id
@@ -526,8 +529,10 @@ bool PelotonFrontendLogger::NeedRecovery(void) {
         TransactionRecord::GetTransactionRecordSize();
 
     // Rollback to the computed offset
-    fseek(log_file, -rollback_offset, SEEK_END);
-    return true;
+    if (rollback_offset > log_file_size) {
+      return false;
+    }
+    return log_reader.Seek(log_file_size - rollback_offset);
   } else {
     return false;
   }
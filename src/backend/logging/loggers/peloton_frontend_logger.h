@@ -15,6 +15,7 @@
 #include <set>
 
 #include "backend/logging/frontend_logger.h"
+#include "backend/logging/log_reader.h"
 #include "backend/logging/records/transaction_record.h"
 #include "backend/logging/records/tuple_record.h"
 #include "backend/logging/records/log_record_pool.h"
@@ -71,7 +72,7 @@ class PelotonFrontendLogger : public FrontendLogger {
  private:
   std::string GetLogFileName(void);
 
-  bool NeedRecovery(void);
+  bool NeedRecovery(LogReader &log_reader);
 
   void WriteTransactionLogRecord(TransactionRecord txnLog);
 
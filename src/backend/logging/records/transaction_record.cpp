@@ -10,9 +10,8 @@ namespace logging {
  * @brief Serialize given data
  * @return true if we serialize data otherwise false
  */
-bool TransactionRecord::Serialize(CopySerializeOutput &output) {
+bool TransactionRecord::SerializeTo(SerializeOutput &output) {
   bool status = true;
-  output.Reset();
 
   // First, write out the log record type
   output.WriteEnumInSingleByte(log_record_type);
@@ -21,16 +20,15 @@ bool TransactionRecord::Serialize(CopySerializeOutput &output) {
   size_t start = output.Position();
   output.WriteInt(0);
   output.WriteLong(txn_id);
+  if (cid != INVALID_CID) {
+    output.WriteLong(cid);
+  }
 
   // Write out the header now
   int32_t header_length =
       static_cast<int32_t>(output.Position() - start - sizeof(int32_t));
   output.WriteIntAt(start, header_length);
 
-  message_length = output.Size();
-  message = new char[message_length];
-  memcpy(message, output.Data(), message_length);
-
   return status;
 }
 
@@ -38,12 +36,15 @@ bool TransactionRecord::Serialize(CopySerializeOutput &output) {
  * @brief Deserialize LogRecordHeader
  * @param input
  */
-void TransactionRecord::Deserialize(CopySerializeInputBE &input) {
+void TransactionRecord::Deserialize(SerializeInputBE &input) {
   // Get the message length
-  input.ReadInt();
+  auto header_length = input.ReadInt();
 
-  // Just grab the transaction id
+  // Grab the transaction id, and the cid if there is one
   txn_id = (txn_id_t)(input.ReadLong());
+  if (header_length >= static_cast<int32_t>(2 * sizeof(int64_t))) {
+    cid = (cid_t)(input.ReadLong());
+  }
 }
 
 // Used for peloton logging
@@ -55,6 +56,9 @@ size_t TransactionRecord::GetTransactionRecordSize(void) {
 void TransactionRecord::Print(void) {
   std::cout << "#LOG TYPE:" << LogRecordTypeToString(GetType()) << "\n";
   std::cout << " #Txn ID:" << GetTransactionId() << "\n";
+  if (cid != INVALID_CID) {
+    std::cout << " #Commit ID:" << cid << "\n";
+  }
   std::cout << "\n";
 }
 
@@ -25,9 +25,9 @@ class TransactionRecord : public LogRecord {
   // Serial/Deserialization
   //===--------------------------------------------------------------------===//
 
-  bool Serialize(CopySerializeOutput &output);
+  bool SerializeTo(SerializeOutput &output);
 
-  void Deserialize(CopySerializeInputBE &input);
+  void Deserialize(SerializeInputBE &input);
 
   static size_t GetTransactionRecordSize(void);
 
@@ -35,7 +35,16 @@ class TransactionRecord : public LogRecord {
   // Accessors
   //===--------------------------------------------------------------------===//
 
+  // The cid of a commit, or up to which the commits of a log stream are
+  // durable. It is only logged if it is set.
+  void SetCommitId(cid_t cid_) { cid = cid_; }
+
+  cid_t GetCommitId(void) const { return cid; }
+
   void Print(void);
+
+ private:
+  cid_t cid = INVALID_CID;
 };
 
 }  // namespace logging
@@ -21,9 +21,8 @@ namespace logging {
  * @brief Serialize given data
  * @return true if we serialize data otherwise false
  */
-bool TupleRecord::Serialize(CopySerializeOutput &output) {
+bool TupleRecord::SerializeTo(SerializeOutput &output) {
   bool status = true;
-  output.Reset();
 
   // Serialize the common variables such as database oid, table oid, etc.
   SerializeHeader(output);
@@ -37,6 +36,20 @@ bool TupleRecord::Serialize(CopySerializeOutput &output) {
       break;
     }
 
+    case LOGRECORD_TYPE_ARIES_TUPLE_DELTA_UPDATE: {
+      // Only the changed columns, each after its id
+      storage::Tuple *tuple = (storage::Tuple *)data;
+      size_t start = output.ReserveBytes(sizeof(int32_t));
+      output.WriteShort(static_cast<int16_t>(changed_columns.size()));
+      for (auto column_id : changed_columns) {
+        output.WriteShort(static_cast<int16_t>(column_id));
+        tuple->GetValue(column_id).SerializeTo(output);
+      }
+      output.WriteIntAt(start, static_cast<int32_t>(output.Position() - start -
+                                                    sizeof(int32_t)));
+      break;
+    }
+
     case LOGRECORD_TYPE_ARIES_TUPLE_DELETE:
       // Nothing to do here !
       break;
@@ -54,10 +67,6 @@ bool TupleRecord::Serialize(CopySerializeOutput &output) {
     }
   }
 
-  message_length = output.Size();
-  message = new char[message_length];
-  std::memcpy(message, output.Data(), message_length);
-
   return status;
 }
 
@@ -65,7 +74,7 @@ bool TupleRecord::Serialize(CopySerializeOutput &output) {
  * @brief Serialize LogRecordHeader
  * @param output
  */
-void TupleRecord::SerializeHeader(CopySerializeOutput &output) {
+void TupleRecord::SerializeHeader(SerializeOutput &output) {
   // Record LogRecordType first
   output.WriteEnumInSingleByte(log_record_type);
 
@@ -89,7 +98,7 @@ void TupleRecord::SerializeHeader(CopySerializeOutput &output) {
  * @brief Deserialize LogRecordHeader
  * @param input
  */
-void TupleRecord::DeserializeHeader(CopySerializeInputBE &input) {
+void TupleRecord::DeserializeHeader(SerializeInputBE &input) {
   input.ReadInt();
   db_oid = (oid_t)(input.ReadLong());
   assert(db_oid);
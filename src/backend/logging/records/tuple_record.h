@@ -12,6 +12,8 @@
 
 #pragma once
 
+#include <vector>
+
 #include "backend/logging/log_record.h"
 #include "backend/common/serializer.h"
 
@@ -60,11 +62,11 @@ class TupleRecord : public LogRecord {
   // Serial/Deserialization
   //===--------------------------------------------------------------------===//
 
-  bool Serialize(CopySerializeOutput &output);
+  bool SerializeTo(SerializeOutput &output);
 
-  void SerializeHeader(CopySerializeOutput &output);
+  void SerializeHeader(SerializeOutput &output);
 
-  void DeserializeHeader(CopySerializeInputBE &input);
+  void DeserializeHeader(SerializeInputBE &input);
 
   //===--------------------------------------------------------------------===//
   // Accessor
@@ -78,6 +80,15 @@ class TupleRecord : public LogRecord {
 
   ItemPointer GetDeleteLocation(void) const { return delete_location; }
 
+  // Columns of the new tuple that a delta update logs
+  void SetChangedColumns(const std::vector<oid_t> &changed_columns_) {
+    changed_columns = changed_columns_;
+  }
+
+  const std::vector<oid_t> &GetChangedColumns(void) const {
+    return changed_columns;
+  }
+
   static size_t GetTupleRecordSize(void);
 
   void Print(void);
@@ -101,6 +112,9 @@ class TupleRecord : public LogRecord {
 
   // database id
   oid_t db_oid;
+
+  // changed columns of a delta update
+  std::vector<oid_t> changed_columns;
 };
 
 }  // namespace logging
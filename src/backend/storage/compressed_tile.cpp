@@ -0,0 +1,448 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// compressed_tile.cpp
+//
+// Identification: src/backend/storage/compressed_tile.cpp
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <sstream>
+#include <string>
+
+#include "backend/common/logger.h"
+#include "backend/common/value_peeker.h"
+#include "backend/storage/compressed_tile.h"
+#include "backend/storage/storage_manager.h"
+#include "backend/storage/tile_group.h"
+
+namespace peloton {
+namespace storage {
+
+//===--------------------------------------------------------------------===//
+// Bit Packing
+//===--------------------------------------------------------------------===//
+
+// Number of bits needed to represent the given value
+static oid_t GetBitWidth(uint64_t value) {
+  oid_t bit_width = 0;
+  while (value != 0) {
+    bit_width++;
+    value >>= 1;
+  }
+  return bit_width;
+}
+
+// Size of the given number of bit-packed values
+static size_t GetPackedSize(oid_t value_count, oid_t bit_width) {
+  size_t bit_count = (size_t)value_count * bit_width;
+  return ((bit_count + 63) / 64) * sizeof(uint64_t);
+}
+
+static uint64_t GetBitMask(oid_t bit_width) {
+  if (bit_width == 64) return ~UINT64_C(0);
+  return (UINT64_C(1) << bit_width) - 1;
+}
+
+static void PackValue(std::vector<uint64_t> &packed_values, oid_t bit_width,
+                      oid_t offset, uint64_t value) {
+  if (bit_width == 0) return;
+
+  size_t bit_offset = (size_t)offset * bit_width;
+  size_t word = bit_offset / 64;
+  oid_t shift = bit_offset % 64;
+
+  packed_values[word] |= value << shift;
+
+  // Spills over to the next word
+  if (shift + bit_width > 64) {
+    packed_values[word + 1] |= value >> (64 - shift);
+  }
+}
+
+static uint64_t UnpackValue(const std::vector<uint64_t> &packed_values,
+                            oid_t bit_width, oid_t offset) {
+  if (bit_width == 0) return 0;
+
+  size_t bit_offset = (size_t)offset * bit_width;
+  size_t word = bit_offset / 64;
+  oid_t shift = bit_offset % 64;
+
+  uint64_t value = packed_values[word] >> shift;
+
+  // Spills over to the next word
+  if (shift + bit_width > 64) {
+    value |= packed_values[word + 1] << (64 - shift);
+  }
+
+  return value & GetBitMask(bit_width);
+}
+
+//===--------------------------------------------------------------------===//
+// Integer Fields
+//===--------------------------------------------------------------------===//
+
+// Only integer columns support RLE and FOR
+static bool IsIntegerColumn(const catalog::Schema &schema, oid_t column_id) {
+  if (schema.IsInlined(column_id) == false) return false;
+
+  switch (schema.GetType(column_id)) {
+    case VALUE_TYPE_TINYINT:
+    case VALUE_TYPE_SMALLINT:
+    case VALUE_TYPE_INTEGER:
+    case VALUE_TYPE_BIGINT:
+    case VALUE_TYPE_TIMESTAMP:
+      return true;
+
+    default:
+      return false;
+  }
+}
+
+// Read the integer stored in the field, including null markers
+static int64_t ReadIntegerField(const char *field, size_t field_length) {
+  switch (field_length) {
+    case sizeof(int8_t):
+      return *reinterpret_cast<const int8_t *>(field);
+    case sizeof(int16_t):
+      return *reinterpret_cast<const int16_t *>(field);
+    case sizeof(int32_t):
+      return *reinterpret_cast<const int32_t *>(field);
+    case sizeof(int64_t):
+      return *reinterpret_cast<const int64_t *>(field);
+    default:
+      assert(false);
+      return 0;
+  }
+}
+
+static void WriteIntegerField(char *field, size_t field_length,
+                              int64_t value) {
+  switch (field_length) {
+    case sizeof(int8_t):
+      *reinterpret_cast<int8_t *>(field) = static_cast<int8_t>(value);
+      break;
+    case sizeof(int16_t):
+      *reinterpret_cast<int16_t *>(field) = static_cast<int16_t>(value);
+      break;
+    case sizeof(int32_t):
+      *reinterpret_cast<int32_t *>(field) = static_cast<int32_t>(value);
+      break;
+    case sizeof(int64_t):
+      *reinterpret_cast<int64_t *>(field) = value;
+      break;
+    default:
+      assert(false);
+  }
+}
+
+//===--------------------------------------------------------------------===//
+// Compressed Tile
+//===--------------------------------------------------------------------===//
+
+CompressedTile::CompressedTile(Tile *tile, TileGroup *tile_group)
+    : Tile(tile->GetBackendType(), tile->GetHeader(), *tile->GetSchema(),
+           tile_group, tile->GetAllocatedTupleCount(), false),
+      tuple_count(tile->GetAllocatedTupleCount()),
+      compressed_columns(column_count),
+      column_offset_map(tuple_length, INVALID_OID),
+      uncompressed_size(tile->GetSize()) {
+  database_id = tile_group->GetDatabaseId();
+  table_id = tile_group->GetTableId();
+  tile_group_id = tile_group->GetTileGroupId();
+  tile_id = tile->GetTileId();
+
+  for (oid_t column_itr = 0; column_itr < column_count; column_itr++) {
+    column_offset_map[schema.GetOffset(column_itr)] = column_itr;
+    CompressColumn(tile, column_itr);
+  }
+
+  // Account for the encoded columns
+  tile_size = 0;
+  for (auto &compressed_column : compressed_columns) {
+    tile_size += compressed_column.fields.size();
+    tile_size += compressed_column.packed_values.size() * sizeof(uint64_t);
+    tile_size += compressed_column.run_values.size() * sizeof(int64_t);
+    tile_size += compressed_column.run_ends.size() * sizeof(oid_t);
+  }
+
+  LOG_TRACE("Compressed tile %lu from %lu to %lu bytes", tile_id,
+            uncompressed_size, GetSize());
+}
+
+CompressedTile::~CompressedTile() {
+  // Tile reclaims the pool holding the uninlined dictionary entries
+}
+
+void CompressedTile::CompressColumn(Tile *tile, const oid_t column_id) {
+  auto &compressed_column = compressed_columns[column_id];
+
+  const size_t field_length = schema.GetLength(column_id);
+  const size_t field_offset = schema.GetOffset(column_id);
+  const bool is_inlined = schema.IsInlined(column_id);
+  const bool is_integer = IsIntegerColumn(schema, column_id);
+
+  // Build the dictionary
+  std::map<std::string, oid_t> dictionary;
+  std::vector<oid_t> codes(tuple_count);
+  std::vector<const char *> entries;
+
+  for (oid_t tuple_itr = 0; tuple_itr < tuple_count; tuple_itr++) {
+    const char *field = tile->GetTupleLocation(tuple_itr) + field_offset;
+
+    // Uninlined fields only hold a pointer, so use the value instead
+    std::string key;
+    if (is_inlined) {
+      key.assign(field, field_length);
+    } else {
+      auto value = tile->GetValue(tuple_itr, column_id);
+      if (value.IsNull() == false) {
+        key = "V" + ValuePeeker::PeekStringCopyWithoutNull(value);
+      }
+    }
+
+    auto entry = dictionary.find(key);
+    if (entry == dictionary.end()) {
+      entry = dictionary.insert(std::make_pair(key, entries.size())).first;
+      entries.push_back(field);
+    }
+    codes[tuple_itr] = entry->second;
+  }
+
+  oid_t entry_count = entries.size();
+  oid_t code_bit_width = GetBitWidth(entry_count - 1);
+
+  // Find the runs and the range of integer values
+  std::vector<int64_t> run_values;
+  std::vector<oid_t> run_ends;
+  int64_t min_value = 0, max_value = 0;
+
+  if (is_integer) {
+    for (oid_t tuple_itr = 0; tuple_itr < tuple_count; tuple_itr++) {
+      const char *field = tile->GetTupleLocation(tuple_itr) + field_offset;
+      int64_t value = ReadIntegerField(field, field_length);
+
+      if (tuple_itr == 0 || value != run_values.back()) {
+        run_values.push_back(value);
+        run_ends.push_back(tuple_itr + 1);
+      } else {
+        run_ends.back() = tuple_itr + 1;
+      }
+
+      if (tuple_itr == 0 || value < min_value) min_value = value;
+      if (tuple_itr == 0 || value > max_value) max_value = value;
+    }
+  }
+
+  oid_t offset_bit_width =
+      GetBitWidth(static_cast<uint64_t>(max_value) -
+                  static_cast<uint64_t>(min_value));
+
+  // Pick the smallest encoding
+  EncodingType encoding_type = ENCODING_TYPE_NONE;
+  size_t encoded_size = tuple_count * field_length;
+
+  size_t dictionary_size = entry_count * field_length +
+                           GetPackedSize(tuple_count, code_bit_width);
+  // Uninlined fields must always be copied through the dictionary
+  if (dictionary_size < encoded_size || is_inlined == false) {
+    encoding_type = ENCODING_TYPE_DICTIONARY;
+    encoded_size = dictionary_size;
+  }
+
+  if (is_integer) {
+    size_t rle_size = run_values.size() * (sizeof(int64_t) + sizeof(oid_t));
+    if (rle_size < encoded_size) {
+      encoding_type = ENCODING_TYPE_RLE;
+      encoded_size = rle_size;
+    }
+
+    size_t for_size = GetPackedSize(tuple_count, offset_bit_width);
+    if (for_size < encoded_size) {
+      encoding_type = ENCODING_TYPE_FOR;
+      encoded_size = for_size;
+    }
+  }
+
+  compressed_column.encoding_type = encoding_type;
+
+  // Encode the column
+  switch (encoding_type) {
+    case ENCODING_TYPE_NONE: {
+      compressed_column.fields.resize(tuple_count * field_length);
+      for (oid_t tuple_itr = 0; tuple_itr < tuple_count; tuple_itr++) {
+        const char *field = tile->GetTupleLocation(tuple_itr) + field_offset;
+        std::memcpy(&compressed_column.fields[tuple_itr * field_length], field,
+                    field_length);
+      }
+    } break;
+
+    case ENCODING_TYPE_DICTIONARY: {
+      compressed_column.fields.resize(entry_count * field_length);
+      for (oid_t entry_itr = 0; entry_itr < entry_count; entry_itr++) {
+        char *entry_field = &compressed_column.fields[entry_itr * field_length];
+        if (is_inlined) {
+          std::memcpy(entry_field, entries[entry_itr], field_length);
+        } else {
+          // Copy the uninlined data into the pool of this tile
+          auto value = Value::InitFromTupleStorage(
+              entries[entry_itr], schema.GetType(column_id), is_inlined);
+          const bool is_in_bytes = false;
+          value.SerializeToTupleStorageAllocateForObjects(
+              entry_field, is_inlined, schema.GetVariableLength(column_id),
+              is_in_bytes, pool);
+        }
+      }
+
+      compressed_column.bit_width = code_bit_width;
+      compressed_column.packed_values.resize(
+          GetPackedSize(tuple_count, code_bit_width) / sizeof(uint64_t), 0);
+      for (oid_t tuple_itr = 0; tuple_itr < tuple_count; tuple_itr++) {
+        PackValue(compressed_column.packed_values, code_bit_width, tuple_itr,
+                  codes[tuple_itr]);
+      }
+    } break;
+
+    case ENCODING_TYPE_RLE: {
+      compressed_column.run_values = run_values;
+      compressed_column.run_ends = run_ends;
+    } break;
+
+    case ENCODING_TYPE_FOR: {
+      compressed_column.base_value = min_value;
+      compressed_column.bit_width = offset_bit_width;
+      compressed_column.packed_values.resize(
+          GetPackedSize(tuple_count, offset_bit_width) / sizeof(uint64_t), 0);
+      for (oid_t tuple_itr = 0; tuple_itr < tuple_count; tuple_itr++) {
+        const char *field = tile->GetTupleLocation(tuple_itr) + field_offset;
+        int64_t value = ReadIntegerField(field, field_length);
+        PackValue(compressed_column.packed_values, offset_bit_width, tuple_itr,
+                  static_cast<uint64_t>(value) -
+                      static_cast<uint64_t>(min_value));
+      }
+    } break;
+
+    default:
+      assert(false);
+  }
+
+  LOG_TRACE("Column %lu :: %s :: %lu bytes", column_id,
+            EncodingTypeToString(encoding_type).c_str(), encoded_size);
+}
+
+Value CompressedTile::DecodeValue(const oid_t tuple_offset,
+                                  const oid_t column_id) const {
+  auto &compressed_column = compressed_columns[column_id];
+
+  const ValueType column_type = schema.GetType(column_id);
+  const size_t field_length = schema.GetLength(column_id);
+  const bool is_inlined = schema.IsInlined(column_id);
+
+  switch (compressed_column.encoding_type) {
+    case ENCODING_TYPE_NONE: {
+      const char *field = &compressed_column.fields[tuple_offset * field_length];
+      return Value::InitFromTupleStorage(field, column_type, is_inlined);
+    }
+
+    case ENCODING_TYPE_DICTIONARY: {
+      auto code = UnpackValue(compressed_column.packed_values,
+                              compressed_column.bit_width, tuple_offset);
+      const char *field = &compressed_column.fields[code * field_length];
+      return Value::InitFromTupleStorage(field, column_type, is_inlined);
+    }
+
+    case ENCODING_TYPE_RLE: {
+      auto &run_ends = compressed_column.run_ends;
+      auto run = std::upper_bound(run_ends.begin(), run_ends.end(),
+                                  tuple_offset) -
+                 run_ends.begin();
+      char field[sizeof(int64_t)];
+      WriteIntegerField(field, field_length, compressed_column.run_values[run]);
+      return Value::InitFromTupleStorage(field, column_type, is_inlined);
+    }
+
+    case ENCODING_TYPE_FOR: {
+      auto offset = UnpackValue(compressed_column.packed_values,
+                                compressed_column.bit_width, tuple_offset);
+      char field[sizeof(int64_t)];
+      WriteIntegerField(field, field_length,
+                        static_cast<int64_t>(static_cast<uint64_t>(
+                                                 compressed_column.base_value) +
+                                             offset));
+      return Value::InitFromTupleStorage(field, column_type, is_inlined);
+    }
+
+    default:
+      assert(false);
+      return Value();
+  }
+}
+
+Value CompressedTile::GetValue(const oid_t tuple_offset,
+                               const oid_t column_id) {
+  assert(tuple_offset < GetAllocatedTupleCount());
+  assert(column_id < schema.GetColumnCount());
+
+  return DecodeValue(tuple_offset, column_id);
+}
+
+Value CompressedTile::GetValueFast(const oid_t tuple_offset,
+                                   const size_t column_offset,
+                                   const ValueType column_type
+                                   __attribute__((unused)),
+                                   const bool is_inlined
+                                   __attribute__((unused))) {
+  assert(tuple_offset < GetAllocatedTupleCount());
+  assert(column_offset < schema.GetLength());
+
+  oid_t column_id = column_offset_map[column_offset];
+  assert(column_id != INVALID_OID);
+
+  return DecodeValue(tuple_offset, column_id);
+}
+
+const std::string CompressedTile::GetInfo() const {
+  std::ostringstream os;
+
+  os << "\t-----------------------------------------------------------\n";
+
+  os << "\tCOMPRESSED TILE\n";
+  os << "\tCatalog ::"
+     << " Backend: " << BackendTypeToString(backend_type) << ","
+     << " DB: " << database_id << " Table: " << table_id
+     << " Tile Group:  " << tile_group_id << " Tile:  " << tile_id << "\n";
+
+  os << "\tSize :: " << GetSize() << " bytes (uncompressed "
+     << uncompressed_size << " bytes)\n";
+
+  for (oid_t column_itr = 0; column_itr < column_count; column_itr++) {
+    os << "\t Column " << column_itr << " :: "
+       << EncodingTypeToString(compressed_columns[column_itr].encoding_type)
+       << "\n";
+  }
+
+  // Tuples
+  os << "\t-----------------------------------------------------------\n";
+  os << "\tDATA\n";
+
+  for (oid_t tuple_itr = 0; tuple_itr < tuple_count; tuple_itr++) {
+    os << "\t";
+    for (oid_t column_itr = 0; column_itr < column_count; column_itr++) {
+      os << "(" << DecodeValue(tuple_itr, column_itr) << ")";
+    }
+    os << "\n";
+  }
+
+  os << "\t-----------------------------------------------------------\n";
+
+  return os.str();
+}
+
+}  // End storage namespace
+}  // End peloton namespace
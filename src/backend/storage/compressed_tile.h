@@ -0,0 +1,119 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// compressed_tile.h
+//
+// Identification: src/backend/storage/compressed_tile.h
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <vector>
+
+#include "backend/storage/tile.h"
+
+namespace peloton {
+namespace storage {
+
+//===--------------------------------------------------------------------===//
+// Compressed Tile
+//===--------------------------------------------------------------------===//
+
+/**
+ * Read-only tile that stores each column with its own encoding.
+ *
+ * It is built from a tile whose tuples do not change anymore, i.e. a tile in
+ * a cold tile group. Every column picks the smallest of the following :
+ *
+ * NONE : fixed-length fields, as in a regular tile.
+ * DICTIONARY : distinct fields and bit-packed codes into them.
+ * RLE : runs of integer values.
+ * FOR : bit-packed offsets of integer values from their minimum.
+ *
+ * Values are decoded on the fly by GetValue and GetValueFast. The tuple
+ * slots are not materialized, so the tile cannot be modified and
+ * GetTupleLocation must not be used on it.
+ */
+class CompressedTile : public Tile {
+  CompressedTile() = delete;
+  CompressedTile(CompressedTile const &) = delete;
+
+ public:
+  // Compress the given tile into a tile in the given tile group
+  CompressedTile(Tile *tile, TileGroup *tile_group);
+
+  ~CompressedTile();
+
+  //===--------------------------------------------------------------------===//
+  // Operations
+  //===--------------------------------------------------------------------===//
+
+  Value GetValue(const oid_t tuple_offset, const oid_t column_id);
+
+  Value GetValueFast(const oid_t tuple_offset, const size_t column_offset,
+                     const ValueType column_type, const bool is_inlined);
+
+  //===--------------------------------------------------------------------===//
+  // Utilities
+  //===--------------------------------------------------------------------===//
+
+  EncodingType GetEncodingType(const oid_t column_id) const {
+    return compressed_columns[column_id].encoding_type;
+  }
+
+  // Get the size of the tile before compression
+  size_t GetUncompressedSize() const { return uncompressed_size; }
+
+  // Get a string representation for debugging
+  const std::string GetInfo() const;
+
+ private:
+  // encoded column
+  struct CompressedColumn {
+    EncodingType encoding_type = ENCODING_TYPE_INVALID;
+
+    // NONE : field of every tuple
+    // DICTIONARY : distinct fields
+    std::vector<char> fields;
+
+    // DICTIONARY : codes, FOR : offsets from the frame of reference
+    std::vector<uint64_t> packed_values;
+
+    oid_t bit_width = 0;
+
+    // FOR : frame of reference
+    int64_t base_value = 0;
+
+    // RLE : value of each run and offset past its last tuple
+    std::vector<int64_t> run_values;
+
+    std::vector<oid_t> run_ends;
+  };
+
+  void CompressColumn(Tile *tile, const oid_t column_id);
+
+  Value DecodeValue(const oid_t tuple_offset, const oid_t column_id) const;
+
+  //===--------------------------------------------------------------------===//
+  // Data members
+  //===--------------------------------------------------------------------===//
+
+  // number of tuples in the tile
+  oid_t tuple_count;
+
+  // encoded columns
+  std::vector<CompressedColumn> compressed_columns;
+
+  // column id of the column at each offset within the tuple slot
+  std::vector<oid_t> column_offset_map;
+
+  // size of the tile before compression
+  size_t uncompressed_size;
+};
+
+}  // End storage namespace
+}  // End peloton namespace
@@ -0,0 +1,195 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// data_file.cpp
+//
+// Identification: src/backend/storage/data_file.cpp
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "backend/storage/data_file.h"
+#include "backend/common/logger.h"
+
+#include <sys/mman.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <unistd.h>
+#include <string.h>
+
+#include <iterator>
+
+namespace peloton {
+namespace storage {
+
+DataFile::DataFile(const std::string &file_name)
+    : file_name(file_name), data_fd(-1), file_size(0) {
+  data_fd = open(file_name.c_str(), O_CREAT | O_RDWR, 0666);
+  if (data_fd < 0) {
+    LOG_ERROR("Could not open data file %s : %s", file_name.c_str(),
+              strerror(errno));
+    return;
+  }
+
+  struct stat file_stat;
+  if (fstat(data_fd, &file_stat) != 0) {
+    LOG_ERROR("Could not stat data file %s : %s", file_name.c_str(),
+              strerror(errno));
+    return;
+  }
+
+  // Tile groups are rebuilt on restart, so the existing pages are free
+  if (file_stat.st_size > 0) {
+    size_t existing_size = GetExtentSize(file_stat.st_size);
+    int status = posix_fallocate(data_fd, 0, existing_size);
+    if (status != 0) {
+      LOG_ERROR("Could not extend data file %s : %s", file_name.c_str(),
+                strerror(status));
+      return;
+    }
+
+    file_size = existing_size;
+    MapChunk(0, existing_size);
+  }
+}
+
+DataFile::~DataFile() {
+  for (auto entry : mapped_chunks) {
+    munmap(entry.second.first, entry.second.second);
+  }
+  mapped_chunks.clear();
+
+  if (data_fd >= 0) close(data_fd);
+}
+
+size_t DataFile::GetExtentSize(size_t size) {
+  static const size_t page_size = sysconf(_SC_PAGESIZE);
+
+  if (size == 0) size = 1;
+  return ((size + page_size - 1) / page_size) * page_size;
+}
+
+bool DataFile::MapChunk(size_t offset, size_t size) {
+  void *address =
+      mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, data_fd, offset);
+  if (address == MAP_FAILED) {
+    LOG_ERROR("Could not map data file %s : %s", file_name.c_str(),
+              strerror(errno));
+    return false;
+  }
+
+  mapped_chunks[offset] =
+      std::make_pair(reinterpret_cast<char *>(address), size);
+  free_extents[offset] = size;
+  return true;
+}
+
+bool DataFile::AddChunk(size_t size) {
+  size_t chunk_size = GetExtentSize(DATA_FILE_CHUNK_SIZE);
+  if (size > chunk_size) chunk_size = size;
+
+  int status = posix_fallocate(data_fd, file_size, chunk_size);
+  if (status != 0) {
+    LOG_ERROR("Could not grow data file %s : %s", file_name.c_str(),
+              strerror(status));
+    return false;
+  }
+
+  size_t offset = file_size;
+  file_size += chunk_size;
+
+  return MapChunk(offset, chunk_size);
+}
+
+void *DataFile::AllocateExtent(size_t size) {
+  if (data_fd < 0) return nullptr;
+
+  size = GetExtentSize(size);
+
+  std::lock_guard<std::mutex> lock(data_file_mutex);
+
+  // Find the first free extent that is large enough
+  auto free_itr = free_extents.begin();
+  for (; free_itr != free_extents.end(); free_itr++) {
+    if (free_itr->second >= size) break;
+  }
+
+  // Otherwise, grow the file by a chunk
+  if (free_itr == free_extents.end()) {
+    if (AddChunk(size) == false) return nullptr;
+    free_itr = std::prev(free_extents.end());
+  }
+
+  size_t offset = free_itr->first;
+  size_t free_size = free_itr->second;
+
+  // Put back the rest of the extent
+  free_extents.erase(free_itr);
+  if (free_size > size) {
+    free_extents[offset + size] = free_size - size;
+  }
+
+  // Locate the extent in its chunk
+  auto chunk_itr = std::prev(mapped_chunks.upper_bound(offset));
+  char *address = chunk_itr->second.first + (offset - chunk_itr->first);
+
+  allocated_extents[address] = std::make_pair(offset, size);
+
+  return address;
+}
+
+bool DataFile::ReleaseExtent(void *address) {
+  std::lock_guard<std::mutex> lock(data_file_mutex);
+
+  auto extent_itr = allocated_extents.find(reinterpret_cast<char *>(address));
+  if (extent_itr == allocated_extents.end()) return false;
+
+  size_t offset = extent_itr->second.first;
+  size_t size = extent_itr->second.second;
+  allocated_extents.erase(extent_itr);
+
+  // Extents are only coalesced within their chunk
+  auto chunk_itr = std::prev(mapped_chunks.upper_bound(offset));
+  size_t chunk_begin = chunk_itr->first;
+  size_t chunk_end = chunk_begin + chunk_itr->second.second;
+
+  // Coalesce with the next free extent
+  auto next_itr = free_extents.find(offset + size);
+  if (offset + size < chunk_end && next_itr != free_extents.end()) {
+    size += next_itr->second;
+    free_extents.erase(next_itr);
+  }
+
+  // Coalesce with the previous free extent
+  auto prev_itr = free_extents.lower_bound(offset);
+  if (offset > chunk_begin && prev_itr != free_extents.begin()) {
+    prev_itr--;
+    if (prev_itr->first + prev_itr->second == offset) {
+      prev_itr->second += size;
+      return true;
+    }
+  }
+
+  free_extents[offset] = size;
+  return true;
+}
+
+size_t DataFile::GetFileSize() {
+  std::lock_guard<std::mutex> lock(data_file_mutex);
+  return file_size;
+}
+
+size_t DataFile::GetFreeSize() {
+  std::lock_guard<std::mutex> lock(data_file_mutex);
+
+  size_t free_size = 0;
+  for (auto entry : free_extents) free_size += entry.second;
+  return free_size;
+}
+
+}  // End storage namespace
+}  // End peloton namespace
@@ -0,0 +1,109 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// data_file.h
+//
+// Identification: src/backend/storage/data_file.h
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <map>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "backend/common/types.h"
+
+// Size of each memory mapped chunk of a data file
+#define DATA_FILE_CHUNK_SIZE (64 * 1024 * 1024)
+
+namespace peloton {
+namespace storage {
+
+//===--------------------------------------------------------------------===//
+// Data File
+//===--------------------------------------------------------------------===//
+
+/**
+ * File that backs the data of a table.
+ *
+ * The file is memory mapped in large chunks, so the OS page cache decides
+ * which parts of the table stay in memory without one mapping per tile.
+ * Every allocation is a page-aligned extent carved out of a chunk.
+ * Released extents stay mapped and are reused by later allocations. The
+ * file only grows, by one chunk at a time, when no free extent is large
+ * enough.
+ */
+class DataFile {
+  DataFile() = delete;
+  DataFile(DataFile const &) = delete;
+
+ public:
+  // Open the file, creating it if needed
+  // the space of an existing file is reused for new extents
+  DataFile(const std::string &file_name);
+
+  // Unmap all the chunks and close the file
+  ~DataFile();
+
+  // Carve out an extent of at least the given size
+  // returns nullptr if the file cannot grow
+  void *AllocateExtent(size_t size);
+
+  // Make the extent at the given address reusable
+  // returns false if the address was not allocated from this file
+  bool ReleaseExtent(void *address);
+
+  //===--------------------------------------------------------------------===//
+  // Accessors
+  //===--------------------------------------------------------------------===//
+
+  const std::string &GetFileName() const { return file_name; }
+
+  // Get the size of the file
+  size_t GetFileSize();
+
+  // Get the total size of the extents waiting to be reused
+  size_t GetFreeSize();
+
+  // Round the size up to a multiple of the page size
+  static size_t GetExtentSize(size_t size);
+
+ private:
+  // Grow the file by a chunk that can hold the given size
+  // returns false if the file cannot grow
+  bool AddChunk(size_t size);
+
+  // Map the chunk at the given offset and make it free
+  bool MapChunk(size_t offset, size_t size);
+
+  //===--------------------------------------------------------------------===//
+  // MEMBERS
+  //===--------------------------------------------------------------------===//
+
+  std::string file_name;
+
+  int data_fd;
+
+  size_t file_size;
+
+  // mapped chunks : offset -> <address, size>
+  std::map<size_t, std::pair<char *, size_t>> mapped_chunks;
+
+  // free extents : offset -> size
+  // adjacent extents in the same chunk are coalesced
+  std::map<size_t, size_t> free_extents;
+
+  // allocated extents : address -> <offset, size>
+  std::unordered_map<char *, std::pair<size_t, size_t>> allocated_extents;
+
+  std::mutex data_file_mutex;
+};
+
+}  // End storage namespace
+}  // End peloton namespace
@@ -11,6 +11,7 @@
 //===----------------------------------------------------------------------===//
 
 #include <mutex>
+#include <unordered_set>
 #include <utility>
 
 #include "backend/brain/clusterer.h"
@@ -25,6 +26,7 @@
 #include "backend/storage/tile.h"
 #include "backend/storage/tile_group_header.h"
 #include "backend/storage/tile_group_factory.h"
+#include "backend/storage/zone_map.h"
 
 //===--------------------------------------------------------------------===//
 // Configuration Variables
@@ -155,11 +157,18 @@ ItemPointer DataTable::GetTupleSlot(const concurrency::Transaction *transaction,
   LOG_TRACE("DataTable :: transaction_id %lu \n", transaction_id);
 
   while (tuple_slot == INVALID_OID) {
-    // First, figure out last tile group
+    bool reuse_slot = false;
+
+    // First, figure out a tile group with reclaimed slots or the last one
     {
       std::lock_guard<std::mutex> lock(table_mutex);
       assert(GetTileGroupCount() > 0);
-      tile_group_offset = GetTileGroupCount() - 1;
+      if (free_slot_tile_groups.empty() == false) {
+        tile_group_offset = *free_slot_tile_groups.begin();
+        reuse_slot = true;
+      } else {
+        tile_group_offset = GetTileGroupCount() - 1;
+      }
       LOG_TRACE("Tile group offset :: %lu ", tile_group_offset);
     }
 
@@ -170,8 +179,14 @@ ItemPointer DataTable::GetTupleSlot(const concurrency::Transaction *transaction,
     tile_group_id = tile_group->GetTileGroupId();
 
     if (tuple_slot == INVALID_OID) {
-      // XXX Should we put this in a critical section?
-      AddDefaultTileGroup();
+      if (reuse_slot == true) {
+        // All the reclaimed slots are taken
+        std::lock_guard<std::mutex> lock(table_mutex);
+        free_slot_tile_groups.erase(tile_group_offset);
+      } else {
+        // XXX Should we put this in a critical section?
+        AddDefaultTileGroup();
+      }
     }
   }
 
@@ -184,12 +199,72 @@ ItemPointer DataTable::GetTupleSlot(const concurrency::Transaction *transaction,
   return location;
 }
 
+std::vector<ItemPointer> DataTable::GetTupleSlots(
+    const concurrency::Transaction *transaction,
+    const std::vector<const storage::Tuple *> &tuples) {
+  std::vector<ItemPointer> locations;
+
+  for (auto tuple : tuples) {
+    assert(tuple);
+    if (CheckConstraints(tuple) == false) return locations;
+  }
+
+  auto transaction_id = transaction->GetTransactionId();
+  oid_t tuple_count = tuples.size();
+  locations.reserve(tuple_count);
+
+  // Fill up the tile groups with reclaimed slots or the last one, and add
+  // new ones as needed
+  std::vector<oid_t> tuple_slots;
+  while (locations.size() < tuple_count) {
+    oid_t tile_group_offset = INVALID_OID;
+    bool reuse_slot = false;
+    {
+      std::lock_guard<std::mutex> lock(table_mutex);
+      assert(GetTileGroupCount() > 0);
+      if (free_slot_tile_groups.empty() == false) {
+        tile_group_offset = *free_slot_tile_groups.begin();
+        reuse_slot = true;
+      } else {
+        tile_group_offset = GetTileGroupCount() - 1;
+      }
+    }
+
+    auto tile_group = GetTileGroup(tile_group_offset);
+    oid_t tile_group_id = tile_group->GetTileGroupId();
+
+    tile_group->InsertTuples(transaction_id, tuples.data() + locations.size(),
+                             tuple_count - locations.size(), tuple_slots);
+
+    for (auto tuple_slot : tuple_slots) {
+      locations.push_back(ItemPointer(tile_group_id, tuple_slot));
+    }
+
+    if (locations.size() < tuple_count) {
+      if (reuse_slot == true) {
+        // All the reclaimed slots are taken
+        std::lock_guard<std::mutex> lock(table_mutex);
+        free_slot_tile_groups.erase(tile_group_offset);
+      } else {
+        AddDefaultTileGroup();
+      }
+    }
+  }
+
+  return locations;
+}
+
 //===--------------------------------------------------------------------===//
 // INSERT
 //===--------------------------------------------------------------------===//
 
 ItemPointer DataTable::InsertTuple(const concurrency::Transaction *transaction,
                                    const storage::Tuple *tuple) {
+  if (transaction->IsReadOnly()) {
+    LOG_WARN("Read-only transaction cannot insert.");
+    return INVALID_ITEMPOINTER;
+  }
+
   // First, do integrity checks and claim a slot
   ItemPointer location = GetTupleSlot(transaction, tuple);
   if (location.block == INVALID_OID) {
@@ -213,6 +288,48 @@ ItemPointer DataTable::InsertTuple(const concurrency::Transaction *transaction,
   return location;
 }
 
+/**
+ * @brief Insert a batch of tuples into the table.
+ *
+ * The slots are claimed a tile group at a time, and every index gets all of
+ * its entries in a single batch.
+ *
+ * @returns The locations of the tuples, or nothing if a tuple violates a
+ * constraint. As with InsertTuple, the slots claimed so far are then not
+ * recorded in the transaction, so they stay invisible and are not reused.
+ */
+std::vector<ItemPointer> DataTable::InsertTuples(
+    const concurrency::Transaction *transaction,
+    const std::vector<const storage::Tuple *> &tuples) {
+  std::vector<ItemPointer> locations;
+  if (tuples.empty()) return locations;
+
+  if (transaction->IsReadOnly()) {
+    LOG_WARN("Read-only transaction cannot insert.");
+    return locations;
+  }
+
+  // First, do integrity checks and claim the slots
+  locations = GetTupleSlots(transaction, tuples);
+  if (locations.size() != tuples.size()) {
+    LOG_WARN("Failed to get tuple slots.");
+    return std::vector<ItemPointer>();
+  }
+
+  // Index checks and updates
+  if (InsertInIndexes(transaction, tuples, locations) == false) {
+    LOG_WARN("Index constraint violated");
+    return std::vector<ItemPointer>();
+  }
+
+  // Increase the table's number of tuples
+  IncreaseNumberOfTuplesBy(tuples.size());
+  // Increase the indexes' number of tuples as well
+  for (auto index : indexes) index->IncreaseNumberOfTuplesBy(tuples.size());
+
+  return locations;
+}
+
 /**
  * @brief Insert a tuple into all indexes. If index is primary/unique,
  * check visibility of existing
@@ -270,6 +387,105 @@ bool DataTable::InsertInIndexes(const concurrency::Transaction *transaction,
   return true;
 }
 
+/**
+ * @brief Insert a batch of tuples into all indexes. If index is
+ * primary/unique, check visibility of existing index entries and
+ * duplicates within the batch.
+ *
+ * @returns True on success, false if a key is taken.
+ */
+bool DataTable::InsertInIndexes(
+    const concurrency::Transaction *transaction,
+    const std::vector<const storage::Tuple *> &tuples,
+    const std::vector<ItemPointer> &locations) {
+  int index_count = GetIndexCount();
+
+  // keys of every index, built once for the check and the insert
+  std::vector<std::vector<std::unique_ptr<storage::Tuple>>> index_keys(
+      index_count);
+
+  // (A) Check existence for primary/unique indexes
+  for (int index_itr = index_count - 1; index_itr >= 0; --index_itr) {
+    auto index = GetIndex(index_itr);
+    auto index_schema = index->GetKeySchema();
+    auto indexed_columns = index_schema->GetIndexedColumns();
+    auto &keys = index_keys[index_itr];
+
+    for (auto tuple : tuples) {
+      keys.emplace_back(new storage::Tuple(index_schema, true));
+      keys.back()->SetFromTuple(tuple, indexed_columns, index->GetPool());
+    }
+
+    switch (index->GetIndexType()) {
+      case INDEX_CONSTRAINT_TYPE_PRIMARY_KEY:
+      case INDEX_CONSTRAINT_TYPE_UNIQUE: {
+        std::unordered_set<storage::Tuple, storage::TupleHasher,
+                           storage::TupleComparator> batch_keys;
+
+        for (auto &key : keys) {
+          if (batch_keys.insert(*key).second == false) {
+            LOG_WARN("A key appears twice in the batch.");
+            return false;
+          }
+
+          auto locations = index->ScanKey(key.get());
+          auto exist_visible = ContainsVisibleEntry(locations, transaction);
+          if (exist_visible) {
+            LOG_WARN("A visible index entry exists.");
+            return false;
+          }
+        }
+      } break;
+
+      case INDEX_CONSTRAINT_TYPE_DEFAULT:
+      default:
+        break;
+    }
+    LOG_INFO("Index constraint check on %s passed.", index->GetName().c_str());
+  }
+
+  // (B) Insert into index
+  for (int index_itr = index_count - 1; index_itr >= 0; --index_itr) {
+    auto index = GetIndex(index_itr);
+
+    std::vector<storage::Tuple *> keys;
+    keys.reserve(tuples.size());
+    for (auto &key : index_keys[index_itr]) keys.push_back(key.get());
+
+    auto status = index->InsertEntries(keys, locations);
+    (void)status;
+    assert(status);
+  }
+
+  return true;
+}
+
+void DataTable::DeleteInIndexes(storage::TileGroup *tile_group,
+                                ItemPointer location) {
+  int index_count = GetIndexCount();
+
+  for (int index_itr = index_count - 1; index_itr >= 0; --index_itr) {
+    auto index = GetIndex(index_itr);
+    auto index_schema = index->GetKeySchema();
+    auto indexed_columns = index_schema->GetIndexedColumns();
+    std::unique_ptr<storage::Tuple> key(new storage::Tuple(index_schema, true));
+
+    // Build the key from the version stored in the tile group
+    for (oid_t key_column_itr = 0; key_column_itr < indexed_columns.size();
+         key_column_itr++) {
+      key->SetValue(key_column_itr,
+                    tile_group->GetValue(location.offset,
+                                         indexed_columns[key_column_itr]),
+                    index->GetPool());
+    }
+
+    // Only the entry pointing to this version is removed
+    if (index->DeleteEntry(key.get(), location) == true) {
+      index->DecreaseNumberOfTuplesBy(1);
+    }
+  }
+}
+
 //===--------------------------------------------------------------------===//
 // DELETE
 //===--------------------------------------------------------------------===//
@@ -277,7 +493,7 @@ bool DataTable::InsertInIndexes(const concurrency::Transaction *transaction,
 /**
  * @brief Try to delete a tuple from the table.
  * It may fail because the tuple has been latched or conflict with a future
- *delete.
+ *delete, or because the transaction is read-only.
  *
  * @param transaction_id  The current transaction Id.
  * @param location        ItemPointer of the tuple to delete.
@@ -286,6 +502,11 @@ bool DataTable::InsertInIndexes(const concurrency::Transaction *transaction,
  */
 bool DataTable::DeleteTuple(const concurrency::Transaction *transaction,
                             ItemPointer location) {
+  if (transaction->IsReadOnly()) {
+    LOG_WARN("Read-only transaction cannot delete.");
+    return false;
+  }
+
   oid_t tile_group_id = location.block;
   oid_t tuple_id = location.offset;
 
@@ -296,8 +517,9 @@ bool DataTable::DeleteTuple(const concurrency::Transaction *transaction,
   // Delete slot in underlying tile group
   auto status = tile_group->DeleteTuple(transaction_id, tuple_id, last_cid);
   if (status == false) {
-    LOG_WARN("Failed to delete tuple from the tile group : %lu , Txn_id : %lu ",
-             tile_group_id, transaction_id);
+    LOG_TRACE("Failed to delete tuple from the tile group : %lu , Txn_id : %lu ",
+              tile_group_id, transaction_id);
+    conflict_count++;
     return false;
   }
 
@@ -725,10 +947,12 @@ void SetTransformedTileGroup(storage::TileGroup *orig_tile_group,
     }
   }
 
-  // Finally, copy over the tile header
-  auto header = orig_tile_group->GetHeader();
-  auto new_header = new_tile_group->GetHeader();
-  *new_header = *header;
+  // The tile group header is shared with the original tile group, so
+  // only the zone map needs to be copied. It is indexed by table column
+  // and so is independent of the layout.
+  auto zone_map = orig_tile_group->GetZoneMap();
+  auto new_zone_map = new_tile_group->GetZoneMap();
+  *new_zone_map = *zone_map;
 }
 
 storage::TileGroup *DataTable::TransformTileGroup(oid_t tile_group_offset,
@@ -740,11 +964,21 @@ storage::TileGroup *DataTable::TransformTileGroup(oid_t tile_group_offset,
     return nullptr;
   }
 
-  auto tile_group_id = tile_groups[tile_group_offset];
+  oid_t tile_group_id = INVALID_OID;
+  {
+    std::lock_guard<std::mutex> lock(table_mutex);
+    tile_group_id = tile_groups[tile_group_offset];
+  }
 
   // Get orig tile group from catalog
   auto &catalog_manager = catalog::Manager::GetInstance();
   auto tile_group = catalog_manager.GetTileGroup(tile_group_id);
+
+  // The tuple slots of compressed tile groups cannot be copied
+  if (tile_group->IsCompressed() == true) return nullptr;
+
+  // The reorganizer may update the default partition meanwhile
+  auto default_partition = GetDefaultPartition();
   auto diff = tile_group->GetSchemaDifference(default_partition);
 
   // Check threshold for transformation
@@ -756,23 +990,208 @@ storage::TileGroup *DataTable::TransformTileGroup(oid_t tile_group_offset,
   auto new_schema =
       TransformTileGroupSchema(tile_group.get(), default_partition);
 
-  // Allocate space for the transformed tile group
+  // Allocate space for the transformed tile group.
+  // It shares the header of the orig tile group, so that MVCC updates made
+  // through either of them while the transformation is in progress (or by
+  // transactions still holding the orig tile group) are never lost.
+  // It stays on the NUMA node of the orig tile group.
   std::shared_ptr<storage::TileGroup> new_tile_group(
       TileGroupFactory::GetTileGroup(
           tile_group->GetDatabaseId(), tile_group->GetTableId(),
           tile_group->GetTileGroupId(), tile_group->GetAbstractTable(),
-          new_schema, default_partition, tile_group->GetAllocatedTupleCount()));
+          new_schema, default_partition, tile_group->GetAllocatedTupleCount(),
+          tile_group->GetHeaderReference(), tile_group->GetNumaNode()));
 
   // Set the transformed tile group column-at-a-time
   SetTransformedTileGroup(tile_group.get(), new_tile_group.get());
 
-  // Set the location of the new tile group
-  // and clean up the orig tile group
+  // Set the location of the new tile group.
+  // Concurrent scans holding a reference to the orig tile group continue
+  // to use it, and it is cleaned up when the last reference is dropped.
   catalog_manager.AddTileGroup(tile_group_id, new_tile_group);
 
   return new_tile_group.get();
 }
 
+// A tile group is cold once all its slots hold committed inserts.
+// Its tuple data does not change after that, as updates are out-of-place,
+// so it can be transformed while transactions are still running.
+// Slots reclaimed by the garbage collector are reset to an uncommitted
+// state, so a tile group with slots waiting to be reused is not cold.
+static bool IsColdTileGroup(storage::TileGroup *tile_group) {
+  auto header = tile_group->GetHeader();
+  oid_t tuple_count = tile_group->GetAllocatedTupleCount();
+
+  if (header->GetNextTupleSlot() < tuple_count) return false;
+
+  for (oid_t tuple_itr = 0; tuple_itr < tuple_count; tuple_itr++) {
+    // insert is still in progress or was aborted
+    if (header->GetBeginCommitId(tuple_itr) == MAX_CID) return false;
+  }
+
+  return true;
+}
+
+oid_t DataTable::ReorganizeTileGroups(double theta) {
+  if (adapt_table == false) return 0;
+
+  // Pick up the dominant partition from the recent samples
+  UpdateDefaultPartition();
+
+  // Nothing to adapt to till we see some samples
+  {
+    std::lock_guard<std::mutex> lock(clustering_mutex);
+    if (clustered_partition == false) return 0;
+  }
+
+  oid_t transformed_count = 0;
+  oid_t tile_group_count = GetTileGroupCount();
+  for (oid_t tile_group_itr = 0; tile_group_itr < tile_group_count;
+       tile_group_itr++) {
+    std::lock_guard<std::mutex> lock(maintenance_mutex);
+
+    auto tile_group = GetTileGroup(tile_group_itr);
+    if (IsColdTileGroup(tile_group.get()) == false) continue;
+
+    if (TransformTileGroup(tile_group_itr, theta) != nullptr) {
+      transformed_count++;
+    }
+  }
+
+  LOG_TRACE("Transformed %lu tile groups in table %lu", transformed_count,
+            table_oid);
+  return transformed_count;
+}
+
+storage::TileGroup *DataTable::CompressTileGroup(oid_t tile_group_offset) {
+  // First, check if the tile group is in this table
+  if (tile_group_offset >= tile_groups.size()) {
+    LOG_ERROR("Tile group offset not found in table : %lu ",
+              tile_group_offset);
+    return nullptr;
+  }
+
+  oid_t tile_group_id = INVALID_OID;
+  {
+    std::lock_guard<std::mutex> lock(table_mutex);
+    tile_group_id = tile_groups[tile_group_offset];
+  }
+
+  std::lock_guard<std::mutex> lock(maintenance_mutex);
+
+  auto &catalog_manager = catalog::Manager::GetInstance();
+  auto tile_group = catalog_manager.GetTileGroup(tile_group_id);
+
+  if (tile_group->IsCompressed() == true) return nullptr;
+
+  // Compressed tiles are kept in memory, so leave the tile groups
+  // on persistent storage alone
+  if (tile_group->GetHeader()->GetBackendType() != BACKEND_TYPE_MM) {
+    return nullptr;
+  }
+
+  if (IsColdTileGroup(tile_group.get()) == false) return nullptr;
+
+  // The compressed tile group shares the header of the orig tile group
+  std::shared_ptr<storage::TileGroup> compressed_tile_group(
+      TileGroupFactory::GetCompressedTileGroup(tile_group.get()));
+
+  // Set the location of the compressed tile group
+  catalog_manager.AddTileGroup(tile_group_id, compressed_tile_group);
+
+  return compressed_tile_group.get();
+}
+
+oid_t DataTable::CompressTileGroups() {
+  oid_t compressed_count = 0;
+  oid_t tile_group_count = GetTileGroupCount();
+  for (oid_t tile_group_itr = 0; tile_group_itr < tile_group_count;
+       tile_group_itr++) {
+    if (CompressTileGroup(tile_group_itr) != nullptr) {
+      compressed_count++;
+    }
+  }
+
+  LOG_TRACE("Compressed %lu tile groups in table %lu", compressed_count,
+            table_oid);
+  return compressed_count;
+}
+
+//===--------------------------------------------------------------------===//
+// GARBAGE COLLECTION
+//===--------------------------------------------------------------------===//
+
+oid_t DataTable::CollectGarbage(cid_t oldest_cid) {
+  oid_t reclaimed_count = 0;
+  oid_t tile_group_count = GetTileGroupCount();
+  for (oid_t tile_group_itr = 0; tile_group_itr < tile_group_count;
+       tile_group_itr++) {
+    reclaimed_count += CollectGarbageInTileGroup(tile_group_itr, oldest_cid);
+  }
+
+  LOG_TRACE("Reclaimed %lu tuple slots in table %lu", reclaimed_count,
+            table_oid);
+  return reclaimed_count;
+}
+
+oid_t DataTable::CollectGarbageInTileGroup(oid_t tile_group_offset,
+                                           cid_t oldest_cid) {
+  std::lock_guard<std::mutex> lock(maintenance_mutex);
+
+  auto tile_group = GetTileGroup(tile_group_offset);
+
+  // The tuples of compressed tile groups cannot be overwritten
+  if (tile_group->IsCompressed() == true) return 0;
+
+  auto header = tile_group->GetHeader();
+  oid_t tile_group_id = tile_group->GetTileGroupId();
+  oid_t active_tuple_count = header->GetNextTupleSlot();
+  std::vector<oid_t> reclaimed_slots;
+
+  for (oid_t tuple_itr = 0; tuple_itr < active_tuple_count; tuple_itr++) {
+    if (header->IsReclaimable(tuple_itr, oldest_cid) == false) continue;
+
+    // Remove the index entries before the slot can be reused
+    DeleteInIndexes(tile_group.get(), ItemPointer(tile_group_id, tuple_itr));
+
+    // The pools keep track of the garbage in them
+    for (oid_t tile_itr = 0; tile_itr < tile_group->GetTileCount();
+         tile_itr++) {
+      tile_group->GetTile(tile_itr)->FreeUninlinedData(tuple_itr);
+    }
+
+    header->ResetTupleSlot(tuple_itr);
+    reclaimed_slots.push_back(tuple_itr);
+  }
+
+  bool has_free_slots = false;
+  if (reclaimed_slots.empty() == false) {
+    // Start over if no tuple in the tile group is in use anymore
+    if (header->FreeTupleSlots(reclaimed_slots) == true) {
+      // The tiles with only inlined columns have no pool
+      for (oid_t tile_itr = 0; tile_itr < tile_group->GetTileCount();
+           tile_itr++) {
+        auto tile_pool = tile_group->GetTilePool(tile_itr);
+        if (tile_pool != nullptr) tile_pool->Purge();
+      }
+      tile_group->GetZoneMap()->ResetZoneMap();
+
+      header->ResetTupleSlots();
+      has_free_slots = true;
+    }
+  }
+
+  if (header->GetFreeTupleSlotCount() > 0) has_free_slots = true;
+
+  // Let the inserts find the reclaimed slots
+  if (has_free_slots == true) {
+    std::lock_guard<std::mutex> lock(table_mutex);
+    free_slot_tile_groups.insert(tile_group_offset);
+  }
+
+  return reclaimed_slots.size();
+}
+
 void DataTable::RecordSample(const brain::Sample &sample) {
   // Add sample
   {
@@ -781,7 +1200,8 @@ void DataTable::RecordSample(const brain::Sample &sample) {
   }
 }
 
-const column_map_type &DataTable::GetDefaultPartition() {
+column_map_type DataTable::GetDefaultPartition() {
+  std::lock_guard<std::mutex> lock(clustering_mutex);
   return default_partition;
 }
 
@@ -789,7 +1209,7 @@ std::map<oid_t, oid_t> DataTable::GetColumnMapStats() {
   std::map<oid_t, oid_t> column_map_stats;
 
   // Cluster per-tile column count
-  for (auto entry : default_partition) {
+  for (auto entry : GetDefaultPartition()) {
     auto tile_id = entry.second.first;
     auto column_map_itr = column_map_stats.find(tile_id);
     if (column_map_itr == column_map_stats.end())
@@ -825,7 +1245,13 @@ void DataTable::UpdateDefaultPartition() {
   }
 
   // TODO: Max number of tiles
-  default_partition = clusterer.GetPartitioning(2);
+  auto partition = clusterer.GetPartitioning(2);
+
+  {
+    std::lock_guard<std::mutex> lock(clustering_mutex);
+    default_partition = partition;
+    clustered_partition = true;
+  }
 }
 
 //===--------------------------------------------------------------------===//
@@ -13,6 +13,7 @@
 #pragma once
 
 #include <memory>
+#include <set>
 
 #include "backend/brain/sample.h"
 #include "backend/bridge/ddl/bridge.h"
@@ -98,6 +99,13 @@ class DataTable : public AbstractTable {
   ItemPointer InsertTuple(const concurrency::Transaction *transaction,
                           const Tuple *tuple);
 
+  // insert a batch of tuples in table
+  // returns the locations of the tuples, or nothing if any of them violates
+  // a constraint
+  std::vector<ItemPointer> InsertTuples(
+      const concurrency::Transaction *transaction,
+      const std::vector<const Tuple *> &tuples);
+
   // delete the tuple at given location
   bool DeleteTuple(const concurrency::Transaction *transaction,
                    ItemPointer location);
@@ -157,6 +165,25 @@ class DataTable : public AbstractTable {
 
   storage::TileGroup *TransformTileGroup(oid_t tile_group_offset, double theta);
 
+  // transform the cold tile groups to the default partition
+  // returns the number of transformed tile groups
+  oid_t ReorganizeTileGroups(double theta);
+
+  // compress the tile group if it is cold
+  storage::TileGroup *CompressTileGroup(oid_t tile_group_offset);
+
+  // compress the cold tile groups
+  // returns the number of compressed tile groups
+  oid_t CompressTileGroups();
+
+  //===--------------------------------------------------------------------===//
+  // GARBAGE COLLECTION
+  //===--------------------------------------------------------------------===//
+
+  // reclaim the slots of the versions invalidated at or before the given cid
+  // returns the number of reclaimed slots
+  oid_t CollectGarbage(cid_t oldest_cid);
+
   //===--------------------------------------------------------------------===//
   // STATS
   //===--------------------------------------------------------------------===//
@@ -169,11 +196,15 @@ class DataTable : public AbstractTable {
 
   float GetNumberOfTuples() const;
 
+  // number of deletes and updates that lost a write-write conflict
+  size_t GetConflictCount() const { return conflict_count; }
+
   bool IsDirty() const;
 
   void ResetDirty();
 
-  const column_map_type &GetDefaultPartition();
+  // Get a copy of the default partition, it changes as samples come in
+  column_map_type GetDefaultPartition();
 
   //===--------------------------------------------------------------------===//
   // Clustering
@@ -193,6 +224,8 @@ class DataTable : public AbstractTable {
 
   bool HasForeignKeys() { return (GetForeignKeyCount() > 0); }
 
+  bool IsAdaptTable() const { return adapt_table; }
+
   column_map_type GetStaticColumnMap(std::string table_name,
                                      oid_t column_count);
 
@@ -214,6 +247,11 @@ class DataTable : public AbstractTable {
   ItemPointer GetTupleSlot(const concurrency::Transaction *transaction,
                            const storage::Tuple *tuple);
 
+  // Claim consecutive tuple slots for a batch of tuples
+  std::vector<ItemPointer> GetTupleSlots(
+      const concurrency::Transaction *transaction,
+      const std::vector<const storage::Tuple *> &tuples);
+
   // add a default unpartitioned tile group to table
   oid_t AddDefaultTileGroup();
 
@@ -228,9 +266,23 @@ class DataTable : public AbstractTable {
   bool InsertInIndexes(const concurrency::Transaction *transaction,
                        const storage::Tuple *tuple, ItemPointer location);
 
+  // try to insert a batch of tuples into the indices
+  bool InsertInIndexes(const concurrency::Transaction *transaction,
+                       const std::vector<const storage::Tuple *> &tuples,
+                       const std::vector<ItemPointer> &locations);
+
   /** @return True if it's a same-key update and it's successful */
   bool UpdateInIndexes(const storage::Tuple *tuple, ItemPointer location);
 
+  // remove the entries of the tuple at the given location from the indices
+  void DeleteInIndexes(storage::TileGroup *tile_group, ItemPointer location);
+
+  //===--------------------------------------------------------------------===//
+  // GARBAGE COLLECTION HELPERS
+  //===--------------------------------------------------------------------===//
+
+  oid_t CollectGarbageInTileGroup(oid_t tile_group_offset, cid_t oldest_cid);
+
  private:
   //===--------------------------------------------------------------------===//
   // MEMBERS
@@ -252,6 +304,14 @@ class DataTable : public AbstractTable {
   // table mutex
   std::mutex table_mutex;
 
+  // offsets of the tile groups with reclaimed slots to reuse
+  // sync access with table_mutex
+  std::set<oid_t> free_slot_tile_groups;
+
+  // serializes garbage collection with the transformations of cold
+  // tile groups, as those must not see reclaimed slots being reused
+  std::mutex maintenance_mutex;
+
   // has a primary key ?
   std::atomic<bool> has_primary_key = ATOMIC_VAR_INIT(false);
 
@@ -264,6 +324,9 @@ class DataTable : public AbstractTable {
   // dirty flag
   bool dirty = false;
 
+  // write-write conflicts
+  std::atomic<size_t> conflict_count = ATOMIC_VAR_INIT(0);
+
   // clustering mutex
   std::mutex clustering_mutex;
 
@@ -273,6 +336,9 @@ class DataTable : public AbstractTable {
   // default partition map for table
   column_map_type default_partition;
 
+  // is the default partition derived from the samples ?
+  bool clustered_partition = false;
+
   // samples for clustering
   std::vector<brain::Sample> samples;
 };
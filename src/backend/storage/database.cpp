@@ -14,6 +14,10 @@
 
 #include "postmaster/peloton.h"
 #include "backend/storage/database.h"
+#include "backend/brain/reorganizer.h"
+#include "backend/concurrency/transaction_manager.h"
+#include "backend/storage/freezer.h"
+#include "backend/storage/garbage_collector.h"
 #include "backend/storage/table_factory.h"
 #include "backend/common/logger.h"
 #include "backend/index/index.h"
@@ -21,7 +25,14 @@
 namespace peloton {
 namespace storage {
 
+Database::Database(oid_t database_oid) : database_oid(database_oid) {}
+
 Database::~Database() {
+  // Stop the background threads before the tables go away
+  StopReorganizer();
+  StopFreezer();
+  StopGarbageCollector();
+
   // Clean up all the tables
   for (auto table : tables) delete table;
 }
@@ -114,6 +125,111 @@ void Database::UpdateStatsWithOid(const oid_t table_oid) const {
   }
 }
 
+//===--------------------------------------------------------------------===//
+// LAYOUT REORGANIZATION
+//===--------------------------------------------------------------------===//
+
+oid_t Database::ReorganizeTables(double theta) {
+  oid_t transformed_count = 0;
+
+  // Hold the lock so that tables are not dropped underneath us
+  {
+    std::lock_guard<std::mutex> lock(database_mutex);
+
+    for (auto table : tables) {
+      if (table->IsAdaptTable() == false) continue;
+      transformed_count += table->ReorganizeTileGroups(theta);
+    }
+  }
+
+  return transformed_count;
+}
+
+void Database::StartReorganizer() {
+  if (reorganizer == nullptr) {
+    reorganizer.reset(new brain::Reorganizer(this));
+  }
+
+  reorganizer->Start();
+}
+
+void Database::StopReorganizer() {
+  if (reorganizer != nullptr) {
+    reorganizer->Stop();
+  }
+}
+
+//===--------------------------------------------------------------------===//
+// COMPRESSION
+//===--------------------------------------------------------------------===//
+
+oid_t Database::CompressTables() {
+  oid_t compressed_count = 0;
+
+  // Hold the lock so that tables are not dropped underneath us
+  {
+    std::lock_guard<std::mutex> lock(database_mutex);
+
+    for (auto table : tables) {
+      compressed_count += table->CompressTileGroups();
+    }
+  }
+
+  return compressed_count;
+}
+
+void Database::StartFreezer() {
+  if (freezer == nullptr) {
+    freezer.reset(new Freezer(this));
+  }
+
+  freezer->Start();
+}
+
+void Database::StopFreezer() {
+  if (freezer != nullptr) {
+    freezer->Stop();
+  }
+}
+
+//===--------------------------------------------------------------------===//
+// GARBAGE COLLECTION
+//===--------------------------------------------------------------------===//
+
+oid_t Database::CollectGarbage() {
+  oid_t reclaimed_count = 0;
+
+  // Versions invalidated at or before the oldest active snapshot
+  // are not visible to any transaction
+  auto &txn_manager = concurrency::TransactionManager::GetInstance();
+  cid_t oldest_cid = txn_manager.GetOldestActiveCid();
+
+  // Hold the lock so that tables are not dropped underneath us
+  {
+    std::lock_guard<std::mutex> lock(database_mutex);
+
+    for (auto table : tables) {
+      reclaimed_count += table->CollectGarbage(oldest_cid);
+    }
+  }
+
+  return reclaimed_count;
+}
+
+void Database::StartGarbageCollector() {
+  if (garbage_collector == nullptr) {
+    garbage_collector.reset(new GarbageCollector(this));
+  }
+
+  garbage_collector->Start();
+}
+
+void Database::StopGarbageCollector() {
+  if (garbage_collector != nullptr) {
+    garbage_collector->Stop();
+  }
+}
+
 //===--------------------------------------------------------------------===//
 // UTILITIES
 //===--------------------------------------------------------------------===//
@@ -13,6 +13,7 @@
 #pragma once
 
 #include <iostream>
+#include <memory>
 
 #include "backend/common/printable.h"
 #include "backend/storage/data_table.h"
@@ -22,8 +23,16 @@ struct dirty_table_info;
 struct dirty_index_info;
 
 namespace peloton {
+
+namespace brain {
+class Reorganizer;
+}
+
 namespace storage {
 
+class Freezer;
+class GarbageCollector;
+
 //===--------------------------------------------------------------------===//
 // DATABASE
 //===--------------------------------------------------------------------===//
@@ -32,7 +41,7 @@ class Database : public Printable {
  public:
   Database(Database const &) = delete;
 
-  Database(oid_t database_oid) : database_oid(database_oid) {}
+  Database(oid_t database_oid);
 
   ~Database();
 
@@ -66,6 +75,48 @@ class Database : public Printable {
 
   void UpdateStatsWithOid(const oid_t table_oid) const;
 
+  //===--------------------------------------------------------------------===//
+  // LAYOUT REORGANIZATION
+  //===--------------------------------------------------------------------===//
+
+  // transform the cold tile groups in all the tables
+  // returns the number of transformed tile groups
+  oid_t ReorganizeTables(double theta);
+
+  // start the background reorganizer
+  void StartReorganizer();
+
+  // stop the background reorganizer
+  void StopReorganizer();
+
+  //===--------------------------------------------------------------------===//
+  // COMPRESSION
+  //===--------------------------------------------------------------------===//
+
+  // compress the cold tile groups in all the tables
+  // returns the number of compressed tile groups
+  oid_t CompressTables();
+
+  // start the background freezer
+  void StartFreezer();
+
+  // stop the background freezer
+  void StopFreezer();
+
+  //===--------------------------------------------------------------------===//
+  // GARBAGE COLLECTION
+  //===--------------------------------------------------------------------===//
+
+  // reclaim the obsolete tuple versions in all the tables
+  // returns the number of reclaimed tuple slots
+  oid_t CollectGarbage();
+
+  // start the background garbage collector
+  void StartGarbageCollector();
+
+  // stop the background garbage collector
+  void StopGarbageCollector();
+
   //===--------------------------------------------------------------------===//
   // UTILITIES
   //===--------------------------------------------------------------------===//
@@ -85,6 +136,15 @@ class Database : public Printable {
   std::vector<storage::DataTable *> tables;
 
   std::mutex database_mutex;
+
+  // background layout reorganizer
+  std::unique_ptr<brain::Reorganizer> reorganizer;
+
+  // background compression of cold tile groups
+  std::unique_ptr<Freezer> freezer;
+
+  // background reclamation of obsolete tuple versions
+  std::unique_ptr<GarbageCollector> garbage_collector;
 };
 
 }  // End storage namespace
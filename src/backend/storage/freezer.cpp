@@ -0,0 +1,29 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// freezer.cpp
+//
+// Identification: src/backend/storage/freezer.cpp
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "backend/storage/freezer.h"
+#include "backend/storage/database.h"
+
+namespace peloton {
+namespace storage {
+
+Freezer::Freezer(Database *database, std::chrono::milliseconds interval)
+    : database(database),
+      worker("Freezer for database " + std::to_string(database->GetOid()),
+             interval, [this] { Freeze(); }) {}
+
+Freezer::~Freezer() { Stop(); }
+
+oid_t Freezer::Freeze() { return database->CompressTables(); }
+
+}  // End storage namespace
+}  // End peloton namespace
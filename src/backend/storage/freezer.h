@@ -0,0 +1,73 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// freezer.h
+//
+// Identification: src/backend/storage/freezer.h
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <chrono>
+
+#include "backend/common/background_worker.h"
+#include "backend/common/types.h"
+
+namespace peloton {
+namespace storage {
+
+class Database;
+
+// Time between two freezing passes
+#define FREEZER_INTERVAL_MS 5000
+
+//===--------------------------------------------------------------------===//
+// Freezer
+//===--------------------------------------------------------------------===//
+
+/**
+ * Background thread that compresses the cold tile groups in a database.
+ *
+ * Compressed tile groups are swapped in via the catalog locator, so
+ * concurrent scans are never blocked.
+ */
+class Freezer {
+  Freezer(Freezer const &) = delete;
+
+ public:
+  Freezer(Database *database,
+          std::chrono::milliseconds interval =
+              std::chrono::milliseconds(FREEZER_INTERVAL_MS));
+
+  ~Freezer();
+
+  // start the background thread
+  void Start() { worker.Start(); }
+
+  // stop the background thread and wait for it to finish
+  void Stop() { worker.Stop(); }
+
+  bool IsRunning() const { return worker.IsRunning(); }
+
+  // do a single pass over the database
+  // returns the number of compressed tile groups
+  oid_t Freeze();
+
+ private:
+  //===--------------------------------------------------------------------===//
+  // MEMBERS
+  //===--------------------------------------------------------------------===//
+
+  // database being compressed
+  Database *database;
+
+  // background thread
+  BackgroundWorker worker;
+};
+
+}  // End storage namespace
+}  // End peloton namespace
@@ -0,0 +1,31 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// garbage_collector.cpp
+//
+// Identification: src/backend/storage/garbage_collector.cpp
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "backend/storage/garbage_collector.h"
+#include "backend/storage/database.h"
+
+namespace peloton {
+namespace storage {
+
+GarbageCollector::GarbageCollector(Database *database,
+                                   std::chrono::milliseconds interval)
+    : database(database),
+      worker("Garbage collector for database " +
+                 std::to_string(database->GetOid()),
+             interval, [this] { Collect(); }) {}
+
+GarbageCollector::~GarbageCollector() { Stop(); }
+
+oid_t GarbageCollector::Collect() { return database->CollectGarbage(); }
+
+}  // End storage namespace
+}  // End peloton namespace
@@ -0,0 +1,75 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// garbage_collector.h
+//
+// Identification: src/backend/storage/garbage_collector.h
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <chrono>
+
+#include "backend/common/background_worker.h"
+#include "backend/common/types.h"
+
+namespace peloton {
+namespace storage {
+
+class Database;
+
+// Time between two garbage collection passes
+#define GC_INTERVAL_MS 1000
+
+//===--------------------------------------------------------------------===//
+// GarbageCollector
+//===--------------------------------------------------------------------===//
+
+/**
+ * Background thread that reclaims obsolete tuple versions in a database.
+ *
+ * Every pass picks the oldest snapshot still in use by an active
+ * transaction. The slots of the versions whose delete committed at or
+ * before it are removed from the indices and handed out again to inserts.
+ * Tile groups with no tuples in use anymore start over from scratch.
+ */
+class GarbageCollector {
+  GarbageCollector(GarbageCollector const &) = delete;
+
+ public:
+  GarbageCollector(Database *database,
+                   std::chrono::milliseconds interval =
+                       std::chrono::milliseconds(GC_INTERVAL_MS));
+
+  ~GarbageCollector();
+
+  // start the background thread
+  void Start() { worker.Start(); }
+
+  // stop the background thread and wait for it to finish
+  void Stop() { worker.Stop(); }
+
+  bool IsRunning() const { return worker.IsRunning(); }
+
+  // do a single pass over the database
+  // returns the number of reclaimed tuple slots
+  oid_t Collect();
+
+ private:
+  //===--------------------------------------------------------------------===//
+  // MEMBERS
+  //===--------------------------------------------------------------------===//
+
+  // database being cleaned up
+  Database *database;
+
+  // background thread
+  BackgroundWorker worker;
+};
+
+}  // End storage namespace
+}  // End peloton namespace
@@ -10,9 +10,12 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include "backend/common/huge_page_allocator.h"
 #include "backend/common/logger.h"
 #include "backend/storage/storage_manager.h"
+#include "backend/storage/data_file.h"
 
+#include <sys/mman.h>
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <fcntl.h>
@@ -32,6 +35,9 @@
 
 extern LoggingType peloton_logging_mode;
 
+// Directory for peloton data files
+extern char *peloton_data_directory;
+
 // PMEM file size
 size_t peloton_data_file_size = 0;
 
@@ -41,6 +47,9 @@ namespace storage {
 #define DATA_FILE_LEN 1024 * 1024 * UINT64_C(512)  // 512 MB
 #define DATA_FILE_NAME "peloton.pmem"
 
+// Data file for file backed data that does not belong to a table
+#define SHARED_DATA_FILE_NAME "peloton.data"
+
 // global singleton
 StorageManager &StorageManager::GetInstance(void) {
   static StorageManager storage_manager;
@@ -48,10 +57,19 @@ StorageManager &StorageManager::GetInstance(void) {
 }
 
 StorageManager::StorageManager()
-    : data_file_address(nullptr),
+    : data_directory(TMP_DIR),
+      has_data_directory(false),
+      data_file_address(nullptr),
       is_pmem(false),
       data_file_len(0),
       data_file_offset(0) {
+  // Check if the user specified a data directory
+  if (peloton_data_directory != nullptr &&
+      strlen(peloton_data_directory) > 0) {
+    data_directory = std::string(peloton_data_directory);
+    has_data_directory = true;
+  }
+
   // Check if we need a data pool
   if (IsSimilarToARIES(peloton_logging_mode) == true ||
       peloton_logging_mode == LOGGING_TYPE_INVALID) {
@@ -78,7 +96,7 @@ StorageManager::StorageManager()
     case LOGGING_TYPE_NVM_SSD: {
       int status = stat(NVM_DIR, &data_stat);
       if (status == 0 && S_ISDIR(data_stat.st_mode)) {
-        data_file_name = std::string(NVM_DIR) + std::string(DATA_FILE_NAME);
+        data_directory = std::string(NVM_DIR);
         found_file_system = true;
       }
 
@@ -89,7 +107,7 @@ StorageManager::StorageManager()
     case LOGGING_TYPE_HDD_HDD: {
       int status = stat(HDD_DIR, &data_stat);
       if (status == 0 && S_ISDIR(data_stat.st_mode)) {
-        data_file_name = std::string(HDD_DIR) + std::string(DATA_FILE_NAME);
+        data_directory = std::string(HDD_DIR);
         found_file_system = true;
       }
 
@@ -100,7 +118,7 @@ StorageManager::StorageManager()
     case LOGGING_TYPE_SSD_SSD: {
       int status = stat(SSD_DIR, &data_stat);
       if (status == 0 && S_ISDIR(data_stat.st_mode)) {
-        data_file_name = std::string(SSD_DIR) + std::string(DATA_FILE_NAME);
+        data_directory = std::string(SSD_DIR);
         found_file_system = true;
       }
 
@@ -112,9 +130,16 @@ StorageManager::StorageManager()
 
   // Fallback to tmp if needed
   if (found_file_system == false) {
-    data_file_name = std::string(TMP_DIR) + std::string(DATA_FILE_NAME);
+    data_directory = std::string(TMP_DIR);
+  }
+
+  // The user specified data directory takes precedence
+  if (has_data_directory == true) {
+    data_directory = std::string(peloton_data_directory);
   }
 
+  data_file_name = GetDataDirectory() + std::string(DATA_FILE_NAME);
+
   LOG_INFO("DATA DIR :: %s ", data_file_name.c_str());
 
   // Create a data file
@@ -152,14 +177,16 @@ StorageManager::~StorageManager() {
   pmem_unmap(data_file_address, data_file_len);
 }
 
-void *StorageManager::Allocate(BackendType type, size_t size) {
+void *StorageManager::Allocate(BackendType type, size_t size,
+                               oid_t table_id) {
   switch (type) {
     case BACKEND_TYPE_MM: {
-      return ::operator new(size);
+      return HugePageAllocator::GetInstance().Allocate(size);
     } break;
 
     case BACKEND_TYPE_FILE: {
-      {
+      // Use the pmem file for data that does not belong to a table
+      if (table_id == INVALID_OID && data_file_address != nullptr) {
         std::lock_guard<std::mutex> pmem_lock(pmem_mutex);
 
         if (data_file_offset >= data_file_len) return nullptr;
@@ -169,6 +196,14 @@ void *StorageManager::Allocate(BackendType type, size_t size) {
         data_file_offset += size;
         return address;
       }
+
+      // Map an extent of the data file
+      void *address = GetDataFile(table_id)->AllocateExtent(size);
+      if (address != nullptr) {
+        std::lock_guard<std::mutex> data_files_lock(data_files_mutex);
+        extent_owners[address] = table_id;
+      }
+      return address;
     } break;
 
     case BACKEND_TYPE_INVALID:
@@ -179,11 +214,25 @@ void *StorageManager::Allocate(BackendType type, size_t size) {
 void StorageManager::Release(BackendType type, void *address) {
   switch (type) {
     case BACKEND_TYPE_MM: {
-      ::operator delete(address);
+      HugePageAllocator::GetInstance().Release(address);
     } break;
 
     case BACKEND_TYPE_FILE: {
-      // Nothing to do here
+      // Nothing to do for the pmem file
+      if (IsInPmemFile(address)) break;
+
+      oid_t table_id = INVALID_OID;
+      {
+        std::lock_guard<std::mutex> data_files_lock(data_files_mutex);
+        auto owner_itr = extent_owners.find(address);
+        if (owner_itr == extent_owners.end()) break;
+
+        table_id = owner_itr->second;
+        extent_owners.erase(owner_itr);
+      }
+
+      // Make the extent reusable
+      GetDataFile(table_id)->ReleaseExtent(address);
     } break;
 
     case BACKEND_TYPE_INVALID:
@@ -202,7 +251,7 @@ void StorageManager::Sync(BackendType type, void *address, size_t length) {
 
     case BACKEND_TYPE_FILE: {
       // flush writes for persistence
-      if (is_pmem)
+      if (is_pmem && IsInPmemFile(address))
         pmem_persist(address, length);
       else
         pmem_msync(address, length);
@@ -215,5 +264,71 @@ void StorageManager::Sync(BackendType type, void *address, size_t length) {
   }
 }
 
+void StorageManager::AdviseSequential(BackendType type, void *address,
+                                      size_t length) {
+  // Only mapped files are read from disk
+  if (type != BACKEND_TYPE_FILE || address == nullptr) return;
+
+  // madvise needs a page-aligned address
+  static const uintptr_t page_size = sysconf(_SC_PAGESIZE);
+  uintptr_t start = reinterpret_cast<uintptr_t>(address);
+  uintptr_t aligned_start = start & ~(page_size - 1);
+  length += start - aligned_start;
+
+  // Read ahead aggressively and drop the pages soon after they are read
+  void *aligned_address = reinterpret_cast<void *>(aligned_start);
+  madvise(aligned_address, length, MADV_SEQUENTIAL);
+  madvise(aligned_address, length, MADV_WILLNEED);
+}
+
+//===--------------------------------------------------------------------===//
+// Data files
+//===--------------------------------------------------------------------===//
+
+void StorageManager::SetDataDirectory(const std::string &directory) {
+  std::lock_guard<std::mutex> data_files_lock(data_files_mutex);
+  data_directory = directory;
+  has_data_directory = true;
+}
+
+std::string StorageManager::GetDataDirectory() {
+  std::lock_guard<std::mutex> data_files_lock(data_files_mutex);
+
+  if (data_directory.empty() || data_directory.back() == '/') {
+    return data_directory;
+  }
+  return data_directory + "/";
+}
+
+bool StorageManager::HasDataDirectory() {
+  std::lock_guard<std::mutex> data_files_lock(data_files_mutex);
+  return has_data_directory;
+}
+
+DataFile *StorageManager::GetDataFile(oid_t table_id) {
+  std::string file_name = GetDataDirectory();
+  if (table_id == INVALID_OID) {
+    file_name += SHARED_DATA_FILE_NAME;
+  } else {
+    file_name += "table_" + std::to_string(table_id) + ".data";
+  }
+
+  std::lock_guard<std::mutex> data_files_lock(data_files_mutex);
+
+  auto &data_file = data_files[table_id];
+  if (data_file == nullptr) {
+    LOG_INFO("DATA FILE :: %s ", file_name.c_str());
+    data_file.reset(new DataFile(file_name));
+  }
+
+  return data_file.get();
+}
+
+bool StorageManager::IsInPmemFile(void *address) const {
+  char *location = reinterpret_cast<char *>(address);
+  return data_file_address != nullptr && location >= data_file_address &&
+         location < data_file_address + data_file_len;
+}
+
 }  // End storage namespace
 }  // End peloton namespace
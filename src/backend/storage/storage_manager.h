@@ -11,13 +11,19 @@
 //===----------------------------------------------------------------------===//
 #pragma once
 
+#include <map>
+#include <memory>
 #include <mutex>
+#include <string>
+#include <unordered_map>
 
 #include "backend/common/types.h"
 
 namespace peloton {
 namespace storage {
 
+class DataFile;
+
 //===--------------------------------------------------------------------===//
 // Filesystem directories
 //===--------------------------------------------------------------------===//
@@ -32,7 +38,16 @@ namespace storage {
 // Storage Manager
 //===--------------------------------------------------------------------===//
 
-/// Stores data on different backends
+/**
+ * Stores data on different backends
+ *
+ * File backed data of a table is stored in its own data file in the data
+ * directory, as page-aligned memory mapped extents. Other file backed data
+ * goes to the pmem file when running with peloton logging, or else to a
+ * shared data file in the data directory.
+ *
+ * In-memory data is backed by huge pages when peloton_huge_pages is set.
+ */
 class StorageManager {
  public:
   // global singleton
@@ -41,13 +56,52 @@ class StorageManager {
   StorageManager();
   ~StorageManager();
 
-  void *Allocate(BackendType type, size_t size);
+  void *Allocate(BackendType type, size_t size,
+                 oid_t table_id = INVALID_OID);
 
   void Release(BackendType type, void *address);
 
   void Sync(BackendType type, void *address, size_t length);
 
+  // Hint that the data is going to be read sequentially soon
+  void AdviseSequential(BackendType type, void *address, size_t length);
+
+  //===--------------------------------------------------------------------===//
+  // Data files
+  //===--------------------------------------------------------------------===//
+
+  // Set the directory of the data files.
+  // Only affects data files that are not created yet.
+  void SetDataDirectory(const std::string &directory);
+
+  std::string GetDataDirectory();
+
+  // Is a data directory configured by the user ?
+  // If so, tile groups are file backed even without peloton logging.
+  bool HasDataDirectory();
+
+  // Get the data file of the given table
+  DataFile *GetDataFile(oid_t table_id);
+
  private:
+  // Is the address in the pmem file ?
+  bool IsInPmemFile(void *address) const;
+
+  // data directory
+  std::string data_directory;
+
+  // was the data directory configured by the user ?
+  bool has_data_directory;
+
+  // table id -> data file
+  std::map<oid_t, std::unique_ptr<DataFile>> data_files;
+
+  // extent address -> table id of its data file
+  std::unordered_map<void *, oid_t> extent_owners;
+
+  // data files synch mutex
+  std::mutex data_files_mutex;
+
   // pmem file address
   char *data_file_address;
 
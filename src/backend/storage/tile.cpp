@@ -16,9 +16,13 @@
 
 #include "backend/catalog/schema.h"
 #include "backend/common/exception.h"
+#include "backend/common/numa_manager.h"
 #include "backend/common/pool.h"
 #include "backend/common/serializer.h"
 #include "backend/common/types.h"
+#include "backend/common/varlen.h"
+#include "backend/storage/abstract_table.h"
+#include "backend/storage/tile_group.h"
 #include "backend/storage/tuple_iterator.h"
 #include "backend/storage/tuple.h"
 #include "backend/storage/storage_manager.h"
@@ -31,6 +35,12 @@ namespace storage {
 Tile::Tile(BackendType backend_type, TileGroupHeader *tile_header,
            const catalog::Schema &tuple_schema, TileGroup *tile_group,
            int tuple_count)
+    : Tile(backend_type, tile_header, tuple_schema, tile_group, tuple_count,
+           true) {}
+
+Tile::Tile(BackendType backend_type, TileGroupHeader *tile_header,
+           const catalog::Schema &tuple_schema, TileGroup *tile_group,
+           int tuple_count, bool allocate_data)
     : database_id(INVALID_OID),
       table_id(INVALID_OID),
       tile_group_id(INVALID_OID),
@@ -52,13 +62,7 @@ Tile::Tile(BackendType backend_type, TileGroupHeader *tile_header,
   tile_size = tuple_count * tuple_length;
 
   // allocate tuple storage space for inlined data
-  auto &storage_manager = storage::StorageManager::GetInstance();
-  data = reinterpret_cast<char *>(
-      storage_manager.Allocate(backend_type, tile_size));
-  assert(data != NULL);
-
-  // zero out the data
-  std::memset(data, 0, tile_size);
+  if (allocate_data == true) AllocateData();
 
   // allocate pool for blob storage if schema not inlined
   if (schema.IsInlined() == false) pool = new VarlenPool(backend_type);
@@ -66,9 +70,7 @@ Tile::Tile(BackendType backend_type, TileGroupHeader *tile_header,
 
 Tile::~Tile() {
   // reclaim the tile memory (INLINED data)
-  auto &storage_manager = storage::StorageManager::GetInstance();
-  storage_manager.Release(backend_type, data);
-  data = NULL;
+  ReleaseData();
 
   // reclaim the tile memory (UNINLINED data)
   if (schema.IsInlined() == false) delete pool;
@@ -168,6 +170,26 @@ void Tile::SetValueFast(const Value &value, const oid_t tuple_offset,
       field_location, is_inlined, column_length, is_in_bytes, pool);
 }
 
+void Tile::FreeUninlinedData(const oid_t tuple_offset) {
+  assert(tuple_offset < num_tuple_slots);
+  if (pool == NULL) return;
+
+  char *tuple_location = GetTupleLocation(tuple_offset);
+  oid_t uninlined_column_count = schema.GetUninlinedColumnCount();
+  for (oid_t column_itr = 0; column_itr < uninlined_column_count;
+       column_itr++) {
+    oid_t column_id = schema.GetUninlinedColumn(column_itr);
+    Varlen **field_location = reinterpret_cast<Varlen **>(
+        tuple_location + schema.GetOffset(column_id));
+
+    // NULL values have no varlen
+    if (*field_location == NULL) continue;
+
+    Varlen::Free(*field_location, pool);
+    *field_location = NULL;
+  }
+}
+
 Tile *Tile::CopyTile(BackendType backend_type) {
   auto schema = GetSchema();
   bool tile_columns_inlined = schema->IsInlined();
@@ -476,6 +498,51 @@ void Tile::Sync() {
   storage_manager.Sync(backend_type, data, tile_size);
 }
 
+void Tile::AllocateData() {
+  // in-memory tiles of a tile group go to its NUMA node, already zeroed
+  auto &numa_manager = NumaManager::GetInstance();
+  if (backend_type == BACKEND_TYPE_MM && tile_group != nullptr &&
+      numa_manager.IsAvailable() == true) {
+    data = reinterpret_cast<char *>(
+        numa_manager.Allocate(tile_size, tile_group->GetNumaNode()));
+    numa_allocated = (data != NULL);
+    if (data != NULL) return;
+  }
+
+  // file backed tiles go to the data file of their table
+  oid_t data_table_id = INVALID_OID;
+  if (tile_group != nullptr && tile_group->GetAbstractTable() != nullptr) {
+    data_table_id = tile_group->GetAbstractTable()->GetOid();
+  }
+
+  auto &storage_manager = storage::StorageManager::GetInstance();
+  data = reinterpret_cast<char *>(
+      storage_manager.Allocate(backend_type, tile_size, data_table_id));
+  assert(data != NULL);
+
+  // zero out the data
+  std::memset(data, 0, tile_size);
+}
+
+void Tile::ReleaseData() {
+  if (data == NULL) return;
+
+  if (numa_allocated == true) {
+    NumaManager::GetInstance().Release(data, tile_size);
+  } else {
+    auto &storage_manager = storage::StorageManager::GetInstance();
+    storage_manager.Release(backend_type, data);
+  }
+
+  data = NULL;
+  numa_allocated = false;
+}
+
+void Tile::AdviseSequentialScan() {
+  auto &storage_manager = storage::StorageManager::GetInstance();
+  storage_manager.AdviseSequential(backend_type, data, tile_size);
+}
+
 //===--------------------------------------------------------------------===//
 // Utilities
 //===--------------------------------------------------------------------===//
@@ -55,6 +55,15 @@ class Tile : public Printable {
 
   virtual ~Tile();
 
+ protected:
+  // Tile that keeps its data elsewhere, if the tuple slots are not
+  // allocated
+  Tile(BackendType backend_type, TileGroupHeader *tile_header,
+       const catalog::Schema &tuple_schema, TileGroup *tile_group,
+       int tuple_count, bool allocate_data);
+
+ public:
+
   //===--------------------------------------------------------------------===//
   // Operations
   //===--------------------------------------------------------------------===//
@@ -78,14 +87,16 @@ class Tile : public Printable {
   /**
    * Returns value present at slot
    */
-  Value GetValue(const oid_t tuple_offset, const oid_t column_id);
+  virtual Value GetValue(const oid_t tuple_offset, const oid_t column_id);
 
   /*
    * Faster way to get value
    * By amortizing schema lookups
    */
-  Value GetValueFast(const oid_t tuple_offset, const size_t column_offset,
-                     const ValueType column_type, const bool is_inlined);
+  virtual Value GetValueFast(const oid_t tuple_offset,
+                             const size_t column_offset,
+                             const ValueType column_type,
+                             const bool is_inlined);
 
   /**
    * Sets value at tuple slot.
@@ -108,6 +119,10 @@ class Tile : public Printable {
   // Copy current tile in given backend and return new tile
   Tile *CopyTile(BackendType backend_type);
 
+  // Give the uninlined values of the tuple back to the pool, once the tuple
+  // slot is reclaimed
+  void FreeUninlinedData(const oid_t tuple_offset);
+
   //===--------------------------------------------------------------------===//
   // Size Stats
   //===--------------------------------------------------------------------===//
@@ -138,6 +153,8 @@ class Tile : public Printable {
 
   oid_t GetTileId() const { return tile_id; }
 
+  BackendType GetBackendType() const { return backend_type; }
+
   // Compare two tiles
   bool operator==(const Tile &other) const;
   bool operator!=(const Tile &other) const;
@@ -168,7 +185,16 @@ class Tile : public Printable {
   // Sync the contents
   void Sync();
 
+  // Hint that the contents are going to be scanned soon
+  void AdviseSequentialScan();
+
  protected:
+  // Allocate the zeroed tuple slots
+  void AllocateData();
+
+  // Give back the tuple slots
+  void ReleaseData();
+
   //===--------------------------------------------------------------------===//
   // Data members
   //===--------------------------------------------------------------------===//
@@ -188,6 +214,9 @@ class Tile : public Printable {
   // set of fixed-length tuple slots
   char *data;
 
+  // were the tuple slots mapped on the NUMA node of the tile group ?
+  bool numa_allocated = false;
+
   // relevant tile group
   TileGroup *tile_group;
 
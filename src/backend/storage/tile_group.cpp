@@ -22,43 +22,66 @@
 #include "backend/storage/tile.h"
 #include "backend/storage/tuple.h"
 #include "backend/storage/tile_group_header.h"
+#include "backend/storage/zone_map.h"
 
 namespace peloton {
 namespace storage {
 
 TileGroup::TileGroup(BackendType backend_type,
-                     TileGroupHeader *tile_group_header, AbstractTable *table,
+                     const std::shared_ptr<TileGroupHeader> &tile_group_header,
+                     AbstractTable *table,
                      const std::vector<catalog::Schema> &schemas,
-                     const column_map_type &column_map, int tuple_count)
+                     const column_map_type &column_map, int tuple_count,
+                     int numa_node)
+    : TileGroup(backend_type, tile_group_header, table, schemas, column_map,
+                tuple_count, numa_node, true) {}
+
+TileGroup::TileGroup(BackendType backend_type,
+                     const std::shared_ptr<TileGroupHeader> &tile_group_header,
+                     AbstractTable *table,
+                     const std::vector<catalog::Schema> &schemas,
+                     const column_map_type &column_map, int tuple_count,
+                     int numa_node, bool allocate_tiles)
     : database_id(INVALID_OID),
       table_id(INVALID_OID),
       tile_group_id(INVALID_OID),
       backend_type(backend_type),
       tile_schemas(schemas),
       tile_group_header(tile_group_header),
+      zone_map(nullptr),
+      numa_node(numa_node),
       table(table),
       num_tuple_slots(tuple_count),
       column_map(column_map) {
   tile_count = tile_schemas.size();
 
-  for (oid_t tile_itr = 0; tile_itr < tile_count; tile_itr++) {
+  for (oid_t tile_itr = 0; allocate_tiles && tile_itr < tile_count;
+       tile_itr++) {
     auto &manager = catalog::Manager::GetInstance();
     oid_t tile_id = manager.GetNextOid();
 
     std::shared_ptr<Tile> tile(storage::TileFactory::GetTile(
         backend_type, database_id, table_id, tile_group_id, tile_id,
-        tile_group_header, tile_schemas[tile_itr], this, tuple_count));
+        tile_group_header.get(), tile_schemas[tile_itr], this, tuple_count));
 
     // Add a reference to the tile in the tile group
     tiles.push_back(tile);
   }
+
+  // Build the zone map over the tile group columns
+  std::vector<ValueType> column_types;
+  for (auto entry : column_map) {
+    auto &tile_schema = tile_schemas[entry.second.first];
+    column_types.push_back(tile_schema.GetType(entry.second.second));
+  }
+  zone_map = new ZoneMap(column_types);
 }
 
 TileGroup::~TileGroup() {
-  // Drop references on all tiles
+  // Drop references on all tiles and the tile group header
 
-  // clean up tile group header
-  delete tile_group_header;
+  // clean up zone map
+  delete zone_map;
 }
 
 oid_t TileGroup::GetTileId(const oid_t tile_id) const {
@@ -128,6 +151,9 @@ oid_t TileGroup::InsertTuple(txn_id_t transaction_id, const Tuple *tuple) {
     }
   }
 
+  // Widen the zone map
+  zone_map->UpdateZoneMap(tuple);
+
   // Set MVCC info
   assert(tile_group_header->GetTransactionId(tuple_slot_id) == INVALID_TXN_ID);
   assert(tile_group_header->GetBeginCommitId(tuple_slot_id) == MAX_CID);
@@ -138,10 +164,83 @@ oid_t TileGroup::InsertTuple(txn_id_t transaction_id, const Tuple *tuple) {
   tile_group_header->SetEndCommitId(tuple_slot_id, MAX_CID);
   tile_group_header->SetInsertCommit(tuple_slot_id, false);
   tile_group_header->SetDeleteCommit(tuple_slot_id, false);
+  tile_group_header->SetPrevItemPointer(tuple_slot_id, INVALID_ITEMPOINTER);
 
   return tuple_slot_id;
 }
 
+/**
+ * Grab the next slots (thread-safe) and fill in the tuples
+ *
+ * The values are copied column-at-a-time, so that every column of a tile is
+ * written in one pass. The slots are consecutive unless the tile group is
+ * full and reuses the slots reclaimed by the garbage collector.
+ *
+ * Returns the number of inserted tuples, which is smaller than the given
+ * count if the tile group fills up
+ */
+oid_t TileGroup::InsertTuples(txn_id_t transaction_id,
+                              const Tuple *const *tuples, oid_t tuple_count,
+                              std::vector<oid_t> &tuple_slots) {
+  tuple_slots.clear();
+  oid_t inserted_count =
+      tile_group_header->GetNextEmptyTupleSlots(tuple_count, tuple_slots);
+
+  LOG_TRACE("Tile Group Id :: %lu status :: %lu slots out of %lu slots ",
+            tile_group_id, inserted_count, num_tuple_slots);
+
+  // No more slots
+  if (inserted_count == 0) {
+    LOG_INFO("Failed to get empty tuple slots within tile group.");
+    return 0;
+  }
+
+  oid_t column_itr = 0;
+
+  for (oid_t tile_itr = 0; tile_itr < tile_count; tile_itr++) {
+    const catalog::Schema &schema = tile_schemas[tile_itr];
+    oid_t tile_column_count = schema.GetColumnCount();
+
+    storage::Tile *tile = GetTile(tile_itr);
+    assert(tile);
+
+    for (oid_t tile_column_itr = 0; tile_column_itr < tile_column_count;
+         tile_column_itr++) {
+      // Amortize the schema lookups over the batch
+      size_t column_offset = schema.GetOffset(tile_column_itr);
+      bool is_inlined = schema.IsInlined(tile_column_itr);
+      size_t column_length = schema.GetAppropriateLength(tile_column_itr);
+
+      for (oid_t tuple_itr = 0; tuple_itr < inserted_count; tuple_itr++) {
+        tile->SetValueFast(tuples[tuple_itr]->GetValue(column_itr),
+                           tuple_slots[tuple_itr], column_offset, is_inlined,
+                           column_length);
+      }
+      column_itr++;
+    }
+  }
+
+  for (oid_t tuple_itr = 0; tuple_itr < inserted_count; tuple_itr++) {
+    oid_t tuple_slot_id = tuple_slots[tuple_itr];
+
+    // Widen the zone map
+    zone_map->UpdateZoneMap(tuples[tuple_itr]);
+
+    // Set MVCC info
+    assert(tile_group_header->GetTransactionId(tuple_slot_id) ==
+           INVALID_TXN_ID);
+
+    tile_group_header->SetTransactionId(tuple_slot_id, transaction_id);
+    tile_group_header->SetBeginCommitId(tuple_slot_id, MAX_CID);
+    tile_group_header->SetEndCommitId(tuple_slot_id, MAX_CID);
+    tile_group_header->SetInsertCommit(tuple_slot_id, false);
+    tile_group_header->SetDeleteCommit(tuple_slot_id, false);
+    tile_group_header->SetPrevItemPointer(tuple_slot_id, INVALID_ITEMPOINTER);
+  }
+
+  return inserted_count;
+}
+
 /**
  * Grab specific slot and fill in the tuple
  * Used by recovery
@@ -180,6 +279,9 @@ oid_t TileGroup::InsertTuple(txn_id_t transaction_id, oid_t tuple_slot_id,
     }
   }
 
+  // Widen the zone map
+  zone_map->UpdateZoneMap(tuple);
+
   // Set MVCC info
   tile_group_header->SetTransactionId(tuple_slot_id, transaction_id);
   tile_group_header->SetBeginCommitId(tuple_slot_id, MAX_CID);
@@ -191,37 +293,52 @@ oid_t TileGroup::InsertTuple(txn_id_t transaction_id, oid_t tuple_slot_id,
   return tuple_slot_id;
 }
 
-// delete tuple at given slot if it is neither already locked nor deleted in
-// future.
+/**
+ * The first updater wins. A txn takes ownership of the version by swapping
+ * its txn id into the header, and every later txn that wants to delete or
+ * update the version fails right away, as does every txn that comes after
+ * a committed delete. We look at the header before the CAS, so that a hot
+ * version does not get hammered with CAS by the txns that are bound to lose.
+ */
 bool TileGroup::DeleteTuple(txn_id_t transaction_id, oid_t tuple_slot_id,
                             cid_t last_cid) {
-  // do a dirty delete
-  if (tile_group_header->LatchTupleSlot(tuple_slot_id, transaction_id)) {
-    if (tile_group_header->IsDeletable(tuple_slot_id, transaction_id,
-                                       last_cid)) {
-      return true;
-    } else {
-      LOG_INFO("Delete failed: not deletable");
-      tile_group_header->ReleaseTupleSlot(tuple_slot_id, transaction_id);
-      return false;
-    }
-  } else if (tile_group_header->GetTransactionId(tuple_slot_id) ==
-             transaction_id) {
+  txn_id_t owner_id = tile_group_header->GetTransactionId(tuple_slot_id);
+
+  if (owner_id == transaction_id) {
     // is a own insert, is already latched by myself and is safe to set
-    LOG_INFO("is this a own insert? txn_id = %lu, cbeg = %lu, cend = %lu",
-             tile_group_header->GetTransactionId(tuple_slot_id),
-             tile_group_header->GetBeginCommitId(tuple_slot_id),
-             tile_group_header->GetEndCommitId(tuple_slot_id));
+    LOG_TRACE("is this a own insert? txn_id = %lu, cbeg = %lu, cend = %lu",
+              owner_id, tile_group_header->GetBeginCommitId(tuple_slot_id),
+              tile_group_header->GetEndCommitId(tuple_slot_id));
     assert(tile_group_header->GetBeginCommitId(tuple_slot_id) == MAX_CID);
     assert(tile_group_header->GetEndCommitId(tuple_slot_id) == MAX_CID);
     tile_group_header->SetTransactionId(tuple_slot_id, INVALID_TXN_ID);
     return true;
-  } else {
-    LOG_INFO(
-        "Delete failed: Latch failed and Ownership check failed: %lu != %lu",
-        tile_group_header->GetTransactionId(tuple_slot_id), transaction_id);
+  }
+
+  // Conflict : owned by another txn, or already deleted
+  if (owner_id != INITIAL_TXN_ID ||
+      tile_group_header->IsDeletable(tuple_slot_id, transaction_id,
+                                     last_cid) == false) {
+    LOG_TRACE("Delete failed: write-write conflict with %lu", owner_id);
+    return false;
+  }
+
+  // Take ownership, this fails if another txn got there first
+  if (tile_group_header->LatchTupleSlot(tuple_slot_id, transaction_id) ==
+      false) {
+    LOG_TRACE("Delete failed: lost the race for ownership");
+    return false;
+  }
+
+  // The delete may have been committed right before we took ownership
+  if (tile_group_header->IsDeletable(tuple_slot_id, transaction_id,
+                                     last_cid) == false) {
+    LOG_TRACE("Delete failed: not deletable");
+    tile_group_header->ReleaseTupleSlot(tuple_slot_id, transaction_id);
     return false;
   }
+
+  return true;
 }
 
 void TileGroup::CommitInsertedTuple(oid_t tuple_slot_id,
@@ -235,8 +352,11 @@ void TileGroup::CommitInsertedTuple(oid_t tuple_slot_id,
 void TileGroup::CommitDeletedTuple(oid_t tuple_slot_id, txn_id_t transaction_id,
                                    cid_t commit_id) {
   // set the end commit id to persist delete
-  if (tile_group_header->ReleaseTupleSlot(tuple_slot_id, transaction_id)) {
+  // before giving up ownership, so that no other txn can take over the
+  // version in between and delete it once more
+  if (tile_group_header->GetTransactionId(tuple_slot_id) == transaction_id) {
     tile_group_header->SetEndCommitId(tuple_slot_id, commit_id);
+    tile_group_header->ReleaseTupleSlot(tuple_slot_id, transaction_id);
   }
 }
 /**
@@ -326,6 +446,15 @@ void TileGroup::Sync() {
   }
 }
 
+void TileGroup::AdviseSequentialScan() {
+  // Only file backed tiles need to be read ahead
+  if (backend_type != BACKEND_TYPE_FILE) return;
+
+  for (auto tile : tiles) {
+    tile->AdviseSequentialScan();
+  }
+}
+
 //===--------------------------------------------------------------------===//
 // Utilities
 //===--------------------------------------------------------------------===//
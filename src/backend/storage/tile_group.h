@@ -40,6 +40,7 @@ namespace storage {
 class Tuple;
 class Tile;
 class TileGroupHeader;
+class ZoneMap;
 class AbstractTable;
 class TileGroupIterator;
 
@@ -63,12 +64,24 @@ class TileGroup : public Printable {
 
  public:
   // Tile group constructor
-  TileGroup(BackendType backend_type, TileGroupHeader *tile_group_header,
+  TileGroup(BackendType backend_type,
+            const std::shared_ptr<TileGroupHeader> &tile_group_header,
             AbstractTable *table, const std::vector<catalog::Schema> &schemas,
-            const column_map_type &column_map, int tuple_count);
+            const column_map_type &column_map, int tuple_count,
+            int numa_node = 0);
 
   ~TileGroup();
 
+ private:
+  // Tile group whose tiles are added later, if they are not allocated
+  TileGroup(BackendType backend_type,
+            const std::shared_ptr<TileGroupHeader> &tile_group_header,
+            AbstractTable *table, const std::vector<catalog::Schema> &schemas,
+            const column_map_type &column_map, int tuple_count, int numa_node,
+            bool allocate_tiles);
+
+ public:
+
   //===--------------------------------------------------------------------===//
   // Operations
   //===--------------------------------------------------------------------===//
@@ -76,6 +89,11 @@ class TileGroup : public Printable {
   // insert tuple at next available slot in tile if a slot exists
   oid_t InsertTuple(txn_id_t transaction_id, const Tuple *tuple);
 
+  // insert a batch of tuples at the next available slots
+  // returns the number of inserted tuples, whose slots go to tuple_slots
+  oid_t InsertTuples(txn_id_t transaction_id, const Tuple *const *tuples,
+                     oid_t tuple_count, std::vector<oid_t> &tuple_slots);
+
   // insert tuple at specific tuple slot
   // used by recovery mode
   oid_t InsertTuple(txn_id_t transaction_id, oid_t tuple_slot_id,
@@ -117,9 +135,25 @@ class TileGroup : public Printable {
 
   oid_t GetAllocatedTupleCount() const { return num_tuple_slots; }
 
-  TileGroupHeader *GetHeader() const { return tile_group_header; }
+  TileGroupHeader *GetHeader() const { return tile_group_header.get(); }
+
+  // Get a reference to the header, used to share it with a tile group
+  // holding the same tuples in a different layout
+  std::shared_ptr<TileGroupHeader> GetHeaderReference() const {
+    return tile_group_header;
+  }
 
-  void SetHeader(TileGroupHeader *header) { tile_group_header = header; }
+  void SetHeader(const std::shared_ptr<TileGroupHeader> &header) {
+    tile_group_header = header;
+  }
+
+  ZoneMap *GetZoneMap() const { return zone_map; }
+
+  // are the tiles compressed ?
+  bool IsCompressed() const { return compressed; }
+
+  // Get the NUMA node that holds the tiles
+  int GetNumaNode() const { return numa_node; }
 
   unsigned int NumTiles() const { return tiles.size(); }
 
@@ -165,6 +199,9 @@ class TileGroup : public Printable {
   // Sync the contents
   void Sync();
 
+  // Hint that the tiles are going to be scanned soon
+  void AdviseSequentialScan();
+
  protected:
   //===--------------------------------------------------------------------===//
   // Data members
@@ -185,7 +222,16 @@ class TileGroup : public Printable {
   std::vector<std::shared_ptr<Tile>> tiles;
 
   // associated tile group
-  TileGroupHeader *tile_group_header;
+  std::shared_ptr<TileGroupHeader> tile_group_header;
+
+  // min/max summaries used for scan pruning
+  ZoneMap *zone_map;
+
+  // are the tiles compressed ?
+  bool compressed = false;
+
+  // NUMA node that holds the tiles
+  int numa_node;
 
   // associated table
   AbstractTable *table;  // TODO: Remove this! It is a waste of space!!
@@ -11,7 +11,11 @@
 //===----------------------------------------------------------------------===//
 
 #include "backend/storage/tile_group_factory.h"
+#include "backend/common/numa_manager.h"
+#include "backend/storage/compressed_tile.h"
+#include "backend/storage/storage_manager.h"
 #include "backend/storage/tile_group_header.h"
+#include "backend/storage/zone_map.h"
 
 //===--------------------------------------------------------------------===//
 // GUC Variables
@@ -35,13 +39,40 @@ TileGroup *TileGroupFactory::GetTileGroup(
   // Allocate the data file on a mmap'ed file
   // This is used for architectures similar to peloton logging
   // Where the data is allocated in NVM or HDD or SSD
-  if (IsSimilarToPeloton(peloton_logging_mode) == true) {
+  // It is also used for tables larger than memory, when the user specifies
+  // a data directory
+  auto &storage_manager = StorageManager::GetInstance();
+  if (IsSimilarToPeloton(peloton_logging_mode) == true ||
+      storage_manager.HasDataDirectory() == true) {
     backend_type = BACKEND_TYPE_FILE;
   }
 
-  TileGroupHeader *tile_header = new TileGroupHeader(backend_type, tuple_count);
-  TileGroup *tile_group = new TileGroup(backend_type, tile_header, table,
-                                        schemas, column_map, tuple_count);
+  // Place the new tile group as per the NUMA placement policy, before
+  // its memory is touched
+  int numa_node = NumaManager::GetInstance().GetPlacementNode();
+
+  std::shared_ptr<TileGroupHeader> tile_header(
+      new TileGroupHeader(backend_type, tuple_count, numa_node));
+
+  TileGroup *tile_group =
+      GetTileGroup(database_id, table_id, tile_group_id, table, schemas,
+                   column_map, tuple_count, tile_header, numa_node);
+
+  return tile_group;
+}
+
+TileGroup *TileGroupFactory::GetTileGroup(
+    oid_t database_id, oid_t table_id, oid_t tile_group_id,
+    AbstractTable *table, const std::vector<catalog::Schema> &schemas,
+    const column_map_type &column_map, int tuple_count,
+    const std::shared_ptr<TileGroupHeader> &tile_group_header,
+    int numa_node) {
+  // Use the backend of the shared header
+  BackendType backend_type = tile_group_header->GetBackendType();
+
+  TileGroup *tile_group =
+      new TileGroup(backend_type, tile_group_header, table, schemas,
+                    column_map, tuple_count, numa_node);
 
   tile_group->database_id = database_id;
   tile_group->tile_group_id = tile_group_id;
@@ -50,5 +81,33 @@ TileGroup *TileGroupFactory::GetTileGroup(
   return tile_group;
 }
 
+TileGroup *TileGroupFactory::GetCompressedTileGroup(TileGroup *tile_group) {
+  // The tiles are not allocated, the compressed tiles take their place
+  TileGroup *compressed_tile_group = new TileGroup(
+      tile_group->GetHeader()->GetBackendType(),
+      tile_group->GetHeaderReference(),
+      tile_group->GetAbstractTable(), tile_group->GetTileSchemas(),
+      tile_group->GetColumnMap(), tile_group->GetAllocatedTupleCount(),
+      tile_group->GetNumaNode(), false);
+
+  compressed_tile_group->database_id = tile_group->GetDatabaseId();
+  compressed_tile_group->tile_group_id = tile_group->GetTileGroupId();
+  compressed_tile_group->table_id = tile_group->GetTableId();
+
+  // Add compressed copies of the original tiles
+  oid_t tile_count = tile_group->GetTileCount();
+  for (oid_t tile_itr = 0; tile_itr < tile_count; tile_itr++) {
+    std::shared_ptr<Tile> compressed_tile(
+        new CompressedTile(tile_group->GetTile(tile_itr), compressed_tile_group));
+    compressed_tile_group->tiles.push_back(compressed_tile);
+  }
+  compressed_tile_group->compressed = true;
+
+  // The zone map still applies
+  *(compressed_tile_group->GetZoneMap()) = *(tile_group->GetZoneMap());
+
+  return compressed_tile_group;
+}
+
 }  // End storage namespace
 }  // End peloton namespace
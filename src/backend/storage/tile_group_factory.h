@@ -34,6 +34,20 @@ class TileGroupFactory {
                                  const std::vector<catalog::Schema> &schemas,
                                  const column_map_type &column_map,
                                  int tuple_count);
+
+  // Get a tile group that shares the given header,
+  // used to store the same tuples in a different layout
+  // its in-memory tiles are allocated on the given NUMA node
+  static TileGroup *GetTileGroup(
+      oid_t database_id, oid_t table_id, oid_t tile_group_id,
+      AbstractTable *table, const std::vector<catalog::Schema> &schemas,
+      const column_map_type &column_map, int tuple_count,
+      const std::shared_ptr<TileGroupHeader> &tile_group_header,
+      int numa_node = 0);
+
+  // Get a compressed copy of the given tile group that shares its header.
+  // The tuples in the given tile group must not change anymore.
+  static TileGroup *GetCompressedTileGroup(TileGroup *tile_group);
 };
 
 }  // End storage namespace
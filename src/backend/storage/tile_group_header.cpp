@@ -14,6 +14,7 @@
 #include <iomanip>
 #include <sstream>
 
+#include "backend/common/numa_manager.h"
 #include "backend/concurrency/transaction_manager.h"
 #include "backend/storage/storage_manager.h"
 #include "backend/storage/tile_group_header.h"
@@ -21,21 +22,33 @@
 namespace peloton {
 namespace storage {
 
-TileGroupHeader::TileGroupHeader(BackendType backend_type, int tuple_count)
+TileGroupHeader::TileGroupHeader(BackendType backend_type, int tuple_count,
+                                 int numa_node)
     : backend_type(backend_type),
       data(nullptr),
+      numa_allocated(false),
       num_tuple_slots(tuple_count),
       next_tuple_slot(0) {
   header_size = num_tuple_slots * header_entry_size;
 
-  // allocate storage space for header
-  auto &storage_manager = storage::StorageManager::GetInstance();
-  data = reinterpret_cast<char *>(
-      storage_manager.Allocate(backend_type, header_size));
-  assert(data != nullptr);
+  // allocate storage space for header, an in-memory header goes to the
+  // NUMA node of its tile group, already zeroed
+  auto &numa_manager = NumaManager::GetInstance();
+  if (backend_type == BACKEND_TYPE_MM && numa_manager.IsAvailable() == true) {
+    data = reinterpret_cast<char *>(
+        numa_manager.Allocate(header_size, numa_node));
+    numa_allocated = (data != nullptr);
+  }
 
-  // zero out the data
-  std::memset(data, 0, header_size);
+  if (data == nullptr) {
+    auto &storage_manager = storage::StorageManager::GetInstance();
+    data = reinterpret_cast<char *>(
+        storage_manager.Allocate(backend_type, header_size));
+    assert(data != nullptr);
+
+    // zero out the data
+    std::memset(data, 0, header_size);
+  }
 
   // Set MVCC Initial Value
   for (oid_t tuple_slot_id = START_OID; tuple_slot_id < num_tuple_slots;
@@ -50,8 +63,12 @@ TileGroupHeader::TileGroupHeader(BackendType backend_type, int tuple_count)
 
 TileGroupHeader::~TileGroupHeader() {
   // reclaim the space
-  auto &storage_manager = storage::StorageManager::GetInstance();
-  storage_manager.Release(backend_type, data);
+  if (numa_allocated == true) {
+    NumaManager::GetInstance().Release(data, header_size);
+  } else {
+    auto &storage_manager = storage::StorageManager::GetInstance();
+    storage_manager.Release(backend_type, data);
+  }
 
   data = nullptr;
 }
@@ -197,6 +214,38 @@ void TileGroupHeader::PrintVisibility(txn_id_t txn_id, cid_t at_cid) {
   std::cout << os.str().c_str();
 }
 
+bool TileGroupHeader::FreeTupleSlots(const std::vector<oid_t> &tuple_slots) {
+  std::lock_guard<std::mutex> tile_header_lock(tile_header_mutex);
+
+  // Check if all the slots are going to be free
+  if (next_tuple_slot == num_tuple_slots &&
+      free_tuple_slots.size() + tuple_slots.size() == num_tuple_slots) {
+    // Take the free slots out of circulation
+    std::queue<oid_t> empty_queue;
+    std::swap(free_tuple_slots, empty_queue);
+    return true;
+  }
+
+  for (auto tuple_slot_id : tuple_slots) {
+    free_tuple_slots.push(tuple_slot_id);
+  }
+
+  return false;
+}
+
+void TileGroupHeader::ResetTupleSlots() {
+  std::lock_guard<std::mutex> tile_header_lock(tile_header_mutex);
+
+  std::queue<oid_t> empty_queue;
+  std::swap(free_tuple_slots, empty_queue);
+  next_tuple_slot = 0;
+}
+
+oid_t TileGroupHeader::GetFreeTupleSlotCount() {
+  std::lock_guard<std::mutex> tile_header_lock(tile_header_mutex);
+  return free_tuple_slots.size();
+}
+
 oid_t TileGroupHeader::GetActiveTupleCount(txn_id_t txn_id) {
   oid_t active_tuple_slots = 0;
   auto &txn_manager = concurrency::TransactionManager::GetInstance();
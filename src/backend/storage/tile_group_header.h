@@ -17,12 +17,14 @@
 #include "backend/common/printable.h"
 #include "backend/logging/log_manager.h"
 
+#include <algorithm>
 #include <atomic>
 #include <mutex>
 #include <iostream>
 #include <cassert>
 #include <queue>
 #include <cstring>
+#include <vector>
 
 namespace peloton {
 namespace storage {
@@ -51,7 +53,9 @@ class TileGroupHeader : public Printable {
   TileGroupHeader() = delete;
 
  public:
-  TileGroupHeader(BackendType backend_type, int tuple_count);
+  // An in-memory header is allocated on the given NUMA node
+  TileGroupHeader(BackendType backend_type, int tuple_count,
+                  int numa_node = 0);
 
   TileGroupHeader &operator=(const peloton::storage::TileGroupHeader &other) {
     // check for self-assignment
@@ -82,11 +86,57 @@ class TileGroupHeader : public Printable {
         tuple_slot_id = next_tuple_slot;
         next_tuple_slot++;
       }
+      // else, reuse a slot reclaimed by the garbage collector
+      else if (free_tuple_slots.empty() == false) {
+        tuple_slot_id = free_tuple_slots.front();
+        free_tuple_slots.pop();
+      }
     }
 
     return tuple_slot_id;
   }
 
+  // Reserve up to count empty slots under a single latch.
+  // Consecutive slots come first, then the slots reclaimed by the garbage
+  // collector. Returns the number of slots added to tuple_slots.
+  oid_t GetNextEmptyTupleSlots(oid_t count, std::vector<oid_t> &tuple_slots) {
+    std::lock_guard<std::mutex> tile_header_lock(tile_header_mutex);
+
+    oid_t reserved_count = 0;
+    while (reserved_count < count) {
+      // check tile group capacity
+      if (next_tuple_slot < num_tuple_slots) {
+        tuple_slots.push_back(next_tuple_slot);
+        next_tuple_slot++;
+      }
+      // else, reuse a slot reclaimed by the garbage collector
+      else if (free_tuple_slots.empty() == false) {
+        tuple_slots.push_back(free_tuple_slots.front());
+        free_tuple_slots.pop();
+      } else {
+        break;
+      }
+      reserved_count++;
+    }
+
+    return reserved_count;
+  }
+
+  /**
+   * Used by garbage collection
+   *
+   * Make the given slots, whose MVCC info has been reset, reusable.
+   * Returns true if no slot in the tile group is in use anymore. The slots
+   * are then not handed out till ResetTupleSlots is called.
+   */
+  bool FreeTupleSlots(const std::vector<oid_t> &tuple_slots);
+
+  // Start over with an empty tile group
+  void ResetTupleSlots();
+
+  // Get the number of reclaimed slots waiting to be reused
+  oid_t GetFreeTupleSlotCount();
+
   /**
    * Used by logging
    */
@@ -109,6 +159,8 @@ class TileGroupHeader : public Printable {
 
   oid_t GetActiveTupleCount(txn_id_t txn_id);
 
+  BackendType GetBackendType() const { return backend_type; }
+
   //===--------------------------------------------------------------------===//
   // MVCC utilities
   //===--------------------------------------------------------------------===//
@@ -207,6 +259,24 @@ class TileGroupHeader : public Printable {
                       2 * sizeof(bool))) = item;
   }
 
+  // Reset the MVCC info of a reclaimed slot
+  inline void ResetTupleSlot(const oid_t tuple_slot_id) {
+    SetTransactionId(tuple_slot_id, INVALID_TXN_ID);
+    SetBeginCommitId(tuple_slot_id, MAX_CID);
+    SetEndCommitId(tuple_slot_id, MAX_CID);
+    SetInsertCommit(tuple_slot_id, false);
+    SetDeleteCommit(tuple_slot_id, false);
+    SetPrevItemPointer(tuple_slot_id, INVALID_ITEMPOINTER);
+  }
+
+  // Can the slot be reclaimed ?
+  // It holds a version whose delete was committed before the given cid, so
+  // it is invisible to all transactions with a snapshot at or after it.
+  inline bool IsReclaimable(const oid_t tuple_slot_id, cid_t oldest_cid) const {
+    return GetTransactionId(tuple_slot_id) == INITIAL_TXN_ID &&
+           GetEndCommitId(tuple_slot_id) <= oldest_cid;
+  }
+
   // Visibility check
   bool IsVisible(const oid_t tuple_slot_id, txn_id_t txn_id, cid_t at_lcid) {
     txn_id_t tuple_txn_id = GetTransactionId(tuple_slot_id);
@@ -256,7 +326,7 @@ class TileGroupHeader : public Printable {
                    ((!own && activated && !invalidated) ||
                     (own && !activated && !invalidated));
 
-    LOG_INFO(
+    LOG_TRACE(
         "<%p, %lu> :(vtid, vbeg, vend) = (%lu, %lu, %lu), (tid, lcid) = (%lu, "
         "%lu), visible = %d",
         this, tuple_slot_id, tuple_txn_id, tuple_begin_cid, tuple_end_cid,
@@ -275,7 +345,7 @@ class TileGroupHeader : public Printable {
 
     bool deletable = tuple_end_cid == MAX_CID;
 
-    LOG_INFO(
+    LOG_TRACE(
         "<%p, %lu> :(vtid, vbeg, vend) = (%lu, %lu, %lu), (tid, lcid) = (%lu, "
         "%lu), deletable = %d",
         this, tuple_slot_id, GetTransactionId(tuple_slot_id),
@@ -315,12 +385,18 @@ class TileGroupHeader : public Printable {
   // set of fixed-length tuple slots
   char *data;
 
+  // was the header mapped on a NUMA node ?
+  bool numa_allocated;
+
   // number of tuple slots allocated
   oid_t num_tuple_slots;
 
   // next free tuple slot
   oid_t next_tuple_slot;
 
+  // slots reclaimed by the garbage collector
+  std::queue<oid_t> free_tuple_slots;
+
   // synch helpers
   std::mutex tile_header_mutex;
 };
@@ -0,0 +1,254 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// zone_map.cpp
+//
+// Identification: src/backend/storage/zone_map.cpp
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "backend/storage/zone_map.h"
+
+#include <sstream>
+
+#include "backend/common/logger.h"
+#include "backend/storage/tuple.h"
+
+namespace peloton {
+namespace storage {
+
+// Only fixed-length types with a total order are summarized
+static bool IsSummarizable(ValueType value_type) {
+  switch (value_type) {
+    case VALUE_TYPE_TINYINT:
+    case VALUE_TYPE_SMALLINT:
+    case VALUE_TYPE_INTEGER:
+    case VALUE_TYPE_BIGINT:
+    case VALUE_TYPE_TIMESTAMP:
+    case VALUE_TYPE_DOUBLE:
+    case VALUE_TYPE_DECIMAL:
+      return true;
+
+    default:
+      return false;
+  }
+}
+
+ZoneMap::ZoneMap(const std::vector<ValueType> &column_types)
+    : tuple_count(0) {
+  for (auto column_type : column_types) {
+    ColumnZone column_zone;
+    column_zone.valid = IsSummarizable(column_type);
+    column_zone.min_value = Value::GetNullValue(column_type);
+    column_zone.max_value = Value::GetNullValue(column_type);
+    column_zone.null_count = 0;
+    column_zones.push_back(column_zone);
+  }
+}
+
+ZoneMap &ZoneMap::operator=(const ZoneMap &other) {
+  // check for self-assignment
+  if (&other == this) return *this;
+
+  other.zone_map_lock.Lock();
+  auto other_column_zones = other.column_zones;
+  auto other_tuple_count = other.tuple_count;
+  other.zone_map_lock.Unlock();
+
+  zone_map_lock.Lock();
+  column_zones = other_column_zones;
+  tuple_count = other_tuple_count;
+  zone_map_lock.Unlock();
+
+  return *this;
+}
+
+void ZoneMap::UpdateZoneMap(const Tuple *tuple) {
+  oid_t column_count = column_zones.size();
+  assert(tuple->GetColumnCount() == column_count);
+
+  zone_map_lock.Lock();
+
+  for (oid_t column_itr = 0; column_itr < column_count; column_itr++) {
+    auto &column_zone = column_zones[column_itr];
+    if (column_zone.valid == false) continue;
+
+    Value value = tuple->GetValue(column_itr);
+    if (value.IsNull()) {
+      column_zone.null_count++;
+      continue;
+    }
+
+    if (column_zone.min_value.IsNull() ||
+        value.Compare(column_zone.min_value) < 0) {
+      column_zone.min_value = value;
+    }
+
+    if (column_zone.max_value.IsNull() ||
+        value.Compare(column_zone.max_value) > 0) {
+      column_zone.max_value = value;
+    }
+  }
+
+  tuple_count++;
+
+  zone_map_lock.Unlock();
+}
+
+void ZoneMap::ResetZoneMap() {
+  zone_map_lock.Lock();
+
+  for (auto &column_zone : column_zones) {
+    column_zone.min_value =
+        Value::GetNullValue(column_zone.min_value.GetValueType());
+    column_zone.max_value =
+        Value::GetNullValue(column_zone.max_value.GetValueType());
+    column_zone.null_count = 0;
+  }
+
+  tuple_count = 0;
+
+  zone_map_lock.Unlock();
+}
+
+void ZoneMap::InvalidateColumn(oid_t column_id) {
+  assert(column_id < column_zones.size());
+
+  zone_map_lock.Lock();
+  column_zones[column_id].valid = false;
+  zone_map_lock.Unlock();
+}
+
+/**
+ * @brief Check whether a simple comparison against a constant can be true
+ * for any tuple summarized by the zone map.
+ * @return false only if no tuple can satisfy the comparison.
+ */
+bool ZoneMap::CouldSatisfy(oid_t column_id, ExpressionType comparison_type,
+                           const Value &value) const {
+  assert(column_id < column_zones.size());
+
+  // Be conservative with NULL constants
+  if (value.IsNull()) return true;
+
+  zone_map_lock.Lock();
+
+  const auto &column_zone = column_zones[column_id];
+  if (column_zone.valid == false) {
+    zone_map_lock.Unlock();
+    return true;
+  }
+
+  // No non-null values seen, so no comparison can be true
+  if (column_zone.min_value.IsNull()) {
+    zone_map_lock.Unlock();
+    return false;
+  }
+
+  int min_cmp = column_zone.min_value.Compare(value);
+  int max_cmp = column_zone.max_value.Compare(value);
+
+  zone_map_lock.Unlock();
+
+  switch (comparison_type) {
+    case EXPRESSION_TYPE_COMPARE_EQUAL:
+      return (min_cmp <= 0 && max_cmp >= 0);
+
+    case EXPRESSION_TYPE_COMPARE_NOTEQUAL:
+      return !(min_cmp == 0 && max_cmp == 0);
+
+    case EXPRESSION_TYPE_COMPARE_LESSTHAN:
+      return (min_cmp < 0);
+
+    case EXPRESSION_TYPE_COMPARE_LESSTHANOREQUALTO:
+      return (min_cmp <= 0);
+
+    case EXPRESSION_TYPE_COMPARE_GREATERTHAN:
+      return (max_cmp > 0);
+
+    case EXPRESSION_TYPE_COMPARE_GREATERTHANOREQUALTO:
+      return (max_cmp >= 0);
+
+    default:
+      return true;
+  }
+}
+
+bool ZoneMap::IsValid(oid_t column_id) const {
+  assert(column_id < column_zones.size());
+
+  zone_map_lock.Lock();
+  bool valid = column_zones[column_id].valid;
+  zone_map_lock.Unlock();
+
+  return valid;
+}
+
+Value ZoneMap::GetMinValue(oid_t column_id) const {
+  assert(column_id < column_zones.size());
+
+  zone_map_lock.Lock();
+  Value min_value = column_zones[column_id].min_value;
+  zone_map_lock.Unlock();
+
+  return min_value;
+}
+
+Value ZoneMap::GetMaxValue(oid_t column_id) const {
+  assert(column_id < column_zones.size());
+
+  zone_map_lock.Lock();
+  Value max_value = column_zones[column_id].max_value;
+  zone_map_lock.Unlock();
+
+  return max_value;
+}
+
+oid_t ZoneMap::GetNullCount(oid_t column_id) const {
+  assert(column_id < column_zones.size());
+
+  zone_map_lock.Lock();
+  oid_t null_count = column_zones[column_id].null_count;
+  zone_map_lock.Unlock();
+
+  return null_count;
+}
+
+oid_t ZoneMap::GetTupleCount() const {
+  zone_map_lock.Lock();
+  oid_t count = tuple_count;
+  zone_map_lock.Unlock();
+
+  return count;
+}
+
+const std::string ZoneMap::GetInfo() const {
+  std::ostringstream os;
+
+  zone_map_lock.Lock();
+
+  os << "\tZONE MAP :: tuple count : " << tuple_count << "\n";
+
+  oid_t column_count = column_zones.size();
+  for (oid_t column_itr = 0; column_itr < column_count; column_itr++) {
+    const auto &column_zone = column_zones[column_itr];
+    os << "\t column : " << column_itr;
+    if (column_zone.valid == false) {
+      os << " (not summarized)\n";
+      continue;
+    }
+    os << " min : " << column_zone.min_value << " max : "
+       << column_zone.max_value << " nulls : " << column_zone.null_count
+       << "\n";
+  }
+
+  zone_map_lock.Unlock();
+
+  return os.str();
+}
+
+}  // End storage namespace
+}  // End peloton namespace
@@ -0,0 +1,108 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// zone_map.h
+//
+// Identification: src/backend/storage/zone_map.h
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <vector>
+
+#include "backend/common/platform.h"
+#include "backend/common/printable.h"
+#include "backend/common/types.h"
+#include "backend/common/value.h"
+
+namespace peloton {
+namespace storage {
+
+class Tuple;
+
+//===--------------------------------------------------------------------===//
+// Zone Map
+//===--------------------------------------------------------------------===//
+
+/**
+ * Per-column min/max and null-count summaries of a tile group.
+ *
+ * The summary is widened whenever a tuple is inserted into the tile group
+ * and is never narrowed. Since updates are performed out-of-place (delete +
+ * insert of a new version), the summary is always a superset of the values
+ * of every version stored in the tile group, visible or not. This makes it
+ * safe for scans to skip a tile group whose summary rules out a predicate.
+ *
+ * Only fixed-length numeric and timestamp columns are summarized.
+ */
+class ZoneMap : public Printable {
+  ZoneMap() = delete;
+  ZoneMap(ZoneMap const &) = delete;
+
+ public:
+  // column types indexed by tile group column offset
+  ZoneMap(const std::vector<ValueType> &column_types);
+
+  ZoneMap &operator=(const ZoneMap &other);
+
+  // widen the summary with the values in the given tuple
+  void UpdateZoneMap(const Tuple *tuple);
+
+  // drop the summary of the given column
+  void InvalidateColumn(oid_t column_id);
+
+  // forget all the values seen so far
+  // used when all the slots in the tile group are reclaimed
+  void ResetZoneMap();
+
+  // can "column <comparison_type> value" be true for any tuple ?
+  bool CouldSatisfy(oid_t column_id, ExpressionType comparison_type,
+                    const Value &value) const;
+
+  // is the column summarized ?
+  bool IsValid(oid_t column_id) const;
+
+  Value GetMinValue(oid_t column_id) const;
+
+  Value GetMaxValue(oid_t column_id) const;
+
+  oid_t GetNullCount(oid_t column_id) const;
+
+  oid_t GetTupleCount() const;
+
+  // Get a string representation for debugging
+  const std::string GetInfo() const;
+
+ private:
+  // summary of a single column
+  struct ColumnZone {
+    // is this column summarized ?
+    bool valid;
+
+    // min and max of the non-null values seen so far
+    Value min_value;
+    Value max_value;
+
+    // number of nulls seen so far
+    oid_t null_count;
+  };
+
+  //===--------------------------------------------------------------------===//
+  // Data members
+  //===--------------------------------------------------------------------===//
+
+  std::vector<ColumnZone> column_zones;
+
+  // number of tuples summarized
+  oid_t tuple_count;
+
+  // synch helper
+  mutable Spinlock zone_map_lock;
+};
+
+}  // End storage namespace
+}  // End peloton namespace
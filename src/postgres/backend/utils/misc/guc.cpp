@@ -500,6 +500,15 @@ LoggingType     peloton_logging_mode;
 // Directory for peloton logs
 char    *peloton_log_directory;
 
+// Directory for peloton data files
+char    *peloton_data_directory;
+
+// Back in-memory data with huge pages
+bool    peloton_huge_pages;
+
+// Compress the cold tile groups
+bool    peloton_compression;
+
 /*
  * This really belongs in pg_shmem.c, but is defined here so that it doesn't
  * need to be duplicated in all the different implementations of pg_shmem.c.
@@ -1664,6 +1673,28 @@ struct config_bool ConfigureNamesBool[] =
 		NULL, NULL, NULL
 	},
 
+	// TODO: Peloton Changes
+	{
+		{"peloton_huge_pages", PGC_POSTMASTER, RESOURCES_MEM,
+			gettext_noop("Backs Peloton tables and indexes with huge pages."),
+			gettext_noop("Uses reserved huge pages if available, or else "
+						 "transparent huge pages.")
+		},
+		&peloton_huge_pages,
+		false,
+		NULL, NULL, NULL
+	},
+
+	{
+		{"peloton_compression", PGC_USERSET, PELOTON_LAYOUT_OPTIONS,
+			gettext_noop("Compresses the cold tile groups of Peloton tables."),
+			gettext_noop("Applies to the databases that are created later.")
+		},
+		&peloton_compression,
+		false,
+		NULL, NULL, NULL
+	},
+
 	/* End-of-list marker */
 	{
 		{NULL, static_cast<GucContext>(0), static_cast<config_group>(0), NULL, NULL}, NULL, false, NULL, NULL, NULL
@@ -3454,6 +3485,18 @@ struct config_string ConfigureNamesString[] =
     check_canonical_path, NULL, NULL
   },
 
+  {
+    {"peloton_data_directory", PGC_POSTMASTER, FILE_LOCATIONS,
+      gettext_noop("Sets the directory of the data files for Peloton."),
+      gettext_noop("Tables are stored in memory mapped files in this directory "
+                   "when it is specified. Must be specified as an absolute path."),
+      GUC_SUPERUSER_ONLY
+    },
+    &peloton_data_directory,
+    "",
+    check_canonical_path, NULL, NULL
+  },
+
 	/* End-of-list marker */
 	{
 		{NULL, static_cast<GucContext>(0), static_cast<config_group>(0), NULL, NULL}, NULL, NULL, NULL, NULL, NULL
@@ -0,0 +1,64 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// background_worker_test.cpp
+//
+// Identification: tests/common/background_worker_test.cpp
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <atomic>
+#include <thread>
+
+#include "gtest/gtest.h"
+#include "backend/common/background_worker.h"
+
+namespace peloton {
+namespace test {
+
+//===--------------------------------------------------------------------===//
+// Background Worker Test
+//===--------------------------------------------------------------------===//
+
+TEST(BackgroundWorkerTests, BasicTest) {
+  std::atomic<int> pass_count(0);
+  BackgroundWorker worker("Test worker", std::chrono::milliseconds(1),
+                          [&] { pass_count++; });
+  EXPECT_FALSE(worker.IsRunning());
+
+  // The passes run periodically
+  worker.Start();
+  worker.Start();
+  EXPECT_TRUE(worker.IsRunning());
+  while (pass_count < 3) std::this_thread::yield();
+
+  // No pass runs once the worker is stopped
+  worker.Stop();
+  worker.Stop();
+  EXPECT_FALSE(worker.IsRunning());
+  int stopped_pass_count = pass_count;
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  EXPECT_EQ(stopped_pass_count, pass_count);
+
+  // It can be started again
+  worker.Start();
+  while (pass_count < stopped_pass_count + 1) std::this_thread::yield();
+  worker.Stop();
+}
+
+TEST(BackgroundWorkerTests, StopTest) {
+  std::atomic<int> pass_count(0);
+  BackgroundWorker worker("Test worker", std::chrono::hours(1),
+                          [&] { pass_count++; });
+
+  // Stopping does not wait for the interval to pass
+  worker.Start();
+  worker.Stop();
+  EXPECT_EQ(0, pass_count);
+}
+
+}  // End test namespace
+}  // End peloton namespace
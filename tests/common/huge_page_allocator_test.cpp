@@ -0,0 +1,97 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// huge_page_allocator_test.cpp
+//
+// Identification: tests/common/huge_page_allocator_test.cpp
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "harness.h"
+
+#include "backend/common/huge_page_allocator.h"
+
+namespace peloton {
+namespace test {
+
+//===--------------------------------------------------------------------===//
+// Huge Page Allocator Test
+//===--------------------------------------------------------------------===//
+
+TEST(HugePageAllocatorTests, AllocateTest) {
+  auto &allocator = HugePageAllocator::GetInstance();
+
+  // Disabled by default, so everything comes from the heap
+  EXPECT_FALSE(allocator.IsEnabled());
+  void *heap_address = allocator.Allocate(1024);
+  EXPECT_EQ(0, allocator.GetAllocationCount());
+  allocator.Release(heap_address);
+
+  allocator.SetEnabled(true);
+
+  // Small allocations share a 2MB aligned arena
+  std::vector<char *> addresses;
+  for (int allocation_itr = 0; allocation_itr < 8; allocation_itr++) {
+    char *address = static_cast<char *>(allocator.Allocate(100 * 1024));
+    EXPECT_NE(nullptr, address);
+    EXPECT_EQ(0, reinterpret_cast<uintptr_t>(address) %
+                     HUGE_PAGE_ARENA_ALIGNMENT);
+    memset(address, allocation_itr, 100 * 1024);
+    addresses.push_back(address);
+  }
+  EXPECT_EQ(1, allocator.GetChunkCount());
+  EXPECT_LE(allocator.GetHugePageAllocationCount(),
+            allocator.GetAllocationCount());
+
+  // Large allocations get a chunk of their own
+  size_t large_size = 3 * HUGE_PAGE_SIZE + 1;
+  char *large_address = static_cast<char *>(allocator.Allocate(large_size));
+  EXPECT_EQ(0, reinterpret_cast<uintptr_t>(large_address) % HUGE_PAGE_SIZE);
+  memset(large_address, 1, large_size);
+  EXPECT_EQ(2, allocator.GetChunkCount());
+  EXPECT_EQ(9, allocator.GetAllocationCount());
+
+  // The allocations do not overlap
+  for (int allocation_itr = 0; allocation_itr < 8; allocation_itr++) {
+    EXPECT_EQ(allocation_itr, addresses[allocation_itr][100 * 1024 - 1]);
+  }
+
+  allocator.Release(large_address);
+  EXPECT_EQ(1, allocator.GetChunkCount());
+
+  // Heap allocations made while disabled can still be released
+  allocator.SetEnabled(false);
+  heap_address = allocator.Allocate(1024);
+  allocator.Release(heap_address);
+  allocator.SetEnabled(true);
+
+  // Fill up the arena, the full one is unmapped once released
+  while (allocator.GetChunkCount() == 1) {
+    addresses.push_back(static_cast<char *>(allocator.Allocate(100 * 1024)));
+  }
+  EXPECT_EQ(2, allocator.GetChunkCount());
+
+  char *last_address = addresses.back();
+  addresses.pop_back();
+  for (auto address : addresses) {
+    allocator.Release(address);
+  }
+  EXPECT_EQ(1, allocator.GetChunkCount());
+
+  // The current arena is kept
+  allocator.Release(last_address);
+  EXPECT_EQ(1, allocator.GetChunkCount());
+
+  allocator.SetEnabled(false);
+}
+
+}  // End test namespace
+}  // End peloton namespace
@@ -0,0 +1,135 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// pool_test.cpp
+//
+// Identification: tests/common/pool_test.cpp
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "harness.h"
+
+#include "backend/common/pool.h"
+
+namespace peloton {
+namespace test {
+
+//===--------------------------------------------------------------------===//
+// Pool Tests
+//===--------------------------------------------------------------------===//
+
+#define ALLOCATION_COUNT 1000
+#define ALLOCATION_SIZE 24
+
+std::mutex blocks_mutex;
+
+void AllocateBlocks(VarlenPool *pool, std::vector<char *> *blocks) {
+  std::vector<char *> local_blocks;
+
+  for (int itr = 0; itr < ALLOCATION_COUNT; itr++) {
+    char *block = reinterpret_cast<char *>(pool->Allocate(ALLOCATION_SIZE));
+    memset(block, itr % 128, ALLOCATION_SIZE);
+    local_blocks.push_back(block);
+  }
+
+  // Check that no other thread overwrote our blocks
+  for (int itr = 0; itr < ALLOCATION_COUNT; itr++) {
+    for (int byte = 0; byte < ALLOCATION_SIZE; byte++) {
+      EXPECT_EQ(itr % 128, local_blocks[itr][byte]);
+    }
+  }
+
+  std::lock_guard<std::mutex> lock(blocks_mutex);
+  blocks->insert(blocks->end(), local_blocks.begin(), local_blocks.end());
+}
+
+TEST(PoolTests, ParallelAllocateTest) {
+  VarlenPool pool(BACKEND_TYPE_MM);
+  std::vector<char *> blocks;
+  const int num_threads = 4;
+
+  LaunchParallelTest(num_threads, AllocateBlocks, &pool, &blocks);
+
+  // All blocks must be aligned and must not overlap
+  EXPECT_EQ(num_threads * ALLOCATION_COUNT, blocks.size());
+  std::sort(blocks.begin(), blocks.end());
+  for (size_t itr = 0; itr < blocks.size(); itr++) {
+    EXPECT_EQ(0, reinterpret_cast<uintptr_t>(blocks[itr]) % 8);
+    if (itr > 0) {
+      EXPECT_GE(blocks[itr] - blocks[itr - 1], ALLOCATION_SIZE);
+    }
+  }
+}
+
+TEST(PoolTests, FreeAndPurgeTest) {
+  VarlenPool pool(BACKEND_TYPE_MM);
+
+  void *small_block = pool.Allocate(10);
+  void *large_block = pool.Allocate(THREAD_SEGMENT_SIZE);
+  EXPECT_EQ(0, pool.GetFreedMemory());
+
+  // Freed sizes are rounded up to the alignment
+  pool.Free(small_block, 10);
+  EXPECT_EQ(16, pool.GetFreedMemory());
+
+  pool.Free(large_block, THREAD_SEGMENT_SIZE);
+  EXPECT_EQ(16 + THREAD_SEGMENT_SIZE, pool.GetFreedMemory());
+
+  // Oversize blocks get their own chunk
+  pool.Allocate(2 * TEMP_POOL_CHUNK_SIZE);
+  EXPECT_EQ(TEMP_POOL_CHUNK_SIZE + 2 * TEMP_POOL_CHUNK_SIZE,
+            pool.GetAllocatedMemory());
+
+  // Purge reclaims everything, and the thread gets a fresh segment
+  pool.Purge();
+  EXPECT_EQ(0, pool.GetFreedMemory());
+  EXPECT_EQ(TEMP_POOL_CHUNK_SIZE, pool.GetAllocatedMemory());
+
+  void *block = pool.Allocate(10);
+  EXPECT_EQ(small_block, block);
+}
+
+TEST(PoolTests, InterleavedPoolsTest) {
+  // More pools than the segments a thread caches
+  const size_t pool_count = 9;
+  std::vector<std::unique_ptr<VarlenPool>> pools;
+  for (size_t pool_itr = 0; pool_itr < pool_count; pool_itr++) {
+    pools.emplace_back(new VarlenPool(BACKEND_TYPE_MM));
+  }
+
+  // Two pools used in turn keep their segments, whatever their ids
+  VarlenPool *first_pool = pools.front().get();
+  VarlenPool *last_pool = pools.back().get();
+  for (int itr = 0; itr < ALLOCATION_COUNT; itr++) {
+    first_pool->Allocate(ALLOCATION_SIZE);
+    last_pool->Allocate(ALLOCATION_SIZE);
+  }
+  for (auto pool : {first_pool, last_pool}) {
+    EXPECT_EQ(TEMP_POOL_CHUNK_SIZE, pool->GetAllocatedMemory());
+    EXPECT_GT(THREAD_SEGMENT_SIZE, pool->GetFreedMemory());
+  }
+
+  // Using all of them in turn evicts the least recently used segment, and
+  // its unused tail is counted as freed in its pool
+  for (auto &pool : pools) pool->Purge();
+  for (size_t pool_itr = 0; pool_itr < pool_count; pool_itr++) {
+    pools[pool_itr]->Allocate(ALLOCATION_SIZE);
+  }
+  EXPECT_EQ(THREAD_SEGMENT_SIZE - ALLOCATION_SIZE,
+            first_pool->GetFreedMemory());
+  for (size_t pool_itr = 1; pool_itr < pool_count; pool_itr++) {
+    EXPECT_EQ(0, pools[pool_itr]->GetFreedMemory());
+  }
+}
+
+}  // End test namespace
+}  // End peloton namespace
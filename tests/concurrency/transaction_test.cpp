@@ -15,6 +15,7 @@
 #include "harness.h"
 #include "backend/concurrency/transaction_manager.h"
 #include "backend/concurrency/transaction.h"
+#include "backend/concurrency/write_set.h"
 
 namespace peloton {
 namespace test {
@@ -50,5 +51,158 @@ TEST(TransactionTests, TransactionTest) {
   std::cout << "Last Commit Id :: " << txn_manager.GetLastCommitId() << "\n";
 }
 
+void CommitTest(concurrency::TransactionManager *txn_manager) {
+  for (oid_t txn_itr = 1; txn_itr <= 1000; txn_itr++) {
+    auto txn = txn_manager->BeginTransaction();
+    cid_t snapshot_cid = txn->GetLastCommitId();
+    txn_manager->CommitTransaction();
+
+    // Snapshots never go back
+    auto next_txn = txn_manager->BeginTransaction();
+    EXPECT_LE(snapshot_cid, next_txn->GetLastCommitId());
+    txn_manager->AbortTransaction();
+  }
+}
+
+TEST(TransactionTests, CommitTest) {
+  auto &txn_manager = concurrency::TransactionManager::GetInstance();
+  const int thread_count = 16;
+
+  cid_t start_cid = txn_manager.GetLastCommitId();
+
+  LaunchParallelTest(thread_count, CommitTest, &txn_manager);
+
+  // Every commit is visible once all of them are done
+  EXPECT_EQ(start_cid + thread_count * 1000, txn_manager.GetLastCommitId());
+
+  // Commits keep getting consecutive cids
+  auto txn = txn_manager.BeginTransaction();
+  EXPECT_EQ(start_cid + thread_count * 1000, txn->GetLastCommitId());
+  txn_manager.CommitTransaction();
+  EXPECT_EQ(start_cid + thread_count * 1000 + 1,
+            txn_manager.GetLastCommitId());
+}
+
+TEST(TransactionTests, ReadOnlyTest) {
+  auto &txn_manager = concurrency::TransactionManager::GetInstance();
+
+  auto last_cid = txn_manager.GetLastCommitId();
+
+  auto txn = txn_manager.BeginReadOnlyTransaction();
+  EXPECT_TRUE(txn->IsReadOnly());
+  EXPECT_EQ(last_cid, txn->GetLastCommitId());
+  EXPECT_EQ(txn, txn_manager.GetTransaction(txn->GetTransactionId()));
+
+  // Its snapshot is protected while it runs
+  EXPECT_LE(txn_manager.GetOldestActiveCid(), last_cid);
+
+  auto txn_id = txn->GetTransactionId();
+  txn_manager.CommitTransaction();
+
+  // It did not take a commit id
+  EXPECT_EQ(last_cid, txn_manager.GetLastCommitId());
+  EXPECT_EQ(nullptr, txn_manager.GetTransaction(txn_id));
+  EXPECT_EQ(nullptr, concurrency::current_txn);
+
+  // A regular transaction reusing the object is not read-only
+  txn = txn_manager.BeginTransaction();
+  EXPECT_FALSE(txn->IsReadOnly());
+  txn_manager.CommitTransaction();
+  EXPECT_EQ(last_cid + 1, txn_manager.GetLastCommitId());
+}
+
+void RegistryTest(concurrency::TransactionManager *txn_manager) {
+  for (oid_t txn_itr = 1; txn_itr <= 1000; txn_itr++) {
+    auto txn = txn_manager->BeginTransaction();
+
+    // Our snapshot is never older than the low-water mark
+    EXPECT_LE(txn_manager->GetOldestActiveCid(), txn->GetLastCommitId());
+
+    txn_manager->CommitTransaction();
+  }
+}
+
+TEST(TransactionTests, RegistryTest) {
+  auto &txn_manager = concurrency::TransactionManager::GetInstance();
+
+  auto txn = txn_manager.BeginTransaction();
+  auto snapshot_cid = txn->GetLastCommitId();
+
+  // A nested txn falls back to the txn table
+  auto nested_txn = txn_manager.BeginTransaction();
+  EXPECT_EQ(txn, txn_manager.GetTransaction(txn->GetTransactionId()));
+  EXPECT_EQ(nested_txn,
+            txn_manager.GetTransaction(nested_txn->GetTransactionId()));
+  EXPECT_EQ(2, txn_manager.GetCurrentTransactions().size());
+
+  // The outer txn holds back the low-water mark
+  txn_manager.CommitTransaction();
+  EXPECT_LT(snapshot_cid, txn_manager.GetLastCommitId());
+  EXPECT_EQ(snapshot_cid, txn_manager.GetOldestActiveCid());
+
+  concurrency::current_txn = txn;
+  txn_manager.CommitTransaction();
+  EXPECT_EQ(txn_manager.GetLastCommitId(), txn_manager.GetOldestActiveCid());
+  EXPECT_EQ(0, txn_manager.GetCurrentTransactions().size());
+
+  LaunchParallelTest(8, RegistryTest, &txn_manager);
+
+  EXPECT_EQ(txn_manager.GetLastCommitId(), txn_manager.GetOldestActiveCid());
+}
+
+TEST(TransactionTests, PoolTest) {
+  auto &txn_manager = concurrency::TransactionManager::GetInstance();
+
+  auto txn = txn_manager.BeginTransaction();
+  EXPECT_EQ(0, reinterpret_cast<uintptr_t>(txn) % 64);
+  auto txn_id = txn->GetTransactionId();
+  txn->SetResult(RESULT_FAILURE);
+  txn_manager.CommitTransaction();
+
+  // The next transaction of this thread reuses the recycled object
+  auto next_txn = txn_manager.BeginTransaction();
+  EXPECT_EQ(txn, next_txn);
+  EXPECT_NE(txn_id, next_txn->GetTransactionId());
+  EXPECT_EQ(INVALID_CID, next_txn->GetCommitId());
+  EXPECT_EQ(RESULT_SUCCESS, next_txn->GetResult());
+  txn_manager.AbortTransaction();
+}
+
+TEST(TransactionTests, WriteSetTest) {
+  concurrency::WriteSet write_set;
+
+  // Interleave enough tile groups to grow the group index
+  const oid_t tile_group_count = 3 * WRITE_SET_INDEX_SIZE;
+  const oid_t tuple_count = 4;
+  for (oid_t tuple_itr = 0; tuple_itr < tuple_count; tuple_itr++) {
+    for (oid_t tile_group_itr = 0; tile_group_itr < tile_group_count;
+         tile_group_itr++) {
+      write_set.Add(ItemPointer(tile_group_itr * 7, tuple_itr));
+    }
+  }
+
+  EXPECT_EQ(tile_group_count * tuple_count, write_set.GetSize());
+  EXPECT_EQ(tile_group_count, write_set.GetGroupCount());
+
+  // The locations come out one tile group at a time, in order
+  oid_t visit_count = 0;
+  write_set.ForEach([&](oid_t block, oid_t tuple_slot) {
+    EXPECT_EQ((visit_count / tuple_count) * 7, block);
+    EXPECT_EQ(visit_count % tuple_count, tuple_slot);
+    visit_count++;
+  });
+  EXPECT_EQ(tile_group_count * tuple_count, visit_count);
+
+  // Clear and reuse
+  write_set.Clear();
+  EXPECT_TRUE(write_set.IsEmpty());
+  EXPECT_EQ(0, write_set.GetGroupCount());
+
+  write_set.Add(ItemPointer(7, 1));
+  write_set.Add(ItemPointer(7, 2));
+  EXPECT_EQ(2, write_set.GetSize());
+  EXPECT_EQ(1, write_set.GetGroupCount());
+}
+
 }  // End test namespace
 }  // End peloton namespace
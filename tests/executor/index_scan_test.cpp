@@ -23,6 +23,7 @@
 #include "backend/executor/index_scan_executor.h"
 #include "backend/storage/data_table.h"
 #include "backend/common/value_factory.h"
+#include "backend/common/value_peeker.h"
 
 #include "executor/executor_tests_util.h"
 #include "harness.h"
@@ -160,5 +161,49 @@ TEST(IndexScanTests, MultiColumnPredicateTest) {
   txn_manager.CommitTransaction();
 }
 
+// Point lookup of a key that is not the smallest one.
+TEST(IndexScanTests, PointLookupTest) {
+  std::unique_ptr<storage::DataTable> data_table(
+      ExecutorTestsUtil::CreateAndPopulateTable());
+
+  std::vector<oid_t> column_ids({0, 1, 3});
+
+  //===--------------------------------------------------------------------===//
+  // ATTR 0 = 110
+  //===--------------------------------------------------------------------===//
+
+  auto index = data_table->GetIndex(0);
+  std::vector<oid_t> key_column_ids({0});
+  std::vector<ExpressionType> expr_types(
+      {ExpressionType::EXPRESSION_TYPE_COMPARE_EQUAL});
+  std::vector<Value> values({ValueFactory::GetIntegerValue(110)});
+  std::vector<expression::AbstractExpression *> runtime_keys;
+
+  planner::IndexScanPlan::IndexScanDesc index_scan_desc(
+      index, key_column_ids, expr_types, values, runtime_keys);
+
+  planner::IndexScanPlan node(data_table.get(), nullptr, column_ids,
+                              index_scan_desc);
+
+  auto &txn_manager = concurrency::TransactionManager::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  std::unique_ptr<executor::ExecutorContext> context(
+      new executor::ExecutorContext(txn));
+
+  executor::IndexScanExecutor executor(&node, context.get());
+
+  EXPECT_TRUE(executor.Init());
+  EXPECT_TRUE(executor.Execute());
+
+  std::unique_ptr<executor::LogicalTile> result_tile(executor.GetOutput());
+  EXPECT_THAT(result_tile, NotNull());
+  EXPECT_EQ(result_tile->GetTupleCount(), 1);
+  EXPECT_EQ(ValuePeeker::PeekAsInteger(result_tile->GetValue(0, 0)), 110);
+
+  EXPECT_FALSE(executor.Execute());
+
+  txn_manager.CommitTransaction();
+}
+
 }  // namespace test
 }  // namespace peloton
@@ -21,6 +21,7 @@
 #include "backend/planner/seq_scan_plan.h"
 
 #include "backend/catalog/schema.h"
+#include "backend/common/numa_manager.h"
 #include "backend/common/types.h"
 #include "backend/common/value.h"
 #include "backend/common/value_factory.h"
@@ -34,6 +35,7 @@
 #include "backend/expression/expression_util.h"
 #include "backend/storage/data_table.h"
 #include "backend/storage/tile_group_factory.h"
+#include "backend/storage/zone_map.h"
 
 #include "executor/executor_tests_util.h"
 #include "executor/mock_executor.h"
@@ -311,6 +313,120 @@ TEST(SeqScanTests, NonLeafNodePredicateTest) {
 
   txn_manager.CommitTransaction();
 }
+
+// Sequential scan of table with a range predicate that rules out all but
+// the last tile group using the zone maps.
+TEST(SeqScanTests, ZoneMapPruningTest) {
+  const int tuple_count = TESTS_TUPLES_PER_TILEGROUP;
+
+  auto &txn_manager = concurrency::TransactionManager::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  std::unique_ptr<storage::DataTable> table(
+      ExecutorTestsUtil::CreateTable(tuple_count, false));
+  ExecutorTestsUtil::PopulateTable(txn, table.get(), 3 * tuple_count, false,
+                                   false, false);
+  txn_manager.CommitTransaction();
+
+  // Check the zone map of the first tile group
+  auto zone_map = table->GetTileGroup(0)->GetZoneMap();
+  EXPECT_EQ(tuple_count, zone_map->GetTupleCount());
+  EXPECT_EQ(ValueFactory::GetIntegerValue(
+                ExecutorTestsUtil::PopulatedValue(0, 0)),
+            zone_map->GetMinValue(0));
+  EXPECT_EQ(ValueFactory::GetIntegerValue(
+                ExecutorTestsUtil::PopulatedValue(tuple_count - 1, 0)),
+            zone_map->GetMaxValue(0));
+  EXPECT_EQ(0, zone_map->GetNullCount(0));
+
+  // Varchar columns are not summarized
+  EXPECT_FALSE(zone_map->IsValid(3));
+
+  // WHERE a >= <first value in last tile group>
+  expression::AbstractExpression *predicate = expression::ComparisonFactory(
+      EXPRESSION_TYPE_COMPARE_GREATERTHANOREQUALTO,
+      expression::TupleValueFactory(0, 0),
+      expression::ConstantValueFactory(ValueFactory::GetIntegerValue(
+          ExecutorTestsUtil::PopulatedValue(2 * tuple_count, 0))));
+
+  std::vector<oid_t> column_ids({0, 1});
+  planner::SeqScanPlan node(table.get(), predicate, column_ids);
+
+  txn = txn_manager.BeginTransaction();
+  std::unique_ptr<executor::ExecutorContext> context(
+      new executor::ExecutorContext(txn));
+
+  executor::SeqScanExecutor executor(&node, context.get());
+  EXPECT_TRUE(executor.Init());
+
+  // The first two tile groups are skipped without being scanned
+  std::unique_ptr<executor::LogicalTile> result_tile(GetNextTile(executor));
+  EXPECT_EQ(2, executor.GetSkippedTileGroupCount());
+  EXPECT_EQ(tuple_count, result_tile->GetTupleCount());
+  EXPECT_EQ(ExecutorTestsUtil::PopulatedValue(2 * tuple_count, 0),
+            result_tile->GetValue(0, 0).GetIntegerForTestsOnly());
+  EXPECT_FALSE(executor.Execute());
+  EXPECT_EQ(2, executor.GetSkippedTileGroupCount());
+
+  txn_manager.CommitTransaction();
+}
+
+// Sequential scan of a table whose tile groups are placed round robin on
+// the NUMA nodes. Each range of tile groups on the same node is scanned on
+// that node, and the thread gets its cpus back after the scan.
+TEST(SeqScanTests, NumaRangeTest) {
+  const int tuple_count = TESTS_TUPLES_PER_TILEGROUP;
+  const int tile_group_count = 4;
+
+  auto &numa_manager = NumaManager::GetInstance();
+  auto placement_type = numa_manager.GetPlacementType();
+  numa_manager.SetPlacementType(NUMA_PLACEMENT_TYPE_ROUND_ROBIN);
+
+  auto &txn_manager = concurrency::TransactionManager::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  std::unique_ptr<storage::DataTable> table(
+      ExecutorTestsUtil::CreateTable(tuple_count, false));
+  ExecutorTestsUtil::PopulateTable(txn, table.get(),
+                                   tile_group_count * tuple_count, false,
+                                   false, false);
+  txn_manager.CommitTransaction();
+  numa_manager.SetPlacementType(placement_type);
+
+  // Count the ranges of tile groups on the same node
+  oid_t expected_range_count = 0;
+  int last_node = -1;
+  for (oid_t offset = 0; offset < table->GetTileGroupCount(); offset++) {
+    int node = table->GetTileGroup(offset)->GetNumaNode();
+    if (node != last_node) expected_range_count++;
+    last_node = node;
+  }
+
+  cpu_set_t cpus_before;
+  ASSERT_TRUE(numa_manager.GetThreadCpus(cpus_before));
+
+  std::vector<oid_t> column_ids({0, 1});
+  planner::SeqScanPlan node(table.get(), nullptr, column_ids);
+
+  txn = txn_manager.BeginTransaction();
+  std::unique_ptr<executor::ExecutorContext> context(
+      new executor::ExecutorContext(txn));
+
+  executor::SeqScanExecutor executor(&node, context.get());
+  EXPECT_TRUE(executor.Init());
+
+  size_t scanned_tuple_count = 0;
+  while (executor.Execute()) {
+    std::unique_ptr<executor::LogicalTile> result_tile(executor.GetOutput());
+    scanned_tuple_count += result_tile->GetTupleCount();
+  }
+  EXPECT_EQ(tile_group_count * tuple_count, scanned_tuple_count);
+  EXPECT_EQ(expected_range_count, executor.GetNumaRangeCount());
+
+  cpu_set_t cpus_after;
+  ASSERT_TRUE(numa_manager.GetThreadCpus(cpus_after));
+  EXPECT_TRUE(CPU_EQUAL(&cpus_before, &cpus_after));
+
+  txn_manager.CommitTransaction();
+}
 }
 
 }  // namespace test
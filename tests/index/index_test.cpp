@@ -90,6 +90,10 @@ TEST(IndexTests, BasicTest) {
 
   key0->SetValue(1, ValueFactory::GetStringValue("a"), pool);
 
+  // EMPTY
+  locations = index->ScanKey(key0.get());
+  EXPECT_EQ(locations.size(), 0);
+
   // INSERT
   index->InsertEntry(key0.get(), item0);
 
@@ -1,9 +1,22 @@
 #include "gtest/gtest.h"
+#include "harness.h"
 
 #include "logging/logging_tests_util.h"
+#include "backend/catalog/schema.h"
 #include "backend/common/logger.h"
+#include "backend/common/value_factory.h"
+#include "backend/logging/log_manager.h"
+#include "backend/logging/log_buffer.h"
+#include "backend/logging/log_reader.h"
+#include "backend/logging/log_file.h"
+#include "backend/logging/records/transaction_record.h"
+#include "backend/logging/records/tuple_record.h"
+#include "backend/storage/tuple.h"
 
+#include <fcntl.h>
+#include <unistd.h>
 #include <fstream>
+#include <thread>
 
 //===--------------------------------------------------------------------===//
 // GUC Variables
@@ -63,6 +76,654 @@ TEST(LoggingTests, RecoveryTest) {
   }
 }
 
+/**
+ * @brief writing a log with synchronous group commits and then do recovery
+ */
+TEST(LoggingTests, GroupCommitTest) {
+  peloton_logging_mode = state.logging_type;
+  peloton_data_file_size = state.data_file_size;
+  peloton_wait_timeout = state.wait_timeout;
+
+  if (IsSimilarToARIES(peloton_logging_mode) == false) return;
+
+  auto& log_manager = logging::LogManager::GetInstance();
+  log_manager.SetSyncCommit(true);
+  log_manager.SetGroupCommit(true);
+  log_manager.ResetFlushStats();
+
+  // A few backends commit at the same time
+  auto tuple_count = state.tuple_count;
+  auto backend_count = state.backend_count;
+  state.backend_count = 4;
+  state.tuple_count = 100;
+
+  // Every backend inserts, updates and deletes each of its tuples in a txn
+  size_t commit_count =
+      3 * (state.tuple_count / state.backend_count) * state.backend_count;
+
+  LoggingTestsUtil::ResetSystem();
+
+  // Every commit waits for its record to be durable
+  EXPECT_TRUE(LoggingTestsUtil::PrepareLogFile(aries_log_file_name));
+
+  // The commits of the backends are flushed together
+  EXPECT_GT(log_manager.GetFlushCount(), 0);
+  EXPECT_LT(log_manager.GetFlushCount(), commit_count);
+  EXPECT_GE(log_manager.GetFlushedRecordCount(), commit_count);
+
+  LoggingTestsUtil::ResetSystem();
+
+  LoggingTestsUtil::DoRecovery(aries_log_file_name);
+
+  state.tuple_count = tuple_count;
+  state.backend_count = backend_count;
+
+  log_manager.SetSyncCommit(false);
+  log_manager.SetGroupCommit(false);
+}
+
+/**
+ * @brief replay a log with a few recovery threads
+ */
+TEST(LoggingTests, ParallelRecoveryTest) {
+  peloton_logging_mode = state.logging_type;
+  peloton_data_file_size = state.data_file_size;
+  peloton_wait_timeout = state.wait_timeout;
+
+  if (IsSimilarToARIES(peloton_logging_mode) == false) return;
+
+  auto& log_manager = logging::LogManager::GetInstance();
+
+  const oid_t txn_count = 100;
+  const oid_t tile_group_count = 8;
+  auto expected_tuple_count = LoggingTestsUtil::PrepareRedoLogFile(
+      aries_log_file_name, txn_count, tile_group_count);
+
+  // One thread, and then more threads than tile groups
+  for (size_t thread_count : {1, 4, 16}) {
+    log_manager.SetRecoveryThreadCount(thread_count);
+    LoggingTestsUtil::ResetSystem();
+
+    EXPECT_EQ(expected_tuple_count,
+              LoggingTestsUtil::DoRecovery(aries_log_file_name));
+  }
+
+  log_manager.SetRecoveryThreadCount(0);
+}
+
+/**
+ * @brief recover from a checkpoint and the log after it
+ */
+TEST(LoggingTests, CheckpointTest) {
+  peloton_logging_mode = state.logging_type;
+  peloton_data_file_size = state.data_file_size;
+  peloton_wait_timeout = state.wait_timeout;
+
+  if (IsSimilarToARIES(peloton_logging_mode) == false) return;
+
+  auto expected_tuples =
+      LoggingTestsUtil::PrepareCheckpointLogFile(aries_log_file_name);
+  EXPECT_EQ(10, expected_tuples.size());
+
+  LoggingTestsUtil::ResetSystem();
+
+  // The tuples of the checkpoint come back with their values
+  std::vector<std::string> recovered_tuples;
+  EXPECT_EQ(expected_tuples.size(),
+            LoggingTestsUtil::DoRecovery(aries_log_file_name,
+                                         &recovered_tuples));
+  EXPECT_EQ(expected_tuples, recovered_tuples);
+}
+
+/**
+ * @brief recover the updates that only logged their changed columns, with
+ * and without compressing the log
+ */
+TEST(LoggingTests, DeltaUpdateTest) {
+  peloton_logging_mode = state.logging_type;
+  peloton_data_file_size = state.data_file_size;
+  peloton_wait_timeout = state.wait_timeout;
+
+  if (IsSimilarToARIES(peloton_logging_mode) == false) return;
+
+  auto& log_manager = logging::LogManager::GetInstance();
+  std::vector<size_t> log_sizes;
+
+  for (bool log_compression : {false, true}) {
+    log_manager.SetLogCompression(log_compression);
+
+    LoggingTestsUtil::ResetSystem();
+    auto expected_tuples =
+        LoggingTestsUtil::PrepareDeltaLogFile(aries_log_file_name);
+    EXPECT_FALSE(expected_tuples.empty());
+
+    logging::LogFile log_file(log_manager.GetLogFileName(), false);
+    EXPECT_TRUE(log_file.Open());
+    log_sizes.push_back(log_file.GetLogEnd());
+
+    LoggingTestsUtil::ResetSystem();
+
+    std::vector<std::string> recovered_tuples;
+    LoggingTestsUtil::DoRecovery(aries_log_file_name, &recovered_tuples);
+    EXPECT_EQ(expected_tuples, recovered_tuples);
+  }
+
+  // The tuples have long runs of the same character
+  EXPECT_LT(log_sizes[1], log_sizes[0]);
+
+  log_manager.SetLogCompression(false);
+}
+
+/**
+ * @brief log through several frontend loggers, with and without group
+ * commit, and recover their log streams, also with another number of
+ * frontend loggers
+ */
+TEST(LoggingTests, MultipleFrontendLoggersTest) {
+  peloton_logging_mode = state.logging_type;
+  peloton_data_file_size = state.data_file_size;
+  peloton_wait_timeout = state.wait_timeout;
+
+  if (IsSimilarToARIES(peloton_logging_mode) == false) return;
+
+  auto& log_manager = logging::LogManager::GetInstance();
+  const size_t frontend_logger_count = 4;
+  log_manager.SetFrontendLoggerCount(frontend_logger_count);
+  log_manager.SetSyncCommit(true);
+
+  for (bool group_commit : {false, true}) {
+    log_manager.SetGroupCommit(group_commit);
+
+    LoggingTestsUtil::ResetSystem();
+    auto expected_tuples = LoggingTestsUtil::PrepareStreamLogFile(
+        aries_log_file_name, frontend_logger_count);
+    EXPECT_FALSE(expected_tuples.empty());
+
+    // Every stream has a part of the log
+    for (oid_t logger_id = 0; logger_id < frontend_logger_count; logger_id++) {
+      logging::LogFile log_file(log_manager.GetLogFileName(logger_id), false);
+      EXPECT_TRUE(log_file.Open());
+      EXPECT_GT(log_file.GetLogEnd(), 0);
+    }
+
+    LoggingTestsUtil::ResetSystem();
+
+    std::vector<std::string> recovered_tuples;
+    LoggingTestsUtil::DoRecovery(aries_log_file_name, &recovered_tuples);
+    EXPECT_EQ(expected_tuples, recovered_tuples);
+  }
+
+  log_manager.SetGroupCommit(false);
+
+  // A log of a single stream, recovered by several frontend loggers
+  log_manager.SetFrontendLoggerCount(1);
+  LoggingTestsUtil::ResetSystem();
+  auto expected_tuples =
+      LoggingTestsUtil::PrepareStreamLogFile(aries_log_file_name, 4);
+
+  log_manager.SetFrontendLoggerCount(frontend_logger_count);
+  LoggingTestsUtil::ResetSystem();
+  std::vector<std::string> recovered_tuples;
+  LoggingTestsUtil::DoRecovery(aries_log_file_name, &recovered_tuples);
+  EXPECT_EQ(expected_tuples, recovered_tuples);
+
+  // The log of several streams, recovered by a single frontend logger
+  LoggingTestsUtil::ResetSystem();
+  expected_tuples = LoggingTestsUtil::PrepareStreamLogFile(
+      aries_log_file_name, frontend_logger_count);
+
+  log_manager.SetFrontendLoggerCount(1);
+  LoggingTestsUtil::ResetSystem();
+  LoggingTestsUtil::DoRecovery(aries_log_file_name, &recovered_tuples);
+  EXPECT_EQ(expected_tuples, recovered_tuples);
+
+  // The recovery checkpointed the retired streams, and removed them
+  EXPECT_FALSE(logging::LogFile::Exists(log_manager.GetLogFileName(1)));
+  LoggingTestsUtil::ResetSystem();
+  LoggingTestsUtil::DoRecovery(aries_log_file_name, &recovered_tuples);
+  EXPECT_EQ(expected_tuples, recovered_tuples);
+
+  log_manager.SetFrontendLoggerCount(FRONTEND_LOGGER_COUNT);
+  log_manager.SetSyncCommit(false);
+}
+
+/**
+ * @brief pass records through a log buffer that wraps around a few times
+ */
+TEST(LoggingTests, LogBufferTest) {
+  logging::LogBuffer log_buffer;
+
+  // Enough records to go around the ring a few times
+  const txn_id_t record_count = 1000000;
+  const size_t batch_size = 7;
+
+  std::thread producer([&log_buffer, record_count, batch_size] {
+    for (txn_id_t txn_id = 1; txn_id <= record_count; txn_id++) {
+      logging::TransactionRecord record(LOGRECORD_TYPE_TRANSACTION_COMMIT,
+                                        txn_id);
+      log_buffer.Append(&record);
+      if (txn_id % batch_size == 0) log_buffer.Publish();
+    }
+    log_buffer.Publish();
+  });
+
+  std::string collected_bytes;
+  size_t collected_record_count = 0;
+  while (collected_record_count < record_count) {
+    std::vector<struct iovec> spans;
+    collected_record_count += log_buffer.Collect(spans);
+    for (auto span : spans) {
+      collected_bytes.append(static_cast<char*>(span.iov_base), span.iov_len);
+    }
+    log_buffer.Release();
+  }
+
+  producer.join();
+
+  EXPECT_EQ(collected_record_count, record_count);
+  EXPECT_TRUE(log_buffer.IsEmpty());
+
+  // The records come out in order, without the padding
+  ReferenceSerializeInputBE input(collected_bytes.data(),
+                                  collected_bytes.size());
+  for (txn_id_t txn_id = 1; txn_id <= record_count; txn_id++) {
+    EXPECT_EQ(input.ReadEnumInSingleByte(), LOGRECORD_TYPE_TRANSACTION_COMMIT);
+    input.ReadInt();
+    ASSERT_EQ(input.ReadLong(), txn_id);
+  }
+  EXPECT_FALSE(input.HasRemaining());
+}
+
+/**
+ * @brief log records that are too large for the log buffer, close to the
+ * end of the ring and through the backend logger
+ */
+TEST(LoggingTests, LargeRecordTest) {
+  // A tuple whose record takes more than a quarter of a log buffer
+  catalog::Schema schema(
+      {catalog::Column(VALUE_TYPE_INTEGER, GetTypeSize(VALUE_TYPE_INTEGER),
+                       "key", true),
+       catalog::Column(VALUE_TYPE_VARCHAR, LOG_BUFFER_SIZE, "value", false)});
+  auto testing_pool = TestingHarness::GetInstance().GetTestingPool();
+  storage::Tuple tuple(&schema, true);
+  tuple.SetValue(0, ValueFactory::GetIntegerValue(1), testing_pool);
+  tuple.SetValue(1, ValueFactory::GetStringValue(
+                        std::string(LOG_BUFFER_SIZE / 2, 'x'), testing_pool),
+                 testing_pool);
+  logging::TupleRecord large_record(LOGRECORD_TYPE_ARIES_TUPLE_INSERT, 1, 1,
+                                    ItemPointer(1, 0), INVALID_ITEMPOINTER,
+                                    &tuple, 1);
+
+  // Move close to the end of the ring, where the large record would be
+  // moved to the front
+  logging::LogBuffer log_buffer;
+  logging::TransactionRecord small_record(LOGRECORD_TYPE_TRANSACTION_COMMIT,
+                                          1);
+  std::vector<struct iovec> spans;
+  while (log_buffer.GetAppendedPosition() % LOG_BUFFER_SIZE <
+         LOG_BUFFER_SIZE - 64) {
+    EXPECT_TRUE(log_buffer.Append(&small_record));
+    log_buffer.Publish();
+    spans.clear();
+    log_buffer.Collect(spans);
+    log_buffer.Release();
+  }
+
+  // The large record is turned down, and leaves no padding behind
+  auto appended_position = log_buffer.GetAppendedPosition();
+  EXPECT_FALSE(log_buffer.Append(&large_record));
+  EXPECT_EQ(log_buffer.GetAppendedPosition(), appended_position);
+
+  EXPECT_TRUE(log_buffer.Append(&small_record));
+  log_buffer.Publish();
+  spans.clear();
+  EXPECT_EQ(log_buffer.Collect(spans), 1);
+  size_t collected_size = 0;
+  for (auto span : spans) {
+    collected_size += span.iov_len;
+  }
+  CopySerializeOutput output;
+  small_record.Serialize(output);
+  EXPECT_EQ(collected_size, small_record.GetMessageLength());
+  log_buffer.Release();
+
+  // The backend logger hands the large record over in its own message,
+  // in order with the records around it
+  peloton_logging_mode = state.logging_type;
+  if (IsSimilarToARIES(peloton_logging_mode) == false) return;
+
+  // A record larger than a log segment gets a segment of its own, and is
+  // not compressed
+  auto& log_manager = logging::LogManager::GetInstance();
+  for (bool log_compression : {false, true}) {
+    log_manager.SetLogCompression(log_compression);
+
+    for (size_t value_size : {LOG_BUFFER_SIZE / 2, LOG_SEGMENT_SIZE + 1024}) {
+      auto logged_records = LoggingTestsUtil::PrepareLargeRecordLogFile(
+          aries_log_file_name, value_size);
+      ASSERT_EQ(logged_records.size(), 3);
+      EXPECT_EQ(logged_records[0].first, LOGRECORD_TYPE_TRANSACTION_BEGIN);
+      EXPECT_EQ(logged_records[1].first, LOGRECORD_TYPE_ARIES_TUPLE_INSERT);
+      EXPECT_GT(logged_records[1].second, value_size);
+      EXPECT_EQ(logged_records[2].first, LOGRECORD_TYPE_TRANSACTION_COMMIT);
+    }
+  }
+
+  log_manager.SetLogCompression(false);
+}
+
+/**
+ * @brief read a log that ends with a torn record, from a few offsets
+ */
+TEST(LoggingTests, LogReaderTest) {
+  std::string log_file_name = "log_reader.log";
+  FILE* log_file = fopen(log_file_name.c_str(), "wb");
+  ASSERT_TRUE(log_file != nullptr);
+
+  CopySerializeOutput output_buffer;
+  // Write the record, without its last bytes if needed
+  auto write_record = [&](logging::LogRecord& record, size_t cut_size) {
+    record.Serialize(output_buffer);
+    fwrite(record.GetMessage(), sizeof(char),
+           record.GetMessageLength() - cut_size, log_file);
+  };
+
+  // Every txn deletes a tuple, the last one is torn
+  const txn_id_t txn_count = 1000;
+  for (txn_id_t txn_id = 1; txn_id <= txn_count; txn_id++) {
+    logging::TransactionRecord begin_record(LOGRECORD_TYPE_TRANSACTION_BEGIN,
+                                            txn_id);
+    write_record(begin_record, 0);
+    logging::TupleRecord delete_record(LOGRECORD_TYPE_ARIES_TUPLE_DELETE,
+                                       txn_id, 1, INVALID_ITEMPOINTER,
+                                       ItemPointer(txn_id, 0), nullptr, 1);
+    write_record(delete_record, 0);
+  }
+  logging::TransactionRecord torn_record(LOGRECORD_TYPE_TRANSACTION_COMMIT,
+                                         txn_count);
+  write_record(torn_record, 1);
+  fclose(log_file);
+
+  int log_file_fd = open(log_file_name.c_str(), O_RDONLY);
+  ASSERT_NE(log_file_fd, -1);
+  struct stat log_stats;
+  fstat(log_file_fd, &log_stats);
+  size_t log_size = log_stats.st_size;
+
+  // Read the whole log
+  std::vector<size_t> record_offsets;
+  {
+    logging::LogReader log_reader(log_file_fd, 0, log_size);
+    EXPECT_TRUE(log_reader.IsValid());
+
+    logging::RawLogRecord record;
+    while (log_reader.ReadRecord(record)) {
+      EXPECT_EQ(record.offset, log_reader.GetOffset() - 1 -
+                                   record.header_size - record.body_size);
+      record_offsets.push_back(record.offset);
+    }
+    EXPECT_EQ(record_offsets.size(), txn_count * 2);
+
+    // It stops before the torn record
+    EXPECT_EQ(log_reader.GetOffset(),
+              log_size - torn_record.GetMessageLength() + 1);
+
+    // Go back to a delete
+    EXPECT_TRUE(log_reader.Seek(record_offsets[3]));
+    ASSERT_TRUE(log_reader.ReadRecord(record));
+    EXPECT_EQ(record.type, LOGRECORD_TYPE_ARIES_TUPLE_DELETE);
+    ReferenceSerializeInputBE header(record.header, record.header_size);
+    logging::TupleRecord tuple_record(record.type);
+    tuple_record.DeserializeHeader(header);
+    EXPECT_EQ(tuple_record.GetTransactionId(), 2);
+    EXPECT_EQ(tuple_record.GetDeleteLocation().block, 2);
+  }
+
+  // Read the second half, that does not start at a page boundary
+  {
+    auto log_start = record_offsets[txn_count];
+    logging::LogReader log_reader(log_file_fd, log_start, log_size);
+    EXPECT_FALSE(log_reader.Seek(log_start - 1));
+
+    size_t record_count = 0;
+    logging::RawLogRecord record;
+    while (log_reader.ReadRecord(record)) {
+      EXPECT_EQ(record.offset, record_offsets[txn_count + record_count]);
+      record_count++;
+    }
+    EXPECT_EQ(record_count, txn_count);
+  }
+
+  close(log_file_fd);
+  std::remove(log_file_name.c_str());
+}
+
+/**
+ * @brief write a log over a few segments, and read it back
+ */
+TEST(LoggingTests, LogFileTest) {
+  std::string log_file_name = "log_file.log";
+
+  // A span of txns that each delete a tuple
+  CopySerializeOutput output_buffer;
+  std::vector<char> span;
+  size_t span_record_count = 0;
+  for (txn_id_t txn_id = 1; span.size() < 1024 * 1024 - 1024; txn_id++) {
+    logging::TransactionRecord begin_record(LOGRECORD_TYPE_TRANSACTION_BEGIN,
+                                            txn_id);
+    begin_record.Serialize(output_buffer);
+    span.insert(span.end(), begin_record.GetMessage(),
+                begin_record.GetMessage() + begin_record.GetMessageLength());
+    logging::TupleRecord delete_record(LOGRECORD_TYPE_ARIES_TUPLE_DELETE,
+                                       txn_id, 1, INVALID_ITEMPOINTER,
+                                       ItemPointer(txn_id, 0), nullptr, 1);
+    delete_record.Serialize(output_buffer);
+    span.insert(span.end(), delete_record.GetMessage(),
+                delete_record.GetMessage() + delete_record.GetMessageLength());
+    span_record_count += 2;
+  }
+
+  // Write the spans a few at a time
+  auto write_spans = [&](logging::LogFile& log_file, size_t span_count) {
+    for (size_t span_itr = 0; span_itr < span_count; span_itr += 4) {
+      std::vector<struct iovec> spans(std::min<size_t>(4, span_count - span_itr),
+                                      {span.data(), span.size()});
+      EXPECT_TRUE(log_file.Write(spans));
+    }
+    EXPECT_TRUE(log_file.Sync());
+  };
+
+  // The spans that do not fit in a segment go to the next one
+  const size_t span_count = 40;
+  size_t spans_per_segment = LOG_SEGMENT_SIZE / span.size();
+  auto get_span_offset = [&](size_t span_itr) {
+    return (span_itr / spans_per_segment) * LOG_SEGMENT_SIZE +
+           (span_itr % spans_per_segment) * span.size();
+  };
+
+  for (bool direct_io : {false, true}) {
+    logging::LogFile::Remove(log_file_name);
+
+    {
+      logging::LogFile log_file(log_file_name, direct_io);
+      ASSERT_TRUE(log_file.Open());
+      EXPECT_EQ(log_file.GetLogEnd(), 0);
+
+      write_spans(log_file, span_count);
+      EXPECT_EQ(log_file.GetLogEnd(),
+                get_span_offset(span_count - 1) + span.size());
+    }
+
+    // Reopen the log, and find its end
+    logging::LogFile log_file(log_file_name, direct_io);
+    ASSERT_TRUE(log_file.Open());
+    EXPECT_EQ(log_file.GetLogStart(), 0);
+    EXPECT_EQ(log_file.GetLogEnd(),
+              get_span_offset(span_count - 1) + span.size());
+
+    // Read the whole log, over the ends of the segments
+    std::vector<size_t> record_offsets;
+    {
+      logging::LogReader log_reader(log_file, log_file.GetLogStart(),
+                                    log_file.GetLogEnd());
+      EXPECT_TRUE(log_reader.IsValid());
+
+      logging::RawLogRecord record;
+      while (log_reader.ReadRecord(record)) {
+        record_offsets.push_back(record.offset);
+      }
+      EXPECT_EQ(log_reader.GetOffset(), log_file.GetLogEnd());
+    }
+    ASSERT_EQ(record_offsets.size(), span_count * span_record_count);
+    for (size_t span_itr = 0; span_itr < span_count; span_itr++) {
+      EXPECT_EQ(record_offsets[span_itr * span_record_count],
+                get_span_offset(span_itr));
+    }
+
+    // Drop the segments before the third one, the first one is recycled
+    size_t truncate_span_itr = 2 * spans_per_segment + 1;
+    log_file.Truncate(get_span_offset(truncate_span_itr));
+    EXPECT_EQ(log_file.GetLogStart(), 2 * LOG_SEGMENT_SIZE);
+    EXPECT_NE(access(log_file_name.c_str(), F_OK), 0);
+    EXPECT_EQ(access((log_file_name + ".spare").c_str(), F_OK), 0);
+
+    // The next segment is the spare one
+    write_spans(log_file, spans_per_segment);
+    size_t total_span_count = span_count + spans_per_segment;
+    EXPECT_EQ(log_file.GetLogEnd(),
+              get_span_offset(total_span_count - 1) + span.size());
+    EXPECT_GT(log_file.GetLogEnd(), 3 * LOG_SEGMENT_SIZE);
+    EXPECT_NE(access((log_file_name + ".spare").c_str(), F_OK), 0);
+
+    // Read the log after the truncation
+    record_offsets.clear();
+    {
+      logging::LogReader log_reader(log_file, log_file.GetLogStart(),
+                                    log_file.GetLogEnd());
+      logging::RawLogRecord record;
+      while (log_reader.ReadRecord(record)) {
+        record_offsets.push_back(record.offset);
+      }
+    }
+    size_t first_span_itr = 2 * spans_per_segment;
+    ASSERT_EQ(record_offsets.size(),
+              (total_span_count - first_span_itr) * span_record_count);
+    for (size_t span_itr = first_span_itr; span_itr < total_span_count;
+         span_itr++) {
+      EXPECT_EQ(record_offsets[(span_itr - first_span_itr) * span_record_count],
+                get_span_offset(span_itr));
+    }
+  }
+
+  logging::LogFile::Remove(log_file_name);
+}
+
+/**
+ * @brief write a span larger than a segment between small spans, and read
+ * the log back
+ */
+TEST(LoggingTests, LargeSpanTest) {
+  std::string log_file_name = "large_span.log";
+
+  // A small span of a single commit, and a large span of a single insert
+  CopySerializeOutput output_buffer;
+  logging::TransactionRecord small_record(LOGRECORD_TYPE_TRANSACTION_COMMIT,
+                                          1);
+  small_record.Serialize(output_buffer);
+  std::vector<char> small_span(
+      small_record.GetMessage(),
+      small_record.GetMessage() + small_record.GetMessageLength());
+
+  const size_t value_size = LOG_SEGMENT_SIZE + LOG_SEGMENT_SIZE / 2;
+  catalog::Schema schema(
+      {catalog::Column(VALUE_TYPE_INTEGER, GetTypeSize(VALUE_TYPE_INTEGER),
+                       "key", true),
+       catalog::Column(VALUE_TYPE_VARCHAR, value_size, "value", false)});
+  auto testing_pool = TestingHarness::GetInstance().GetTestingPool();
+  std::vector<char> large_span;
+  {
+    storage::Tuple tuple(&schema, true);
+    tuple.SetValue(0, ValueFactory::GetIntegerValue(1), testing_pool);
+    tuple.SetValue(1, ValueFactory::GetStringValue(std::string(value_size, 'x'),
+                                                   testing_pool),
+                   testing_pool);
+    logging::TupleRecord large_record(LOGRECORD_TYPE_ARIES_TUPLE_INSERT, 1, 1,
+                                      ItemPointer(1, 0), INVALID_ITEMPOINTER,
+                                      &tuple, 1);
+    CopySerializeOutput large_output;
+    large_record.Serialize(large_output);
+    large_span.assign(
+        large_record.GetMessage(),
+        large_record.GetMessage() + large_record.GetMessageLength());
+  }
+  ASSERT_GT(large_span.size(), LOG_SEGMENT_SIZE);
+
+  auto write_span = [&](logging::LogFile& log_file, std::vector<char>& span) {
+    std::vector<struct iovec> spans(1, {span.data(), span.size()});
+    EXPECT_TRUE(log_file.Write(spans));
+  };
+
+  // The large span starts the second segment, which covers two segments,
+  // and the small span after it is in the same segment
+  const size_t large_span_offset = LOG_SEGMENT_SIZE;
+  const size_t last_span_offset = large_span_offset + large_span.size();
+  const size_t log_end = last_span_offset + small_span.size();
+
+  for (bool direct_io : {false, true}) {
+    logging::LogFile::Remove(log_file_name);
+
+    {
+      logging::LogFile log_file(log_file_name, direct_io);
+      ASSERT_TRUE(log_file.Open());
+
+      write_span(log_file, small_span);
+      write_span(log_file, large_span);
+      EXPECT_EQ(log_file.GetLogEnd(), large_span_offset + large_span.size());
+      write_span(log_file, small_span);
+      EXPECT_TRUE(log_file.Sync());
+      EXPECT_EQ(log_file.GetLogEnd(), log_end);
+    }
+
+    // Reopen the log, and find its end in the large segment
+    logging::LogFile log_file(log_file_name, direct_io);
+    ASSERT_TRUE(log_file.Open());
+    EXPECT_EQ(log_file.GetLogEnd(), log_end);
+
+    auto read_offsets = [&](size_t log_start) {
+      std::vector<size_t> record_offsets;
+      logging::LogReader log_reader(log_file, log_start, log_file.GetLogEnd());
+      EXPECT_TRUE(log_reader.IsValid());
+      logging::RawLogRecord record;
+      while (log_reader.ReadRecord(record)) {
+        record_offsets.push_back(record.offset);
+      }
+      EXPECT_EQ(log_reader.GetOffset(), log_file.GetLogEnd());
+      return record_offsets;
+    };
+    EXPECT_EQ(read_offsets(0), std::vector<size_t>({0, large_span_offset,
+                                                    last_span_offset}));
+
+    // The next segment comes after the ones the large segment covers
+    std::vector<char> filler_span;
+    while (filler_span.size() < LOG_SEGMENT_SIZE - small_span.size()) {
+      filler_span.insert(filler_span.end(), small_span.begin(),
+                         small_span.end());
+    }
+    write_span(log_file, filler_span);
+    EXPECT_EQ(log_file.GetLogEnd(), 3 * LOG_SEGMENT_SIZE + filler_span.size());
+    EXPECT_EQ(access((log_file_name + ".3").c_str(), F_OK), 0);
+
+    // The large segment is dropped, and not kept as the spare one
+    log_file.Truncate(3 * LOG_SEGMENT_SIZE);
+    EXPECT_EQ(log_file.GetLogStart(), 3 * LOG_SEGMENT_SIZE);
+    EXPECT_NE(access((log_file_name + ".1").c_str(), F_OK), 0);
+    EXPECT_EQ(read_offsets(log_file.GetLogStart()).size(),
+              filler_span.size() / small_span.size());
+  }
+
+  logging::LogFile::Remove(log_file_name);
+}
+
 }  // End test namespace
 }  // End peloton namespace
 
@@ -3,11 +3,14 @@
 
 #include <thread>
 #include <chrono>
+#include <functional>
+#include <future>
 #include <getopt.h>
 
 #include "logging/logging_tests_util.h"
 
 #include "backend/bridge/ddl/ddl_database.h"
+#include "backend/catalog/schema.h"
 #include "backend/concurrency/transaction_manager.h"
 #include "backend/common/value_factory.h"
 #include "backend/storage/table_factory.h"
@@ -15,7 +18,11 @@
 #include "backend/storage/data_table.h"
 #include "backend/storage/tuple.h"
 #include "backend/storage/tile_group.h"
+#include "backend/storage/tile_group_header.h"
 #include "backend/logging/log_manager.h"
+#include "backend/logging/log_buffer.h"
+#include "backend/logging/log_file.h"
+#include "backend/logging/log_reader.h"
 #include "backend/logging/records/tuple_record.h"
 #include "backend/logging/records/transaction_record.h"
 
@@ -60,6 +67,21 @@ static void WriteOutput(double value) {
   out.flush();
 }
 
+/**
+ * @brief Remove the log file, and the log streams that were next to it
+ */
+static void RemoveLogFiles(std::string file_path) {
+  auto& log_manager = logging::LogManager::GetInstance();
+  log_manager.SetLogFileName(file_path);
+
+  for (oid_t logger_id = 0;
+       logger_id == 0 ||
+           logging::LogFile::Exists(log_manager.GetLogFileName(logger_id));
+       logger_id++) {
+    logging::LogFile::Remove(log_manager.GetLogFileName(logger_id));
+  }
+}
+
 std::string GetFilePath(std::string directory_path, std::string file_name) {
   std::string file_path = directory_path;
 
@@ -79,13 +101,8 @@ std::string GetFilePath(std::string directory_path, std::string file_name) {
 bool LoggingTestsUtil::PrepareLogFile(std::string file_name) {
   auto file_path = GetFilePath(state.log_file_dir, file_name);
 
-  std::ifstream log_file(file_path);
-
-  // Reset the log file if exists
-  if (log_file.good()) {
-    EXPECT_TRUE(std::remove(file_path.c_str()) == 0);
-  }
-  log_file.close();
+  // Reset the log file and its segments if exist
+  RemoveLogFiles(file_path);
 
   // start a thread for logging
   auto& log_manager = logging::LogManager::GetInstance();
@@ -106,6 +123,9 @@ bool LoggingTestsUtil::PrepareLogFile(std::string file_name) {
   // set log file and logging type
   log_manager.SetLogFileName(file_path);
 
+  // The checkpoint of an older log does not belong to this one
+  std::remove(log_manager.GetCheckpointFileName().c_str());
+
   // start off the frontend logger of appropriate type in STANDBY mode
   std::thread thread(&logging::LogManager::StartStandbyMode, &log_manager);
 
@@ -132,6 +152,489 @@ bool LoggingTestsUtil::PrepareLogFile(std::string file_name) {
   return false;
 }
 
+/**
+ * @brief writing a log by hand
+ * Every committed txn inserts a tuple into one of a few tile groups, then a
+ * txn moves a tuple to a new tile group and another one deletes a tuple.
+ * The last txn never commits.
+ */
+oid_t LoggingTestsUtil::PrepareRedoLogFile(std::string file_name,
+                                           oid_t txn_count,
+                                           oid_t tile_group_count) {
+  auto file_path = GetFilePath(state.log_file_dir, file_name);
+
+  // The log is a single segment
+  RemoveLogFiles(file_path);
+  FILE* log_file = fopen(file_path.c_str(), "wb");
+  EXPECT_TRUE(log_file != nullptr);
+  if (log_file == nullptr) return 0;
+
+  auto& log_manager = logging::LogManager::GetInstance();
+  log_manager.SetLogFileName(file_path);
+  std::remove(log_manager.GetCheckpointFileName().c_str());
+
+  std::unique_ptr<catalog::Schema> schema(new catalog::Schema(CreateSchema()));
+  auto testing_pool = TestingHarness::GetInstance().GetTestingPool();
+  auto tuples = CreateTuples(schema.get(), txn_count + 2, testing_pool);
+
+  CopySerializeOutput output_buffer;
+  auto write_record = [&](logging::LogRecord& record) {
+    record.Serialize(output_buffer);
+    fwrite(record.GetMessage(), sizeof(char), record.GetMessageLength(),
+           log_file);
+  };
+
+  auto write_txn = [&](txn_id_t txn_id, logging::TupleRecord& tuple_record,
+                       bool commit) {
+    logging::TransactionRecord begin_record(LOGRECORD_TYPE_TRANSACTION_BEGIN,
+                                            txn_id);
+    write_record(begin_record);
+    write_record(tuple_record);
+    if (commit == false) return;
+
+    logging::TransactionRecord commit_record(
+        LOGRECORD_TYPE_TRANSACTION_COMMIT, txn_id);
+    write_record(commit_record);
+    logging::TransactionRecord end_record(LOGRECORD_TYPE_TRANSACTION_END,
+                                          txn_id);
+    write_record(end_record);
+  };
+
+  const oid_t first_tile_group_id = 1000;
+  txn_id_t txn_id = 1;
+
+  // Inserts, the last one never commits
+  for (oid_t txn_itr = 0; txn_itr <= txn_count; txn_itr++, txn_id++) {
+    ItemPointer location(first_tile_group_id + txn_itr % tile_group_count,
+                         txn_itr / tile_group_count);
+    logging::TupleRecord insert_record(
+        LOGRECORD_TYPE_ARIES_TUPLE_INSERT, txn_id, LOGGING_TESTS_TABLE_OID,
+        location, INVALID_ITEMPOINTER, tuples[txn_itr],
+        LOGGING_TESTS_DATABASE_OID);
+    write_txn(txn_id, insert_record, txn_itr < txn_count);
+  }
+
+  // Move the first tuple to a new tile group
+  logging::TupleRecord update_record(
+      LOGRECORD_TYPE_ARIES_TUPLE_UPDATE, txn_id++, LOGGING_TESTS_TABLE_OID,
+      ItemPointer(first_tile_group_id + tile_group_count, 0),
+      ItemPointer(first_tile_group_id, 0), tuples[txn_count + 1],
+      LOGGING_TESTS_DATABASE_OID);
+  write_txn(update_record.GetTransactionId(), update_record, true);
+
+  // Delete the second tuple
+  logging::TupleRecord delete_record(
+      LOGRECORD_TYPE_ARIES_TUPLE_DELETE, txn_id++, LOGGING_TESTS_TABLE_OID,
+      INVALID_ITEMPOINTER, ItemPointer(first_tile_group_id + 1, 0), nullptr,
+      LOGGING_TESTS_DATABASE_OID);
+  write_txn(delete_record.GetTransactionId(), delete_record, true);
+
+  fclose(log_file);
+
+  for (auto tuple : tuples) {
+    delete tuple;
+  }
+
+  return txn_count - 1;
+}
+
+/**
+ * @brief writing a log with a checkpoint in the middle
+ * A txn is still running when the checkpoint is taken, so its records are
+ * before the checkpoint and its commit after it. The txns after the
+ * checkpoint also delete a tuple that the checkpoint has.
+ * @return the number of tuples that should be recovered
+ */
+std::vector<std::string> LoggingTestsUtil::PrepareCheckpointLogFile(
+    std::string file_name) {
+  auto file_path = GetFilePath(state.log_file_dir, file_name);
+  std::vector<std::string> expected_tuples;
+
+  auto& log_manager = logging::LogManager::GetInstance();
+  if (log_manager.ActiveFrontendLoggerCount() > 0) {
+    LOG_ERROR("another logging thread is running now");
+    return expected_tuples;
+  }
+
+  // Reset the log file and its checkpoint
+  RemoveLogFiles(file_path);
+  std::remove(log_manager.GetCheckpointFileName().c_str());
+
+  CreateDatabaseAndTable(LOGGING_TESTS_DATABASE_OID, LOGGING_TESTS_TABLE_OID);
+  auto& manager = catalog::Manager::GetInstance();
+  auto table = manager.GetDatabaseWithOid(LOGGING_TESTS_DATABASE_OID)
+                   ->GetTableWithOid(LOGGING_TESTS_TABLE_OID);
+
+  std::thread thread(&logging::LogManager::StartStandbyMode, &log_manager);
+  log_manager.WaitForMode(LOGGING_STATUS_TYPE_STANDBY, true);
+  log_manager.StartRecoveryMode();
+  log_manager.WaitForMode(LOGGING_STATUS_TYPE_LOGGING, true);
+
+  auto testing_pool = TestingHarness::GetInstance().GetTestingPool();
+  auto tuples = CreateTuples(table->GetSchema(), 13, testing_pool);
+  std::vector<storage::Tuple*> first_tuples(tuples.begin(), tuples.begin() + 8);
+  std::vector<storage::Tuple*> last_tuples(tuples.begin() + 9, tuples.end());
+
+  std::promise<void> txn_running, checkpoint_taken;
+  auto checkpoint_done = checkpoint_taken.get_future();
+
+  std::thread backend([&] {
+    auto& txn_manager = concurrency::TransactionManager::GetInstance();
+    auto logger = log_manager.GetBackendLogger();
+
+    // Before the checkpoint
+    auto locations = InsertTuples(table, first_tuples, true);
+    DeleteTuples(table, {locations[0], locations[1]}, true);
+
+    // A txn that commits after the checkpoint
+    auto txn = txn_manager.BeginTransaction();
+    auto location = table->InsertTuple(txn, tuples[8]);
+    txn->RecordInsert(location);
+    auto record = logger->GetTupleRecord(
+        LOGRECORD_TYPE_TUPLE_INSERT, txn->GetTransactionId(), table->GetOid(),
+        location, INVALID_ITEMPOINTER, tuples[8], LOGGING_TESTS_DATABASE_OID);
+    logger->Log(record);
+    logger->WaitForFlushing();
+
+    txn_running.set_value();
+    checkpoint_done.wait();
+
+    // After the checkpoint
+    txn_manager.CommitTransaction();
+    InsertTuples(table, last_tuples, true);
+    DeleteTuples(table, {locations[2]}, true);
+
+    logger->WaitForFlushing();
+    log_manager.RemoveBackendLogger(logger);
+  });
+
+  txn_running.get_future().wait();
+  EXPECT_TRUE(log_manager.TakeCheckpoint());
+  checkpoint_taken.set_value();
+
+  backend.join();
+
+  if (log_manager.EndLogging()) {
+    thread.join();
+  } else {
+    LOG_ERROR("Failed to terminate logging thread");
+  }
+
+  // The first three tuples are deleted
+  for (auto tuple_itr = tuples.begin() + 3; tuple_itr != tuples.end();
+       tuple_itr++) {
+    expected_tuples.push_back(GetTupleInfo(*tuple_itr));
+  }
+
+  DropDatabaseAndTable(LOGGING_TESTS_DATABASE_OID, LOGGING_TESTS_TABLE_OID);
+
+  for (auto tuple : tuples) {
+    delete tuple;
+  }
+
+  std::sort(expected_tuples.begin(), expected_tuples.end());
+  return expected_tuples;
+}
+
+/**
+ * @brief writing a log with delta updates
+ * The tuples are in a checkpoint, then every tuple gets its first field
+ * updated, and half of them their key too. The last update is aborted.
+ * @return the tuples that should be recovered, sorted
+ */
+std::vector<std::string> LoggingTestsUtil::PrepareDeltaLogFile(
+    std::string file_name) {
+  auto file_path = GetFilePath(state.log_file_dir, file_name);
+  std::vector<std::string> expected_tuples;
+
+  auto& log_manager = logging::LogManager::GetInstance();
+  if (log_manager.ActiveFrontendLoggerCount() > 0) {
+    LOG_ERROR("another logging thread is running now");
+    return expected_tuples;
+  }
+
+  // Reset the log file and its checkpoint
+  RemoveLogFiles(file_path);
+  std::remove(log_manager.GetCheckpointFileName().c_str());
+
+  CreateDatabaseAndTable(LOGGING_TESTS_DATABASE_OID, LOGGING_TESTS_TABLE_OID);
+  auto& manager = catalog::Manager::GetInstance();
+  auto table = manager.GetDatabaseWithOid(LOGGING_TESTS_DATABASE_OID)
+                   ->GetTableWithOid(LOGGING_TESTS_TABLE_OID);
+
+  std::thread thread(&logging::LogManager::StartStandbyMode, &log_manager);
+  log_manager.WaitForMode(LOGGING_STATUS_TYPE_STANDBY, true);
+  log_manager.StartRecoveryMode();
+  log_manager.WaitForMode(LOGGING_STATUS_TYPE_LOGGING, true);
+
+  const oid_t tuple_count = 8;
+  auto testing_pool = TestingHarness::GetInstance().GetTestingPool();
+  auto tuples = CreateTuples(table->GetSchema(), tuple_count, testing_pool);
+  auto new_tuples = CreateTuples(table->GetSchema(), tuple_count, testing_pool);
+
+  std::thread backend([&] {
+    auto& txn_manager = concurrency::TransactionManager::GetInstance();
+    auto logger = log_manager.GetBackendLogger();
+
+    // Replace the tuple, and only log the changed column
+    auto update_tuple = [&](ItemPointer delete_location, storage::Tuple* tuple,
+                            oid_t column_id, bool commit) {
+      auto txn = txn_manager.BeginTransaction();
+      EXPECT_TRUE(table->DeleteTuple(txn, delete_location));
+      txn->RecordDelete(delete_location);
+      auto insert_location = table->InsertTuple(txn, tuple);
+      txn->RecordInsert(insert_location);
+
+      auto record = logger->GetTupleUpdateRecord(
+          txn->GetTransactionId(), table->GetOid(), insert_location,
+          delete_location, tuple, {column_id}, LOGGING_TESTS_DATABASE_OID);
+      logger->Log(record);
+
+      if (commit) {
+        txn_manager.CommitTransaction();
+      } else {
+        txn_manager.AbortTransaction();
+      }
+      return insert_location;
+    };
+
+    auto locations = InsertTuples(table, tuples, true);
+    logger->WaitForFlushing();
+    EXPECT_TRUE(log_manager.TakeCheckpoint());
+
+    // The checkpoint has the old tuples
+    for (oid_t tuple_itr = 0; tuple_itr < tuple_count; tuple_itr++) {
+      auto tuple = new_tuples[tuple_itr];
+      tuple->SetValue(
+          1, ValueFactory::GetStringValue("updated " + std::to_string(tuple_itr),
+                                          testing_pool),
+          testing_pool);
+      locations[tuple_itr] = update_tuple(locations[tuple_itr], tuple, 1, true);
+    }
+
+    // The log has the old tuples
+    for (oid_t tuple_itr = 0; tuple_itr < tuple_count / 2; tuple_itr++) {
+      auto tuple = new_tuples[tuple_itr];
+      tuple->SetValue(0, ValueFactory::GetIntegerValue(tuple_itr + tuple_count),
+                      nullptr);
+      locations[tuple_itr] = update_tuple(locations[tuple_itr], tuple, 0, true);
+    }
+
+    for (auto tuple : new_tuples) {
+      expected_tuples.push_back(GetTupleInfo(tuple));
+    }
+
+    // This one never happened
+    auto tuple = new_tuples.back();
+    tuple->SetValue(1, ValueFactory::GetStringValue("aborted", testing_pool),
+                    testing_pool);
+    update_tuple(locations.back(), tuple, 1, false);
+
+    logger->WaitForFlushing();
+    log_manager.RemoveBackendLogger(logger);
+  });
+
+  backend.join();
+
+  if (log_manager.EndLogging()) {
+    thread.join();
+  } else {
+    LOG_ERROR("Failed to terminate logging thread");
+  }
+
+  DropDatabaseAndTable(LOGGING_TESTS_DATABASE_OID, LOGGING_TESTS_TABLE_OID);
+
+  for (auto tuple : tuples) {
+    delete tuple;
+  }
+  for (auto tuple : new_tuples) {
+    delete tuple;
+  }
+
+  std::sort(expected_tuples.begin(), expected_tuples.end());
+  return expected_tuples;
+}
+
+std::vector<std::string> LoggingTestsUtil::PrepareStreamLogFile(
+    std::string file_name, size_t backend_count) {
+  auto file_path = GetFilePath(state.log_file_dir, file_name);
+  std::vector<std::string> expected_tuples;
+
+  auto& log_manager = logging::LogManager::GetInstance();
+  if (log_manager.ActiveFrontendLoggerCount() > 0) {
+    LOG_ERROR("another logging thread is running now");
+    return expected_tuples;
+  }
+
+  // Reset the log files of all the streams and the checkpoint
+  RemoveLogFiles(file_path);
+  std::remove(log_manager.GetCheckpointFileName().c_str());
+
+  CreateDatabaseAndTable(LOGGING_TESTS_DATABASE_OID, LOGGING_TESTS_TABLE_OID);
+  auto& manager = catalog::Manager::GetInstance();
+  auto table = manager.GetDatabaseWithOid(LOGGING_TESTS_DATABASE_OID)
+                   ->GetTableWithOid(LOGGING_TESTS_TABLE_OID);
+
+  std::thread thread(&logging::LogManager::StartStandbyMode, &log_manager);
+  log_manager.WaitForMode(LOGGING_STATUS_TYPE_STANDBY, true);
+  log_manager.StartRecoveryMode();
+  log_manager.WaitForMode(LOGGING_STATUS_TYPE_LOGGING, true);
+
+  const oid_t tuple_count = 8;
+  auto testing_pool = TestingHarness::GetInstance().GetTestingPool();
+  std::vector<std::vector<storage::Tuple*>> tuples(backend_count);
+  std::vector<std::vector<storage::Tuple*>> new_tuples(backend_count);
+  std::vector<std::vector<ItemPointer>> locations(backend_count);
+  for (size_t backend_itr = 0; backend_itr < backend_count; backend_itr++) {
+    tuples[backend_itr] =
+        CreateTuples(table->GetSchema(), tuple_count, testing_pool);
+    new_tuples[backend_itr] =
+        CreateTuples(table->GetSchema(), tuple_count, testing_pool);
+  }
+
+  // The backends are spread over the frontend loggers
+  auto run_backends = [&](std::function<void(size_t)> backend_work) {
+    std::vector<std::thread> backends;
+    for (size_t backend_itr = 0; backend_itr < backend_count; backend_itr++) {
+      backends.push_back(std::thread([&, backend_itr] {
+        backend_work(backend_itr);
+
+        auto logger = log_manager.GetBackendLogger();
+        logger->WaitForFlushing();
+        log_manager.RemoveBackendLogger(logger);
+      }));
+    }
+    for (auto& backend : backends) {
+      backend.join();
+    }
+  };
+
+  // First, every backend inserts its tuples
+  run_backends([&](size_t backend_itr) {
+    locations[backend_itr] = InsertTuples(table, tuples[backend_itr], true);
+  });
+
+  // Then, it replaces the tuples of another one, and only logs the changed
+  // column
+  run_backends([&](size_t backend_itr) {
+    auto& txn_manager = concurrency::TransactionManager::GetInstance();
+    auto logger = log_manager.GetBackendLogger();
+    auto other_itr = (backend_itr + 1) % backend_count;
+
+    for (oid_t tuple_itr = 0; tuple_itr < tuple_count; tuple_itr++) {
+      auto tuple = new_tuples[other_itr][tuple_itr];
+      tuple->SetValue(1, ValueFactory::GetStringValue(
+                             "updated by " + std::to_string(backend_itr),
+                             testing_pool),
+                      testing_pool);
+
+      auto delete_location = locations[other_itr][tuple_itr];
+      auto txn = txn_manager.BeginTransaction();
+      EXPECT_TRUE(table->DeleteTuple(txn, delete_location));
+      txn->RecordDelete(delete_location);
+      auto insert_location = table->InsertTuple(txn, tuple);
+      txn->RecordInsert(insert_location);
+
+      auto record = logger->GetTupleUpdateRecord(
+          txn->GetTransactionId(), table->GetOid(), insert_location,
+          delete_location, tuple, {1}, LOGGING_TESTS_DATABASE_OID);
+      logger->Log(record);
+
+      txn_manager.CommitTransaction();
+    }
+  });
+
+  // The tuples are in the testing pool until the logging is over
+  expected_tuples =
+      GetActiveTuples(LOGGING_TESTS_DATABASE_OID, LOGGING_TESTS_TABLE_OID);
+
+  if (log_manager.EndLogging()) {
+    thread.join();
+  } else {
+    LOG_ERROR("Failed to terminate logging thread");
+  }
+
+  DropDatabaseAndTable(LOGGING_TESTS_DATABASE_OID, LOGGING_TESTS_TABLE_OID);
+
+  for (size_t backend_itr = 0; backend_itr < backend_count; backend_itr++) {
+    for (auto tuple : tuples[backend_itr]) {
+      delete tuple;
+    }
+    for (auto tuple : new_tuples[backend_itr]) {
+      delete tuple;
+    }
+  }
+
+  return expected_tuples;
+}
+
+std::vector<std::pair<LogRecordType, size_t>>
+LoggingTestsUtil::PrepareLargeRecordLogFile(std::string file_name,
+                                            size_t value_size) {
+  auto file_path = GetFilePath(state.log_file_dir, file_name);
+  std::vector<std::pair<LogRecordType, size_t>> logged_records;
+
+  auto& log_manager = logging::LogManager::GetInstance();
+  if (log_manager.ActiveFrontendLoggerCount() > 0) {
+    LOG_ERROR("another logging thread is running now");
+    return logged_records;
+  }
+
+  RemoveLogFiles(file_path);
+  std::remove(log_manager.GetCheckpointFileName().c_str());
+
+  std::thread thread(&logging::LogManager::StartStandbyMode, &log_manager);
+  log_manager.WaitForMode(LOGGING_STATUS_TYPE_STANDBY, true);
+  log_manager.StartRecoveryMode();
+  log_manager.WaitForMode(LOGGING_STATUS_TYPE_LOGGING, true);
+
+  catalog::Schema schema(
+      {catalog::Column(VALUE_TYPE_INTEGER, GetTypeSize(VALUE_TYPE_INTEGER),
+                       "key", true),
+       catalog::Column(VALUE_TYPE_VARCHAR, value_size, "value", false)});
+  auto testing_pool = TestingHarness::GetInstance().GetTestingPool();
+  storage::Tuple tuple(&schema, true);
+  tuple.SetValue(0, ValueFactory::GetIntegerValue(1), testing_pool);
+  tuple.SetValue(1, ValueFactory::GetStringValue(std::string(value_size, 'x'),
+                                                 testing_pool),
+                 testing_pool);
+
+  std::thread backend([&] {
+    auto logger = log_manager.GetBackendLogger();
+    const txn_id_t txn_id = 1;
+
+    logger->Log(new logging::TransactionRecord(
+        LOGRECORD_TYPE_TRANSACTION_BEGIN, txn_id));
+    logger->Log(logger->GetTupleRecord(
+        LOGRECORD_TYPE_TUPLE_INSERT, txn_id, LOGGING_TESTS_TABLE_OID,
+        ItemPointer(1, 0), INVALID_ITEMPOINTER, &tuple,
+        LOGGING_TESTS_DATABASE_OID));
+    logger->Log(new logging::TransactionRecord(
+        LOGRECORD_TYPE_TRANSACTION_COMMIT, txn_id));
+
+    logger->WaitForFlushing();
+    log_manager.RemoveBackendLogger(logger);
+  });
+  backend.join();
+
+  if (log_manager.EndLogging()) {
+    thread.join();
+  } else {
+    LOG_ERROR("Failed to terminate logging thread");
+  }
+
+  // Read the log back
+  logging::LogFile log_file(log_manager.GetLogFileName(0), false);
+  EXPECT_TRUE(log_file.Open());
+  logging::LogReader log_reader(log_file, 0, log_file.GetLogEnd());
+  logging::RawLogRecord record;
+  while (log_reader.ReadRecord(record)) {
+    logged_records.emplace_back(record.type, record.body_size);
+  }
+
+  return logged_records;
+}
+
 //===--------------------------------------------------------------------===//
 // CHECK RECOVERY
 //===--------------------------------------------------------------------===//
@@ -149,7 +652,8 @@ void LoggingTestsUtil::ResetSystem() {
 /**
  * @brief recover the database and check the tuples
  */
-void LoggingTestsUtil::DoRecovery(std::string file_name) {
+oid_t LoggingTestsUtil::DoRecovery(std::string file_name,
+                                   std::vector<std::string>* recovered_tuples) {
   std::chrono::time_point<std::chrono::system_clock> start, end;
   std::chrono::duration<double, std::milli> elapsed_milliseconds;
 
@@ -168,7 +672,7 @@ void LoggingTestsUtil::DoRecovery(std::string file_name) {
   auto& log_manager = logging::LogManager::GetInstance();
   if (log_manager.ActiveFrontendLoggerCount() > 0) {
     LOG_ERROR("another logging thread is running now");
-    return;
+    return 0;
   }
 
   //===--------------------------------------------------------------------===//
@@ -209,17 +713,35 @@ void LoggingTestsUtil::DoRecovery(std::string file_name) {
   // Check the next oid
   // LoggingTestsUtil::CheckNextOid();
 
+  // The recovered strings are in the pool of the frontend logger
+  if (recovered_tuples != nullptr) {
+    *recovered_tuples = LoggingTestsUtil::GetActiveTuples(
+        LOGGING_TESTS_DATABASE_OID, LOGGING_TESTS_TABLE_OID);
+  }
+
   if (log_manager.EndLogging()) {
     thread.join();
   } else {
     LOG_ERROR("Failed to terminate logging thread");
   }
+
+  // Count the tuples once the logging is over, as it takes a txn
+  auto recovered_tuple_count = LoggingTestsUtil::GetActiveTupleCount(
+      LOGGING_TESTS_DATABASE_OID, LOGGING_TESTS_TABLE_OID);
+
   LoggingTestsUtil::DropDatabaseAndTable(LOGGING_TESTS_DATABASE_OID,
                                          LOGGING_TESTS_TABLE_OID);
+
+  return recovered_tuple_count;
 }
 
 void LoggingTestsUtil::CheckTupleCount(oid_t db_oid, oid_t table_oid,
                                        oid_t expected) {
+  // check # of active tuples
+  EXPECT_EQ(expected, GetActiveTupleCount(db_oid, table_oid));
+}
+
+oid_t LoggingTestsUtil::GetActiveTupleCount(oid_t db_oid, oid_t table_oid) {
   auto& manager = catalog::Manager::GetInstance();
   storage::Database* db = manager.GetDatabaseWithOid(db_oid);
   auto table = db->GetTableWithOid(table_oid);
@@ -234,8 +756,53 @@ void LoggingTestsUtil::CheckTupleCount(oid_t db_oid, oid_t table_oid,
     active_tuple_count += tile_group->GetActiveTupleCount(next_txn_id);
   }
 
-  // check # of active tuples
-  EXPECT_EQ(expected, active_tuple_count);
+  return active_tuple_count;
+}
+
+/**
+ * @brief get the active tuples, sorted
+ */
+std::vector<std::string> LoggingTestsUtil::GetActiveTuples(oid_t db_oid,
+                                                           oid_t table_oid) {
+  auto& manager = catalog::Manager::GetInstance();
+  storage::Database* db = manager.GetDatabaseWithOid(db_oid);
+  auto table = db->GetTableWithOid(table_oid);
+  auto schema = table->GetSchema();
+
+  // Look at the committed tuples without a txn, that would be logged
+  auto& txn_manager = concurrency::TransactionManager::GetInstance();
+  auto last_cid = txn_manager.GetLastCommitId();
+
+  std::vector<std::string> active_tuples;
+  oid_t tile_group_count = table->GetTileGroupCount();
+  for (oid_t tile_group_itr = 0; tile_group_itr < tile_group_count;
+       tile_group_itr++) {
+    auto tile_group = table->GetTileGroup(tile_group_itr);
+    auto header = tile_group->GetHeader();
+    for (oid_t tuple_slot = 0; tuple_slot < tile_group->GetAllocatedTupleCount();
+         tuple_slot++) {
+      if (header->IsVisible(tuple_slot, MAX_TXN_ID, last_cid) == false) {
+        continue;
+      }
+
+      storage::Tuple tuple(schema, true);
+      for (oid_t column_itr = 0; column_itr < schema->GetColumnCount();
+           column_itr++) {
+        tuple.SetValue(column_itr, tile_group->GetValue(tuple_slot, column_itr),
+                       nullptr);
+      }
+      active_tuples.push_back(GetTupleInfo(&tuple));
+    }
+  }
+
+  std::sort(active_tuples.begin(), active_tuples.end());
+  return active_tuples;
+}
+
+std::string LoggingTestsUtil::GetTupleInfo(storage::Tuple* tuple) {
+  CopySerializeOutput output;
+  tuple->SerializeTo(output);
+  return std::string(output.Data(), output.Size());
 }
 
 //===--------------------------------------------------------------------===//
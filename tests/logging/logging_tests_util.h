@@ -1,5 +1,6 @@
 #pragma once
 
+#include <utility>
 #include <vector>
 
 #include "backend/common/types.h"
@@ -36,13 +37,42 @@ class LoggingTestsUtil {
 
   static bool PrepareLogFile(std::string file_name);
 
+  // Write the log by hand, so that we know what recovery brings back
+  // returns the number of tuples that should be recovered
+  static oid_t PrepareRedoLogFile(std::string file_name, oid_t txn_count,
+                                  oid_t tile_group_count);
+
+  // Log with a checkpoint taken while a txn is running
+  // returns the tuples that should be recovered
+  static std::vector<std::string> PrepareCheckpointLogFile(
+      std::string file_name);
+
+  // Log with updates that only log their changed columns, on top of a
+  // checkpoint and of each other
+  // returns the tuples that should be recovered
+  static std::vector<std::string> PrepareDeltaLogFile(std::string file_name);
+
+  // Log with several backends, whose txns change the tuples of each other,
+  // so the commits that depend on each other are in different log streams
+  // returns the tuples that should be recovered
+  static std::vector<std::string> PrepareStreamLogFile(std::string file_name,
+                                                       size_t backend_count);
+
+  // Log a txn that inserts a tuple too large for the log buffer, between
+  // small records
+  // returns the types and the body sizes of the records in the log
+  static std::vector<std::pair<LogRecordType, size_t>>
+  PrepareLargeRecordLogFile(std::string file_name, size_t value_size);
+
   //===--------------------------------------------------------------------===//
   // CHECK RECOVERY
   //===--------------------------------------------------------------------===//
 
   static void ResetSystem(void);
 
-  static void DoRecovery(std::string file_name);
+  // returns the number of recovered tuples, and the tuples if needed
+  static oid_t DoRecovery(std::string file_name,
+                          std::vector<std::string>* recovered_tuples = nullptr);
 
   //===--------------------------------------------------------------------===//
   // Configuration
@@ -123,6 +153,13 @@ class LoggingTestsUtil {
   static void DropDatabase(oid_t db_oid);
 
   static void CheckTupleCount(oid_t db_oid, oid_t table_oid, oid_t expected);
+
+  static oid_t GetActiveTupleCount(oid_t db_oid, oid_t table_oid);
+
+  static std::vector<std::string> GetActiveTuples(oid_t db_oid,
+                                                  oid_t table_oid);
+
+  static std::string GetTupleInfo(storage::Tuple* tuple);
 };
 
 // configuration for testing
@@ -0,0 +1,134 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// compressed_tile_test.cpp
+//
+// Identification: tests/storage/compressed_tile_test.cpp
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <memory>
+
+#include "gtest/gtest.h"
+
+#include "backend/catalog/manager.h"
+#include "backend/common/value.h"
+#include "backend/storage/compressed_tile.h"
+#include "backend/storage/data_table.h"
+#include "backend/storage/tile_group.h"
+#include "executor/executor_tests_util.h"
+
+namespace peloton {
+namespace test {
+
+//===--------------------------------------------------------------------===//
+// Compressed Tile Tests
+//===--------------------------------------------------------------------===//
+
+// Check that the compressed tile group holds the same values
+void CheckCompressedTileGroup(storage::TileGroup *tile_group,
+                              storage::TileGroup *compressed_tile_group) {
+  EXPECT_TRUE(compressed_tile_group->IsCompressed());
+  EXPECT_EQ(tile_group->GetHeader(), compressed_tile_group->GetHeader());
+
+  // Only the compressed tiles, in place of the original ones
+  oid_t tile_count = tile_group->GetTileCount();
+  EXPECT_EQ(tile_count, compressed_tile_group->GetTileCount());
+  for (oid_t tile_itr = 0; tile_itr < tile_count; tile_itr++) {
+    auto compressed_tile = compressed_tile_group->GetTile(tile_itr);
+    EXPECT_TRUE(dynamic_cast<storage::CompressedTile *>(compressed_tile) !=
+                nullptr);
+    EXPECT_EQ(tile_group->GetTileId(tile_itr), compressed_tile->GetTileId());
+  }
+
+  oid_t tuple_count = tile_group->GetAllocatedTupleCount();
+  for (oid_t tuple_itr = 0; tuple_itr < tuple_count; tuple_itr++) {
+    for (oid_t column_itr = 0; column_itr < 4; column_itr++) {
+      EXPECT_EQ(tile_group->GetValue(tuple_itr, column_itr),
+                compressed_tile_group->GetValue(tuple_itr, column_itr));
+    }
+  }
+}
+
+TEST(CompressedTileTests, CompressTileGroupsTest) {
+  const int tuples_per_tilegroup = 100;
+
+  auto &txn_manager = concurrency::TransactionManager::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  std::unique_ptr<storage::DataTable> data_table(
+      ExecutorTestsUtil::CreateTable(tuples_per_tilegroup, false));
+  ExecutorTestsUtil::PopulateTable(txn, data_table.get(),
+                                   tuples_per_tilegroup * 2 + 1, false, false,
+                                   false);
+  txn_manager.CommitTransaction();
+
+  auto tile_group = data_table->GetTileGroup(0);
+
+  // Only the full tile groups get compressed
+  EXPECT_EQ(2, data_table->CompressTileGroups());
+  EXPECT_FALSE(data_table->GetTileGroup(2)->IsCompressed());
+
+  auto compressed_tile_group = data_table->GetTileGroup(0);
+  EXPECT_NE(tile_group.get(), compressed_tile_group.get());
+  CheckCompressedTileGroup(tile_group.get(), compressed_tile_group.get());
+
+  auto compressed_tile = dynamic_cast<storage::CompressedTile *>(
+      compressed_tile_group->GetTile(0));
+  EXPECT_TRUE(compressed_tile != nullptr);
+
+  // A compressed tile group keeps its layout, whatever the threshold
+  EXPECT_TRUE(data_table->TransformTileGroup(0, 0.0) == nullptr);
+  EXPECT_EQ(compressed_tile_group, data_table->GetTileGroup(0));
+
+  // Unique integers
+  EXPECT_EQ(ENCODING_TYPE_FOR, compressed_tile->GetEncodingType(0));
+  EXPECT_EQ(ENCODING_TYPE_FOR, compressed_tile->GetEncodingType(1));
+  // Unique doubles
+  EXPECT_EQ(ENCODING_TYPE_NONE, compressed_tile->GetEncodingType(2));
+  // Uninlined strings
+  EXPECT_EQ(ENCODING_TYPE_DICTIONARY, compressed_tile->GetEncodingType(3));
+
+  EXPECT_LT(compressed_tile->GetInlinedSize(),
+            compressed_tile->GetUncompressedSize());
+
+  // Already compressed
+  EXPECT_EQ(0, data_table->CompressTileGroups());
+}
+
+TEST(CompressedTileTests, EncodingTest) {
+  const int tuples_per_tilegroup = 240;
+
+  auto &txn_manager = concurrency::TransactionManager::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  std::unique_ptr<storage::DataTable> data_table(
+      ExecutorTestsUtil::CreateTable(tuples_per_tilegroup, false));
+  // The first column has two long runs and
+  // the other columns have only a third of distinct values
+  ExecutorTestsUtil::PopulateTable(txn, data_table.get(), tuples_per_tilegroup,
+                                   false, true, true);
+  txn_manager.CommitTransaction();
+
+  // No uncompressed tiles are built on the way
+  auto &manager = catalog::Manager::GetInstance();
+  oid_t current_oid = manager.GetCurrentOid();
+
+  auto tile_group = data_table->GetTileGroup(0);
+  auto compressed_tile_group = data_table->CompressTileGroup(0);
+  EXPECT_TRUE(compressed_tile_group != nullptr);
+  EXPECT_EQ(current_oid, manager.GetCurrentOid());
+  CheckCompressedTileGroup(tile_group.get(), compressed_tile_group);
+
+  auto compressed_tile = dynamic_cast<storage::CompressedTile *>(
+      compressed_tile_group->GetTile(0));
+  EXPECT_TRUE(compressed_tile != nullptr);
+
+  EXPECT_EQ(ENCODING_TYPE_RLE, compressed_tile->GetEncodingType(0));
+  EXPECT_EQ(ENCODING_TYPE_FOR, compressed_tile->GetEncodingType(1));
+  EXPECT_EQ(ENCODING_TYPE_DICTIONARY, compressed_tile->GetEncodingType(3));
+}
+
+}  // End test namespace
+}  // End peloton namespace
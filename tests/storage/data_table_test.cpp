@@ -12,9 +12,21 @@
 
 #include "gtest/gtest.h"
 
+#include "backend/brain/reorganizer.h"
+#include "backend/catalog/manager.h"
+#include "backend/catalog/schema.h"
+#include "backend/common/value.h"
+#include "backend/common/value_factory.h"
+#include "backend/index/index.h"
 #include "backend/storage/data_table.h"
+#include "backend/storage/database.h"
+#include "backend/storage/garbage_collector.h"
+#include "backend/storage/table_factory.h"
 #include "backend/storage/tile_group.h"
+#include "backend/storage/tile_group_header.h"
+#include "backend/storage/tuple.h"
 #include "executor/executor_tests_util.h"
+#include "harness.h"
 
 namespace peloton {
 namespace test {
@@ -67,5 +79,489 @@ TEST(DataTableTests, TransformTileGroupTest) {
   data_table->TransformTileGroup(0, theta);
 }
 
+TEST(DataTableTests, ReorganizeTileGroupsTest) {
+  const int tuple_count = TESTS_TUPLES_PER_TILEGROUP;
+
+  // Create an adaptive table
+  catalog::Schema *table_schema = new catalog::Schema(
+      {ExecutorTestsUtil::GetColumnInfo(0), ExecutorTestsUtil::GetColumnInfo(1),
+       ExecutorTestsUtil::GetColumnInfo(2),
+       ExecutorTestsUtil::GetColumnInfo(3)});
+  storage::DataTable *data_table = storage::TableFactory::GetDataTable(
+      INVALID_OID, INVALID_OID, table_schema, "TEST_TABLE", tuple_count, true,
+      true);
+
+  // The database owns the table
+  storage::Database database(INVALID_OID);
+  database.AddTable(data_table);
+
+  // Fill up two tile groups and leave the third one partially filled
+  auto &txn_manager = concurrency::TransactionManager::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  ExecutorTestsUtil::PopulateTable(txn, data_table, tuple_count * 2 + 1, false,
+                                   false, false);
+  txn_manager.CommitTransaction();
+  EXPECT_EQ(3, data_table->GetTileGroupCount());
+
+  // No samples yet, so there is nothing to adapt to
+  brain::Reorganizer reorganizer(&database);
+  EXPECT_EQ(0, reorganizer.Reorganize());
+
+  // Queries only access the first two columns
+  for (int sample_itr = 0; sample_itr < 10; sample_itr++) {
+    brain::Sample sample({1, 1, 0, 0});
+    data_table->RecordSample(sample);
+  }
+
+  auto orig_tile_group = data_table->GetTileGroup(0);
+  auto orig_header = orig_tile_group->GetHeader();
+
+  // Only the cold tile groups get transformed
+  EXPECT_EQ(2, reorganizer.Reorganize());
+
+  auto default_partition = data_table->GetDefaultPartition();
+  for (oid_t tile_group_itr = 0; tile_group_itr < 2; tile_group_itr++) {
+    auto tile_group = data_table->GetTileGroup(tile_group_itr);
+    EXPECT_EQ(default_partition, tile_group->GetColumnMap());
+  }
+  EXPECT_NE(default_partition, data_table->GetTileGroup(2)->GetColumnMap());
+
+  // The transformed tile group shares the header and holds the same values
+  auto new_tile_group = data_table->GetTileGroup(0);
+  EXPECT_NE(orig_tile_group.get(), new_tile_group.get());
+  EXPECT_EQ(orig_header, new_tile_group->GetHeader());
+  for (oid_t tuple_itr = 0; tuple_itr < (oid_t)tuple_count; tuple_itr++) {
+    for (oid_t column_itr = 0; column_itr < 4; column_itr++) {
+      EXPECT_EQ(orig_tile_group->GetValue(tuple_itr, column_itr),
+                new_tile_group->GetValue(tuple_itr, column_itr));
+    }
+  }
+
+  // Already in the right layout
+  EXPECT_EQ(0, reorganizer.Reorganize());
+
+  // The background thread can be started and stopped
+  reorganizer.Start();
+  EXPECT_TRUE(reorganizer.IsRunning());
+  reorganizer.Stop();
+  EXPECT_FALSE(reorganizer.IsRunning());
+}
+
+TEST(DataTableTests, CollectGarbageTest) {
+  const int tuple_count = TESTS_TUPLES_PER_TILEGROUP;
+  auto testing_pool = TestingHarness::GetInstance().GetTestingPool();
+
+  // Create a table with indexes and fill up a tile group
+  storage::DataTable *data_table =
+      ExecutorTestsUtil::CreateTable(tuple_count, true);
+  storage::Database database(INVALID_OID);
+  database.AddTable(data_table);
+
+  auto &txn_manager = concurrency::TransactionManager::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  ExecutorTestsUtil::PopulateTable(txn, data_table, tuple_count, false, false,
+                                   false);
+  txn_manager.CommitTransaction();
+
+  auto tile_group = data_table->GetTileGroup(0);
+  auto header = tile_group->GetHeader();
+  oid_t tile_group_id = tile_group->GetTileGroupId();
+  auto primary_index = data_table->GetIndex(0);
+  EXPECT_EQ(tuple_count, header->GetNextTupleSlot());
+  EXPECT_EQ(tuple_count, primary_index->ScanAllKeys().size());
+
+  // A reader that started before the delete still sees the old versions
+  auto reader_txn = txn_manager.BeginTransaction();
+  concurrency::current_txn = nullptr;
+
+  txn = txn_manager.BeginTransaction();
+  for (oid_t tuple_itr = 0; tuple_itr < 2; tuple_itr++) {
+    ItemPointer location(tile_group_id, tuple_itr);
+    EXPECT_TRUE(data_table->DeleteTuple(txn, location));
+    txn->RecordDelete(location);
+  }
+  txn_manager.CommitTransaction();
+
+  EXPECT_EQ(0, database.CollectGarbage());
+
+  concurrency::current_txn = reader_txn;
+  txn_manager.CommitTransaction();
+
+  // Now the deleted versions are not visible to anyone, and their strings
+  // are garbage in the pool
+  auto tile_pool = tile_group->GetTilePool(0);
+  auto freed_memory = tile_pool->GetFreedMemory();
+  EXPECT_EQ(2, database.CollectGarbage());
+  EXPECT_EQ(2, header->GetFreeTupleSlotCount());
+  EXPECT_GT(tile_pool->GetFreedMemory(), freed_memory);
+  EXPECT_EQ(tuple_count - 2, primary_index->ScanAllKeys().size());
+
+  // Inserts reuse the reclaimed slots
+  txn = txn_manager.BeginTransaction();
+  std::unique_ptr<storage::Tuple> tuple(
+      ExecutorTestsUtil::GetTuple(data_table, 100, testing_pool));
+  ItemPointer location = data_table->InsertTuple(txn, tuple.get());
+  txn->RecordInsert(location);
+  txn_manager.CommitTransaction();
+
+  EXPECT_EQ(tile_group_id, location.block);
+  EXPECT_LT(location.offset, 2);
+  EXPECT_EQ(1, header->GetFreeTupleSlotCount());
+  EXPECT_EQ(1, data_table->GetTileGroupCount());
+
+  // So do batch inserts
+  txn = txn_manager.BeginTransaction();
+  std::unique_ptr<storage::Tuple> other_tuple(
+      ExecutorTestsUtil::GetTuple(data_table, 101, testing_pool));
+  auto locations = data_table->InsertTuples(txn, {other_tuple.get()});
+  EXPECT_EQ(1, locations.size());
+  for (auto location : locations) txn->RecordInsert(location);
+  txn_manager.CommitTransaction();
+
+  EXPECT_EQ(tile_group_id, locations[0].block);
+  EXPECT_LT(locations[0].offset, 2);
+  EXPECT_NE(location.offset, locations[0].offset);
+  EXPECT_EQ(0, header->GetFreeTupleSlotCount());
+  EXPECT_EQ(1, data_table->GetTileGroupCount());
+
+  // Delete everything, the tile group then starts over
+  txn = txn_manager.BeginTransaction();
+  for (oid_t tuple_itr = 0; tuple_itr < (oid_t)tuple_count; tuple_itr++) {
+    if (header->GetTransactionId(tuple_itr) == INVALID_TXN_ID) continue;
+    ItemPointer location(tile_group_id, tuple_itr);
+    EXPECT_TRUE(data_table->DeleteTuple(txn, location));
+    txn->RecordDelete(location);
+  }
+  txn_manager.CommitTransaction();
+
+  EXPECT_EQ(tuple_count, database.CollectGarbage());
+  EXPECT_EQ(0, header->GetNextTupleSlot());
+  EXPECT_EQ(0, header->GetFreeTupleSlotCount());
+  EXPECT_EQ(0, primary_index->ScanAllKeys().size());
+
+  // Nothing left to reclaim
+  EXPECT_EQ(0, database.CollectGarbage());
+
+  // The background thread can be started and stopped
+  storage::GarbageCollector garbage_collector(&database);
+  garbage_collector.Start();
+  EXPECT_TRUE(garbage_collector.IsRunning());
+  garbage_collector.Stop();
+  EXPECT_FALSE(garbage_collector.IsRunning());
+}
+
+// Delete all the tuples of the first tile group, and reclaim them
+static void CollectAllGarbage(storage::DataTable *data_table, int tuple_count) {
+  storage::Database database(INVALID_OID);
+  database.AddTable(data_table);
+
+  auto testing_pool = TestingHarness::GetInstance().GetTestingPool();
+  auto schema = data_table->GetSchema();
+
+  auto &txn_manager = concurrency::TransactionManager::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  for (int tuple_itr = 0; tuple_itr < tuple_count; tuple_itr++) {
+    storage::Tuple tuple(schema, true);
+    for (oid_t column_itr = 0; column_itr < schema->GetColumnCount();
+         column_itr++) {
+      switch (schema->GetType(column_itr)) {
+        case VALUE_TYPE_INTEGER:
+          tuple.SetValue(column_itr, ValueFactory::GetIntegerValue(tuple_itr),
+                         testing_pool);
+          break;
+        case VALUE_TYPE_DOUBLE:
+          tuple.SetValue(column_itr, ValueFactory::GetDoubleValue(tuple_itr),
+                         testing_pool);
+          break;
+        default:
+          tuple.SetValue(column_itr, ValueFactory::GetStringValue(
+                                         std::to_string(tuple_itr)),
+                         testing_pool);
+          break;
+      }
+    }
+    ItemPointer location = data_table->InsertTuple(txn, &tuple);
+    txn->RecordInsert(location);
+  }
+  txn_manager.CommitTransaction();
+
+  auto tile_group = data_table->GetTileGroup(0);
+  auto header = tile_group->GetHeader();
+  oid_t tile_group_id = tile_group->GetTileGroupId();
+  EXPECT_EQ(tuple_count, header->GetNextTupleSlot());
+
+  txn = txn_manager.BeginTransaction();
+  for (oid_t tuple_itr = 0; tuple_itr < (oid_t)tuple_count; tuple_itr++) {
+    ItemPointer location(tile_group_id, tuple_itr);
+    EXPECT_TRUE(data_table->DeleteTuple(txn, location));
+    txn->RecordDelete(location);
+  }
+  txn_manager.CommitTransaction();
+
+  // The tile group starts over, whatever pools its tiles have
+  EXPECT_EQ(tuple_count, database.CollectGarbage());
+  EXPECT_EQ(0, header->GetNextTupleSlot());
+  EXPECT_EQ(0, header->GetFreeTupleSlotCount());
+}
+
+TEST(DataTableTests, CollectGarbageLayoutTest) {
+  const int tuple_count = TESTS_TUPLES_PER_TILEGROUP;
+
+  // Only inlined columns, so no tile has a pool
+  auto table_schema = new catalog::Schema(
+      {ExecutorTestsUtil::GetColumnInfo(0), ExecutorTestsUtil::GetColumnInfo(1),
+       ExecutorTestsUtil::GetColumnInfo(2)});
+  CollectAllGarbage(storage::TableFactory::GetDataTable(
+                        INVALID_OID, INVALID_OID, table_schema, "INLINED_TABLE",
+                        tuple_count, true, false),
+                    tuple_count);
+
+  // One column per tile, only the varchar tile has a pool
+  peloton_layout_mode = LAYOUT_COLUMN;
+  CollectAllGarbage(ExecutorTestsUtil::CreateTable(tuple_count, false),
+                    tuple_count);
+  peloton_layout_mode = LAYOUT_ROW;
+}
+
+TEST(DataTableTests, InsertTuplesTest) {
+  const int tuple_count = TESTS_TUPLES_PER_TILEGROUP;
+  const int batch_size = tuple_count * 2 + tuple_count / 2;
+  auto testing_pool = TestingHarness::GetInstance().GetTestingPool();
+
+  // Create a table with indexes
+  std::unique_ptr<storage::DataTable> data_table(
+      ExecutorTestsUtil::CreateTable(tuple_count, true));
+  auto primary_index = data_table->GetIndex(0);
+
+  std::vector<std::unique_ptr<storage::Tuple>> tuples;
+  std::vector<const storage::Tuple *> batch;
+  for (int tuple_itr = 0; tuple_itr < batch_size; tuple_itr++) {
+    tuples.emplace_back(
+        ExecutorTestsUtil::GetTuple(data_table.get(), tuple_itr, testing_pool));
+    batch.push_back(tuples.back().get());
+  }
+
+  // Insert the batch across several tile groups
+  auto &txn_manager = concurrency::TransactionManager::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  auto locations = data_table->InsertTuples(txn, batch);
+  EXPECT_EQ(batch_size, locations.size());
+  for (auto location : locations) {
+    txn->RecordInsert(location);
+  }
+  txn_manager.CommitTransaction();
+
+  EXPECT_EQ(3, data_table->GetTileGroupCount());
+  EXPECT_EQ(batch_size, primary_index->ScanAllKeys().size());
+  EXPECT_EQ(batch_size, data_table->GetNumberOfTuples());
+
+  // The tuples are stored at their locations
+  auto &manager = catalog::Manager::GetInstance();
+  for (int tuple_itr = 0; tuple_itr < batch_size; tuple_itr++) {
+    auto location = locations[tuple_itr];
+    auto tile_group = manager.GetTileGroup(location.block);
+    for (oid_t column_itr = 0; column_itr < 4; column_itr++) {
+      EXPECT_EQ(batch[tuple_itr]->GetValue(column_itr),
+                tile_group->GetValue(location.offset, column_itr));
+    }
+    auto prev_location =
+        tile_group->GetHeader()->GetPrevItemPointer(location.offset);
+    EXPECT_EQ(INVALID_OID, prev_location.block);
+    EXPECT_EQ(INVALID_OID, prev_location.offset);
+  }
+
+  // Every key points to its tuple
+  auto primary_key_schema = primary_index->GetKeySchema();
+  auto primary_key_columns = primary_key_schema->GetIndexedColumns();
+  for (int tuple_itr = 0; tuple_itr < batch_size; tuple_itr++) {
+    storage::Tuple key(primary_key_schema, true);
+    key.SetFromTuple(batch[tuple_itr], primary_key_columns, testing_pool);
+    auto key_locations = primary_index->ScanKey(&key);
+    EXPECT_EQ(1, key_locations.size());
+    EXPECT_EQ(locations[tuple_itr].block, key_locations.at(0).block);
+    EXPECT_EQ(locations[tuple_itr].offset, key_locations.at(0).offset);
+  }
+
+  // A batch with a duplicate key is rejected
+  std::unique_ptr<storage::Tuple> new_tuple(
+      ExecutorTestsUtil::GetTuple(data_table.get(), batch_size, testing_pool));
+  txn = txn_manager.BeginTransaction();
+  locations = data_table->InsertTuples(txn, {new_tuple.get(), new_tuple.get()});
+  EXPECT_TRUE(locations.empty());
+  txn_manager.AbortTransaction();
+
+  // So is a batch with a key that is already taken
+  txn = txn_manager.BeginTransaction();
+  locations = data_table->InsertTuples(txn, {new_tuple.get(), batch[0]});
+  EXPECT_TRUE(locations.empty());
+  txn_manager.AbortTransaction();
+
+  EXPECT_EQ(batch_size, primary_index->ScanAllKeys().size());
+}
+
+TEST(DataTableTests, ReadOnlyWriteTest) {
+  const int tuple_count = TESTS_TUPLES_PER_TILEGROUP;
+  auto testing_pool = TestingHarness::GetInstance().GetTestingPool();
+
+  std::unique_ptr<storage::DataTable> data_table(
+      ExecutorTestsUtil::CreateTable(tuple_count, true));
+
+  auto &txn_manager = concurrency::TransactionManager::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  ExecutorTestsUtil::PopulateTable(txn, data_table.get(), tuple_count, false,
+                                   false, false);
+  txn_manager.CommitTransaction();
+
+  oid_t tile_group_id = data_table->GetTileGroup(0)->GetTileGroupId();
+  ItemPointer location(tile_group_id, 0);
+  std::unique_ptr<storage::Tuple> new_tuple(
+      ExecutorTestsUtil::GetTuple(data_table.get(), tuple_count, testing_pool));
+
+  // The writes of a read-only txn are turned down, and leave the table as
+  // it was
+  txn = txn_manager.BeginReadOnlyTransaction();
+  EXPECT_EQ(INVALID_OID,
+            data_table->InsertTuple(txn, new_tuple.get()).block);
+  EXPECT_TRUE(data_table->InsertTuples(txn, {new_tuple.get()}).empty());
+  EXPECT_FALSE(data_table->DeleteTuple(txn, location));
+  EXPECT_EQ(tuple_count, data_table->GetNumberOfTuples());
+  EXPECT_EQ(tuple_count, data_table->GetIndex(0)->ScanAllKeys().size());
+  EXPECT_EQ(RESULT_SUCCESS, txn->GetResult());
+
+  // Recording a write fails the txn, and nothing is written at commit
+  txn->RecordInsert(location);
+  txn->RecordDelete(location);
+  EXPECT_EQ(RESULT_FAILURE, txn->GetResult());
+  EXPECT_TRUE(txn->GetInsertedTuples().IsEmpty());
+  EXPECT_TRUE(txn->GetDeletedTuples().IsEmpty());
+  EXPECT_EQ(RESULT_FAILURE, txn_manager.CommitTransaction());
+
+  // The tuple can still be deleted by a regular txn
+  txn = txn_manager.BeginTransaction();
+  EXPECT_TRUE(data_table->DeleteTuple(txn, location));
+  txn->RecordDelete(location);
+  EXPECT_EQ(RESULT_SUCCESS, txn_manager.CommitTransaction());
+}
+
+void ConflictTest(storage::DataTable *data_table, ItemPointer location,
+                  std::atomic<int> *delete_count) {
+  auto &txn_manager = concurrency::TransactionManager::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+
+  if (data_table->DeleteTuple(txn, location)) {
+    (*delete_count)++;
+    txn->RecordDelete(location);
+    txn_manager.CommitTransaction();
+  } else {
+    txn_manager.AbortTransaction();
+  }
+}
+
+TEST(DataTableTests, ConflictTest) {
+  const int tuple_count = TESTS_TUPLES_PER_TILEGROUP;
+
+  std::unique_ptr<storage::DataTable> data_table(
+      ExecutorTestsUtil::CreateTable(tuple_count, false));
+
+  auto &txn_manager = concurrency::TransactionManager::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  ExecutorTestsUtil::PopulateTable(txn, data_table.get(), tuple_count, false,
+                                   false, false);
+  txn_manager.CommitTransaction();
+
+  oid_t tile_group_id = data_table->GetTileGroup(0)->GetTileGroupId();
+  ItemPointer location(tile_group_id, 0);
+
+  auto first_txn = txn_manager.BeginTransaction();
+  auto second_txn = txn_manager.BeginTransaction();
+  concurrency::current_txn = nullptr;
+
+  // The first updater wins
+  EXPECT_TRUE(data_table->DeleteTuple(first_txn, location));
+  first_txn->RecordDelete(location);
+  EXPECT_FALSE(data_table->DeleteTuple(second_txn, location));
+  EXPECT_EQ(1, data_table->GetConflictCount());
+
+  // Even after it commits
+  concurrency::current_txn = first_txn;
+  txn_manager.CommitTransaction();
+  EXPECT_FALSE(data_table->DeleteTuple(second_txn, location));
+  EXPECT_EQ(2, data_table->GetConflictCount());
+
+  concurrency::current_txn = second_txn;
+  txn_manager.AbortTransaction();
+
+  // Only one of the concurrent deletes goes through
+  std::atomic<int> delete_count(0);
+  LaunchParallelTest(8, ConflictTest, data_table.get(),
+                     ItemPointer(tile_group_id, 1), &delete_count);
+  EXPECT_EQ(1, delete_count);
+  EXPECT_EQ(2 + 7, data_table->GetConflictCount());
+}
+
+TEST(DataTableTests, OptimisticConcurrencyTest) {
+  const int tuple_count = TESTS_TUPLES_PER_TILEGROUP;
+
+  std::unique_ptr<storage::DataTable> data_table(
+      ExecutorTestsUtil::CreateTable(tuple_count, false));
+
+  auto &txn_manager = concurrency::TransactionManager::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  ExecutorTestsUtil::PopulateTable(txn, data_table.get(), tuple_count, false,
+                                   false, false);
+  txn_manager.CommitTransaction();
+
+  auto tile_group = data_table->GetTileGroup(0);
+  auto header = tile_group->GetHeader();
+  oid_t tile_group_id = tile_group->GetTileGroupId();
+  ItemPointer read_location(tile_group_id, 0);
+  ItemPointer other_location(tile_group_id, 1);
+
+  txn_manager.SetConcurrencyType(CONCURRENCY_TYPE_OCC);
+  auto abort_count = txn_manager.GetValidationAbortCount();
+
+  // A reader whose read version is deleted before it commits fails
+  auto reader_txn = txn_manager.BeginTransaction();
+  EXPECT_TRUE(reader_txn->IsTrackingReads());
+  reader_txn->RecordRead(read_location, header->GetBeginCommitId(0));
+  concurrency::current_txn = nullptr;
+
+  txn = txn_manager.BeginTransaction();
+  EXPECT_TRUE(data_table->DeleteTuple(txn, read_location));
+  txn->RecordDelete(read_location);
+  EXPECT_EQ(RESULT_SUCCESS, txn_manager.CommitTransaction());
+
+  concurrency::current_txn = reader_txn;
+  EXPECT_EQ(RESULT_ABORTED, txn_manager.CommitTransaction());
+  EXPECT_EQ(abort_count + 1, txn_manager.GetValidationAbortCount());
+
+  // Reads that nobody wrote validate fine
+  txn = txn_manager.BeginTransaction();
+  txn->RecordRead(other_location, header->GetBeginCommitId(1));
+  EXPECT_EQ(RESULT_SUCCESS, txn_manager.CommitTransaction());
+
+  // Read-only txns only read their snapshot
+  txn = txn_manager.BeginReadOnlyTransaction();
+  EXPECT_FALSE(txn->IsTrackingReads());
+  txn_manager.CommitTransaction();
+
+  // Under MVCC, the same interleaving commits
+  txn_manager.SetConcurrencyType(CONCURRENCY_TYPE_MVCC);
+
+  reader_txn = txn_manager.BeginTransaction();
+  EXPECT_FALSE(reader_txn->IsTrackingReads());
+  reader_txn->RecordRead(other_location, header->GetBeginCommitId(1));
+  concurrency::current_txn = nullptr;
+
+  txn = txn_manager.BeginTransaction();
+  EXPECT_TRUE(data_table->DeleteTuple(txn, other_location));
+  txn->RecordDelete(other_location);
+  EXPECT_EQ(RESULT_SUCCESS, txn_manager.CommitTransaction());
+
+  concurrency::current_txn = reader_txn;
+  EXPECT_EQ(RESULT_SUCCESS, txn_manager.CommitTransaction());
+  EXPECT_EQ(abort_count + 1, txn_manager.GetValidationAbortCount());
+}
+
 }  // End test namespace
 }  // End peloton namespace
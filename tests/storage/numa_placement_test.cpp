@@ -0,0 +1,125 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// numa_placement_test.cpp
+//
+// Identification: tests/storage/numa_placement_test.cpp
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <memory>
+
+#include "gtest/gtest.h"
+
+#include "backend/common/numa_manager.h"
+#include "backend/concurrency/transaction_manager.h"
+#include "backend/storage/data_table.h"
+#include "backend/storage/tile.h"
+#include "backend/storage/tile_group.h"
+#include "backend/storage/tile_group_factory.h"
+#include "backend/storage/tile_group_header.h"
+
+#include "executor/executor_tests_util.h"
+#include "harness.h"
+
+namespace peloton {
+namespace test {
+
+//===--------------------------------------------------------------------===//
+// NUMA Placement Tests
+//===--------------------------------------------------------------------===//
+
+TEST(NumaPlacementTests, PlacementTest) {
+  auto &numa_manager = NumaManager::GetInstance();
+  int node_count = numa_manager.GetNodeCount();
+  EXPECT_GE(node_count, 1);
+
+  numa_manager.SetPlacementType(NUMA_PLACEMENT_TYPE_ROUND_ROBIN);
+  EXPECT_EQ(NUMA_PLACEMENT_TYPE_ROUND_ROBIN, numa_manager.GetPlacementType());
+
+  // Every placement is on a valid node
+  for (int node_itr = 0; node_itr < 2 * node_count; node_itr++) {
+    int node = numa_manager.GetPlacementNode();
+    EXPECT_GE(node, 0);
+    EXPECT_LT(node, node_count);
+  }
+
+  numa_manager.SetPlacementType(NUMA_PLACEMENT_TYPE_LOCAL);
+  int node = numa_manager.GetPlacementNode();
+  EXPECT_GE(node, 0);
+  EXPECT_LT(node, node_count);
+
+  // Without NUMA, pinning is a no-op
+  if (numa_manager.IsAvailable() == false) {
+    EXPECT_FALSE(numa_manager.PinThread(0));
+  }
+}
+
+TEST(NumaPlacementTests, AllocateTest) {
+  auto &numa_manager = NumaManager::GetInstance();
+
+  // Memory on every node is zeroed and writable, with or without NUMA
+  const size_t size = 3 * 4096 + 17;
+  for (int node = 0; node < numa_manager.GetNodeCount(); node++) {
+    char *data = reinterpret_cast<char *>(numa_manager.Allocate(size, node));
+    ASSERT_TRUE(data != nullptr);
+
+    for (size_t offset = 0; offset < size; offset++) {
+      ASSERT_EQ(0, data[offset]);
+    }
+    data[0] = data[size - 1] = 1;
+
+    numa_manager.Release(data, size);
+  }
+
+  EXPECT_TRUE(numa_manager.Allocate(0, 0) == nullptr);
+}
+
+TEST(NumaPlacementTests, TileGroupTest) {
+  const int tuple_count = TESTS_TUPLES_PER_TILEGROUP;
+  const int tile_group_count = 5;
+
+  auto &txn_manager = concurrency::TransactionManager::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  std::unique_ptr<storage::DataTable> data_table(
+      ExecutorTestsUtil::CreateTable(tuple_count, false));
+  ExecutorTestsUtil::PopulateTable(txn, data_table.get(),
+                                   tuple_count * tile_group_count, false,
+                                   false, false);
+  txn_manager.CommitTransaction();
+
+  oid_t table_tile_group_count = data_table->GetTileGroupCount();
+  EXPECT_GE(table_tile_group_count, tile_group_count);
+
+  // Every tile group is recorded on a valid node
+  int node_count = NumaManager::GetInstance().GetNodeCount();
+  for (oid_t offset = 0; offset < table_tile_group_count; offset++) {
+    int node = data_table->GetTileGroup(offset)->GetNumaNode();
+    EXPECT_GE(node, 0);
+    EXPECT_LT(node, node_count);
+  }
+
+  // A new tile group starts out zeroed, wherever its memory comes from
+  auto tile_group = data_table->GetTileGroup(0);
+  std::unique_ptr<storage::TileGroup> new_tile_group(
+      storage::TileGroupFactory::GetTileGroup(
+          tile_group->GetDatabaseId(), tile_group->GetTableId(),
+          tile_group->GetTileGroupId(), tile_group->GetAbstractTable(),
+          tile_group->GetTileSchemas(), tile_group->GetColumnMap(),
+          tile_group->GetAllocatedTupleCount()));
+  EXPECT_EQ(0, new_tile_group->GetHeader()->GetNextTupleSlot());
+  for (oid_t tile_itr = 0; tile_itr < new_tile_group->GetTileCount();
+       tile_itr++) {
+    auto tile = new_tile_group->GetTile(tile_itr);
+    const char *data = tile->GetTupleLocation(0);
+    for (size_t offset = 0; offset < tile->GetSize(); offset++) {
+      ASSERT_EQ(0, data[offset]);
+    }
+  }
+}
+
+}  // End test namespace
+}  // End peloton namespace
@@ -10,7 +10,10 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <unistd.h>
+
 #include "gtest/gtest.h"
+#include "backend/storage/data_file.h"
 #include "backend/storage/storage_manager.h"
 
 namespace peloton {
@@ -51,5 +54,134 @@ TEST(StorageManagerTests, BasicTest) {
   }
 }
 
+/**
+ * Test extent reuse in a data file
+ *
+ */
+TEST(StorageManagerTests, DataFileTest) {
+  const std::string file_name = "/tmp/peloton_data_file_test.data";
+  unlink(file_name.c_str());
+
+  peloton::storage::DataFile data_file(file_name);
+  const size_t page_size = sysconf(_SC_PAGESIZE);
+  const size_t chunk_size = DATA_FILE_CHUNK_SIZE;
+
+  // Extents are page-aligned and carved out of one chunk
+  auto first_extent = data_file.AllocateExtent(100);
+  auto second_extent = data_file.AllocateExtent(3 * page_size);
+  EXPECT_NE(nullptr, first_extent);
+  EXPECT_NE(nullptr, second_extent);
+  EXPECT_EQ(0, reinterpret_cast<uintptr_t>(first_extent) % page_size);
+  EXPECT_EQ(static_cast<char *>(first_extent) + page_size, second_extent);
+  EXPECT_EQ(chunk_size, data_file.GetFileSize());
+  EXPECT_EQ(chunk_size - 4 * page_size, data_file.GetFreeSize());
+
+  memset(first_extent, '-', page_size);
+  memset(second_extent, '-', 3 * page_size);
+
+  // Released extents are reused
+  EXPECT_TRUE(data_file.ReleaseExtent(first_extent));
+  EXPECT_FALSE(data_file.ReleaseExtent(first_extent));
+  EXPECT_EQ(chunk_size - 3 * page_size, data_file.GetFreeSize());
+
+  auto third_extent = data_file.AllocateExtent(10);
+  EXPECT_EQ(first_extent, third_extent);
+  EXPECT_EQ(chunk_size, data_file.GetFileSize());
+  EXPECT_EQ(chunk_size - 4 * page_size, data_file.GetFreeSize());
+
+  // Adjacent free extents are coalesced
+  EXPECT_TRUE(data_file.ReleaseExtent(second_extent));
+  EXPECT_TRUE(data_file.ReleaseExtent(third_extent));
+  EXPECT_EQ(chunk_size, data_file.GetFreeSize());
+
+  auto fourth_extent = data_file.AllocateExtent(chunk_size);
+  EXPECT_EQ(first_extent, fourth_extent);
+  EXPECT_EQ(chunk_size, data_file.GetFileSize());
+
+  // The file grows by a chunk when no free extent is large enough
+  auto fifth_extent = data_file.AllocateExtent(page_size);
+  EXPECT_NE(nullptr, fifth_extent);
+  EXPECT_EQ(2 * chunk_size, data_file.GetFileSize());
+
+  // Free extents of different chunks are not coalesced, and extents
+  // larger than a chunk get a chunk of their own
+  EXPECT_TRUE(data_file.ReleaseExtent(fourth_extent));
+  EXPECT_TRUE(data_file.ReleaseExtent(fifth_extent));
+  EXPECT_EQ(2 * chunk_size, data_file.GetFreeSize());
+
+  auto sixth_extent = data_file.AllocateExtent(chunk_size + page_size);
+  EXPECT_NE(nullptr, sixth_extent);
+  EXPECT_EQ(3 * chunk_size + page_size, data_file.GetFileSize());
+  EXPECT_EQ(2 * chunk_size, data_file.GetFreeSize());
+
+  unlink(file_name.c_str());
+}
+
+/**
+ * Test reopening an existing data file
+ *
+ */
+TEST(StorageManagerTests, DataFileReopenTest) {
+  const std::string file_name = "/tmp/peloton_data_file_reopen_test.data";
+  unlink(file_name.c_str());
+  const size_t page_size = sysconf(_SC_PAGESIZE);
+
+  {
+    peloton::storage::DataFile data_file(file_name);
+    auto extent = data_file.AllocateExtent(page_size);
+    EXPECT_NE(nullptr, extent);
+    memset(extent, '-', page_size);
+  }
+
+  // The existing file is not truncated, and its space is reused
+  peloton::storage::DataFile data_file(file_name);
+  EXPECT_EQ(DATA_FILE_CHUNK_SIZE, data_file.GetFileSize());
+  EXPECT_EQ(DATA_FILE_CHUNK_SIZE, data_file.GetFreeSize());
+
+  auto extent = data_file.AllocateExtent(page_size);
+  EXPECT_NE(nullptr, extent);
+  EXPECT_EQ('-', static_cast<char *>(extent)[0]);
+  EXPECT_EQ(DATA_FILE_CHUNK_SIZE, data_file.GetFileSize());
+
+  unlink(file_name.c_str());
+}
+
+/**
+ * Test per-table data files
+ *
+ */
+TEST(StorageManagerTests, FileBackendTest) {
+  peloton::storage::StorageManager storage_manager;
+  storage_manager.SetDataDirectory("/tmp");
+  EXPECT_TRUE(storage_manager.HasDataDirectory());
+  EXPECT_EQ("/tmp/", storage_manager.GetDataDirectory());
+
+  const peloton::oid_t table_id = 12345;
+  size_t length = 256;
+  unlink("/tmp/table_12345.data");
+
+  auto location = storage_manager.Allocate(peloton::BACKEND_TYPE_FILE, length,
+                                           table_id);
+  EXPECT_NE(nullptr, location);
+
+  memset(location, '-', length);
+  storage_manager.Sync(peloton::BACKEND_TYPE_FILE, location, length);
+  storage_manager.AdviseSequential(peloton::BACKEND_TYPE_FILE, location,
+                                   length);
+
+  auto data_file = storage_manager.GetDataFile(table_id);
+  EXPECT_EQ("/tmp/table_12345.data", data_file->GetFileName());
+  EXPECT_EQ(DATA_FILE_CHUNK_SIZE, data_file->GetFileSize());
+  EXPECT_EQ(DATA_FILE_CHUNK_SIZE - peloton::storage::DataFile::GetExtentSize(
+                                       length),
+            data_file->GetFreeSize());
+
+  // The extent goes back to the data file of the table
+  storage_manager.Release(peloton::BACKEND_TYPE_FILE, location);
+  EXPECT_EQ(data_file->GetFileSize(), data_file->GetFreeSize());
+
+  unlink(data_file->GetFileName().c_str());
+}
+
 }  // End test namespace
 }  // End peloton namespace